@@ -186,7 +186,7 @@ int main(int argc, char** argv) {
         FLAGS_world_size,
         FLAGS_max_devices_per_node,
         FLAGS_rndv_filepath);
-    reducer = std::make_shared<fl::CoalescingReducer>(1.0, true, true);
+    reducer = std::make_shared<fl::BucketedReducer>(1.0, true, true);
   }
 
   int worldRank = fl::getWorldRank();
@@ -5,12 +5,18 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <iomanip>
+#include <iostream>
+
 #include <gflags/gflags.h>
 
 #include "flashlight/app/benchmark/ModelBenchmarker.h"
 #include "flashlight/app/benchmark/Utils.h"
 #include "flashlight/app/benchmark/models/AsrTransformer.h"
 #include "flashlight/app/benchmark/models/LmTransformer.h"
+#include "flashlight/fl/common/Timer.h"
+#include "flashlight/fl/nn/quantization/quantization.h"
+#include "flashlight/fl/tensor/Compute.h"
 #include "flashlight/fl/tensor/Index.h"
 #include "flashlight/lib/text/String.h"
 #include "flashlight/pkg/runtime/common/DistributedUtils.h"
@@ -22,6 +28,11 @@
 #include "flashlight/pkg/vision/models/ViT.h"
 
 DEFINE_bool(log_verbose, false, "Log out detailed running time benchmark");
+DEFINE_bool(
+    int8,
+    false,
+    "Benchmark int8 post-training quantized inference on CPU instead of "
+    "training");
 
 DEFINE_bool(distributed_enable, false, "Enable distributed training");
 DEFINE_int64(
@@ -315,10 +326,116 @@ void runAsrTransformer(bool fp16 = false) {
       FLAGS_log_verbose);
 }
 
+/* --------------------------- Int8 Inference --------------------------- */
+namespace {
+
+// ASR-style convolutional frontend followed by an MLP, i.e., Conv2D and
+// Linear layers in (nested) Sequentials that fl::quantize can fully rewrite
+std::shared_ptr<fl::Sequential> createConvMlp(int nFeature, int nLabel) {
+  auto model = std::make_shared<fl::Sequential>();
+  model->add(std::make_shared<fl::View>(fl::Shape({-1, 1, nFeature, 0})));
+  // Time x 1 x nFeature x Batch
+  model->add(
+      std::make_shared<fl::Conv2D>(nFeature, 1536, 7, 1, 3, 1, -1, 0, 1, 1));
+  model->add(std::make_shared<fl::GatedLinearUnit>(2));
+  model->add(std::make_shared<fl::Reorder>(fl::Shape({2, 0, 3, 1})));
+  // nFeature x Time x Batch x 1
+  for (int i = 0; i < 4; i++) {
+    auto block = std::make_shared<fl::Sequential>();
+    block->add(std::make_shared<fl::Linear>(768, 3072));
+    block->add(std::make_shared<fl::ReLU>());
+    block->add(std::make_shared<fl::Linear>(3072, 768));
+    block->add(std::make_shared<fl::ReLU>());
+    model->add(block);
+  }
+  model->add(std::make_shared<fl::Linear>(768, nLabel));
+  return model;
+}
+
+// Returns the average time of a forward pass, and its output in `output`
+double timeInference(
+    fl::Sequential& model,
+    const fl::Variable& input,
+    fl::Variable& output) {
+  const int numWarmupIters = 3, numIters = 10;
+  for (int i = 0; i < numWarmupIters; i++) {
+    output = model(input);
+  }
+  fl::sync();
+  auto start = fl::Timer::start();
+  for (int i = 0; i < numIters; i++) {
+    output = model(input);
+    fl::eval(output.tensor());
+  }
+  fl::sync();
+  return fl::Timer::stop(start) / numIters;
+}
+
+} // namespace
+
+void runInt8Inference() {
+  fl::app::benchmark::init();
+
+  // Data
+  const int batchsize = 8, numFrames = 1500, numFeatures = 80;
+  const int numTarget = 30, numCalibrationBatches = 4;
+  auto input = fl::noGrad(fl::randn({numFrames, 1, numFeatures, batchsize}));
+
+  // Model
+  auto model = createConvMlp(numFeatures, numTarget);
+  model->eval();
+
+  // Calibrate, then time f32 & int8 inference of the same model
+  fl::QuantizationCalibrator calibrator;
+  for (int i = 0; i < numCalibrationBatches; i++) {
+    calibrator.forward(
+        *model,
+        fl::noGrad(fl::randn({numFrames, 1, numFeatures, batchsize})));
+  }
+  fl::Variable f32Output, int8Output;
+  const double f32Time = timeInference(*model, input, f32Output);
+  const int numQuantized = fl::quantize(*model, calibrator);
+  const double int8Time = timeInference(*model, input, int8Output);
+
+  // Accuracy of int8 relatively to f32
+  const auto& expected = f32Output.tensor();
+  const auto& actual = int8Output.tensor();
+  const float maxRelError =
+      fl::amax(fl::abs(actual - expected)).asScalar<float>() /
+      fl::amax(fl::abs(expected)).asScalar<float>();
+  const float top1Agreement =
+      fl::mean((fl::argmax(actual, 0) == fl::argmax(expected, 0))
+                   .astype(fl::dtype::f32))
+          .asScalar<float>();
+
+  // Print
+  const double numUnits = batchsize * numFrames / 100.;
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "\n----- Conv + MLP, int8 inference -----" << std::endl;
+  std::cout << "Quantized modules: " << numQuantized << std::endl;
+  std::cout << "Throughput (f32): " << numUnits / f32Time << std::endl;
+  std::cout << "Throughput (int8): " << numUnits / int8Time << std::endl;
+  std::cout << "Speedup: " << f32Time / int8Time << std::endl;
+  std::cout << std::setprecision(4);
+  std::cout << "Max relative error: " << maxRelError << std::endl;
+  std::cout << "Top-1 agreement: " << top1Agreement << std::endl;
+  if (FLAGS_log_verbose) {
+    std::cout << std::setprecision(2);
+    std::cout << "\nForward Time f32 (ms): " << f32Time * 1000;
+    std::cout << "\nForward Time int8 (ms): " << int8Time * 1000;
+    std::cout << std::endl;
+  }
+}
+
 int main(int argc, char** argv) {
   fl::init();
   gflags::ParseCommandLineFlags(&argc, &argv, false);
 
+  if (FLAGS_int8) {
+    runInt8Inference();
+    return 0;
+  }
+
   if (FLAGS_distributed_enable) {
     fl::pkg::runtime::initDistributed(
         FLAGS_distributed_world_rank,
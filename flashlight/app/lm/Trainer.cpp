@@ -247,7 +247,10 @@ Trainer::Trainer(const std::string& mode) {
 
   this->init();
   if (FLAGS_distributed_enable) {
-    reducer_ = std::make_shared<fl::CoalescingReducer>(1.0, true, true);
+    // Synchronizes gradients by buckets while the backward pass goes on
+    reducer_ = std::make_shared<fl::BucketedReducer>(1.0, true, true);
+    fl::distributeModuleGrads(network_, reducer_);
+    fl::distributeModuleGrads(criterion_, reducer_);
   }
 
   if (FLAGS_fl_amp_use_mixed_precision) {
@@ -741,14 +744,8 @@ void Trainer::setLr() {
 void Trainer::reduceGrads() {
   collectParameters();
   if (reducer_) {
-    for (auto& p : parameters_) {
-      if (!p.isGradAvailable()) {
-        p.addGrad(fl::constant(0.0, p.shape(), p.type(), false));
-      }
-      auto& grad = p.grad().tensor();
-      p.grad().tensor() = grad;
-      reducer_->add(p.grad());
-    }
+    // Gradients were added by hooks during the backward pass. Also
+    // synchronizes zero gradients for the parameters which didn't get any
     reducer_->finalize();
   }
 }
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/autograd/Checkpoint.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+
+namespace fl {
+
+namespace {
+
+// Draws a seed from the random generator, so that reseeding it keeps the
+// sequence of random values unpredictable
+int drawSeed() {
+  return static_cast<int>(
+      fl::rand({1}).scalar<float>() * std::numeric_limits<int>::max());
+}
+
+// Runs `fn` on inputs sharing the data of `inputs`, but not their graph, and
+// returns these inputs and the outputs
+std::pair<std::vector<Variable>, std::vector<Variable>> runDetached(
+    const CheckpointFunc& fn,
+    const std::vector<Variable>& inputs,
+    int seed) {
+  std::vector<Variable> detached;
+  detached.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    detached.emplace_back(input.tensor(), input.isCalcGrad());
+  }
+  fl::setSeed(seed);
+  auto outputs = fn(detached);
+  return {std::move(detached), std::move(outputs)};
+}
+
+struct CheckpointGradData {
+  // gradients of the outputs, if the backward pass reached them
+  std::vector<std::optional<Tensor>> outputGrads;
+};
+
+} // namespace
+
+std::vector<Variable> checkpoint(
+    const CheckpointFunc& fn,
+    const std::vector<Variable>& inputs) {
+  if (!NoGradGuard::isGradEnabled()) {
+    return fn(inputs); // nothing to recompute
+  }
+  const int seed = drawSeed();
+  // The graph is only recorded when `fn` is recomputed in the backward pass
+  std::vector<Variable> outputs;
+  {
+    NoGradGuard noGrad;
+    outputs = runDetached(fn, inputs, seed).second;
+  }
+  const bool anyInputCalcGrad =
+      std::any_of(inputs.begin(), inputs.end(), [](const Variable& input) {
+        return input.isCalcGrad();
+      });
+
+  auto gradData = std::make_shared<CheckpointGradData>();
+  gradData->outputGrads.resize(outputs.size());
+
+  // Recomputes `fn` with its graph, and backpropagates the gradients of its
+  // outputs through it
+  auto gradFunc = [fn, seed, gradData, numInputs = inputs.size()](
+                      std::vector<Variable>& inputs,
+                      const Variable& /* gradOutput */) {
+    const int resumeSeed = drawSeed();
+    std::vector<Variable> recomputeInputs(
+        inputs.begin(), inputs.begin() + numInputs);
+    auto [leaves, outputs] = runDetached(fn, recomputeInputs, seed);
+    fl::setSeed(resumeSeed);
+
+    // Propagate all gradients at once, so that shared parts of the graph are
+    // only traversed once
+    std::vector<Variable> outputsWithGrad;
+    std::vector<Tensor> outputGrads;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      if (gradData->outputGrads[i] && outputs[i].isCalcGrad()) {
+        outputsWithGrad.push_back(outputs[i]);
+        outputGrads.push_back(std::move(*gradData->outputGrads[i]));
+      }
+      gradData->outputGrads[i].reset();
+    }
+    Variable gradRoot(
+        Tensor(),
+        std::move(outputsWithGrad),
+        [outputGrads = std::move(outputGrads)](
+            std::vector<Variable>& outputs, const Variable& /* unused */) {
+          for (size_t i = 0; i < outputs.size(); ++i) {
+            outputs[i].addGrad(Variable(outputGrads[i], false));
+          }
+        });
+    if (!gradRoot.isCalcGrad()) {
+      return;
+    }
+    gradRoot.backward(Variable(Tensor(), false));
+
+    for (size_t i = 0; i < numInputs; ++i) {
+      if (leaves[i].isGradAvailable()) {
+        inputs[i].addGrad(leaves[i].grad());
+      }
+    }
+  };
+
+  std::vector<Variable> checkpointInputs = inputs;
+  if (!anyInputCalcGrad) {
+    // Parameters used by `fn` may still need gradients, which only the node
+    // can compute
+    checkpointInputs.emplace_back(Tensor(), true);
+  }
+  Variable checkpointNode(Tensor(), std::move(checkpointInputs), gradFunc);
+
+  // Without the graph, outputs not depending on inputs or parameters can't be
+  // told apart, so all of them require gradients
+  std::vector<Variable> result;
+  result.reserve(outputs.size());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    auto outputGradFunc = [gradData, i](
+                              std::vector<Variable>& inputs,
+                              const Variable& gradOutput) {
+      if (!inputs[0].isGradAvailable()) {
+        inputs[0].addGrad(Variable(Tensor(), false));
+      }
+      gradData->outputGrads[i] = gradOutput.tensor();
+    };
+    result.push_back(
+        Variable(outputs[i].tensor(), {checkpointNode}, outputGradFunc));
+  }
+  return result;
+}
+
+Variable checkpoint(
+    const std::function<Variable(const Variable&)>& fn,
+    const Variable& input) {
+  auto outputs = checkpoint(
+      [fn](const std::vector<Variable>& inputs) -> std::vector<Variable> {
+        return {fn(inputs[0])};
+      },
+      {input});
+  return outputs[0];
+}
+
+} // namespace fl
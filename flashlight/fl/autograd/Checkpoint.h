@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "flashlight/fl/autograd/Variable.h"
+#include "flashlight/fl/common/Defines.h"
+
+namespace fl {
+
+/**
+ * \defgroup autograd_checkpoint Activation Checkpointing
+ * @{
+ */
+
+using CheckpointFunc =
+    std::function<std::vector<Variable>(const std::vector<Variable>&)>;
+
+/**
+ * Computes `fn(inputs)` without keeping the intermediate values of the
+ * computation alive until the backward pass: `fn` runs without recording its
+ * graph (see NoGradGuard), only `inputs` are stored, and `fn` is run again,
+ * recording its graph, when the backward pass reaches its outputs. This trades
+ * compute for memory, e.g. to fit larger batches or longer sequences.
+ *
+ * Gradients flow to `inputs`, and to the parameters used by `fn`, as if `fn`
+ * had been called directly. The random seed is restored for the recomputation,
+ * so that random ops (e.g. dropout) in `fn` draw the same values. `fn` must
+ * otherwise compute the same outputs when called again, and side effects (e.g.
+ * updates of running statistics of batch normalization) happen twice.
+ *
+ * Since the graph of `fn` isn't known until it's recomputed, all outputs
+ * require gradients (unless called under a NoGradGuard).
+ *
+ * Parameters used in `fn` get their gradient, and their gradient hook called,
+ * by a nested backward pass through the recomputed graph. Their hooks are
+ * therefore called once per checkpoint using them, plus once by the outer
+ * backward pass if they're also used outside of checkpoints, possibly before
+ * their gradient is complete. Gradients are still accumulated correctly, but
+ * hooks expecting a single call per backward pass (e.g. the one registered by
+ * BucketedReducer, which throws when a gradient is computed twice) don't
+ * support parameters shared across checkpoint boundaries.
+ *
+ * Example:
+ * \code{.cpp}
+ * auto output = checkpoint(
+ *     [&](const std::vector<Variable>& in) { return layer->forward(in); },
+ *     {input});
+ * \endcode
+ *
+ * @param fn the function to compute
+ * @param inputs the inputs of `fn`
+ * @return the outputs of `fn`
+ */
+FL_API std::vector<Variable> checkpoint(
+    const CheckpointFunc& fn,
+    const std::vector<Variable>& inputs);
+
+/**
+ * Single input and output version of `checkpoint` above.
+ */
+FL_API Variable checkpoint(
+    const std::function<Variable(const Variable&)>& fn,
+    const Variable& input);
+
+/** @} */
+
+} // namespace fl
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -1825,6 +1826,103 @@ fl::Variable relativePositionEmbeddingRotate(const fl::Variable& input) {
   return fl::Variable(data, {input}, gradFunc);
 }
 
+namespace {
+
+// Whether attention can be computed by the autograd extension, which doesn't
+// store the attention weights of all pairs of positions
+bool canUseFusedAttention(
+    const Variable& query,
+    const Variable& key,
+    const Variable& value,
+    const Variable& posEmb,
+    const Variable& mask,
+    const Variable& padMask) {
+  const auto isF32 = [](const Variable& var) {
+    return var.type() == fl::dtype::f32;
+  };
+  const Dim queryLen = query.dim(0);
+  const Dim keyLen = key.dim(0);
+  return posEmb.isEmpty() && isF32(query) && isF32(key) && isF32(value) &&
+      key.shape() == value.shape() &&
+      (mask.isEmpty() ||
+       (!mask.isCalcGrad() && mask.dim(0) == queryLen &&
+        mask.elements() == queryLen * keyLen)) &&
+      (padMask.isEmpty() ||
+       (!padMask.isCalcGrad() && padMask.dim(0) == keyLen &&
+        padMask.elements() == keyLen * query.dim(2))) &&
+      detail::isAttentionSupported(query.tensor());
+}
+
+Variable fusedMultiheadAttention(
+    const Variable& query,
+    const Variable& key,
+    const Variable& value,
+    const Variable& mask,
+    const Variable& padMask,
+    const int32_t nHeads,
+    const double pDropout) {
+  const float scale = 1 / std::sqrt(float(query.dim(1) / nHeads));
+  // Drawn from the random generator, so that fl::setSeed determines the
+  // dropout mask
+  const int seed = pDropout > 0
+      ? static_cast<int>(
+            fl::rand({1}).scalar<float>() * std::numeric_limits<int>::max())
+      : 0;
+  const Tensor maskTensor = mask.isEmpty() ? Tensor() : mask.tensor();
+  const Tensor padMaskTensor = padMask.isEmpty() ? Tensor() : padMask.tensor();
+
+  auto payload = detail::createAutogradPayload(query, key, value);
+  Tensor logSumExp;
+  Tensor output = detail::attention(
+      logSumExp,
+      query.tensor(),
+      key.tensor(),
+      value.tensor(),
+      maskTensor,
+      padMaskTensor,
+      nHeads,
+      scale,
+      pDropout,
+      seed,
+      payload);
+
+  auto gradFunc = [maskTensor,
+                   padMaskTensor,
+                   output,
+                   logSumExp,
+                   nHeads,
+                   scale,
+                   pDropout,
+                   seed,
+                   payload](
+                      std::vector<Variable>& inputs,
+                      const Variable& gradOutput) {
+    auto [gradQuery, gradKey, gradValue] = detail::attentionBackward(
+        gradOutput.tensor(),
+        inputs[0].tensor(),
+        inputs[1].tensor(),
+        inputs[2].tensor(),
+        maskTensor,
+        padMaskTensor,
+        output,
+        logSumExp,
+        nHeads,
+        scale,
+        pDropout,
+        seed,
+        payload);
+    std::vector<Tensor> grads = {gradQuery, gradKey, gradValue};
+    for (size_t i = 0; i < grads.size(); ++i) {
+      if (inputs[i].isCalcGrad()) {
+        inputs[i].addGrad(Variable(grads[i], false));
+      }
+    }
+  };
+  return Variable(output, {query, key, value}, gradFunc);
+}
+
+} // namespace
+
 fl::Variable multiheadAttention(
     const fl::Variable& query,
     const fl::Variable& key,
@@ -1851,6 +1949,15 @@ fl::Variable multiheadAttention(
         "Time x (nHeads * headDim) x B");
   }
 
+  if (!padMask.isEmpty() && padMask.dim(0) != query.dim(0)) {
+    throw std::invalid_argument(
+        "multiheadAttention: invalid padding mask size");
+  }
+  if (canUseFusedAttention(query, key, value, posEmb, mask, padMask)) {
+    return fusedMultiheadAttention(
+        query, key, value, mask, padMask, nHeads, pDropout);
+  }
+
   int32_t bsz = query.dim(2);
   int32_t modelDim = query.dim(1);
   int32_t headDim = modelDim / nHeads;
@@ -1872,10 +1979,6 @@ fl::Variable multiheadAttention(
     scores = scores + tileAs(mask.astype(scores.type()), scores);
   }
   if (!padMask.isEmpty()) {
-    if (padMask.dim(0) != query.dim(0)) {
-      throw std::invalid_argument(
-          "multiheadAttention: invalid padding mask size");
-    }
     auto padMaskTile = moddims(padMask, {1, padMask.dim(0), 1, bsz});
     padMaskTile =
         tileAs(padMaskTile, {padMask.dim(0), padMask.dim(0), nHeads, bsz});
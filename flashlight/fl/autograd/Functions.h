@@ -67,11 +67,11 @@ T adjustInputType(const T& in, const char* funcname) {
   // TODO: tiny, but this lookup incurs an extra alloc from char* to string
   if (funcs.find(std::string(funcname)) == funcs.end() &&
       optimLevel != OptimLevel::DEFAULT) {
-    // Not in the excluded list - cast to f16
-    res = in.astype(fl::dtype::f16);
+    // Not in the excluded list - cast to f16 (or bf16)
+    res = in.astype(OptimMode::get().getReducedPrecisionType());
   } else {
-    // Upcast to f32 only if we have an f16 input - otherwise, leave as is
-    if (in.type() == fl::dtype::f16) {
+    // Upcast to f32 only if we have an f16/bf16 input - otherwise, leave as is
+    if (in.type() == fl::dtype::f16 || in.type() == fl::dtype::bf16) {
       res = in.astype(fl::dtype::f32);
     } else {
       res = in;
@@ -988,6 +988,12 @@ FL_API Variable relativePositionalEmbeddingRotate(const Variable& input);
 /**
  * Multihead Attention function
  * For details, see [Vaswani et al (2017)](https://arxiv.org/abs/1706.03762).
+ *
+ * Without positional embedding, f32 inputs and masks which don't require
+ * gradients use the fused attention of the backend if it has one (see
+ * `AutogradExtension::isAttentionSupported`), which doesn't store the
+ * attention weights of all pairs of positions for the backward pass.
+ *
  * @param query query Variable of size T x nHeads * headDim x B
  * @param key key Variable of size Time x nHeads * headDim x B
  * @param value value Variable of size Time x nHeads * headDim x B
@@ -8,8 +8,8 @@
 #include "flashlight/fl/autograd/Variable.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <unordered_set>
@@ -23,6 +23,74 @@
 
 namespace fl {
 
+namespace {
+
+// Ids of graph traversals, used to mark visited Variables without a set
+std::atomic<uint64_t> nextVisitId{1};
+
+// # of graph traversals in progress, across threads. Marks would be clobbered
+// by concurrent traversals of shared parts of graphs (e.g., parameters), so
+// only a traversal started while no other is in progress uses them, while
+// others track visited Variables in a set.
+std::atomic<size_t> numActiveTraversals{0};
+
+class ActiveTraversalGuard {
+ public:
+  ActiveTraversalGuard()
+      : isExclusive_(
+            numActiveTraversals.fetch_add(1, std::memory_order_acq_rel) == 0) {}
+
+  ~ActiveTraversalGuard() {
+    numActiveTraversals.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  // whether no other traversal was in progress when this one started
+  bool isExclusive() const {
+    return isExclusive_;
+  }
+
+ private:
+  const bool isExclusive_;
+};
+
+// Buffers of the graph traversals of a thread, kept between traversals so
+// that their capacity is reused:
+// - the Variables being visited, and the index of their next input to visit.
+// - the topological orders, per nesting level of backward passes (gradient
+//   functions may run backward passes themselves).
+thread_local std::vector<std::pair<const Variable*, size_t>> visitStack;
+thread_local std::vector<std::unique_ptr<std::vector<Variable>>> dagBuffers;
+thread_local size_t dagDepth = 0;
+
+// # of NoGradGuards in scope on the current thread
+thread_local size_t noGradDepth = 0;
+
+// Acquires the topological order buffer of the current nesting level, and
+// clears it when done
+class DagBufferGuard {
+ public:
+  DagBufferGuard() {
+    if (dagDepth == dagBuffers.size()) {
+      dagBuffers.push_back(std::make_unique<std::vector<Variable>>());
+    }
+    dag_ = dagBuffers[dagDepth++].get();
+  }
+
+  ~DagBufferGuard() {
+    dag_->clear();
+    --dagDepth;
+  }
+
+  std::vector<Variable>& operator*() const {
+    return *dag_;
+  }
+
+ private:
+  std::vector<Variable>* dag_;
+};
+
+} // namespace
+
 Variable::Variable(Tensor data, bool calcGrad) {
   sharedData_->data = std::move(data);
   sharedGrad_->calcGrad = calcGrad;
@@ -33,7 +101,8 @@ Variable::Variable(
     std::vector<Variable> inputs,
     GradFunc gradFunc) {
   sharedData_->data = std::move(data);
-  if (std::any_of(inputs.begin(), inputs.end(), [](const Variable& input) {
+  if (NoGradGuard::isGradEnabled() &&
+      std::any_of(inputs.begin(), inputs.end(), [](const Variable& input) {
         return input.isCalcGrad();
       })) {
     sharedGrad_->calcGrad = true;
@@ -170,15 +239,36 @@ void Variable::eval() const {
 }
 
 void Variable::zeroGrad() {
+  if (sharedGrad_->persistentGrad && sharedGrad_->grad) {
+    sharedGrad_->gradBuffer = std::move(sharedGrad_->grad);
+  }
   sharedGrad_->grad.reset();
 }
 
+void Variable::setPersistentGrad(bool persistentGrad) {
+  sharedGrad_->persistentGrad = persistentGrad;
+  if (!persistentGrad) {
+    sharedGrad_->gradBuffer.reset();
+  } else if (
+      sharedGrad_->calcGrad && !sharedGrad_->grad &&
+      !sharedGrad_->gradBuffer) {
+    sharedGrad_->gradBuffer =
+        std::make_unique<Variable>(Tensor(shape(), type()), false);
+  }
+}
+
+bool Variable::isPersistentGrad() const {
+  return sharedGrad_->persistentGrad;
+}
+
 void Variable::setCalcGrad(bool calcGrad) {
   sharedGrad_->calcGrad = calcGrad;
   if (!calcGrad) {
     sharedGrad_->gradFunc = nullptr;
     sharedGrad_->inputs.clear();
     sharedGrad_->grad.reset();
+    sharedGrad_->gradBuffer.reset();
+    sharedGrad_->cachedOrder.reset();
   }
 }
 
@@ -202,7 +292,9 @@ void Variable::addGrad(const Variable& childGrad) {
          << childGrad.shape() << std::endl;
       throw std::invalid_argument(ss.str());
     }
-    if (sharedGrad_->grad) {
+    if (sharedGrad_->persistentGrad) {
+      addPersistentGrad(childGrad);
+    } else if (sharedGrad_->grad) {
       // Prevent increment of array refcount to avoid a copy
       // if getting a device pointer. See
       // https://git.io/fp9oM for more
@@ -217,6 +309,25 @@ void Variable::addGrad(const Variable& childGrad) {
   }
 }
 
+void Variable::addPersistentGrad(const Variable& childGrad) {
+  auto& grad = sharedGrad_->grad;
+  auto& buffer = sharedGrad_->gradBuffer;
+  if (grad) {
+    grad->tensor() += childGrad.tensor();
+  } else if (
+      buffer && buffer->shape() == childGrad.shape() &&
+      buffer->type() == childGrad.type()) {
+    // Copy into the existing buffer
+    std::move(buffer->tensor()) = childGrad.tensor();
+    grad = std::move(buffer);
+  } else {
+    // Own the gradient, since accumulating in place must not modify the
+    // tensor of `childGrad`, which may be shared
+    grad = std::make_unique<Variable>(childGrad.tensor(), false);
+    buffer.reset();
+  }
+}
+
 void Variable::registerGradHook(const GradHook& hook) {
   sharedGrad_->onGradAvailable = hook;
 }
@@ -242,19 +353,54 @@ void Variable::calcGradInputs(bool retainGraph) {
   }
   if (!retainGraph) {
     sharedGrad_->inputs.clear();
+    sharedGrad_->cachedOrder.reset();
   }
 }
 
 void Variable::backward(const Variable& grad, bool retainGraph) {
   addGrad(grad);
-  auto dag = build();
-  for (auto iter = dag.rbegin(); iter != dag.rend(); iter++) {
-    iter->calcGradInputs(retainGraph);
-    iter->applyGradHook();
-    if (!retainGraph) {
+  if (!retainGraph) {
+    sharedGrad_->cachedOrder.reset();
+    DagBufferGuard dagBuffer;
+    auto& dag = *dagBuffer;
+    build(dag);
+    for (auto iter = dag.rbegin(); iter != dag.rend(); iter++) {
+      iter->calcGradInputs(retainGraph);
+      iter->applyGradHook();
+      // Release the graph as we go
       *iter = Variable();
     }
+    return;
+  }
+
+  if (!isCachedOrderValid()) {
+    auto order = std::make_unique<GraphOrder>();
+    {
+      DagBufferGuard dagBuffer;
+      auto& dag = *dagBuffer;
+      build(dag);
+      // The last Variable is this one
+      order->variables.assign(
+          std::make_move_iterator(dag.begin()),
+          std::make_move_iterator(dag.end() - 1));
+    }
+    order->numInputs.reserve(order->variables.size());
+    for (const auto& var : order->variables) {
+      order->numInputs.push_back(var.getInputs().size());
+    }
+    sharedGrad_->cachedOrder = std::move(order);
   }
+  // Hold the order while gradient functions and hooks run, in case they
+  // modify this Variable
+  auto order = std::move(sharedGrad_->cachedOrder);
+  calcGradInputs(retainGraph);
+  applyGradHook();
+  auto& variables = order->variables;
+  for (auto iter = variables.rbegin(); iter != variables.rend(); iter++) {
+    iter->calcGradInputs(retainGraph);
+    iter->applyGradHook();
+  }
+  sharedGrad_->cachedOrder = std::move(order);
 }
 
 void Variable::backward(bool retainGraph) {
@@ -271,26 +417,67 @@ Variable Variable::withoutData() const {
   return other;
 }
 
-Variable::DAG Variable::build() const {
-  std::unordered_set<SharedGrad*> cache;
-  DAG dag;
-  std::function<void(const Variable&)> recurse;
-
-  // Topological sort
-  recurse = [&](const Variable& var) {
-    auto id = var.sharedGrad_.get();
-    if (cache.find(id) != cache.end()) {
-      return;
+void Variable::build(DAG& dag) const {
+  const ActiveTraversalGuard traversal;
+  const uint64_t visitId = nextVisitId.fetch_add(1, std::memory_order_relaxed);
+  std::unordered_set<const SharedGrad*> visited;
+  // returns whether `var` wasn't visited yet
+  const auto visit = [&](const Variable& var) {
+    if (!traversal.isExclusive()) {
+      return visited.insert(var.sharedGrad_.get()).second;
     }
-    for (const auto& input : var.getInputs()) {
-      recurse(input);
+    if (var.sharedGrad_->visitId == visitId) {
+      return false;
     }
-    cache.insert(id);
-    dag.push_back(var);
+    var.sharedGrad_->visitId = visitId;
+    return true;
   };
+  auto& stack = visitStack;
+  stack.clear();
+
+  // Topological sort, with an iterative depth-first search so that deep graphs
+  // don't overflow the call stack
+  visit(*this);
+  stack.emplace_back(this, 0);
+  while (!stack.empty()) {
+    auto& [var, nextInput] = stack.back();
+    const auto& inputs = var->getInputs();
+    if (nextInput == inputs.size()) {
+      dag.push_back(*var);
+      stack.pop_back();
+      continue;
+    }
+    const auto& input = inputs[nextInput++];
+    if (visit(input)) {
+      stack.emplace_back(&input, 0);
+    }
+  }
+}
+
+bool Variable::isCachedOrderValid() const {
+  const auto& order = sharedGrad_->cachedOrder;
+  if (!order) {
+    return false;
+  }
+  // Graphs are only modified by clearing the inputs of their Variables
+  for (size_t i = 0; i < order->variables.size(); ++i) {
+    if (order->variables[i].getInputs().size() != order->numInputs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+NoGradGuard::NoGradGuard() {
+  ++noGradDepth;
+}
+
+NoGradGuard::~NoGradGuard() {
+  --noGradDepth;
+}
 
-  recurse(*this);
-  return dag;
+bool NoGradGuard::isGradEnabled() {
+  return noGradDepth == 0;
 }
 
 } // namespace fl
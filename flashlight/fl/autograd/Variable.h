@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -228,17 +229,38 @@ class FL_API Variable {
   }
 
   /**
-   * Remove the gradient stored by the Variable
+   * Remove the gradient stored by the Variable. If the gradient is persistent
+   * (see `setPersistentGrad`), its buffer is kept for the next backward pass.
    */
   void zeroGrad();
 
+  /**
+   * Set whether the gradient buffer of the Variable persists across
+   * `zeroGrad()` calls. A persistent gradient is allocated once, and
+   * accumulated in place, which avoids reallocating gradients of parameters at
+   * every iteration, or when accumulating gradients over several backward
+   * passes. The buffer is allocated (uninitialized) when enabling it, and
+   * released when disabling it, or when disabling gradient calculation.
+   *
+   * Since the buffer is reused, copies of `grad()` see the gradients of
+   * further backward passes.
+   */
+  void setPersistentGrad(bool persistentGrad);
+
+  /**
+   * Returns whether the gradient buffer of the Variable persists across
+   * `zeroGrad()` calls. See `setPersistentGrad`.
+   */
+  bool isPersistentGrad() const;
+
   /**
    * Set whether to calculate gradient for the Variable.
    */
   void setCalcGrad(bool calcGrad);
 
   /**
-   * Add the gradient `childGrad` to the Variable.
+   * Add the gradient `childGrad` to the Variable, in place if the gradient is
+   * persistent.
    * No-op if `this->isCalcGrad()` is false.
    */
   void addGrad(const Variable& childGrad);
@@ -258,6 +280,17 @@ class FL_API Variable {
    * Run backward pass on the Variable.  Gradient of all the inputs
    * in the computation graph leading up to the Variable on which the function
    * is computed.
+   *
+   * The graph is traversed iteratively, and without allocating once the
+   * traversal buffers of the calling thread fit the graph (unless other
+   * threads traverse graphs at the same time). When the graph is retained, its
+   * topological order is kept by the Variable, and reused by further backward
+   * passes from the Variable as long as the graph is unchanged.
+   *
+   * Backward passes may run concurrently on different threads, but gradients
+   * are accumulated without synchronization, so Variables shared by their
+   * graphs must not require gradients.
+   *
    * @param[in] grad gradient w.r.t to the Variable
    * @param[in] retainGraph If False, clears the input Variables stored
    * by the Variable
@@ -290,10 +323,17 @@ class FL_API Variable {
   std::vector<Variable>& getInputs() const;
 
   /**
-   * Builds the computation graph which comprises of all the input Variables for
-   * which the gradient of `var` can be propagated using chain rule
+   * Appends to `dag` the computation graph which comprises of all the input
+   * Variables for which the gradient of this Variable can be propagated using
+   * chain rule, in topological order (ending with this Variable)
    */
-  DAG build() const;
+  void build(DAG& dag) const;
+
+  /**
+   * Whether the topological order cached by a previous backward pass can be
+   * reused, i.e. the Variables of the graph still have the same inputs
+   */
+  bool isCachedOrderValid() const;
 
   /**
    * Calculate the gradient of inputs.
@@ -302,6 +342,11 @@ class FL_API Variable {
    */
   void calcGradInputs(bool retainGraph = false);
 
+  /**
+   * Adds `childGrad` to the persistent gradient, in place
+   */
+  void addPersistentGrad(const Variable& childGrad);
+
   /**
    * Calls the gradient hook (if any) registered by the Variable
    */
@@ -314,6 +359,15 @@ class FL_API Variable {
     FL_SAVE_LOAD(data)
   };
 
+  struct GraphOrder {
+    /// Variables of the graph, in topological order, excluding the Variable
+    /// owning the order (which would form a reference cycle)
+    DAG variables;
+    /// Number of inputs of each Variable of `variables` when the order was
+    /// built
+    std::vector<size_t> numInputs;
+  };
+
   struct SharedGrad {
     /// Whether the gradient should be computed for this Variable
     bool calcGrad{false};
@@ -321,10 +375,20 @@ class FL_API Variable {
     std::vector<Variable> inputs;
     /// Gradient with respect to this Variable
     std::unique_ptr<Variable> grad{nullptr};
+    /// Whether the gradient buffer is kept when zeroing the gradient
+    bool persistentGrad{false};
+    /// Gradient buffer kept for the next backward pass, when persistent
+    std::unique_ptr<Variable> gradBuffer{nullptr};
     /// Function for calculating the gradient of the input Variables
     GradFunc gradFunc{nullptr};
     /// Function applied to gradient after it's computed during bwd pass
     GradHook onGradAvailable{nullptr};
+    /// Id of the last graph traversal which reached this Variable, only used
+    /// by traversals not running concurrently with others
+    uint64_t visitId{0};
+    /// Topological order of the graph leading to this Variable, kept when
+    /// backward passes retain the graph
+    std::unique_ptr<GraphOrder> cachedOrder{nullptr};
 
    private:
     FL_SAVE_LOAD(calcGrad);
@@ -339,4 +403,33 @@ class FL_API Variable {
   FL_SAVE_LOAD(sharedData_, sharedGrad_)
 };
 
+/**
+ * Disables recording of the computation graph on the current thread while in
+ * scope: Variables computed from other Variables don't require gradients, so
+ * their gradient functions (and the values these keep alive) are released
+ * right away. Guards can be nested.
+ *
+ * Example:
+ * \code{.cpp}
+ * {
+ *   NoGradGuard noGrad;
+ *   auto output = model->forward(input); // output.isCalcGrad() is false
+ * }
+ * \endcode
+ */
+class FL_API NoGradGuard {
+ public:
+  NoGradGuard();
+  ~NoGradGuard();
+
+  NoGradGuard(const NoGradGuard&) = delete;
+  NoGradGuard& operator=(const NoGradGuard&) = delete;
+
+  /**
+   * @return whether the computation graph is recorded on the current thread,
+   * i.e., whether no NoGradGuard is in scope.
+   */
+  static bool isGradEnabled();
+};
+
 } // namespace fl
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "flashlight/fl/autograd/Checkpoint.h"
 #include "flashlight/fl/autograd/Functions.h"
 #include "flashlight/fl/autograd/Utils.h"
 #include "flashlight/fl/autograd/Variable.h"
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <stdexcept>
+
 #include "flashlight/fl/autograd/tensor/AutogradOps.h"
 #include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/tensor/TensorExtension.h"
@@ -105,6 +107,30 @@ class AutogradExtension : public TensorExtension<AutogradExtension> {
       const float dropout,
       std::shared_ptr<detail::AutogradPayload> payload) = 0;
 
+  /**
+   * Whether the extension implements `attention` and `attentionBackward`.
+   * Callers otherwise compute attention with other tensor ops.
+   */
+  virtual bool isAttentionSupported() const {
+    return false;
+  }
+
+  virtual Tensor attention(
+      Tensor& /* logSumExp */,
+      const Tensor& /* query */,
+      const Tensor& /* key */,
+      const Tensor& /* value */,
+      const Tensor& /* mask */,
+      const Tensor& /* padMask */,
+      const int /* nHeads */,
+      const float /* scale */,
+      const float /* dropout */,
+      const int /* seed */,
+      std::shared_ptr<detail::AutogradPayload> /* payload */) {
+    throw std::runtime_error(
+        "AutogradExtension::attention - not supported by this extension");
+  }
+
   /**************************** Backward ****************************/
   // ]----- conv2d
   virtual Tensor conv2dBackwardData(
@@ -177,6 +203,26 @@ class AutogradExtension : public TensorExtension<AutogradExtension> {
       const bool bidirectional,
       const float dropProb,
       std::shared_ptr<detail::AutogradPayload> payload) = 0;
+
+  // ]----- attention
+  virtual std::tuple<Tensor, Tensor, Tensor> attentionBackward(
+      const Tensor& /* gradOutput */,
+      const Tensor& /* query */,
+      const Tensor& /* key */,
+      const Tensor& /* value */,
+      const Tensor& /* mask */,
+      const Tensor& /* padMask */,
+      const Tensor& /* output */,
+      const Tensor& /* logSumExp */,
+      const int /* nHeads */,
+      const float /* scale */,
+      const float /* dropout */,
+      const int /* seed */,
+      std::shared_ptr<detail::AutogradPayload> /* payload */) {
+    throw std::runtime_error(
+        "AutogradExtension::attentionBackward - not supported by this "
+        "extension");
+  }
 };
 
 } // namespace fl
@@ -141,6 +141,29 @@ std::tuple<Tensor, Tensor, Tensor> rnn(
       /* payload = */ nullptr);
 }
 
+Tensor attention(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const int nHeads,
+    const float scale) {
+  Tensor logSumExp;
+  return detail::attention(
+      logSumExp,
+      query,
+      key,
+      value,
+      mask,
+      padMask,
+      nHeads,
+      scale,
+      /* dropout = */ 0,
+      /* seed = */ 0,
+      /* payload = */ nullptr);
+}
+
 namespace detail {
 
 Tensor conv2d(
@@ -225,6 +248,39 @@ std::tuple<Tensor, Tensor, Tensor> rnn(
       payload);
 }
 
+bool isAttentionSupported(const Tensor& input) {
+  return detail::TensorExtensionRegistrar::getInstance()
+             .isTensorExtensionRegistered(
+                 input.backendType(), TensorExtensionType::Autograd) &&
+      input.backend().getExtension<AutogradExtension>().isAttentionSupported();
+}
+
+Tensor attention(
+    Tensor& logSumExp,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const int nHeads,
+    const float scale,
+    const float dropout,
+    const int seed,
+    std::shared_ptr<detail::AutogradPayload> payload) {
+  return query.backend().getExtension<AutogradExtension>().attention(
+      logSumExp,
+      query,
+      key,
+      value,
+      mask,
+      padMask,
+      nHeads,
+      scale,
+      dropout,
+      seed,
+      payload);
+}
+
 Tensor conv2dBackwardData(
     const Tensor& gradOutput,
     const Tensor& input,
@@ -360,6 +416,36 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> rnnBackward(
       payload);
 }
 
+std::tuple<Tensor, Tensor, Tensor> attentionBackward(
+    const Tensor& gradOutput,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const Tensor& output,
+    const Tensor& logSumExp,
+    const int nHeads,
+    const float scale,
+    const float dropout,
+    const int seed,
+    std::shared_ptr<detail::AutogradPayload> payload) {
+  return query.backend().getExtension<AutogradExtension>().attentionBackward(
+      gradOutput,
+      query,
+      key,
+      value,
+      mask,
+      padMask,
+      output,
+      logSumExp,
+      nHeads,
+      scale,
+      dropout,
+      seed,
+      payload);
+}
+
 } // namespace detail
 
 } // namespace fl
@@ -240,6 +240,36 @@ FL_API std::tuple<Tensor, Tensor, Tensor> rnn(
     const bool bidirectional,
     const float dropout);
 
+/**
+ * Computes multi-head scaled dot-product attention without storing the
+ * attention weights of all pairs of query and key positions. For each head:
+ * \f[
+    \text{out} = \text{softmax}(\text{scale} \cdot QK^T + \text{mask}) V
+ * \f]
+ * where the softmax is taken along key positions. Requires a backend whose
+ * autograd extension implements attention (see
+ * `AutogradExtension::isAttentionSupported`).
+ *
+ * @param query a Tensor with shape [\f$T_q\f$, nHeads * headDim, \f$B\f$]
+ * @param key a Tensor with shape [\f$T_k\f$, nHeads * headDim, \f$B\f$]
+ * @param value a Tensor with shape [\f$T_k\f$, nHeads * headDim, \f$B\f$]
+ * @param mask an additive mask with shape [\f$T_q\f$, \f$T_k\f$], or an
+ * empty Tensor
+ * @param padMask an additive mask with shape [\f$T_k\f$, \f$B\f$], or an
+ * empty Tensor
+ * @param nHeads number of heads
+ * @param scale scale of the scores, usually \f$1 / \sqrt{headDim}\f$
+ * @return a Tensor with shape [\f$T_q\f$, nHeads * headDim, \f$B\f$]
+ */
+FL_API Tensor attention(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const int nHeads,
+    const float scale);
+
 namespace detail {
 
 FL_API Tensor conv2d(
@@ -292,6 +322,27 @@ FL_API std::tuple<Tensor, Tensor, Tensor> rnn(
     const float dropout,
     std::shared_ptr<detail::AutogradPayload> payload);
 
+// Whether the autograd extension of the backend of `input` implements
+// attention
+FL_API bool isAttentionSupported(const Tensor& input);
+
+// Attention with dropout of probability `dropout` on the attention weights,
+// drawn deterministically from `seed`. Also returns the log-sum-exp of the
+// scores of each query position, with shape [Tq, nHeads * B], for the
+// backward pass to recompute the attention weights
+FL_API Tensor attention(
+    Tensor& logSumExp,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const int nHeads,
+    const float scale,
+    const float dropout,
+    const int seed,
+    std::shared_ptr<detail::AutogradPayload> payload);
+
 // Returns the gradient with respect to the input
 FL_API Tensor conv2dBackwardData(
     const Tensor& gradOutput,
@@ -376,6 +427,23 @@ FL_API std::tuple<Tensor, Tensor, Tensor, Tensor> rnnBackward(
     const float dropProb,
     std::shared_ptr<detail::AutogradPayload> payload);
 
+// Returns the gradients with respect to the query, key and value,
+// respectively. Masks don't get gradients
+FL_API std::tuple<Tensor, Tensor, Tensor> attentionBackward(
+    const Tensor& gradOutput,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const Tensor& output,
+    const Tensor& logSumExp,
+    const int nHeads,
+    const float scale,
+    const float dropout,
+    const int seed,
+    std::shared_ptr<detail::AutogradPayload> payload);
+
 } // namespace detail
 
 } // namespace fl
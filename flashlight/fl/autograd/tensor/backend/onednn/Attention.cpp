@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/OneDnnAutogradExtension.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+
+namespace fl {
+
+// Attention on host buffers, which never stores the scores of all pairs of
+// query and key positions: queries are processed in blocks against blocks of
+// keys, whose scores stay in cache. The forward pass normalizes with an online
+// softmax (a running max and sum per query position), and only stores the
+// log-sum-exp of the scores of each query position, from which the backward
+// pass recomputes the attention weights.
+namespace {
+
+// # of query and key positions processed at once, small enough for a block
+// of scores and the corresponding rows of the inputs to stay in L1/L2
+constexpr Dim kQueryBlockSize = 64;
+constexpr Dim kKeyBlockSize = 64;
+
+constexpr float kNegInf = -std::numeric_limits<float>::infinity();
+
+/**
+ * Sizes of an attention problem. The kernels use a [headDim, T, N] layout,
+ * with N = nHeads * batch size, so that the features of a position are
+ * contiguous.
+ */
+struct AttentionDims {
+  Dim headDim;
+  Dim queryLen;
+  Dim keyLen;
+  Dim nHeads;
+  Dim batchSize;
+
+  Dim numSeqs() const {
+    return nHeads * batchSize;
+  }
+};
+
+AttentionDims getAttentionDims(
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const int nHeads) {
+  if (query.ndim() != 3 || key.ndim() != 3 || value.ndim() != 3) {
+    throw std::invalid_argument(
+        "attention - query, key and value must have 3 dimensions: "
+        "Time x (nHeads * headDim) x B");
+  }
+  if (query.type() != fl::dtype::f32 || key.type() != fl::dtype::f32 ||
+      value.type() != fl::dtype::f32) {
+    throw std::invalid_argument("attention - only f32 inputs are supported");
+  }
+  if (nHeads <= 0 || query.dim(1) % nHeads != 0) {
+    throw std::invalid_argument(
+        "attention - the feature size must be a multiple of nHeads");
+  }
+  if (key.shape() != value.shape() || key.dim(1) != query.dim(1) ||
+      key.dim(2) != query.dim(2)) {
+    throw std::invalid_argument(
+        "attention - key and value must have the same shape, and the feature "
+        "and batch sizes of query");
+  }
+
+  AttentionDims d;
+  d.headDim = query.dim(1) / nHeads;
+  d.queryLen = query.dim(0);
+  d.keyLen = key.dim(0);
+  d.nHeads = nHeads;
+  d.batchSize = query.dim(2);
+  if (!mask.isEmpty() &&
+      (static_cast<Dim>(mask.elements()) != d.queryLen * d.keyLen ||
+       mask.dim(0) != d.queryLen)) {
+    throw std::invalid_argument("attention - mask must be of size Tq x Tk");
+  }
+  if (!padMask.isEmpty() &&
+      (static_cast<Dim>(padMask.elements()) != d.keyLen * d.batchSize ||
+       padMask.dim(0) != d.keyLen)) {
+    throw std::invalid_argument("attention - padMask must be of size Tk x B");
+  }
+  return d;
+}
+
+// [T, nHeads * headDim, B] -> [headDim, T, N]
+std::vector<float> toHostHeads(const Tensor& x, const AttentionDims& d) {
+  return fl::transpose(
+             fl::reshape(x, {x.dim(0), d.headDim, d.numSeqs()}), {1, 0, 2})
+      .toHostVector<float>();
+}
+
+// [headDim, T, N] -> [T, nHeads * headDim, B]
+Tensor fromHostHeads(
+    const std::vector<float>& x,
+    const Dim seqLen,
+    const AttentionDims& d) {
+  auto heads = Tensor::fromVector({d.headDim, seqLen, d.numSeqs()}, x);
+  return fl::reshape(
+      fl::transpose(heads, {1, 0, 2}),
+      {seqLen, d.nHeads * d.headDim, d.batchSize});
+}
+
+std::vector<float> toHostMask(const Tensor& mask) {
+  return mask.isEmpty() ? std::vector<float>()
+                        : mask.astype(fl::dtype::f32).toHostVector<float>();
+}
+
+inline float dot(const float* a, const float* b, const Dim size) {
+  float result = 0;
+#pragma omp simd reduction(+ : result)
+  for (Dim i = 0; i < size; i++) {
+    result += a[i] * b[i];
+  }
+  return result;
+}
+
+// out += alpha * x
+inline void axpy(const float alpha, const float* x, float* out, Dim size) {
+#pragma omp simd
+  for (Dim i = 0; i < size; i++) {
+    out[i] += alpha * x[i];
+  }
+}
+
+inline uint64_t splitMix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * Dropout on the attention weights. Random values are a hash of the seed and
+ * of the position of the weight, so that the backward pass regenerates the
+ * mask of the forward pass without storing it, regardless of the order in
+ * which weights are visited.
+ */
+struct AttentionDropout {
+  float p;
+  float keepScale;
+  uint64_t key;
+  Dim queryLen;
+  Dim keyLen;
+
+  AttentionDropout(float p, int seed, const AttentionDims& d)
+      : p(p),
+        keepScale(1 / (1 - p)),
+        key(splitMix64(static_cast<uint64_t>(seed))),
+        queryLen(d.queryLen),
+        keyLen(d.keyLen) {}
+
+  // The factor of the weight of key j for query i of sequence n
+  float scale(const Dim n, const Dim i, const Dim j) const {
+    if (p == 0) {
+      return 1;
+    }
+    const auto idx = static_cast<uint64_t>((n * queryLen + i) * keyLen + j);
+    // 24 random bits, i.e. a uniform float in [0, 1)
+    const auto bits = splitMix64(key ^ splitMix64(idx)) >> 40;
+    const float u = static_cast<float>(bits) / (1 << 24);
+    // same convention as fl::dropout: keep if u > p
+    return u > p ? keepScale : 0;
+  }
+};
+
+struct AttentionInputs {
+  const float* query;
+  const float* key;
+  const float* value;
+  const float* mask; // [Tq, Tk] or null
+  const float* padMask; // [Tk, B] or null
+  float scale;
+};
+
+/**
+ * Computes the scores of queries [i0, i0 + rows) and keys [j0, j0 + cols) of
+ * sequence n into `scores`, with a row stride of kKeyBlockSize.
+ */
+void blockScores(
+    const AttentionInputs& in,
+    const AttentionDims& d,
+    const Dim n,
+    const Dim i0,
+    const Dim rows,
+    const Dim j0,
+    const Dim cols,
+    float* scores) {
+  const float* q = in.query + n * d.queryLen * d.headDim;
+  const float* k = in.key + n * d.keyLen * d.headDim;
+  const float* padMask =
+      in.padMask ? in.padMask + (n / d.nHeads) * d.keyLen : nullptr;
+  for (Dim r = 0; r < rows; r++) {
+    const Dim i = i0 + r;
+    float* s = scores + r * kKeyBlockSize;
+    for (Dim c = 0; c < cols; c++) {
+      const Dim j = j0 + c;
+      s[c] = in.scale * dot(q + i * d.headDim, k + j * d.headDim, d.headDim);
+    }
+    if (in.mask) {
+      for (Dim c = 0; c < cols; c++) {
+        s[c] += in.mask[i + (j0 + c) * d.queryLen];
+      }
+    }
+    if (padMask) {
+      for (Dim c = 0; c < cols; c++) {
+        s[c] += padMask[j0 + c];
+      }
+    }
+  }
+}
+
+void attentionForwardKernel(
+    const AttentionInputs& in,
+    const AttentionDims& d,
+    const AttentionDropout& dropout,
+    float* out,
+    float* logSumExp) {
+  const Dim numQueryBlocks =
+      (d.queryLen + kQueryBlockSize - 1) / kQueryBlockSize;
+  const Dim numTasks = d.numSeqs() * numQueryBlocks;
+
+  // Blocks of queries are independent
+#pragma omp parallel for schedule(dynamic) if (numTasks > 1)
+  for (Dim task = 0; task < numTasks; task++) {
+    const Dim n = task / numQueryBlocks;
+    const Dim i0 = (task % numQueryBlocks) * kQueryBlockSize;
+    const Dim rows = std::min(kQueryBlockSize, d.queryLen - i0);
+    const float* v = in.value + n * d.keyLen * d.headDim;
+    // the output rows accumulate the unnormalized weighted sum of values
+    float* o = out + (n * d.queryLen + i0) * d.headDim;
+    std::fill(o, o + rows * d.headDim, 0.f);
+
+    std::vector<float> scores(kQueryBlockSize * kKeyBlockSize);
+    std::vector<float> rowMax(rows, kNegInf);
+    std::vector<float> rowSum(rows, 0.f);
+    for (Dim j0 = 0; j0 < d.keyLen; j0 += kKeyBlockSize) {
+      const Dim cols = std::min(kKeyBlockSize, d.keyLen - j0);
+      blockScores(in, d, n, i0, rows, j0, cols, scores.data());
+
+      for (Dim r = 0; r < rows; r++) {
+        const float* s = scores.data() + r * kKeyBlockSize;
+        const float newMax =
+            std::max(rowMax[r], *std::max_element(s, s + cols));
+        if (newMax == kNegInf) {
+          // all keys so far are masked out
+          continue;
+        }
+        // rescale what was accumulated relative to the previous max
+        const float correction = std::exp(rowMax[r] - newMax);
+        float* oRow = o + r * d.headDim;
+        rowSum[r] *= correction;
+        for (Dim f = 0; f < d.headDim; f++) {
+          oRow[f] *= correction;
+        }
+        for (Dim c = 0; c < cols; c++) {
+          const float p = std::exp(s[c] - newMax);
+          rowSum[r] += p;
+          const float w = p * dropout.scale(n, i0 + r, j0 + c);
+          if (w != 0) {
+            axpy(w, v + (j0 + c) * d.headDim, oRow, d.headDim);
+          }
+        }
+        rowMax[r] = newMax;
+      }
+    }
+
+    for (Dim r = 0; r < rows; r++) {
+      float* oRow = o + r * d.headDim;
+      const float norm = 1 / rowSum[r];
+      for (Dim f = 0; f < d.headDim; f++) {
+        oRow[f] *= norm;
+      }
+      logSumExp[n * d.queryLen + i0 + r] = rowMax[r] + std::log(rowSum[r]);
+    }
+  }
+}
+
+void attentionBackwardKernel(
+    const AttentionInputs& in,
+    const AttentionDims& d,
+    const AttentionDropout& dropout,
+    const float* gradOut,
+    const float* out,
+    const float* logSumExp,
+    float* gradQuery,
+    float* gradKey,
+    float* gradValue) {
+  const Dim numSeqs = d.numSeqs();
+
+  // Sequences are independent; within a sequence, each key block accumulates
+  // into the gradients of all queries
+#pragma omp parallel for schedule(dynamic) if (numSeqs > 1)
+  for (Dim n = 0; n < numSeqs; n++) {
+    const Dim qOffset = n * d.queryLen * d.headDim;
+    const Dim kOffset = n * d.keyLen * d.headDim;
+    const float* q = in.query + qOffset;
+    const float* k = in.key + kOffset;
+    const float* v = in.value + kOffset;
+    const float* dOut = gradOut + qOffset;
+    const float* lse = logSumExp + n * d.queryLen;
+    float* dq = gradQuery + qOffset;
+    float* dk = gradKey + kOffset;
+    float* dv = gradValue + kOffset;
+    std::fill(dq, dq + d.queryLen * d.headDim, 0.f);
+    std::fill(dk, dk + d.keyLen * d.headDim, 0.f);
+    std::fill(dv, dv + d.keyLen * d.headDim, 0.f);
+
+    // sum_j P_ij * dP_ij = dOut_i . out_i, with dP the gradient of the
+    // attention weights
+    std::vector<float> delta(d.queryLen);
+    for (Dim i = 0; i < d.queryLen; i++) {
+      delta[i] = dot(
+          dOut + i * d.headDim, out + qOffset + i * d.headDim, d.headDim);
+    }
+
+    std::vector<float> scores(kQueryBlockSize * kKeyBlockSize);
+    for (Dim j0 = 0; j0 < d.keyLen; j0 += kKeyBlockSize) {
+      const Dim cols = std::min(kKeyBlockSize, d.keyLen - j0);
+      for (Dim i0 = 0; i0 < d.queryLen; i0 += kQueryBlockSize) {
+        const Dim rows = std::min(kQueryBlockSize, d.queryLen - i0);
+        blockScores(in, d, n, i0, rows, j0, cols, scores.data());
+
+        for (Dim r = 0; r < rows; r++) {
+          const Dim i = i0 + r;
+          if (lse[i] == kNegInf) {
+            // all keys are masked out
+            continue;
+          }
+          const float* s = scores.data() + r * kKeyBlockSize;
+          const float* dOutRow = dOut + i * d.headDim;
+          for (Dim c = 0; c < cols; c++) {
+            const Dim j = j0 + c;
+            const float p = std::exp(s[c] - lse[i]);
+            if (p == 0) {
+              continue;
+            }
+            const float keep = dropout.scale(n, i, j);
+            float dp = 0;
+            if (keep != 0) {
+              axpy(p * keep, dOutRow, dv + j * d.headDim, d.headDim);
+              dp = keep * dot(dOutRow, v + j * d.headDim, d.headDim);
+            }
+            const float ds = in.scale * p * (dp - delta[i]);
+            axpy(ds, k + j * d.headDim, dq + i * d.headDim, d.headDim);
+            axpy(ds, q + i * d.headDim, dk + j * d.headDim, d.headDim);
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+bool OneDnnAutogradExtension::isAttentionSupported() const {
+  return true;
+}
+
+Tensor OneDnnAutogradExtension::attention(
+    Tensor& logSumExp,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const int nHeads,
+    const float scale,
+    const float dropout,
+    const int seed,
+    std::shared_ptr<detail::AutogradPayload> /* payload */) {
+  const auto d = getAttentionDims(query, key, value, mask, padMask, nHeads);
+  const auto hostQuery = toHostHeads(query, d);
+  const auto hostKey = toHostHeads(key, d);
+  const auto hostValue = toHostHeads(value, d);
+  const auto hostMask = toHostMask(mask);
+  const auto hostPadMask = toHostMask(padMask);
+  AttentionInputs in{
+      hostQuery.data(),
+      hostKey.data(),
+      hostValue.data(),
+      hostMask.empty() ? nullptr : hostMask.data(),
+      hostPadMask.empty() ? nullptr : hostPadMask.data(),
+      scale};
+
+  std::vector<float> out(hostQuery.size());
+  std::vector<float> lse(d.queryLen * d.numSeqs());
+  attentionForwardKernel(
+      in, d, AttentionDropout(dropout, seed, d), out.data(), lse.data());
+
+  logSumExp = Tensor::fromVector({d.queryLen, d.numSeqs()}, lse);
+  return fromHostHeads(out, d.queryLen, d);
+}
+
+std::tuple<Tensor, Tensor, Tensor> OneDnnAutogradExtension::attentionBackward(
+    const Tensor& gradOutput,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const Tensor& mask,
+    const Tensor& padMask,
+    const Tensor& output,
+    const Tensor& logSumExp,
+    const int nHeads,
+    const float scale,
+    const float dropout,
+    const int seed,
+    std::shared_ptr<detail::AutogradPayload> /* payload */) {
+  const auto d = getAttentionDims(query, key, value, mask, padMask, nHeads);
+  const auto hostQuery = toHostHeads(query, d);
+  const auto hostKey = toHostHeads(key, d);
+  const auto hostValue = toHostHeads(value, d);
+  const auto hostMask = toHostMask(mask);
+  const auto hostPadMask = toHostMask(padMask);
+  AttentionInputs in{
+      hostQuery.data(),
+      hostKey.data(),
+      hostValue.data(),
+      hostMask.empty() ? nullptr : hostMask.data(),
+      hostPadMask.empty() ? nullptr : hostPadMask.data(),
+      scale};
+  const auto hostGradOutput =
+      toHostHeads(gradOutput.astype(fl::dtype::f32), d);
+  const auto hostOutput = toHostHeads(output, d);
+  const auto hostLogSumExp = logSumExp.toHostVector<float>();
+
+  std::vector<float> gradQuery(hostQuery.size());
+  std::vector<float> gradKey(hostKey.size());
+  std::vector<float> gradValue(hostValue.size());
+  attentionBackwardKernel(
+      in,
+      d,
+      AttentionDropout(dropout, seed, d),
+      hostGradOutput.data(),
+      hostOutput.data(),
+      hostLogSumExp.data(),
+      gradQuery.data(),
+      gradKey.data(),
+      gradValue.data());
+
+  return {
+      fromHostHeads(gradQuery, d.queryLen, d),
+      fromHostHeads(gradKey, d.keyLen, d),
+      fromHostHeads(gradValue, d.keyLen, d)};
+}
+
+} // namespace fl
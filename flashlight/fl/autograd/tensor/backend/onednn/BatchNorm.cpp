@@ -101,8 +101,9 @@ Tensor OneDnnAutogradExtension::batchnorm(
   if (momentum != 0.) {
     throw std::runtime_error("OneDNN batchnorm op doesn't support momentum.");
   }
-  if (input.type() == fl::dtype::f16) {
-    throw std::runtime_error("OneDNN batchnorm op - f16 inputs not supported.");
+  if (input.type() == fl::dtype::f16 || input.type() == fl::dtype::bf16) {
+    throw std::runtime_error(
+        "OneDNN batchnorm op - f16/bf16 inputs not supported.");
   }
 
   auto payload = std::make_shared<OneDnnBatchNormPayload>();
@@ -110,7 +111,6 @@ Tensor OneDnnAutogradExtension::batchnorm(
     autogradPayload->data = payload;
   }
 
-  auto output = Tensor(input.shape(), input.type());
   int nfeatures = getNfeatures(input.shape(), axes);
 
   if (runningVar.isEmpty()) {
@@ -146,11 +146,37 @@ Tensor OneDnnAutogradExtension::batchnorm(
   payload->biasDims = detail::convertToDnnlDims({nfeatures});
   auto inputOutputDims = getInputOutputDims(minAxis, maxAxis, input, nfeatures);
 
+  // Spatial batchnorm on an input kept in a layout picked by a previous
+  // primitive (e.g., blocked conv output) runs in that layout and produces its
+  // output in the same layout. The backward pass expects plain layouts, so
+  // only do so for inference.
+  const bool keepLayout = !train && input.ndim() == 4 &&
+      axes == std::vector<int>{kChannelSizeIdx} &&
+      detail::hasOpaqueLayout(input);
+
   // Memory for forward
-  const detail::DnnlMemoryWrapper inputMemory(
-      input, inputOutputDims, formatNCHW);
-  const detail::DnnlMemoryWrapper outputMemory(
-      output, inputOutputDims, formatNCHW);
+  Tensor output;
+  detail::DnnlMemoryWrapper inputMemory;
+  detail::DnnlMemoryWrapper outputMemory;
+  if (keepLayout) {
+    inputOutputDims = detail::convertToDnnlDims(
+        {input.dim(kBatchSizeIdx),
+         input.dim(kChannelSizeIdx),
+         input.dim(kWIdx),
+         input.dim(kHIdx)});
+    inputMemory = detail::DnnlMemoryWrapper::anyLayout(
+        input, inputOutputDims, formatNCHW);
+    output =
+        detail::createOneDnnTensor(input.shape(), inputMemory.getDescriptor())
+            .first;
+    outputMemory = detail::DnnlMemoryWrapper::anyLayout(
+        output, inputOutputDims, formatNCHW);
+  } else {
+    output = Tensor(input.shape(), input.type());
+    inputMemory = detail::DnnlMemoryWrapper(input, inputOutputDims, formatNCHW);
+    outputMemory =
+        detail::DnnlMemoryWrapper(output, inputOutputDims, formatNCHW);
+  }
   const detail::DnnlMemoryWrapper meanMemory(
       runningMean, {runningMean.dim(0)}, formatX);
   const detail::DnnlMemoryWrapper varMemory(
@@ -9,6 +9,7 @@
 
 #include <array>
 #include <memory>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -176,7 +177,7 @@ Tensor OneDnnAutogradExtension::conv2d(
   // representation) of these shapes and viewing as if the representation is
   // row major transposes along all axis into NCHW for the input and output
   // and OIHW for the weights
-  auto output = Tensor(
+  const Shape outputShape(
       {1 +
            (input.dim(kWIdx) + (2 * px) - (1 + (weights.dim(kWIdx) - 1) * dx)) /
                sx,
@@ -184,8 +185,10 @@ Tensor OneDnnAutogradExtension::conv2d(
            (input.dim(kHIdx) + (2 * py) - (1 + (weights.dim(kHIdx) - 1) * dy)) /
                sy,
        weights.dim(kWeightOutputChannelSizeIdx),
-       input.dim(kIOBatchSizeIdx)},
-      input.type());
+       input.dim(kIOBatchSizeIdx)});
+  // OneDnnTensors can hold the output in the layout picked by the convolution
+  // (reordered lazily), so that chains of layers don't reorder in between
+  const bool keepOutputLayout = detail::isOneDnnTensor(input);
   auto hasBias = bias.elements() > 0;
 
   auto formatWeight =
@@ -198,7 +201,7 @@ Tensor OneDnnAutogradExtension::conv2d(
       input.shape(),
       weights.shape(),
       bias.shape(),
-      output.shape(),
+      outputShape,
       sx,
       sy,
       px,
@@ -208,10 +211,8 @@ Tensor OneDnnAutogradExtension::conv2d(
       groups);
 
   // Create memory
-  const detail::DnnlMemoryWrapper inputMemInit(
+  const auto inputMemInit = detail::DnnlMemoryWrapper::anyLayout(
       input, {conv2DData.inputDims}, formatNCHW);
-  const detail::DnnlMemoryWrapper outputMemInit(
-      output, {conv2DData.outputDims}, formatNCHW);
   const detail::DnnlMemoryWrapper weightsMem(
       weights, {conv2DData.weightDims}, formatWeight);
 
@@ -232,9 +233,20 @@ Tensor OneDnnAutogradExtension::conv2d(
   auto weightsMemory = detail::dnnlAlignOrdering(
       network, fwdArgs, weightsMem.getMemory(), weightsDesc);
   // Output - adds a reorder after the conv if needed
-  auto outputMemory = outputMemInit.getMemory();
-  if (outputMemInit.getMemory().get_desc() != outputDesc) {
-    outputMemory = memory(outputDesc, dnnlEngine);
+  Tensor output;
+  detail::DnnlMemoryWrapper outputMemInit;
+  dnnl::memory outputMemory;
+  if (keepOutputLayout) {
+    std::tie(output, outputMemory) =
+        detail::createOneDnnTensor(outputShape, outputDesc);
+  } else {
+    output = Tensor(outputShape, input.type());
+    outputMemInit = detail::DnnlMemoryWrapper(
+        output, {conv2DData.outputDims}, formatNCHW);
+    outputMemory = outputMemInit.getMemory();
+    if (outputMemory.get_desc() != outputDesc) {
+      outputMemory = memory(outputDesc, dnnlEngine);
+    }
   }
 
   // Create convolution
@@ -256,7 +268,7 @@ Tensor OneDnnAutogradExtension::conv2d(
   fwdArgs.push_back(convFwdArgs);
 
   // Add output reordering if needed
-  if (outputMemory != outputMemInit.getMemory()) {
+  if (!keepOutputLayout && outputMemory != outputMemInit.getMemory()) {
     network.push_back(dnnl::reorder(outputMemory, outputMemInit.getMemory()));
     fwdArgs.push_back(
         {{DNNL_ARG_FROM, outputMemory},
@@ -16,7 +16,10 @@
 
 #include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/tensor/Compute.h"
+#include "flashlight/fl/tensor/TensorAdapter.h"
 #include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/onednn/OneDnnBackend.h"
+#include "flashlight/fl/tensor/backend/onednn/OneDnnTensor.h"
 
 #if FL_BACKEND_OPENCL
   #include "flashlight/fl/common/OpenClUtils.h"
@@ -32,12 +35,20 @@ DnnlStream::DnnlStream(dnnl::engine engine) {
 #endif
 }
 
+DnnlStream::DnnlStream(dnnl::stream stream) : stream_(std::move(stream)) {}
+
 dnnl::stream& DnnlStream::getStream() {
   return stream_;
 }
 
 DnnlStream& DnnlStream::getInstance() {
+#if FL_BACKEND_OPENCL
   static DnnlStream instance(DnnlEngine::getInstance().getEngine());
+#else
+  // share the OneDNN backend's stream, so primitives are ordered w.r.t. ops on
+  // OneDnnTensors (whose memory is used without synchronization)
+  static DnnlStream instance(OneDnnBackend::getInstance().nativeStream());
+#endif
   return instance;
 }
 
@@ -46,7 +57,9 @@ DnnlEngine::DnnlEngine() {
   engine_ = dnnl::ocl_interop::make_engine(
       fl::ocl::getDeviceId(), fl::ocl::getContext());
 #else
-  engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
+  // share the OneDNN backend's engine, so primitives can use memory of
+  // OneDnnTensors directly
+  engine_ = OneDnnBackend::getInstance().cpuEngine();
 #endif
 }
 
@@ -85,6 +98,22 @@ DnnlMemoryWrapper::DnnlMemoryWrapper(
       descriptor_, detail::DnnlEngine::getInstance().getEngine(), buffer);
 }
 
+DnnlMemoryWrapper DnnlMemoryWrapper::anyLayout(
+    const Tensor& tensor,
+    dnnl::memory::dims dims,
+    dnnl::memory::format_tag plainFormat) {
+  if (hasOpaqueLayout(tensor)) {
+    auto& oneDnnTensor = toOneDnnTensor(tensor);
+    if (oneDnnTensor.memoryDescAnyLayout().get_dims() == dims) {
+      DnnlMemoryWrapper wrapper;
+      wrapper.memory_ = oneDnnTensor.memoryAnyLayout();
+      wrapper.descriptor_ = wrapper.memory_.get_desc();
+      return wrapper;
+    }
+  }
+  return DnnlMemoryWrapper(tensor, std::move(dims), plainFormat);
+}
+
 DnnlMemoryWrapper& DnnlMemoryWrapper::operator=(DnnlMemoryWrapper&& other) {
   devicePtr_ = std::move(other.devicePtr_);
   memory_ = std::move(other.memory_);
@@ -100,6 +129,24 @@ dnnl::memory::desc DnnlMemoryWrapper::getDescriptor() const {
   return descriptor_;
 }
 
+bool isOneDnnTensor(const Tensor& tensor) {
+  return tensor.backendType() == TensorBackendType::OneDnn;
+}
+
+bool hasOpaqueLayout(const Tensor& tensor) {
+  return isOneDnnTensor(tensor) && !toOneDnnTensor(tensor).hasPlainLayout();
+}
+
+std::pair<Tensor, dnnl::memory> createOneDnnTensor(
+    const Shape& shape,
+    const dnnl::memory::desc& desc) {
+  auto& backend = OneDnnBackend::getInstance();
+  auto [memory, buffer] = backend.createMemory(desc, backend.cpuEngine());
+  auto tensor =
+      toTensor<OneDnnTensor>(shape, dnnl::memory(memory), std::move(buffer));
+  return {std::move(tensor), std::move(memory)};
+}
+
 dnnl::memory dnnlAlignOrdering(
     std::vector<dnnl::primitive>& net,
     std::vector<std::unordered_map<int, dnnl::memory>>& netArgs,
@@ -131,14 +178,26 @@ void executeNetwork(
     fl::sync();
   }
 
+#if FL_BACKEND_OPENCL
   for (size_t i = 0; i < net.size(); ++i) {
     net.at(i).execute(DnnlStream::getInstance().getStream(), netArgs.at(i));
   }
+#else
+  // go through the OneDNN backend's stream rather than its native stream: in
+  // asynchronous mode, it orders the primitives after queued ones writing
+  // their inputs (e.g., opaque memory from `DnnlMemoryWrapper::anyLayout`),
+  // and OneDnnTensors they write are synced upon access
+  auto& cpuStream = OneDnnBackend::getInstance().cpuStream();
+  for (size_t i = 0; i < net.size(); ++i) {
+    cpuStream.execute(net.at(i), netArgs.at(i));
+  }
+#endif
 
   // TODO{fl::Tensor}{macros} -- improve this to work with other backend interop
   if (FL_BACKEND_CPU) {
-    // Block the executing thread until the work is complete
-    DnnlStream::getInstance().getStream().wait();
+    // Block the executing thread until the work is complete, including work
+    // queued on the OneDNN backend's stream
+    fl::sync();
   }
 }
 
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <array>
+#include <utility>
 
 #include <dnnl.hpp>
 
@@ -28,6 +29,7 @@ namespace detail {
 class DnnlStream {
  public:
   DnnlStream(dnnl::engine engine);
+  explicit DnnlStream(dnnl::stream stream);
   ~DnnlStream() = default;
 
   /// Prohibit assignment
@@ -78,9 +80,24 @@ class DnnlMemoryWrapper {
       dnnl::memory::dims dims,
       dnnl::memory::format_tag format);
   DnnlMemoryWrapper() = default;
+  DnnlMemoryWrapper(DnnlMemoryWrapper&& other) = default;
 
   DnnlMemoryWrapper& operator=(DnnlMemoryWrapper&& other);
 
+  /**
+   * If `tensor` is a OneDnnTensor whose memory is in an opaque layout (e.g.,
+   * blocked, as produced by another primitive) with dims `dims`, wraps that
+   * memory as is, for primitives that accept any layout. Otherwise, same as
+   * the constructor with `plainFormat`.
+   *
+   * NOTE opaque memory isn't synced, since primitives run by `executeNetwork`
+   * are ordered after queued work producing it.
+   */
+  static DnnlMemoryWrapper anyLayout(
+      const Tensor& tensor,
+      dnnl::memory::dims dims,
+      dnnl::memory::format_tag plainFormat);
+
   dnnl::memory getMemory() const;
 
   dnnl::memory::desc getDescriptor() const;
@@ -91,6 +108,29 @@ class DnnlMemoryWrapper {
   fl::DevicePtr devicePtr_;
 };
 
+/**
+ * Whether `tensor` is backed by the OneDNN tensor backend, whose tensors can
+ * hold memory in opaque layouts picked by primitives.
+ */
+bool isOneDnnTensor(const Tensor& tensor);
+
+/**
+ * Whether `tensor` is a OneDnnTensor whose memory is in an opaque layout, i.e.,
+ * not yet reordered to the plain layout its shape implies.
+ */
+bool hasOpaqueLayout(const Tensor& tensor);
+
+/**
+ * Creates a OneDnnTensor of `shape` backed by new memory of `desc`, which may
+ * be in an opaque layout picked by a primitive; it's only reordered to plain
+ * layout when a consumer needs it.
+ *
+ * @return the tensor and its memory, for use as a primitive's destination.
+ */
+std::pair<Tensor, dnnl::memory> createOneDnnTensor(
+    const Shape& shape,
+    const dnnl::memory::desc& desc);
+
 /**
  * Given some an dnnl network (a ``std::vector<dnnl::primitive>``), a
  * ``dnnl::memory`` with some ordering, and a
@@ -134,6 +174,8 @@ dnnl::algorithm dnnlMapToPoolingMode(const PoolingMode mode);
 inline dnnl::memory::data_type dnnlMapToType(const fl::dtype t) {
   if (t == fl::dtype::f16) {
     return dnnl::memory::data_type::f16;
+  } else if (t == fl::dtype::bf16) {
+    return dnnl::memory::data_type::bf16;
   } else if (t == fl::dtype::f32) {
     return dnnl::memory::data_type::f32;
   } else if (t == fl::dtype::f64) {
@@ -68,6 +68,21 @@ class OneDnnAutogradExtension : public AutogradExtension {
       const float dropout,
       std::shared_ptr<detail::AutogradPayload> payload) override;
 
+  bool isAttentionSupported() const override;
+
+  Tensor attention(
+      Tensor& logSumExp,
+      const Tensor& query,
+      const Tensor& key,
+      const Tensor& value,
+      const Tensor& mask,
+      const Tensor& padMask,
+      const int nHeads,
+      const float scale,
+      const float dropout,
+      const int seed,
+      std::shared_ptr<detail::AutogradPayload> payload) override;
+
   /**************************** Backward ****************************/
   // ]----- Convolution
   Tensor conv2dBackwardData(
@@ -140,6 +155,22 @@ class OneDnnAutogradExtension : public AutogradExtension {
       const bool bidirectional,
       const float dropProb,
       std::shared_ptr<detail::AutogradPayload> payload) override;
+
+  // ]----- attention
+  std::tuple<Tensor, Tensor, Tensor> attentionBackward(
+      const Tensor& gradOutput,
+      const Tensor& query,
+      const Tensor& key,
+      const Tensor& value,
+      const Tensor& mask,
+      const Tensor& padMask,
+      const Tensor& output,
+      const Tensor& logSumExp,
+      const int nHeads,
+      const float scale,
+      const float dropout,
+      const int seed,
+      std::shared_ptr<detail::AutogradPayload> payload) override;
 };
 
 } // namespace fl
@@ -10,9 +10,12 @@
 
 #include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/common/Types.h"
+#include "flashlight/fl/tensor/Types.h"
 
 namespace fl {
 
+OptimMode::OptimMode() : reducedPrecisionType_(dtype::f16) {}
+
 OptimLevel OptimMode::getOptimLevel() {
   return optimLevel_;
 }
@@ -21,6 +24,18 @@ void OptimMode::setOptimLevel(OptimLevel level) {
   optimLevel_ = level;
 }
 
+dtype OptimMode::getReducedPrecisionType() {
+  return reducedPrecisionType_;
+}
+
+void OptimMode::setReducedPrecisionType(dtype type) {
+  if (type != dtype::f16 && type != dtype::bf16) {
+    throw std::invalid_argument(
+        "OptimMode::setReducedPrecisionType - type must be f16 or bf16");
+  }
+  reducedPrecisionType_ = type;
+}
+
 OptimMode& OptimMode::get() {
   static OptimMode optimMode;
   return optimMode;
@@ -103,6 +103,9 @@ constexpr double kAmpMinimumScaleFactorValue = 1e-4;
 /**************************** Optimization Modes *****************************/
 // TODO(jacobkahn): should we move this to a different header? In Types.h/cpp?
 
+// defined in flashlight/fl/tensor/Types.h, which depends on this header
+enum class dtype;
+
 /**
  * Optimization levels in flashlight. These determine the computation behavior
  * of autograd operator computation as well as how inputs and outputs of
@@ -152,6 +155,23 @@ class FL_API OptimMode {
    */
   void setOptimLevel(OptimLevel level);
 
+  /**
+   * Gets the reduced precision type that operations are cast to at
+   * optimization levels other than DEFAULT (f16 by default). Not thread safe.
+   *
+   * @return the reduced precision type.
+   */
+  dtype getReducedPrecisionType();
+
+  /**
+   * Sets the reduced precision type, either f16 or bf16. bf16 has the range of
+   * f32, so losses don't need scaling to avoid underflowing gradients. Not
+   * thread safe.
+   *
+   * @param[in] type the reduced precision type to set
+   */
+  void setReducedPrecisionType(dtype type);
+
   /**
    *
    */
@@ -160,7 +180,10 @@ class FL_API OptimMode {
   static const std::unordered_map<std::string, OptimLevel> kStringToOptimLevel;
 
  private:
+  OptimMode();
+
   OptimLevel optimLevel_{OptimLevel::DEFAULT};
+  dtype reducedPrecisionType_;
 };
 
 /** @} */
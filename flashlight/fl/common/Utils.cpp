@@ -26,6 +26,10 @@ bool f16Supported() {
   return defaultTensorBackend().isDataTypeSupported(fl::dtype::f16);
 }
 
+bool bf16Supported() {
+  return defaultTensorBackend().isDataTypeSupported(fl::dtype::bf16);
+}
+
 size_t divRoundUp(size_t numerator, size_t denominator) {
   if (!numerator) {
     return 0;
@@ -29,6 +29,12 @@ class Tensor;
  */
 FL_API bool f16Supported();
 
+/**
+ * @return if bf16 operations are supported with the current flashlight
+ * configuration.
+ */
+FL_API bool bf16Supported();
+
 // Returns round-up result of integer division.
 // throws invalid_argument exception on zero denominator.
 FL_API size_t divRoundUp(size_t numerator, size_t denominator);
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/distributed/reducers/BucketedReducer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#include "flashlight/fl/distributed/DistributedApi.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+
+namespace fl {
+
+BucketedReducer::BucketedReducer(
+    double scale,
+    bool async,
+    bool contiguous,
+    std::size_t bucketSizeBytes)
+    : scale_(scale),
+      async_(async),
+      contiguous_(contiguous),
+      bucketSizeBytes_(bucketSizeBytes) {
+  if (bucketSizeBytes_ == 0) {
+    throw std::invalid_argument(
+        "BucketedReducer - bucket size must be positive");
+  }
+  if (contiguous_ &&
+      bucketSizeBytes_ > DistributedConstants::kCoalesceCacheSize) {
+    throw std::invalid_argument(
+        "BucketedReducer - bucket size exceeds the size of the contiguous "
+        "synchronization buffer");
+  }
+}
+
+BucketedReducer::~BucketedReducer() {
+  finalize();
+  for (auto& param : params_) {
+    param.clearGradHook();
+  }
+}
+
+void BucketedReducer::registerParams(const std::vector<Variable>& params) {
+  if (numReady_ > 0) {
+    throw std::logic_error(
+        "BucketedReducer::registerParams - can't register parameters "
+        "before the pending gradients are finalized");
+  }
+
+  // Variables sharing their tensor are the same parameter
+  std::unordered_set<const Tensor*> newParams;
+  for (const auto& param : params) {
+    newParams.insert(&param.tensor());
+  }
+  for (auto& group : groups_) {
+    group.erase(
+        std::remove_if(
+            group.begin(),
+            group.end(),
+            [&newParams](const Variable& param) {
+              return newParams.count(&param.tensor()) > 0;
+            }),
+        group.end());
+  }
+  groups_.push_back(params);
+  buildBuckets();
+}
+
+void BucketedReducer::buildBuckets() {
+  params_.clear();
+  buckets_.clear();
+  // The gradients of the last parameters are usually computed first
+  std::size_t bucketBytes = 0;
+  for (auto group = groups_.rbegin(); group != groups_.rend(); ++group) {
+    for (auto it = group->rbegin(); it != group->rend(); ++it) {
+      const auto& param = *it;
+      const bool isFull = !buckets_.empty() &&
+          (bucketBytes + param.bytes() > bucketSizeBytes_ ||
+           param.type() != params_.back().type());
+      if (buckets_.empty() || isFull) {
+        buckets_.emplace_back();
+        bucketBytes = 0;
+      }
+      const std::size_t paramIdx = params_.size();
+      buckets_.back().params.push_back(paramIdx);
+      bucketBytes += param.bytes();
+
+      params_.push_back(param);
+      params_.back().registerGradHook(
+          [this, paramIdx](Variable& /* grad */) { markReady(paramIdx); });
+    }
+  }
+
+  paramReady_.assign(params_.size(), false);
+  paramToBucket_.resize(params_.size());
+  for (std::size_t i = 0; i < buckets_.size(); ++i) {
+    for (auto paramIdx : buckets_[i].params) {
+      paramToBucket_[paramIdx] = i;
+    }
+  }
+}
+
+void BucketedReducer::add(Variable& var) {
+  allReduce(var, scale_, async_);
+}
+
+void BucketedReducer::finalize() {
+  if (numReady_ == 0) {
+    // No gradient was computed since the last call
+    if (async_) {
+      syncDistributed();
+    }
+    return;
+  }
+
+  for (std::size_t i = 0; i < params_.size(); ++i) {
+    if (paramReady_[i]) {
+      continue;
+    }
+    auto& param = params_[i];
+    // Unused parameters must take part in the synchronization of their
+    // bucket on all processes
+    if (param.isCalcGrad() && !param.isGradAvailable()) {
+      param.addGrad(
+          Variable(fl::full(param.shape(), 0.0, param.type()), false));
+    }
+    markReady(i);
+  }
+  if (async_ || contiguous_) {
+    syncDistributed();
+  }
+
+  for (auto& bucket : buckets_) {
+    bucket.numReady = 0;
+  }
+  paramReady_.assign(paramReady_.size(), false);
+  nextBucket_ = 0;
+  numReady_ = 0;
+}
+
+void BucketedReducer::markReady(std::size_t paramIdx) {
+  if (paramReady_[paramIdx]) {
+    throw std::logic_error(
+        "BucketedReducer - the gradient of a parameter was computed twice "
+        "without calling finalize()");
+  }
+  auto& param = params_[paramIdx];
+  // Evaluating the gradient now lets its computation overlap with the
+  // synchronization of the previous buckets
+  if (async_ && param.isGradAvailable()) {
+    param.grad().eval();
+  }
+  paramReady_[paramIdx] = true;
+  ++numReady_;
+  ++buckets_[paramToBucket_[paramIdx]].numReady;
+
+  while (nextBucket_ < buckets_.size() &&
+         buckets_[nextBucket_].numReady ==
+             buckets_[nextBucket_].params.size()) {
+    launch(buckets_[nextBucket_]);
+    ++nextBucket_;
+  }
+}
+
+void BucketedReducer::launch(const Bucket& bucket) {
+  std::vector<Variable> grads;
+  grads.reserve(bucket.params.size());
+  for (auto paramIdx : bucket.params) {
+    const auto& param = params_[paramIdx];
+    // Parameters without gradient calculation are skipped on all processes
+    if (param.isGradAvailable()) {
+      grads.push_back(param.grad());
+    }
+  }
+
+  if (grads.size() == 1 && grads.front().bytes() > bucketSizeBytes_) {
+    // Too large to be copied into the contiguous buffer
+    allReduce(grads.front(), scale_, async_);
+  } else if (!grads.empty()) {
+    allReduceMultiple(std::move(grads), scale_, async_, contiguous_);
+  }
+}
+
+} // namespace fl
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/distributed/reducers/Reducer.h"
+
+namespace fl {
+
+class Variable;
+
+/**
+ * A Reducer which overlaps the synchronization of gradients with the backward
+ * pass that computes them.
+ *
+ * Parameters registered with ``registerParams`` are grouped in buckets of
+ * bounded size, in reverse order, which is the order in which the backward
+ * pass usually computes their gradients. Gradient hooks registered on the
+ * parameters mark their gradients as ready, and each bucket is synchronized
+ * with ``allReduceMultiple`` as soon as all of its gradients are ready, while
+ * the backward pass goes on.
+ *
+ * Buckets are synchronized in order, so that all processes launch the same
+ * collective operations in the same order. ``finalize`` synchronizes the
+ * remaining buckets, with zero gradients for the parameters which didn't get
+ * any, and must be called before using the gradients. The gradient of each
+ * parameter must be computed at most once between calls to ``finalize``.
+ */
+class FL_API BucketedReducer : public Reducer {
+ public:
+  /**
+   * Creates a new bucketed reducer.
+   *
+   * @param[in] scale a scale by which to scale reduced gradients
+   * @param[in] async determines whether or not the distributed compute stream
+   * runs asynchronously to the AF stream.
+   * @param[in] contiguous forces synchronization of the gradients of a bucket
+   * to occur in a contiguous buffer, which may improve performance.
+   * @param[in] bucketSizeBytes the maximum size of a bucket, in bytes.
+   * Parameters larger than this are synchronized on their own.
+   */
+  BucketedReducer(
+      double scale,
+      bool async,
+      bool contiguous,
+      std::size_t bucketSizeBytes = DistributedConstants::kCoalesceCacheSize);
+
+  /**
+   * Destroy the Reducer. Calls ``finalize()`` and clears the gradient hooks
+   * of the registered parameters before returning.
+   */
+  ~BucketedReducer() override;
+
+  // hooks of the registered parameters refer to this instance
+  BucketedReducer(const BucketedReducer&) = delete;
+  BucketedReducer& operator=(const BucketedReducer&) = delete;
+
+  /**
+   * Registers gradient hooks on ``params`` (replacing existing hooks), and
+   * adds buckets for them. Parameters are expected in the order in which they
+   * are used by the forward pass, and the parameters of successive calls in
+   * the order in which they are used too, e.g. the parameters of a network
+   * before those of its criterion. Parameters which were already registered
+   * are moved to their new position.
+   *
+   * Must not be called between a backward pass and ``finalize``.
+   *
+   * @param[in] params the parameters whose gradients to synchronize
+   */
+  void registerParams(const std::vector<Variable>& params);
+
+  /**
+   * Synchronize a ``Variable`` which isn't the gradient of a registered
+   * parameter immediately with ``allReduce``.
+   */
+  void add(Variable& var) override;
+
+  /**
+   * Synchronize the remaining buckets, and wait for the synchronization of
+   * all buckets.
+   */
+  void finalize() override;
+
+ private:
+  struct Bucket {
+    /// Indices of the parameters in the bucket, in `params_`
+    std::vector<std::size_t> params;
+    /// The number of parameters of the bucket whose gradient is ready
+    std::size_t numReady{0};
+  };
+
+  /**
+   * Assigns the parameters of `groups_` to buckets, and registers their hooks.
+   */
+  void buildBuckets();
+
+  /**
+   * Marks the gradient of the parameter at `paramIdx` as ready, and
+   * synchronizes the buckets that are ready, in order.
+   */
+  void markReady(std::size_t paramIdx);
+
+  /**
+   * Synchronize the gradients of a bucket with ``allReduceMultiple``.
+   */
+  void launch(const Bucket& bucket);
+
+  /// A scale by which to scale reduced gradients
+  double scale_;
+  /// Whether or not the distributed synchronization operates in a separate
+  /// compute stream asynchronously to the ArrayFire stream
+  bool async_;
+  /// Determines if the gradients of a bucket are put into contiguous memory
+  /// before being synchronized
+  bool contiguous_;
+  /// The maximum size of a bucket, in bytes
+  const std::size_t bucketSizeBytes_;
+  /// The parameters of each call to `registerParams`
+  std::vector<std::vector<Variable>> groups_;
+  /// The registered parameters, in the order of the buckets
+  std::vector<Variable> params_;
+  /// Whether the gradient of each parameter is ready
+  std::vector<bool> paramReady_;
+  /// Index of the bucket of each parameter, in `buckets_`
+  std::vector<std::size_t> paramToBucket_;
+  /// Buckets, in the order in which they are synchronized
+  std::vector<Bucket> buckets_;
+  /// Index of the next bucket to synchronize
+  std::size_t nextBucket_{0};
+  /// The number of gradients marked as ready since the last `finalize`
+  std::size_t numReady_{0};
+};
+
+} // namespace fl
@@ -143,6 +143,55 @@ double layerNorm() {
   return timeit(ln_fn);
 }
 
+// Times the backward pass on a long chain of ops on tiny tensors, so that the
+// overhead of the graph traversal dominates, and reports it per node
+void backwardOverhead() {
+  const int numOps = 100000;
+  const int numIters = 10;
+  auto input = Variable(fl::rand({1}), true);
+  auto buildGraph = [&]() {
+    auto output = input;
+    for (int i = 0; i < numOps; ++i) {
+      output = output * 0.5 + input;
+    }
+    return output;
+  };
+  // The chain has two nodes per op
+  const double numNodes = 2.0 * numOps;
+
+  auto output = buildGraph();
+  output.backward(); // warmup
+  double rebuiltOrder = 0.;
+  for (int i = 0; i < numIters; ++i) {
+    input.zeroGrad();
+    output = buildGraph();
+    fl::sync();
+    auto start = fl::Timer::start();
+    output.backward();
+    fl::sync();
+    rebuiltOrder += fl::Timer::stop(start);
+  }
+
+  output = buildGraph();
+  output.backward(/* retainGraph = */ true);
+  fl::sync();
+  auto start = fl::Timer::start();
+  for (int i = 0; i < numIters; ++i) {
+    output.backward(/* retainGraph = */ true);
+  }
+  fl::sync();
+  double cachedOrder = fl::Timer::stop(start);
+  // Release the graph node by node
+  output.backward();
+
+  std::cout << "Backward overhead per node (new graph) ...  "
+            << std::setprecision(5) << rebuiltOrder / numIters / numNodes * 1e9
+            << " nsec" << std::endl;
+  std::cout << "Backward overhead per node (retained graph) ...  "
+            << std::setprecision(5) << cachedOrder / numIters / numNodes * 1e9
+            << " nsec" << std::endl;
+}
+
 int main() {
   fl::init();
   TIME(alexnet);
@@ -150,5 +199,6 @@ int main() {
   TIME(linear);
   TIME(batchNorm);
   TIME(layerNorm);
+  backwardOverhead();
   return 0;
 }
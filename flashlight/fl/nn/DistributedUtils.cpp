@@ -16,6 +16,10 @@ namespace fl {
 void distributeModuleGrads(
     std::shared_ptr<const Module> module,
     std::shared_ptr<Reducer> reducer) {
+  if (auto bucketed = std::dynamic_pointer_cast<BucketedReducer>(reducer)) {
+    bucketed->registerParams(module->params());
+    return;
+  }
   for (auto& param : module->params()) {
     param.registerGradHook([reducer](Variable& grad) { reducer->add(grad); });
   }
@@ -26,7 +26,8 @@ namespace fl {
  *
  * @param[in] module a module whose parameter gradients will be synchronized
  * @param[in] a ``Reducer`` instance to which gradients will be immediately
- * added when available
+ * added when available. The parameters are registered with a
+ * ``BucketedReducer`` instead, see ``BucketedReducer::registerParams``.
  */
 FL_API void distributeModuleGrads(
     std::shared_ptr<const Module> module,
@@ -84,7 +84,9 @@ Variable BatchNorm::forward(const Variable& input) {
   }
 
   auto paramsType =
-      (input.type() == fl::dtype::f16) ? fl::dtype::f32 : input.type();
+      (input.type() == fl::dtype::f16 || input.type() == fl::dtype::bf16)
+      ? fl::dtype::f32
+      : input.type();
   return batchnorm(
       input,
       params_.empty() ? Variable(Tensor(paramsType), false) : params_[0],
@@ -7,6 +7,9 @@
 
 #include "flashlight/fl/nn/modules/Container.h"
 
+#include <algorithm>
+
+#include "flashlight/fl/autograd/Checkpoint.h"
 #include "flashlight/fl/autograd/Variable.h"
 
 namespace fl {
@@ -43,6 +46,72 @@ ModulePtr Container::module(int id) const {
   return modules_[id];
 }
 
+void Container::replace(int id, ModulePtr module) {
+  if (!module) {
+    throw std::invalid_argument("can't replace with null Module in Container");
+  }
+  if (id < 0 || id >= static_cast<int>(modules_.size())) {
+    throw std::out_of_range("Container::replace - invalid module index");
+  }
+  auto orphanParamIdxMap = getOrphanedParamsIdxMap();
+  auto oldParams = std::move(params_);
+  params_.clear();
+  childParamIdx_.clear();
+  modules_[id] = std::move(module);
+  for (int i = -1; i < static_cast<int>(modules_.size()); ++i) {
+    if (i >= 0) {
+      for (int j = 0; j < modules_[i]->numParamTensors(); j++) {
+        childParamIdx_[params_.size()] = std::make_tuple(i, j);
+        params_.push_back(modules_[i]->param(j));
+      }
+    }
+    auto [paramIter, pEnd] = orphanParamIdxMap.equal_range(i);
+    for (; paramIter != pEnd; ++paramIter) {
+      params_.push_back(oldParams[paramIter->second]);
+    }
+  }
+}
+
+void Container::setCheckpointEvery(int n) {
+  if (n < 0) {
+    throw std::invalid_argument(
+        "Container::setCheckpointEvery - n must be non-negative");
+  }
+  checkpointEvery_ = n;
+}
+
+int Container::checkpointEvery() const {
+  return checkpointEvery_;
+}
+
+std::vector<Variable> Container::forwardSequentially(
+    const std::vector<Variable>& input) {
+  auto output = input;
+  if (!train_ || checkpointEvery_ == 0) {
+    for (auto& module : modules_) {
+      output = module->forward(output);
+    }
+    return output;
+  }
+
+  for (size_t begin = 0; begin < modules_.size(); begin += checkpointEvery_) {
+    const size_t end = std::min(begin + checkpointEvery_, modules_.size());
+    // Modules are recomputed during the backward pass
+    std::vector<ModulePtr> group(
+        modules_.begin() + begin, modules_.begin() + end);
+    output = checkpoint(
+        [group = std::move(group)](const std::vector<Variable>& groupInput) {
+          auto groupOutput = groupInput;
+          for (auto& module : group) {
+            groupOutput = module->forward(groupOutput);
+          }
+          return groupOutput;
+        },
+        output);
+  }
+  return output;
+}
+
 std::vector<ModulePtr> Container::modules() const {
   return modules_;
 }
@@ -101,18 +170,11 @@ std::string Container::prettyString() const {
 Sequential::Sequential() = default;
 
 std::vector<Variable> Sequential::forward(const std::vector<Variable>& input) {
-  auto output = input;
-  for (auto& module : modules_) {
-    output = module->forward(output);
-  }
-  return output;
+  return forwardSequentially(input);
 }
 
 Variable Sequential::forward(const Variable& input) {
-  std::vector<Variable> output = {input};
-  for (auto& module : modules_) {
-    output = module->forward(output);
-  }
+  auto output = forwardSequentially({input});
   if (output.size() != 1) {
     throw std::invalid_argument("Module output size is not 1");
   }
@@ -39,6 +39,12 @@ class FL_API Container : public Module {
    */
   std::vector<ModulePtr> modules_;
 
+  /**
+   * Number of consecutive modules checkpointed together, 0 to disable. See
+   * `setCheckpointEvery`.
+   */
+  int checkpointEvery_{0};
+
   Container();
 
   /**
@@ -78,6 +84,16 @@ class FL_API Container : public Module {
    */
   std::unordered_multimap<int, int> getOrphanedParamsIdxMap() const;
 
+  /**
+   * Calls `forward` of each module in `modules_`, in order, feeding the result
+   * as input to the next one. In train mode, modules are grouped by
+   * `checkpointEvery_` and each group is computed with `fl::checkpoint`.
+   *
+   * @param input the input of the first module
+   * @return the output of the last module
+   */
+  std::vector<Variable> forwardSequentially(const std::vector<Variable>& input);
+
  public:
   /**
    * Adds a module to a `Container` by making a copy of the underlying module if
@@ -130,6 +146,30 @@ class FL_API Container : public Module {
    */
   ModulePtr module(int id) const;
 
+  /**
+   * Replaces the module at the specified index in the container's `modules_`,
+   * and its parameters in the container's `params_`. Parameters of other
+   * modules and orphaned parameters keep their relative order.
+   *
+   * @param id the index of the module to replace
+   * @param module the new module
+   */
+  void replace(int id, ModulePtr module);
+
+  /**
+   * Enables activation checkpointing (see `fl::checkpoint`) for containers
+   * which forward through their modules in sequence: in train mode, only the
+   * input of every `n` consecutive modules is kept until the backward pass,
+   * where the outputs of the modules in between are recomputed. This option is
+   * not serialized.
+   *
+   * @param n the number of modules per checkpoint, 0 (the default) disables
+   * checkpointing
+   */
+  void setCheckpointEvery(int n);
+
+  int checkpointEvery() const;
+
   /**
    * Returns pointers to each of `Module` in the `Container`.
    *
@@ -191,12 +231,14 @@ class FL_API Container : public Module {
 #define FL_BASIC_CONTAINER_CLONING(ContainerClass)             \
   ContainerClass(const ContainerClass& other) {                \
     train_ = other.train_;                                     \
+    checkpointEvery_ = other.checkpointEvery_;                 \
     for (auto& mod : other.modules_) {                         \
       add(mod->clone());                                       \
     }                                                          \
   }                                                            \
   ContainerClass& operator=(const ContainerClass& other) {     \
     train_ = other.train_;                                     \
+    checkpointEvery_ = other.checkpointEvery_;                 \
     clear();                                                   \
     for (auto& mod : other.modules_) {                         \
       add(mod->clone());                                       \
@@ -84,7 +84,9 @@ Variable LayerNorm::forward(const Variable& _input) {
     inputToBn = reorder(input, reorderDims);
   }
   auto paramsType =
-      (input.type() == fl::dtype::f16) ? fl::dtype::f32 : input.type();
+      (input.type() == fl::dtype::f16 || input.type() == fl::dtype::bf16)
+      ? fl::dtype::f32
+      : input.type();
   auto output = batchnorm(
       inputToBn,
       Variable(Tensor(paramsType), false),
@@ -55,6 +55,12 @@ void Module::zeroGrad() {
   }
 }
 
+void Module::setPersistentGrads(bool persistentGrads) {
+  for (auto& param : params_) {
+    param.setPersistentGrad(persistentGrads);
+  }
+}
+
 void Module::eval() {
   train_ = false;
   for (auto& param : params_) {
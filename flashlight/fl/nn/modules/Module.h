@@ -118,6 +118,12 @@ class FL_API Module {
    */
   void zeroGrad();
 
+  /**
+   * Sets whether the gradient buffers of all parameters in the module persist
+   * across `zeroGrad()` calls. See `Variable::setPersistentGrad`.
+   */
+  void setPersistentGrads(bool persistentGrads);
+
   /**
    * Performs forward computation for the module, given some inputs.
    *
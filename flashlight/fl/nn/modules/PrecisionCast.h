@@ -29,8 +29,9 @@ class FL_API PrecisionCast : public Module {
   /**
    * Constructor of the Cast Module (PrecisionCast class).
    *
-   * @param targetType An ArrayFire type that specifies the target type of the
-   * cast. Inputs to the the `forward` function will be casted to `targetType`.
+   * @param targetType A Flashlight type (e.g., `f16` or `bf16` for mixed
+   * precision) that specifies the target type of the cast. Inputs to the the
+   * `forward` function will be casted to `targetType`.
    */
   explicit PrecisionCast(fl::dtype targetType);
 
@@ -11,3 +11,4 @@
 #include "flashlight/fl/nn/Init.h"
 #include "flashlight/fl/nn/Utils.h"
 #include "flashlight/fl/nn/modules/modules.h"
+#include "flashlight/fl/nn/quantization/quantization.h"
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/nn/quantization/Calibrator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <typeinfo>
+
+#include "flashlight/fl/nn/modules/Conv2D.h"
+#include "flashlight/fl/nn/modules/Linear.h"
+#include "flashlight/fl/nn/quantization/QuantizedConv2D.h"
+#include "flashlight/fl/nn/quantization/QuantizedOps.h"
+
+namespace fl {
+
+namespace {
+
+bool isQuantizable(const Module& module) {
+  return dynamic_cast<const Linear*>(&module) ||
+      (dynamic_cast<const Conv2D*>(&module) &&
+       !dynamic_cast<const QuantizedConv2D*>(&module));
+}
+
+// subclasses of Sequential may not run their modules in order
+bool isPlainSequential(const Module& module) {
+  return typeid(module) == typeid(Sequential);
+}
+
+} // namespace
+
+Variable QuantizationCalibrator::forward(
+    Sequential& model,
+    const Variable& input) {
+  auto output = forward(model, std::vector<Variable>{input});
+  if (output.size() != 1) {
+    throw std::invalid_argument("Module output size is not 1");
+  }
+  return output.front();
+}
+
+std::vector<Variable> QuantizationCalibrator::forward(
+    Sequential& model,
+    const std::vector<Variable>& input) {
+  auto output = input;
+  for (const auto& module : model.modules()) {
+    if (isPlainSequential(*module)) {
+      output = forward(static_cast<Sequential&>(*module), output);
+      continue;
+    }
+    if (isQuantizable(*module) && !output.empty()) {
+      observe(*module, output.front().tensor());
+    }
+    output = module->forward(output);
+  }
+  return output;
+}
+
+void QuantizationCalibrator::observe(
+    const Module& module,
+    const Tensor& input) {
+  const float absMax = fl::amax(fl::abs(input)).asScalar<float>();
+  auto [iter, inserted] = moduleToAbsMax_.emplace(&module, absMax);
+  if (!inserted) {
+    iter->second = std::max(iter->second, absMax);
+  }
+}
+
+bool QuantizationCalibrator::hasObserved(const Module& module) const {
+  return moduleToAbsMax_.count(&module) > 0;
+}
+
+float QuantizationCalibrator::absMax(const Module& module) const {
+  const auto iter = moduleToAbsMax_.find(&module);
+  if (iter == moduleToAbsMax_.end()) {
+    throw std::invalid_argument(
+        "QuantizationCalibrator::absMax - module wasn't observed: " +
+        module.prettyString());
+  }
+  return iter->second;
+}
+
+float QuantizationCalibrator::inputScale(const Module& module) const {
+  return quantizationScale(absMax(module));
+}
+
+void QuantizationCalibrator::clear() {
+  moduleToAbsMax_.clear();
+}
+
+} // namespace fl
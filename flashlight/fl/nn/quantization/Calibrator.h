@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "flashlight/fl/nn/modules/Container.h"
+
+namespace fl {
+
+/**
+ * Records the range of the inputs of `Linear` and `Conv2D` modules of a model
+ * over calibration data, from which `quantize` derives the scales with which
+ * these inputs are quantized.
+ *
+ * \code
+   QuantizationCalibrator calibrator;
+   model.eval();
+   for (auto& sample : calibrationData) {
+     calibrator.forward(model, fl::input(sample[kInputIdx]));
+   }
+   quantize(model, calibrator);
+   \endcode
+ */
+class FL_API QuantizationCalibrator {
+ public:
+  /**
+   * Runs `model` on `input` like `Sequential::forward`, and records the max
+   * absolute value of the inputs of its `Linear` and `Conv2D` modules,
+   * including those in nested `Sequential`s (but not in other containers,
+   * whose modules aren't necessarily run in order).
+   *
+   * @return the output of `model`
+   */
+  Variable forward(Sequential& model, const Variable& input);
+
+  /**
+   * Whether the inputs of `module` have been recorded.
+   */
+  bool hasObserved(const Module& module) const;
+
+  /**
+   * Returns the max absolute value of the recorded inputs of `module`; throws
+   * if none was recorded.
+   */
+  float absMax(const Module& module) const;
+
+  /**
+   * Returns the scale with which the inputs of `module` should be quantized.
+   */
+  float inputScale(const Module& module) const;
+
+  /**
+   * Forgets all recorded ranges.
+   */
+  void clear();
+
+ private:
+  // modules are only used as keys, never dereferenced
+  std::unordered_map<const Module*, float> moduleToAbsMax_;
+
+  std::vector<Variable> forward(
+      Sequential& model,
+      const std::vector<Variable>& input);
+  void observe(const Module& module, const Tensor& input);
+};
+
+} // namespace fl
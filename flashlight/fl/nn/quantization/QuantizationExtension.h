@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "flashlight/fl/nn/quantization/QuantizedOps.h"
+#include "flashlight/fl/tensor/TensorExtension.h"
+
+namespace fl {
+
+namespace detail {
+
+/*
+ * A base type for backend-specific data that persists across calls of a
+ * quantized op with the same weights, e.g., weights packed for the backend.
+ */
+struct QuantizationPayloadData {
+  virtual ~QuantizationPayloadData() = default;
+};
+
+/**
+ * Shallow-copyable holder of a quantization payload. Backends set `data` upon
+ * the first call and reuse it afterwards, so a payload must only be passed
+ * along with the same weights.
+ */
+struct QuantizationPayload {
+  std::shared_ptr<detail::QuantizationPayloadData> data;
+};
+
+} // namespace detail
+
+/**
+ * Tensor Extension for inference with int8 quantized weights & activations.
+ * See `QuantizedOps.h` for the semantics of each op.
+ */
+class QuantizationExtension : public TensorExtension<QuantizationExtension> {
+ public:
+  virtual ~QuantizationExtension() = default;
+
+  static constexpr TensorExtensionType extensionType =
+      TensorExtensionType::Quantization;
+
+  virtual Tensor quantizedLinear(
+      const Tensor& input,
+      const Tensor& weights,
+      const Tensor& weightScales,
+      const Tensor& bias,
+      const float inputScale,
+      std::shared_ptr<detail::QuantizationPayload> payload) = 0;
+
+  virtual Tensor quantizedConv2d(
+      const Tensor& input,
+      const Tensor& weights,
+      const Tensor& weightScales,
+      const Tensor& bias,
+      const float inputScale,
+      const int sx,
+      const int sy,
+      const int px,
+      const int py,
+      const int dx,
+      const int dy,
+      const int groups,
+      std::shared_ptr<detail::QuantizationPayload> payload) = 0;
+};
+
+} // namespace fl
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/tensor/TensorBackend.h"
+#include "flashlight/fl/tensor/TensorExtension.h"
+
+#if FL_USE_ONEDNN
+  #include "flashlight/fl/nn/quantization/backend/onednn/OneDnnQuantizationExtension.h"
+#endif // FL_USE_ONEDNN
+
+namespace fl {
+
+/****************** Quantization Extension Registration ******************/
+
+#if FL_USE_ONEDNN
+FL_REGISTER_TENSOR_EXTENSION(OneDnnQuantizationExtension, OneDnn);
+
+  // int8 weights are packed from host memory, so only CPU engines are supported
+  #if FL_USE_ARRAYFIRE && FL_ARRAYFIRE_USE_CPU
+FL_REGISTER_TENSOR_EXTENSION(OneDnnQuantizationExtension, ArrayFire);
+  #endif // FL_USE_ARRAYFIRE && FL_ARRAYFIRE_USE_CPU
+#endif // FL_USE_ONEDNN
+
+} // namespace fl
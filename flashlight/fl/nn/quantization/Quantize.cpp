@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/nn/quantization/Quantize.h"
+
+#include <memory>
+
+#include "flashlight/fl/nn/modules/Conv2D.h"
+#include "flashlight/fl/nn/modules/Linear.h"
+#include "flashlight/fl/nn/quantization/QuantizedConv2D.h"
+#include "flashlight/fl/nn/quantization/QuantizedLinear.h"
+
+namespace fl {
+
+int quantize(Sequential& model, const QuantizationCalibrator& calibrator) {
+  int numQuantized = 0;
+  const auto modules = model.modules();
+  for (int i = 0; i < static_cast<int>(modules.size()); ++i) {
+    const auto& module = modules[i];
+    if (auto* sequential = dynamic_cast<Sequential*>(module.get())) {
+      const int numNested = quantize(*sequential, calibrator);
+      if (numNested > 0) {
+        // refresh the params of `model`
+        model.replace(i, module);
+        numQuantized += numNested;
+      }
+      continue;
+    }
+    if (!calibrator.hasObserved(*module)) {
+      continue;
+    }
+    const float inputScale = calibrator.inputScale(*module);
+    if (auto* linear = dynamic_cast<Linear*>(module.get())) {
+      model.replace(i, std::make_shared<QuantizedLinear>(*linear, inputScale));
+    } else if (auto* conv = dynamic_cast<Conv2D*>(module.get())) {
+      model.replace(i, std::make_shared<QuantizedConv2D>(*conv, inputScale));
+    } else {
+      continue;
+    }
+    ++numQuantized;
+  }
+  return numQuantized;
+}
+
+} // namespace fl
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/nn/modules/Container.h"
+#include "flashlight/fl/nn/quantization/Calibrator.h"
+
+namespace fl {
+
+/**
+ * Rewrites `model` in place for int8 inference: each `Linear` and `Conv2D`
+ * module (including those in nested `Sequential`s) whose inputs were observed
+ * by `calibrator` is replaced by a `QuantizedLinear` / `QuantizedConv2D`.
+ * Other modules are left as is, and keep running in f32.
+ *
+ * @return the number of replaced modules
+ */
+FL_API int quantize(
+    Sequential& model,
+    const QuantizationCalibrator& calibrator);
+
+} // namespace fl
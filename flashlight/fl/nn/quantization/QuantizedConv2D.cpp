@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/nn/quantization/QuantizedConv2D.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "flashlight/fl/nn/Utils.h"
+#include "flashlight/fl/nn/quantization/QuantizedOps.h"
+
+namespace fl {
+
+QuantizedConv2D::QuantizedConv2D(const Conv2D& conv, float inputScale)
+    : Conv2D(conv), inputScale_(inputScale) {
+  if (!(inputScale_ > 0)) {
+    throw std::invalid_argument(
+        "QuantizedConv2D: input scale must be positive");
+  }
+  // weights are WHIO
+  auto [weights, weightScales] =
+      quantizeWeights(params_[0].tensor(), /* channelAxis = */ 3);
+  // the bias copied from `conv` is kept as is
+  params_[0] = Variable(std::move(weights), false);
+  params_.insert(params_.begin() + 1, Variable(std::move(weightScales), false));
+  for (auto& param : params_) {
+    param.setCalcGrad(false);
+  }
+}
+
+QuantizedConv2D::QuantizedConv2D(const QuantizedConv2D& other)
+    : Conv2D(other), inputScale_(other.inputScale_) {}
+
+QuantizedConv2D& QuantizedConv2D::operator=(const QuantizedConv2D& other) {
+  Conv2D::operator=(other);
+  inputScale_ = other.inputScale_;
+  payload_ = std::make_shared<detail::QuantizationPayload>();
+  return *this;
+}
+
+Variable QuantizedConv2D::forward(const Variable& input) {
+  auto px = derivePadding(input.dim(0), xFilter_, xStride_, xPad_, xDilation_);
+  auto py = derivePadding(input.dim(1), yFilter_, yStride_, yPad_, yDilation_);
+  if (!(px >= 0 && py >= 0)) {
+    throw std::invalid_argument("invalid padding for QuantizedConv2D");
+  }
+
+  const Tensor noBias;
+  const Tensor& bias = bias_ ? params_[2].tensor() : noBias;
+  auto output = detail::quantizedConv2d(
+      input.tensor(),
+      params_[0].tensor(),
+      params_[1].tensor(),
+      bias,
+      inputScale_,
+      xStride_,
+      yStride_,
+      px,
+      py,
+      xDilation_,
+      yDilation_,
+      groups_,
+      payload_);
+  return Variable(std::move(output), false);
+}
+
+void QuantizedConv2D::setParams(const Variable& var, int position) {
+  Module::setParams(var, position);
+  // drop data built from the previous params
+  payload_ = std::make_shared<detail::QuantizationPayload>();
+}
+
+std::unique_ptr<Module> QuantizedConv2D::clone() const {
+  return std::make_unique<QuantizedConv2D>(*this);
+}
+
+std::string QuantizedConv2D::prettyString() const {
+  std::ostringstream ss;
+  ss << "Quantized" << Conv2D::prettyString() << " (input scale "
+     << inputScale_ << ")";
+  return ss.str();
+}
+
+float QuantizedConv2D::inputScale() const {
+  return inputScale_;
+}
+
+} // namespace fl
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "flashlight/fl/nn/modules/Conv2D.h"
+#include "flashlight/fl/nn/quantization/QuantizationExtension.h"
+
+namespace fl {
+
+/**
+ * Inference-only counterpart of `Conv2D` with int8 weights and activations.
+ * See `quantizedConv2d`. Shapes, strides, padding, dilation and groups are the
+ * same as the `Conv2D` it's constructed from.
+ *
+ * Parameters are the quantized weights, their per-output-channel scales and
+ * the (f32) bias if any. None of them require gradients.
+ */
+class FL_API QuantizedConv2D : public Conv2D {
+ private:
+  QuantizedConv2D() = default; // Intentionally private
+
+  // scale with which inputs are quantized, from calibration
+  float inputScale_;
+  // backend data (e.g., packed weights) built upon the first forward
+  std::shared_ptr<detail::QuantizationPayload> payload_{
+      std::make_shared<detail::QuantizationPayload>()};
+
+  FL_SAVE_LOAD_WITH_BASE(Conv2D, inputScale_)
+
+ public:
+  /**
+   * Constructs a QuantizedConv2D module by quantizing the weights of a
+   * `Conv2D` module.
+   *
+   * @param conv the module to quantize
+   * @param inputScale the scale with which inputs are quantized, see
+   * `QuantizationCalibrator`
+   */
+  QuantizedConv2D(const Conv2D& conv, float inputScale);
+
+  QuantizedConv2D(const QuantizedConv2D& other);
+
+  QuantizedConv2D& operator=(const QuantizedConv2D& other);
+
+  QuantizedConv2D(QuantizedConv2D&& other) = default;
+
+  QuantizedConv2D& operator=(QuantizedConv2D&& other) = default;
+
+  /**
+   * Takes an f32 input and returns an f32 output, which doesn't require
+   * gradient.
+   */
+  Variable forward(const Variable& input) override;
+
+  void setParams(const Variable& var, int position) override;
+
+  std::unique_ptr<Module> clone() const override;
+
+  std::string prettyString() const override;
+
+  float inputScale() const;
+};
+
+} // namespace fl
+
+CEREAL_REGISTER_TYPE(fl::QuantizedConv2D)
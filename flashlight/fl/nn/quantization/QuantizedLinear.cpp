@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/nn/quantization/QuantizedLinear.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "flashlight/fl/nn/quantization/QuantizedOps.h"
+
+namespace fl {
+
+QuantizedLinear::QuantizedLinear(const Linear& linear, float inputScale)
+    : UnaryModule(),
+      nIn_(linear.param(0).dim(1)),
+      nOut_(linear.param(0).dim(0)),
+      bias_(linear.params().size() > 1),
+      inputScale_(inputScale) {
+  if (!(inputScale_ > 0)) {
+    throw std::invalid_argument(
+        "QuantizedLinear: input scale must be positive");
+  }
+  auto [weights, weightScales] =
+      quantizeWeights(linear.param(0).tensor(), /* channelAxis = */ 0);
+  params_ = {
+      Variable(std::move(weights), false),
+      Variable(std::move(weightScales), false)};
+  if (bias_) {
+    params_.emplace_back(linear.param(1).tensor().copy(), false);
+  }
+}
+
+QuantizedLinear::QuantizedLinear(const QuantizedLinear& other)
+    : UnaryModule(other.copyParams()),
+      nIn_(other.nIn_),
+      nOut_(other.nOut_),
+      bias_(other.bias_),
+      inputScale_(other.inputScale_) {
+  train_ = other.train_;
+}
+
+QuantizedLinear& QuantizedLinear::operator=(const QuantizedLinear& other) {
+  params_ = other.copyParams();
+  train_ = other.train_;
+  nIn_ = other.nIn_;
+  nOut_ = other.nOut_;
+  bias_ = other.bias_;
+  inputScale_ = other.inputScale_;
+  payload_ = std::make_shared<detail::QuantizationPayload>();
+  return *this;
+}
+
+Variable QuantizedLinear::forward(const Variable& input) {
+  const Tensor noBias;
+  const Tensor& bias = bias_ ? params_[2].tensor() : noBias;
+  auto output = detail::quantizedLinear(
+      input.tensor(),
+      params_[0].tensor(),
+      params_[1].tensor(),
+      bias,
+      inputScale_,
+      payload_);
+  return Variable(std::move(output), false);
+}
+
+void QuantizedLinear::setParams(const Variable& var, int position) {
+  Module::setParams(var, position);
+  // drop data built from the previous params
+  payload_ = std::make_shared<detail::QuantizationPayload>();
+}
+
+std::unique_ptr<Module> QuantizedLinear::clone() const {
+  return std::make_unique<QuantizedLinear>(*this);
+}
+
+std::string QuantizedLinear::prettyString() const {
+  std::ostringstream ss;
+  ss << "QuantizedLinear";
+  ss << " (" << nIn_ << "->" << nOut_ << ")";
+  if (bias_) {
+    ss << " (with bias)";
+  } else {
+    ss << " (without bias)";
+  }
+  ss << " (input scale " << inputScale_ << ")";
+  return ss.str();
+}
+
+float QuantizedLinear::inputScale() const {
+  return inputScale_;
+}
+
+} // namespace fl
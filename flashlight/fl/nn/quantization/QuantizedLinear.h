@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "flashlight/fl/nn/modules/Linear.h"
+#include "flashlight/fl/nn/modules/Module.h"
+#include "flashlight/fl/nn/quantization/QuantizationExtension.h"
+
+namespace fl {
+
+/**
+ * Inference-only counterpart of `Linear` with int8 weights and activations.
+ * See `quantizedLinear`.
+ *
+ * Parameters are the quantized weights, their per-output-channel scales and
+ * the (f32) bias if any. None of them require gradients.
+ */
+class FL_API QuantizedLinear : public UnaryModule {
+ private:
+  QuantizedLinear() = default; // Intentionally private
+
+  int nIn_, nOut_;
+  bool bias_;
+  // scale with which inputs are quantized, from calibration
+  float inputScale_;
+  // backend data (e.g., packed weights) built upon the first forward
+  std::shared_ptr<detail::QuantizationPayload> payload_{
+      std::make_shared<detail::QuantizationPayload>()};
+
+  FL_SAVE_LOAD_WITH_BASE(UnaryModule, nIn_, nOut_, bias_, inputScale_)
+
+ public:
+  /**
+   * Constructs a QuantizedLinear module by quantizing the weights of a
+   * `Linear` module.
+   *
+   * @param linear the module to quantize
+   * @param inputScale the scale with which inputs are quantized, see
+   * `QuantizationCalibrator`
+   */
+  QuantizedLinear(const Linear& linear, float inputScale);
+
+  QuantizedLinear(const QuantizedLinear& other);
+
+  QuantizedLinear& operator=(const QuantizedLinear& other);
+
+  QuantizedLinear(QuantizedLinear&& other) = default;
+
+  QuantizedLinear& operator=(QuantizedLinear&& other) = default;
+
+  /**
+   * Takes an f32 input of shape [`input_size`, *, *, *] and returns an f32
+   * output of shape [`output_size`, *, *, *], which doesn't require gradient.
+   */
+  Variable forward(const Variable& input) override;
+
+  void setParams(const Variable& var, int position) override;
+
+  std::unique_ptr<Module> clone() const override;
+
+  std::string prettyString() const override;
+
+  float inputScale() const;
+};
+
+} // namespace fl
+
+CEREAL_REGISTER_TYPE(fl::QuantizedLinear)
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/nn/quantization/QuantizedOps.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "flashlight/fl/nn/quantization/QuantizationExtension.h"
+#include "flashlight/fl/nn/quantization/QuantizationExtensionBackends.h"
+#include "flashlight/fl/tensor/TensorBackend.h"
+
+namespace fl {
+
+namespace {
+
+// -128 is left out, so that the quantized range is symmetric around 0
+constexpr float kInt8Max = 127;
+
+} // namespace
+
+float quantizationScale(float absMax) {
+  return std::max(absMax, std::numeric_limits<float>::min()) / kInt8Max;
+}
+
+std::pair<Tensor, Tensor> quantizeWeights(
+    const Tensor& weights,
+    const int channelAxis) {
+  if (weights.type() != fl::dtype::f32) {
+    throw std::invalid_argument("quantizeWeights: weights must be f32");
+  }
+  if (channelAxis < 0 || channelAxis >= weights.ndim()) {
+    throw std::invalid_argument("quantizeWeights: invalid channel axis");
+  }
+  std::vector<int> reducedAxes;
+  for (int i = 0; i < weights.ndim(); i++) {
+    if (i != channelAxis) {
+      reducedAxes.push_back(i);
+    }
+  }
+  const auto absMax =
+      fl::amax(fl::abs(weights), reducedAxes, /* keepDims = */ true);
+  auto scales =
+      fl::maximum(absMax, std::numeric_limits<float>::min()) / kInt8Max;
+  auto quantized = fl::clip(fl::rint(weights / scales), -kInt8Max, kInt8Max)
+                       .astype(fl::dtype::s32);
+  return {
+      std::move(quantized),
+      fl::reshape(scales, {weights.dim(channelAxis)})};
+}
+
+Tensor quantizedLinear(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale) {
+  return detail::quantizedLinear(
+      input,
+      weights,
+      weightScales,
+      bias,
+      inputScale,
+      /* payload = */ nullptr);
+}
+
+Tensor quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups) {
+  return detail::quantizedConv2d(
+      input,
+      weights,
+      weightScales,
+      bias,
+      inputScale,
+      sx,
+      sy,
+      px,
+      py,
+      dx,
+      dy,
+      groups,
+      /* payload = */ nullptr);
+}
+
+namespace detail {
+
+Tensor quantizedLinear(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    std::shared_ptr<detail::QuantizationPayload> payload) {
+  return input.backend().getExtension<QuantizationExtension>().quantizedLinear(
+      input, weights, weightScales, bias, inputScale, payload);
+}
+
+Tensor quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups,
+    std::shared_ptr<detail::QuantizationPayload> payload) {
+  return input.backend().getExtension<QuantizationExtension>().quantizedConv2d(
+      input,
+      weights,
+      weightScales,
+      bias,
+      inputScale,
+      sx,
+      sy,
+      px,
+      py,
+      dx,
+      dy,
+      groups,
+      payload);
+}
+
+} // namespace detail
+
+} // namespace fl
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+
+/*
+ * Ops for int8 inference. Quantization is symmetric (no zero point):
+ * - a weight `w` of output channel `c` is stored as an integer `q` in
+ *   [-127, 127] with `w ~= q * weightScales(c)`.
+ * - an f32 input `x` is quantized to `round(x / inputScale)`, saturated to
+ *   [-128, 127], right before the op.
+ * Accumulation happens in int32; outputs are dequantized to f32.
+ *
+ * Since Flashlight has no 8-bit signed type, quantized weights are held in s32
+ * tensors and narrowed by the backend.
+ */
+
+namespace fl {
+
+namespace detail {
+struct QuantizationPayload;
+}
+
+/**
+ * Returns the scale that maps values in [-absMax, absMax] to [-127, 127].
+ */
+FL_API float quantizationScale(float absMax);
+
+/**
+ * Quantizes `weights` symmetrically, with one scale per slice along
+ * `channelAxis` (i.e., per output channel).
+ *
+ * @param weights f32 weights
+ * @param channelAxis the axis of output channels, e.g., 0 for Linear weights
+ * and 3 for Conv2D weights
+ * @return the quantized weights (s32, in [-127, 127], same shape as `weights`)
+ * and their scales (f32, of shape [`weights.dim(channelAxis)`]).
+ */
+FL_API std::pair<Tensor, Tensor> quantizeWeights(
+    const Tensor& weights,
+    const int channelAxis);
+
+/**
+ * Int8 counterpart of `linear`.
+ *
+ * @param input an f32 Tensor of shape [\f$C_{in}\f$, *, *, *]
+ * @param weights quantized weights of shape [\f$C_{out}\f$, \f$C_{in}\f$]
+ * @param weightScales f32 Tensor of shape [\f$C_{out}\f$]
+ * @param bias an f32 Tensor of shape [\f$C_{out}\f$], or empty
+ * @param inputScale the scale with which `input` is quantized
+ * @return an f32 Tensor of shape [\f$C_{out}\f$, *, *, *]
+ */
+FL_API Tensor quantizedLinear(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale);
+
+/**
+ * Int8 counterpart of `conv2d`; see `conv2d` for the shapes & arguments.
+ *
+ * @param weightScales f32 Tensor of shape [\f$C_{out}\f$]
+ * @param bias an f32 Tensor of shape [1, 1, \f$C_{out}\f$, 1], or empty
+ * @param inputScale the scale with which `input` is quantized
+ * @return an f32 Tensor
+ */
+FL_API Tensor quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    const int sx = 1,
+    const int sy = 1,
+    const int px = 0,
+    const int py = 0,
+    const int dx = 1,
+    const int dy = 1,
+    const int groups = 1);
+
+namespace detail {
+
+// Same as the above, with a payload that caches backend-specific data (e.g.,
+// packed weights) across calls with the same weights.
+
+FL_API Tensor quantizedLinear(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    std::shared_ptr<detail::QuantizationPayload> payload);
+
+FL_API Tensor quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups,
+    std::shared_ptr<detail::QuantizationPayload> payload);
+
+} // namespace detail
+
+} // namespace fl
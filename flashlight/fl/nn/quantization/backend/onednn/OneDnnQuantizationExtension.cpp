@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/nn/quantization/backend/onednn/OneDnnQuantizationExtension.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <dnnl.hpp>
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/DnnlUtils.h"
+
+using namespace dnnl;
+
+namespace fl {
+
+namespace {
+
+// Input, output: WHCN; weights: WHIO
+constexpr size_t kWIdx = 0;
+constexpr size_t kHIdx = 1;
+constexpr size_t kIOChannelSizeIdx = 2;
+constexpr size_t kIOBatchSizeIdx = 3;
+constexpr size_t kWeightOutputChannelSizeIdx = 3;
+
+// Let primitives pick the layouts of int8 operands, since they are reordered
+// (and quantized) anyway.
+constexpr auto formatAny = memory::format_tag::any;
+constexpr auto formatNCHW = memory::format_tag::nchw;
+constexpr auto formatBias = memory::format_tag::x;
+
+struct OneDnnQuantizationPayloadData : detail::QuantizationPayloadData {
+  // int8 weights in plain layout
+  std::vector<int8_t> plainWeights;
+  // weights in the layout requested by the last primitive that used them
+  memory packedWeights;
+};
+
+/**
+ * Returns int8 `weights` in the layout of `desc`. Weights are narrowed from
+ * s32 and reordered only if `payload` doesn't hold them in that layout yet.
+ */
+memory getPackedWeights(
+    const Tensor& weights,
+    const memory::dims& dims,
+    const memory::format_tag plainFormat,
+    const memory::desc& desc,
+    const std::shared_ptr<detail::QuantizationPayload>& payload) {
+  std::shared_ptr<OneDnnQuantizationPayloadData> data;
+  if (payload && payload->data) {
+    data =
+        std::static_pointer_cast<OneDnnQuantizationPayloadData>(payload->data);
+  } else {
+    if (weights.type() != fl::dtype::s32) {
+      throw std::invalid_argument(
+          "quantized weights must be s32 - see fl::quantizeWeights");
+    }
+    data = std::make_shared<OneDnnQuantizationPayloadData>();
+    const auto hostWeights = weights.toHostVector<int>();
+    data->plainWeights.assign(hostWeights.begin(), hostWeights.end());
+    if (payload) {
+      payload->data = data;
+    }
+  }
+
+  if (!data->packedWeights || data->packedWeights.get_desc() != desc) {
+    auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
+    memory plainMemory(
+        memory::desc(dims, memory::data_type::s8, plainFormat),
+        dnnlEngine,
+        data->plainWeights.data());
+    // always copy, so that packed weights don't alias `plainWeights`
+    data->packedWeights = memory(desc, dnnlEngine);
+    std::vector<primitive> network = {
+        reorder(plainMemory, data->packedWeights)};
+    std::vector<std::unordered_map<int, memory>> args = {
+        {{DNNL_ARG_FROM, plainMemory}, {DNNL_ARG_TO, data->packedWeights}}};
+    detail::executeNetwork(network, args);
+  }
+  return data->packedWeights;
+}
+
+/**
+ * Returns a memory holding `scale`, for use as a DNNL_ARG_ATTR_SCALES
+ * argument with a mask of 0.
+ */
+memory createScaleMemory(const float scale) {
+  memory scaleMemory(
+      memory::desc({1}, memory::data_type::f32, memory::format_tag::x),
+      detail::DnnlEngine::getInstance().getEngine());
+  *static_cast<float*>(scaleMemory.get_data_handle()) = scale;
+  return scaleMemory;
+}
+
+/**
+ * Adds a reorder to `net` that quantizes f32 `memory` into new int8 memory of
+ * `desc`, i.e., that divides it by the scale in `scaleMemory`, rounds and
+ * saturates.
+ */
+memory quantizeInput(
+    std::vector<primitive>& net,
+    std::vector<std::unordered_map<int, memory>>& netArgs,
+    const memory& inputMemory,
+    const memory::desc& desc,
+    const memory& scaleMemory) {
+  memory quantized(desc, detail::DnnlEngine::getInstance().getEngine());
+  primitive_attr attr;
+  attr.set_scales_mask(DNNL_ARG_DST, 0);
+  net.push_back(reorder(reorder::primitive_desc(inputMemory, quantized, attr)));
+  netArgs.push_back(
+      {{DNNL_ARG_FROM, inputMemory},
+       {DNNL_ARG_TO, quantized},
+       {DNNL_ARG_ATTR_SCALES | DNNL_ARG_DST, scaleMemory}});
+  return quantized;
+}
+
+} // namespace
+
+bool OneDnnQuantizationExtension::isDataTypeSupported(
+    const fl::dtype& dtype) const {
+  // f32 inputs & outputs, s32 for quantized weights
+  return dtype == fl::dtype::f32 || dtype == fl::dtype::s32;
+}
+
+Tensor OneDnnQuantizationExtension::quantizedLinear(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    std::shared_ptr<detail::QuantizationPayload> payload) {
+  if (input.type() != fl::dtype::f32) {
+    throw std::invalid_argument("quantizedLinear: input must be f32");
+  }
+  const Dim nOut = weights.dim(0);
+  const Dim nIn = weights.dim(1);
+  if (input.dim(0) != nIn) {
+    throw std::invalid_argument(
+        "quantizedLinear: input size mismatches weights");
+  }
+  const Dim batchSize = input.elements() / nIn;
+  const bool hasBias = bias.elements() > 0;
+
+  // Flashlight is column major, so viewed as row major, input [nIn, *] is
+  // {batchSize, nIn} (MxK), weights [nOut, nIn] are {nIn, nOut} (KxN) and
+  // output [nOut, *] is {batchSize, nOut} (MxN).
+  const memory::dims srcDims = {batchSize, nIn};
+  const memory::dims weightsDims = {nIn, nOut};
+  const memory::dims biasDims = {1, nOut};
+  const memory::dims dstDims = {batchSize, nOut};
+  const auto formatPlain = memory::format_tag::ab;
+
+  primitive_attr attr;
+  attr.set_scales_mask(DNNL_ARG_SRC, 0);
+  // per output channel, i.e., along the 2nd dim of KxN weights
+  attr.set_scales_mask(DNNL_ARG_WEIGHTS, 1 << 1);
+
+  const memory::desc srcDesc(srcDims, memory::data_type::s8, formatAny);
+  const memory::desc weightsDesc(weightsDims, memory::data_type::s8, formatAny);
+  const memory::desc biasDesc(biasDims, memory::data_type::f32, formatPlain);
+  const memory::desc dstDesc(dstDims, memory::data_type::f32, formatPlain);
+  auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
+  const auto primDesc = hasBias
+      ? matmul::primitive_desc(
+            dnnlEngine, srcDesc, weightsDesc, biasDesc, dstDesc, attr)
+      : matmul::primitive_desc(dnnlEngine, srcDesc, weightsDesc, dstDesc, attr);
+
+  const auto weightsMemory = getPackedWeights(
+      weights, weightsDims, formatPlain, primDesc.weights_desc(), payload);
+  const detail::DnnlMemoryWrapper inputMem(input, srcDims, formatPlain);
+  const detail::DnnlMemoryWrapper weightScalesMem(
+      weightScales, {nOut}, formatBias);
+  const detail::DnnlMemoryWrapper biasMem(bias, biasDims, formatPlain);
+  const auto inputScaleMemory = createScaleMemory(inputScale);
+
+  Shape outputShape = input.shape();
+  outputShape[0] = nOut;
+  Tensor output(outputShape, fl::dtype::f32);
+  const detail::DnnlMemoryWrapper outputMem(output, dstDims, formatPlain);
+
+  std::vector<primitive> network;
+  std::vector<std::unordered_map<int, memory>> args;
+  const auto srcMemory = quantizeInput(
+      network,
+      args,
+      inputMem.getMemory(),
+      primDesc.src_desc(),
+      inputScaleMemory);
+  std::unordered_map<int, memory> matmulArgs = {
+      {DNNL_ARG_SRC, srcMemory},
+      {DNNL_ARG_WEIGHTS, weightsMemory},
+      {DNNL_ARG_DST, outputMem.getMemory()},
+      {DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, inputScaleMemory},
+      {DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS, weightScalesMem.getMemory()}};
+  if (hasBias) {
+    matmulArgs[DNNL_ARG_BIAS] = biasMem.getMemory();
+  }
+  network.push_back(matmul(primDesc));
+  args.push_back(std::move(matmulArgs));
+
+  detail::executeNetwork(network, args);
+
+  return output;
+}
+
+Tensor OneDnnQuantizationExtension::quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const Tensor& bias,
+    const float inputScale,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups,
+    std::shared_ptr<detail::QuantizationPayload> payload) {
+  if (input.type() != fl::dtype::f32) {
+    throw std::invalid_argument("quantizedConv2d: input must be f32");
+  }
+
+  // Same layouts as (non-quantized) conv2d: viewed as row major, WHCN input &
+  // output are NCHW, and WHIO weights are OIHW.
+  const Dim nOut = weights.dim(kWeightOutputChannelSizeIdx);
+  const Shape outputShape(
+      {1 +
+           (input.dim(kWIdx) + (2 * px) - (1 + (weights.dim(kWIdx) - 1) * dx)) /
+               sx,
+       1 +
+           (input.dim(kHIdx) + (2 * py) - (1 + (weights.dim(kHIdx) - 1) * dy)) /
+               sy,
+       nOut,
+       input.dim(kIOBatchSizeIdx)});
+  // OneDnnTensors can hold the output in the layout picked by the convolution
+  const bool keepOutputLayout = detail::isOneDnnTensor(input);
+  const bool hasBias = bias.elements() > 0;
+
+  const auto inputDims = detail::convertToDnnlDims(
+      {input.dim(kIOBatchSizeIdx),
+       input.dim(kIOChannelSizeIdx),
+       input.dim(kHIdx),
+       input.dim(kWIdx)});
+  memory::dims weightsDims;
+  if (groups == 1) {
+    weightsDims = detail::convertToDnnlDims(
+        {nOut,
+         input.dim(kIOChannelSizeIdx),
+         weights.dim(kHIdx),
+         weights.dim(kWIdx)});
+  } else {
+    weightsDims = detail::convertToDnnlDims(
+        {groups,
+         nOut / groups,
+         input.dim(kIOChannelSizeIdx) / groups,
+         weights.dim(kHIdx),
+         weights.dim(kWIdx)});
+  }
+  const auto outputDims = detail::convertToDnnlDims(
+      {input.dim(kIOBatchSizeIdx),
+       nOut,
+       outputShape.dim(kHIdx),
+       outputShape.dim(kWIdx)});
+  const auto biasDims = detail::convertToDnnlDims({nOut});
+  const memory::dims strideDims = {sy, sx};
+  const memory::dims paddingDims = {py, px};
+  // NB: DNNL treats a dilation of 0 as a standard convolution
+  const memory::dims dilationDims = {dy - 1, dx - 1};
+  const auto formatWeight =
+      (groups == 1) ? memory::format_tag::oihw : memory::format_tag::goihw;
+
+  primitive_attr attr;
+  attr.set_scales_mask(DNNL_ARG_SRC, 0);
+  // per output channel, i.e., along O of OIHW, or along G & O of GOIHW
+  attr.set_scales_mask(DNNL_ARG_WEIGHTS, (groups == 1) ? 1 : (1 << 0 | 1 << 1));
+
+  const memory::desc srcDesc(inputDims, memory::data_type::s8, formatAny);
+  const memory::desc weightsDesc(weightsDims, memory::data_type::s8, formatAny);
+  const memory::desc biasDesc(biasDims, memory::data_type::f32, formatBias);
+  const memory::desc dstDesc(outputDims, memory::data_type::f32, formatAny);
+  auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
+  const auto primDesc = hasBias
+      ? convolution_forward::primitive_desc(
+            dnnlEngine,
+            prop_kind::forward_inference,
+            algorithm::convolution_direct,
+            srcDesc,
+            weightsDesc,
+            biasDesc,
+            dstDesc,
+            strideDims,
+            dilationDims,
+            paddingDims,
+            paddingDims,
+            attr)
+      : convolution_forward::primitive_desc(
+            dnnlEngine,
+            prop_kind::forward_inference,
+            algorithm::convolution_direct,
+            srcDesc,
+            weightsDesc,
+            dstDesc,
+            strideDims,
+            dilationDims,
+            paddingDims,
+            paddingDims,
+            attr);
+
+  const auto weightsMemory = getPackedWeights(
+      weights, weightsDims, formatWeight, primDesc.weights_desc(), payload);
+  const auto inputMemInit =
+      detail::DnnlMemoryWrapper::anyLayout(input, inputDims, formatNCHW);
+  const detail::DnnlMemoryWrapper weightScalesMem(
+      weightScales, {nOut}, formatBias);
+  const detail::DnnlMemoryWrapper biasMem(bias, biasDims, formatBias);
+  const auto inputScaleMemory = createScaleMemory(inputScale);
+
+  std::vector<primitive> network;
+  std::vector<std::unordered_map<int, memory>> args;
+  const auto srcMemory = quantizeInput(
+      network,
+      args,
+      inputMemInit.getMemory(),
+      primDesc.src_desc(),
+      inputScaleMemory);
+
+  // Output - adds a reorder after the conv if needed
+  const auto outputDesc = primDesc.dst_desc();
+  Tensor output;
+  detail::DnnlMemoryWrapper outputMemInit;
+  memory outputMemory;
+  if (keepOutputLayout) {
+    std::tie(output, outputMemory) =
+        detail::createOneDnnTensor(outputShape, outputDesc);
+  } else {
+    output = Tensor(outputShape, fl::dtype::f32);
+    outputMemInit = detail::DnnlMemoryWrapper(output, outputDims, formatNCHW);
+    outputMemory = outputMemInit.getMemory();
+    if (outputMemory.get_desc() != outputDesc) {
+      outputMemory = memory(outputDesc, dnnlEngine);
+    }
+  }
+
+  std::unordered_map<int, memory> convArgs = {
+      {DNNL_ARG_SRC, srcMemory},
+      {DNNL_ARG_WEIGHTS, weightsMemory},
+      {DNNL_ARG_DST, outputMemory},
+      {DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, inputScaleMemory},
+      {DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS, weightScalesMem.getMemory()}};
+  if (hasBias) {
+    convArgs[DNNL_ARG_BIAS] = biasMem.getMemory();
+  }
+  network.push_back(convolution_forward(primDesc));
+  args.push_back(std::move(convArgs));
+
+  if (!keepOutputLayout && outputMemory != outputMemInit.getMemory()) {
+    network.push_back(reorder(outputMemory, outputMemInit.getMemory()));
+    args.push_back(
+        {{DNNL_ARG_FROM, outputMemory},
+         {DNNL_ARG_TO, outputMemInit.getMemory()}});
+  }
+
+  detail::executeNetwork(network, args);
+
+  return output;
+}
+
+} // namespace fl
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/nn/quantization/QuantizationExtension.h"
+
+namespace fl {
+
+/**
+ * Runs quantized ops with OneDNN int8 primitives (matmul & convolution), on
+ * weights reordered once to the layout picked by the primitive.
+ */
+class OneDnnQuantizationExtension : public QuantizationExtension {
+ public:
+  bool isDataTypeSupported(const fl::dtype& dtype) const override;
+
+  Tensor quantizedLinear(
+      const Tensor& input,
+      const Tensor& weights,
+      const Tensor& weightScales,
+      const Tensor& bias,
+      const float inputScale,
+      std::shared_ptr<detail::QuantizationPayload> payload) override;
+
+  Tensor quantizedConv2d(
+      const Tensor& input,
+      const Tensor& weights,
+      const Tensor& weightScales,
+      const Tensor& bias,
+      const float inputScale,
+      const int sx,
+      const int sy,
+      const int px,
+      const int py,
+      const int dx,
+      const int dy,
+      const int groups,
+      std::shared_ptr<detail::QuantizationPayload> payload) override;
+};
+
+} // namespace fl
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/nn/quantization/Calibrator.h"
+#include "flashlight/fl/nn/quantization/Quantize.h"
+#include "flashlight/fl/nn/quantization/QuantizedConv2D.h"
+#include "flashlight/fl/nn/quantization/QuantizedLinear.h"
+#include "flashlight/fl/nn/quantization/QuantizedOps.h"
@@ -457,6 +457,7 @@ class FL_API Tensor {
     // Implicitly cast to the requested return type
     switch (type()) {
       case dtype::f16:
+      case dtype::bf16:
         return astype(dtype::f32).scalar<float>();
       case dtype::f32:
         return scalar<float>();
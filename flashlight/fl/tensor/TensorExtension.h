@@ -24,6 +24,7 @@ enum class TensorExtensionType {
   Autograd,
   Vision,
   JitOptimizer,
+  Quantization,
 };
 
 // Common base type
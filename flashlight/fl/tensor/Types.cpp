@@ -14,6 +14,7 @@ namespace fl {
 
 const std::unordered_map<dtype, std::string> kTypeToString = {
     {dtype::f16, "f16"},
+    {dtype::bf16, "bf16"},
     {dtype::f32, "f32"},
     {dtype::f64, "f64"},
     {dtype::b8, "b8"},
@@ -28,6 +29,7 @@ const std::unordered_map<dtype, std::string> kTypeToString = {
 
 const std::unordered_map<std::string, dtype> kStringToType = {
     {"f16", dtype::f16},
+    {"bf16", dtype::bf16},
     {"f32", dtype::f32},
     {"f64", dtype::f64},
     {"b8", dtype::b8},
@@ -43,6 +45,7 @@ const std::unordered_map<std::string, dtype> kStringToType = {
 size_t getTypeSize(dtype type) {
   switch (type) {
     case dtype::f16:
+    case dtype::bf16:
       return sizeof(float) / 2;
     case dtype::f32:
       return sizeof(float);
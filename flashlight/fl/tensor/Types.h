@@ -25,7 +25,8 @@ enum class dtype {
   u8 = 7, // 8-bit unsigned integer
   u16 = 8, // 16-bit unsigned integer
   u32 = 9, // 32-bit unsigned integer
-  u64 = 10 // 64-bit unsigned integer
+  u64 = 10, // 64-bit unsigned integer
+  bf16 = 11 // 16-bit brain float (f32 exponent range, 8-bit mantissa)
   // TODO: add support for complex-valued tensors? (AF)
 };
 
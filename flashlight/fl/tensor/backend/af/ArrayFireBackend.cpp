@@ -148,6 +148,8 @@ bool ArrayFireBackend::supportsDataType(const fl::dtype& dtype) const {
           // f16 isn't [yet] supported with the CPU backend per onednn
           // limitations
           !FL_BACKEND_CPU;
+    case fl::dtype::bf16:
+      return false; // no ArrayFire equivalent
     default:
       return true;
   }
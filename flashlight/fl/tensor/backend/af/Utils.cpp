@@ -29,7 +29,12 @@ af::dtype flToAfType(fl::dtype type) {
           {fl::dtype::u16, af::dtype::u16},
           {fl::dtype::u32, af::dtype::u32},
           {fl::dtype::u64, af::dtype::u64}};
-  return kFlashlightTypeToArrayFire.at(type);
+  const auto iter = kFlashlightTypeToArrayFire.find(type);
+  if (iter == kFlashlightTypeToArrayFire.end()) {
+    throw std::invalid_argument(
+        "flToAfType: type unsupported by ArrayFire: " + dtypeToString(type));
+  }
+  return iter->second;
 }
 
 fl::dtype afToFlType(af::dtype type) {
@@ -14,6 +14,8 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -36,6 +38,9 @@ constexpr size_t kRoundLarge = 2097152; // round up large allocs to 2 MiB
 // Environment variables names, specifying number of mega bytes as floats.
 constexpr const char* kMemRecyclingSize = "FL_MEM_RECYCLING_SIZE_MB";
 constexpr const char* kMemSplitSize = "FL_MEM_SPLIT_SIZE_MB";
+// Environment variable name, compaction upon allocation failure if non-zero.
+constexpr const char* kMemCompactOnAllocFailure =
+    "FL_MEM_COMPACT_ON_ALLOC_FAILURE";
 constexpr double kMB = static_cast<double>(1UL << 20);
 
 size_t roundSize(size_t size) {
@@ -46,6 +51,15 @@ size_t roundSize(size_t size) {
   }
 }
 
+size_t getSizeClass(size_t size) {
+  size_t sizeClass = 0;
+  for (size_t classSize = 2 * kMinBlockSize; classSize <= size;
+       classSize *= 2) {
+    ++sizeClass;
+  }
+  return std::min(sizeClass, CachingMemoryManager::kNumSizeClasses - 1);
+}
+
 size_t getAllocationSize(size_t size) {
   if (size <= kSmallSize) {
     return kSmallBuffer;
@@ -59,6 +73,9 @@ size_t getAllocationSize(size_t size) {
 static bool BlockComparator(
     const CachingMemoryManager::Block* a,
     const CachingMemoryManager::Block* b) {
+  if (a->stream_ != b->stream_) {
+    return (uintptr_t)a->stream_ < (uintptr_t)b->stream_;
+  }
   if (a->size_ != b->size_) {
     return a->size_ < b->size_;
   }
@@ -95,6 +112,11 @@ size_t getEnvAsBytesFromFloatMb(const char* name, size_t defaultVal) {
   return defaultVal;
 }
 
+void* getActiveStream(const MemoryManagerDeviceInterface& deviceInterface) {
+  return deviceInterface.supportsStreams() ? deviceInterface.getActiveStream()
+                                           : nullptr;
+}
+
 } // namespace
 
 CachingMemoryManager::DeviceMemoryInfo::DeviceMemoryInfo(int id)
@@ -102,6 +124,14 @@ CachingMemoryManager::DeviceMemoryInfo::DeviceMemoryInfo(int id)
       largeBlocks_(BlockComparator),
       smallBlocks_(BlockComparator) {}
 
+CachingMemoryManager::AllocatedShard&
+CachingMemoryManager::DeviceMemoryInfo::allocatedShard(const void* ptr) {
+  // blocks never share a kMinBlockSize-aligned chunk
+  return allocatedShards_
+      [(reinterpret_cast<uintptr_t>(ptr) / kMinBlockSize) %
+       kNumAllocatedShards];
+}
+
 CachingMemoryManager::CachingMemoryManager(
     int numDevices,
     std::shared_ptr<MemoryManagerDeviceInterface> deviceInterface)
@@ -109,6 +139,9 @@ CachingMemoryManager::CachingMemoryManager(
   recyclingSizeLimit_ =
       getEnvAsBytesFromFloatMb(kMemRecyclingSize, recyclingSizeLimit_);
   splitSizeLimit_ = getEnvAsBytesFromFloatMb(kMemSplitSize, splitSizeLimit_);
+  if (const char* env = std::getenv(kMemCompactOnAllocFailure)) {
+    compactOnAllocFailure_ = std::string(env) != "0";
+  }
 
   for (int i = 0; i < numDevices; ++i) {
     deviceMemInfos_.emplace(
@@ -126,6 +159,20 @@ void CachingMemoryManager::setSplitSizeLimit(size_t limit) {
   splitSizeLimit_ = limit;
 }
 
+void CachingMemoryManager::setCompactOnAllocFailure(bool compact) {
+  compactOnAllocFailure_ = compact;
+}
+
+void CachingMemoryManager::setTimelineCapacity(size_t capacity) {
+  timelineCapacity_ = capacity;
+  for (auto& [device, memoryInfo] : deviceMemInfos_) {
+    std::lock_guard<std::mutex> lock(memoryInfo->timelineMutex_);
+    while (memoryInfo->timeline_.size() > capacity) {
+      memoryInfo->timeline_.pop_front();
+    }
+  }
+}
+
 void CachingMemoryManager::shutdown() {
   signalMemoryCleanup();
 }
@@ -150,8 +197,6 @@ void* CachingMemoryManager::alloc(
     const unsigned ndims,
     dim_t* dims,
     const unsigned elementSize) {
-  auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
   size_t size = elementSize;
   for (unsigned i = 0; i < ndims; ++i) {
     size *= dims[i];
@@ -159,41 +204,56 @@ void* CachingMemoryManager::alloc(
   if (size == 0) {
     return nullptr;
   }
+  auto& memoryInfo = getDeviceMemoryInfo();
+  processEvents(memoryInfo);
   size = roundSize(size);
   const bool isSmallAlloc = (size <= kSmallSize);
-  CachingMemoryManager::Block searchKey(size);
+  CachingMemoryManager::Block searchKey(
+      size, nullptr, getActiveStream(*this->deviceInterface));
+  std::mutex& poolMutex =
+      isSmallAlloc ? memoryInfo.smallMutex_ : memoryInfo.largeMutex_;
   CachingMemoryManager::BlockSet& pool =
       isSmallAlloc ? memoryInfo.smallBlocks_ : memoryInfo.largeBlocks_;
 
   CachingMemoryManager::Block* block = nullptr;
-  auto it = pool.lower_bound(&searchKey);
-  // Recycle blocks if any found, and if small alloc or the block size is not
-  // too large:
-  if (it != pool.end() &&
-      (isSmallAlloc || (*it)->size_ < recyclingSizeLimit_)) {
-    block = *it;
-    pool.erase(it);
-    memoryInfo.stats_.cachedBytes_ -= block->size_;
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    auto it = pool.lower_bound(&searchKey);
+    // Recycle blocks of the active stream if any found, and if small alloc or
+    // the block size is not too large:
+    if (it != pool.end() && (*it)->stream_ == searchKey.stream_ &&
+        (isSmallAlloc || (*it)->size_ < recyclingSizeLimit_)) {
+      block = *it;
+      pool.erase(it);
+      block->cached_ = false;
+      memoryInfo.stats_.cachedBytes_ -= block->size_;
+    }
+  }
+  const size_t sizeClass = getSizeClass(size);
+  if (block) {
+    ++memoryInfo.stats_.cacheHits_[sizeClass];
   } else {
+    ++memoryInfo.stats_.cacheMisses_[sizeClass];
     void* ptr = nullptr;
     size_t allocSize = getAllocationSize(size);
     mallocWithRetry(allocSize, &ptr); // could throw
-    block = new Block(allocSize, ptr);
+    block = new Block(allocSize, ptr, searchKey.stream_);
     memoryInfo.stats_.allocatedBytes_ += allocSize;
+    recordTimeline(memoryInfo, TimelineAction::NativeAlloc, allocSize);
   }
 
   // If the block is larger than the requested size to handle another
   // allocation in the same large or small BlockSet, it will be split into two.
   // Note that we don't split a small stepsize out of a large one to keep the
   // implementation simple.
-  CachingMemoryManager::Block* remaining = nullptr;
   size_t diff = block->size_ - size;
   if ((diff >= (isSmallAlloc ? kMinBlockSize : kSmallSize)) &&
       (block->size_ < splitSizeLimit_) // possibly dont split large buffers to
                                        // minimize risk of fragmentation
   ) {
-    remaining = block;
-    block = new Block(size, block->ptr_);
+    std::lock_guard<std::mutex> lock(poolMutex);
+    CachingMemoryManager::Block* remaining = block;
+    block = new Block(size, block->ptr_, block->stream_);
     block->prev_ = remaining->prev_;
     if (block->prev_) {
       block->prev_->next_ = block;
@@ -203,13 +263,17 @@ void* CachingMemoryManager::alloc(
     remaining->prev_ = block;
     remaining->ptr_ = static_cast<char*>(remaining->ptr_) + size;
     remaining->size_ -= size;
+    remaining->cached_ = true;
     pool.insert(remaining);
     memoryInfo.stats_.cachedBytes_ += remaining->size_;
   }
 
   block->managerLock_ = !userLock;
   block->userLock_ = userLock;
-  memoryInfo.allocatedBlocks_[block->ptr_] = block;
+  recordTimeline(memoryInfo, TimelineAction::Alloc, size);
+  auto& shard = memoryInfo.allocatedShard(block->ptr_);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  shard.blocks_[block->ptr_] = block;
   return static_cast<void*>(block->ptr_);
 }
 
@@ -217,10 +281,10 @@ size_t CachingMemoryManager::allocated(void* ptr) {
   if (!ptr) {
     return 0;
   }
-  auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
-  auto it = memoryInfo.allocatedBlocks_.find(ptr);
-  if (it == memoryInfo.allocatedBlocks_.end()) {
+  auto& shard = getDeviceMemoryInfo().allocatedShard(ptr);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  auto it = shard.blocks_.find(ptr);
+  if (it == shard.blocks_.end()) {
     return 0;
   }
   return (it->second)->size_;
@@ -231,28 +295,75 @@ void CachingMemoryManager::unlock(void* ptr, bool userUnlock) {
     return;
   }
   auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
-  auto it = memoryInfo.allocatedBlocks_.find(ptr);
-  if (it == memoryInfo.allocatedBlocks_.end()) {
+  auto& shard = memoryInfo.allocatedShard(ptr);
+  CachingMemoryManager::Block* block = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex_);
+    auto it = shard.blocks_.find(ptr);
+    if (it != shard.blocks_.end()) {
+      block = it->second;
+      if (userUnlock) {
+        block->userLock_ = false;
+      } else {
+        block->managerLock_ = false;
+      }
+
+      // Return early if either one is locked
+      if (block->inUse()) {
+        return;
+      }
+      shard.blocks_.erase(it);
+    }
+  }
+  if (!block) {
     // Probably came from user, just free it
     this->deviceInterface->nativeFree(ptr);
     ++memoryInfo.stats_.totalNativeFrees_;
     return;
   }
+  const size_t size = block->size_;
+  if (block->streamUses_.empty()) {
+    freeBlock(block);
+    recordTimeline(memoryInfo, TimelineAction::Free, size);
+    return;
+  }
 
-  CachingMemoryManager::Block* block = it->second;
-  if (userUnlock) {
-    block->userLock_ = false;
-  } else {
-    block->managerLock_ = false;
+  // The block can only be reused once the work queued so far on the other
+  // streams using it completed
+  std::vector<void*> events;
+  for (void* stream : block->streamUses_) {
+    events.push_back(this->deviceInterface->recordEvent(stream));
+  }
+  block->streamUses_.clear();
+  {
+    std::lock_guard<std::mutex> lock(memoryInfo.eventsMutex_);
+    block->numPendingEvents_ = events.size();
+    for (void* event : events) {
+      memoryInfo.pendingEvents_.emplace_back(event, block);
+    }
+    memoryInfo.numPendingEvents_ += events.size();
   }
+  recordTimeline(memoryInfo, TimelineAction::Free, size);
+}
 
-  // Return early if either one is locked
-  if (block->inUse()) {
+void CachingMemoryManager::recordStream(const void* ptr, void* stream) {
+  if (!ptr || !this->deviceInterface->supportsStreams()) {
     return;
   }
-  memoryInfo.allocatedBlocks_.erase(it);
-  freeBlock(block);
+  auto& shard = getDeviceMemoryInfo().allocatedShard(ptr);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  auto it = shard.blocks_.find(const_cast<void*>(ptr));
+  if (it == shard.blocks_.end()) {
+    throw std::invalid_argument(
+        "CachingMemoryManager::recordStream - "
+        "memory wasn't allocated by this memory manager");
+  }
+  auto* block = it->second;
+  if (stream != block->stream_ &&
+      std::find(block->streamUses_.begin(), block->streamUses_.end(), stream) ==
+          block->streamUses_.end()) {
+    block->streamUses_.push_back(stream);
+  }
 }
 
 void CachingMemoryManager::freeBlock(CachingMemoryManager::Block* block) {
@@ -260,24 +371,58 @@ void CachingMemoryManager::freeBlock(CachingMemoryManager::Block* block) {
     throw std::runtime_error("trying to free a block which is in use");
   }
   auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
 
   const bool isSmallAlloc = (block->size_ <= kSmallSize);
+  std::lock_guard<std::mutex> lock(
+      isSmallAlloc ? memoryInfo.smallMutex_ : memoryInfo.largeMutex_);
   CachingMemoryManager::BlockSet& pool =
       isSmallAlloc ? memoryInfo.smallBlocks_ : memoryInfo.largeBlocks_;
   tryMergeBlocks(block, block->prev_, pool);
   tryMergeBlocks(block, block->next_, pool);
 
+  block->cached_ = true;
   pool.insert(block);
   memoryInfo.stats_.cachedBytes_ += block->size_;
 }
 
+void CachingMemoryManager::processEvents(
+    DeviceMemoryInfo& memoryInfo,
+    bool wait /* = false */) {
+  if (memoryInfo.numPendingEvents_ == 0) {
+    return;
+  }
+  std::vector<Block*> readyBlocks;
+  {
+    std::lock_guard<std::mutex> lock(memoryInfo.eventsMutex_);
+    auto& pendingEvents = memoryInfo.pendingEvents_;
+    while (!pendingEvents.empty()) {
+      auto [event, block] = pendingEvents.front();
+      if (wait) {
+        this->deviceInterface->syncEvent(event);
+      } else if (!this->deviceInterface->isEventDone(event)) {
+        break;
+      }
+      this->deviceInterface->destroyEvent(event);
+      pendingEvents.pop_front();
+      --memoryInfo.numPendingEvents_;
+      if (--block->numPendingEvents_ == 0) {
+        readyBlocks.push_back(block);
+      }
+    }
+  }
+  for (auto* block : readyBlocks) {
+    freeBlock(block);
+  }
+}
+
 /** combine previously split blocks */
 void CachingMemoryManager::tryMergeBlocks(
     CachingMemoryManager::Block* dst,
     CachingMemoryManager::Block* src,
     BlockSet& pool) {
-  if (!src || src->inUse()) {
+  // neighbors are either cached, or in use (possibly by other streams). Free
+  // memory of different streams is only coalesced by compaction.
+  if (!src || !src->cached_ || src->stream_ != dst->stream_) {
     return;
   }
   if (dst->prev_ == src) {
@@ -300,26 +445,38 @@ void CachingMemoryManager::tryMergeBlocks(
 
 void CachingMemoryManager::mallocWithRetry(size_t size, void** ptr) {
   // Try nativeMalloc. If nativeMalloc fails, frees all non-split cached blocks
-  // and retries.
+  // and retries. Called without holding any lock.
   auto& memInfo = getDeviceMemoryInfo();
   try {
     ++memInfo.stats_.totalNativeMallocs_;
     *ptr = this->deviceInterface->nativeAlloc(size);
   } catch (std::exception&) {
     try {
-      signalMemoryCleanup();
-      ++memInfo.stats_.totalNativeMallocs_;
-      *ptr = this->deviceInterface->nativeAlloc(size);
+      try {
+        signalMemoryCleanup();
+        ++memInfo.stats_.totalNativeMallocs_;
+        *ptr = this->deviceInterface->nativeAlloc(size);
+      } catch (std::exception&) {
+        if (!compactOnAllocFailure_ || compact() == 0) {
+          throw;
+        }
+        ++memInfo.stats_.totalNativeMallocs_;
+        *ptr = this->deviceInterface->nativeAlloc(size);
+      }
     } catch (std::exception& ex) {
       // note: af exception inherits from std exception
+      const auto snapshot = getMemorySnapshot(memInfo.deviceId_, 1);
       std::cerr << "Failed to allocate memory of size " << formatMemory(size)
                 << " (Device: " << memInfo.deviceId_ << ", Capacity: "
                 << formatMemory(this->deviceInterface->getMaxMemorySize(
                        memInfo.deviceId_))
-                << ", Allocated: "
-                << formatMemory(memInfo.stats_.allocatedBytes_)
-                << ", Cached: " << formatMemory(memInfo.stats_.cachedBytes_)
-                << ") with error '" << ex.what() << "'" << std::endl;
+                << ", Allocated: " << formatMemory(snapshot.allocatedBytes)
+                << ", Cached: " << formatMemory(snapshot.cachedBytes)
+                << ", Largest free block: "
+                << formatMemory(snapshot.largestFreeBlock)
+                << ", Cached in split blocks: "
+                << formatMemory(snapshot.splitCachedBytes) << ") with error '"
+                << ex.what() << "'" << std::endl;
       // note: converting here an af exception to std exception prevents to
       // catch the af error code at the user level. Rethrowing.
       throw;
@@ -340,6 +497,7 @@ void CachingMemoryManager::freeBlocks(
       ++memoryInfo.stats_.totalNativeFrees_;
       memoryInfo.stats_.allocatedBytes_ -= block->size_;
       memoryInfo.stats_.cachedBytes_ -= block->size_;
+      recordTimeline(memoryInfo, TimelineAction::NativeFree, block->size_);
       auto cur = it;
       ++it;
       blocks.erase(cur);
@@ -351,19 +509,237 @@ void CachingMemoryManager::freeBlocks(
 }
 
 void CachingMemoryManager::signalMemoryCleanup() {
-  // Free all non-split cached blocks on device
+  // Free all non-split cached blocks on device, including the ones waiting for
+  // other streams
+  auto& memoryInfo = getDeviceMemoryInfo();
+  processEvents(memoryInfo, /* wait = */ true);
+
+  {
+    std::lock_guard<std::mutex> lock(memoryInfo.largeMutex_);
+    freeBlocks(
+        memoryInfo.largeBlocks_,
+        memoryInfo.largeBlocks_.begin(),
+        memoryInfo.largeBlocks_.end());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(memoryInfo.smallMutex_);
+    freeBlocks(
+        memoryInfo.smallBlocks_,
+        memoryInfo.smallBlocks_.begin(),
+        memoryInfo.smallBlocks_.end());
+  }
+}
+
+size_t CachingMemoryManager::compact() {
   auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
+  void* stream = getActiveStream(*this->deviceInterface);
+  processEvents(memoryInfo, /* wait = */ true);
+
+  size_t releasedBytes = 0;
+  {
+    std::lock_guard<std::mutex> largeLock(memoryInfo.largeMutex_);
+    std::lock_guard<std::mutex> smallLock(memoryInfo.smallMutex_);
+    // Free blocks of other streams can be used on the active stream once
+    // these streams finished the work queued before the blocks were freed
+    std::set<void*> otherStreams;
+    for (const auto* pool :
+         {&memoryInfo.largeBlocks_, &memoryInfo.smallBlocks_}) {
+      for (const auto* block : *pool) {
+        if (block->stream_ != stream) {
+          otherStreams.insert(block->stream_);
+        }
+      }
+    }
+    for (void* otherStream : otherStreams) {
+      void* event = this->deviceInterface->recordEvent(otherStream);
+      this->deviceInterface->syncEvent(event);
+      this->deviceInterface->destroyEvent(event);
+    }
+
+    releasedBytes +=
+        compactBlocks(memoryInfo, memoryInfo.largeBlocks_, stream);
+    releasedBytes +=
+        compactBlocks(memoryInfo, memoryInfo.smallBlocks_, stream);
+  }
+  ++memoryInfo.stats_.numCompactions_;
+  memoryInfo.stats_.compactedBytes_ += releasedBytes;
+  recordTimeline(memoryInfo, TimelineAction::Compact, releasedBytes);
+  return releasedBytes;
+}
+
+size_t CachingMemoryManager::compactBlocks(
+    DeviceMemoryInfo& memoryInfo,
+    BlockSet& blocks,
+    void* stream) {
+  // Blocks are re-inserted after their stream changed, which changes their
+  // order in the set
+  std::vector<Block*> cachedBlocks(blocks.begin(), blocks.end());
+  blocks.clear();
+  // first block of each run of adjacent cached blocks
+  std::vector<Block*> firstBlocks;
+  for (auto* block : cachedBlocks) {
+    block->stream_ = stream;
+    if (!block->prev_ || !block->prev_->cached_) {
+      firstBlocks.push_back(block);
+    }
+  }
 
-  freeBlocks(
-      memoryInfo.largeBlocks_,
-      memoryInfo.largeBlocks_.begin(),
-      memoryInfo.largeBlocks_.end());
+  size_t releasedBytes = 0;
+  for (auto* block : firstBlocks) {
+    while (block->next_ && block->next_->cached_) {
+      Block* next = block->next_;
+      block->size_ += next->size_;
+      block->next_ = next->next_;
+      if (block->next_) {
+        block->next_->prev_ = block;
+      }
+      delete next;
+    }
+    if (block->isSplit()) {
+      blocks.insert(block);
+      continue;
+    }
+    // The whole allocation is free
+    this->deviceInterface->nativeFree(static_cast<void*>(block->ptr_));
+    ++memoryInfo.stats_.totalNativeFrees_;
+    memoryInfo.stats_.allocatedBytes_ -= block->size_;
+    memoryInfo.stats_.cachedBytes_ -= block->size_;
+    recordTimeline(memoryInfo, TimelineAction::NativeFree, block->size_);
+    releasedBytes += block->size_;
+    delete block;
+  }
+  return releasedBytes;
+}
 
-  freeBlocks(
-      memoryInfo.smallBlocks_,
-      memoryInfo.smallBlocks_.begin(),
-      memoryInfo.smallBlocks_.end());
+double CachingMemoryManager::SizeClassStats::hitRate() const {
+  const size_t numAllocs = cacheHits + cacheMisses;
+  return numAllocs == 0 ? 0.0 : static_cast<double>(cacheHits) / numAllocs;
+}
+
+CachingMemoryManager::MemorySnapshot CachingMemoryManager::getMemorySnapshot(
+    int device /* = -1 */,
+    size_t numHistogramBuckets /* = 10 */) {
+  auto& memoryInfo = getDeviceMemoryInfo(device);
+  MemorySnapshot snapshot{};
+  snapshot.deviceId = memoryInfo.deviceId_;
+
+  std::vector<size_t> freeBlockSizes;
+  std::vector<size_t> usedBlockSizes;
+  {
+    // Blocks only move between the pools and the allocated blocks with a pool
+    // lock held
+    std::lock_guard<std::mutex> largeLock(memoryInfo.largeMutex_);
+    std::lock_guard<std::mutex> smallLock(memoryInfo.smallMutex_);
+    for (const auto* pool :
+         {&memoryInfo.largeBlocks_, &memoryInfo.smallBlocks_}) {
+      for (const auto* block : *pool) {
+        freeBlockSizes.push_back(block->size_);
+        snapshot.largestFreeBlock =
+            std::max(snapshot.largestFreeBlock, block->size_);
+        if (block->isSplit()) {
+          snapshot.splitCachedBytes += block->size_;
+        }
+      }
+    }
+    for (auto& shard : memoryInfo.allocatedShards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex_);
+      for (const auto& [ptr, block] : shard.blocks_) {
+        usedBlockSizes.push_back(block->size_);
+      }
+    }
+    snapshot.allocatedBytes = memoryInfo.stats_.allocatedBytes_;
+    snapshot.cachedBytes = memoryInfo.stats_.cachedBytes_;
+  }
+  snapshot.totalNativeMallocs = memoryInfo.stats_.totalNativeMallocs_;
+  snapshot.totalNativeFrees = memoryInfo.stats_.totalNativeFrees_;
+  snapshot.numPendingEvents = memoryInfo.numPendingEvents_;
+  snapshot.numCompactions = memoryInfo.stats_.numCompactions_;
+  snapshot.compactedBytes = memoryInfo.stats_.compactedBytes_;
+  snapshot.freeBlockSizes = FixedBucketSizeHistogram<size_t>(
+      freeBlockSizes.begin(), freeBlockSizes.end(), numHistogramBuckets);
+  snapshot.usedBlockSizes = FixedBucketSizeHistogram<size_t>(
+      usedBlockSizes.begin(), usedBlockSizes.end(), numHistogramBuckets);
+
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    SizeClassStats sizeClass;
+    sizeClass.minSize = i == 0 ? 0 : kMinBlockSize << i;
+    sizeClass.maxSize = i + 1 == kNumSizeClasses
+        ? std::numeric_limits<size_t>::max()
+        : kMinBlockSize << (i + 1);
+    sizeClass.cacheHits = memoryInfo.stats_.cacheHits_[i];
+    sizeClass.cacheMisses = memoryInfo.stats_.cacheMisses_[i];
+    if (sizeClass.cacheHits + sizeClass.cacheMisses > 0) {
+      snapshot.sizeClasses.push_back(sizeClass);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(memoryInfo.timelineMutex_);
+  snapshot.timeline.assign(
+      memoryInfo.timeline_.begin(), memoryInfo.timeline_.end());
+  return snapshot;
+}
+
+std::string CachingMemoryManager::MemorySnapshot::prettyString() const {
+  std::stringstream ss;
+  ss << "Device: " << deviceId
+     << ", Allocated: " << formatMemory(allocatedBytes)
+     << ", Cached: " << formatMemory(cachedBytes)
+     << "\nLargest free block: " << formatMemory(largestFreeBlock)
+     << ", Cached in split blocks: " << formatMemory(splitCachedBytes)
+     << ", Pending cross-stream events: " << numPendingEvents
+     << "\nTotal native calls: " << totalNativeMallocs << "(mallocs), "
+     << totalNativeFrees << "(frees), Compactions: " << numCompactions
+     << " (released " << formatMemory(compactedBytes) << ")"
+     << "\nFree block sizes: " << freeBlockSizes.prettyString()
+     << "Used block sizes: " << usedBlockSizes.prettyString()
+     << "Cache hit rate per allocation size:\n";
+  for (const auto& sizeClass : sizeClasses) {
+    ss << "[" << formatMemory(sizeClass.minSize) << ", ";
+    if (sizeClass.maxSize == std::numeric_limits<size_t>::max()) {
+      ss << "inf";
+    } else {
+      ss << formatMemory(sizeClass.maxSize);
+    }
+    ss << ") " << sizeClass.cacheHits << "/"
+       << sizeClass.cacheHits + sizeClass.cacheMisses << " ("
+       << std::round(sizeClass.hitRate() * 100) << "%)\n";
+  }
+  if (!timeline.empty()) {
+    static const char* const kActionNames[] = {
+        "alloc", "free", "nativeAlloc", "nativeFree", "compact"};
+    const auto start = timeline.front().time;
+    ss << "Timeline (us, action, size, allocated, cached):\n";
+    for (const auto& entry : timeline) {
+      ss << std::chrono::duration_cast<std::chrono::microseconds>(
+                entry.time - start)
+                .count()
+         << " " << kActionNames[static_cast<int>(entry.action)] << " "
+         << entry.size << " " << entry.allocatedBytes << " "
+         << entry.cachedBytes << "\n";
+    }
+  }
+  return ss.str();
+}
+
+void CachingMemoryManager::recordTimeline(
+    DeviceMemoryInfo& memoryInfo,
+    TimelineAction action,
+    size_t size) {
+  const size_t capacity = timelineCapacity_;
+  if (capacity == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(memoryInfo.timelineMutex_);
+  memoryInfo.timeline_.push_back(
+      {std::chrono::steady_clock::now(),
+       action,
+       size,
+       memoryInfo.stats_.allocatedBytes_,
+       memoryInfo.stats_.cachedBytes_});
+  while (memoryInfo.timeline_.size() > capacity) {
+    memoryInfo.timeline_.pop_front();
+  }
 }
 
 float CachingMemoryManager::getMemoryPressure() {
@@ -380,7 +756,6 @@ void CachingMemoryManager::printInfo(
     std::ostream* _ostream) {
   std::ostream& ostream = *_ostream;
   auto& memInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memInfo.mutexAll_);
 
   ostream << msg << "\nType: CachingMemoryManager" << std::endl
           << "\nDevice: " << memInfo.deviceId_ << ", Capacity: "
@@ -391,23 +766,33 @@ void CachingMemoryManager::printInfo(
           << std::endl
           << "\nTotal native calls: " << memInfo.stats_.totalNativeMallocs_
           << "(mallocs), " << memInfo.stats_.totalNativeFrees_ << "(frees)"
+          << std::endl
+          << "\nPending cross-stream events: " << memInfo.numPendingEvents_
           << std::endl;
+  // Walks all blocks
+  const auto snapshot = getMemorySnapshot(memInfo.deviceId_, 1);
+  ostream << "\nLargest free block: " << formatMemory(snapshot.largestFreeBlock)
+          << ", Cached in split blocks: "
+          << formatMemory(snapshot.splitCachedBytes) << std::endl;
 }
 
 void CachingMemoryManager::userLock(const void* ptr) {
   if (!ptr) {
     return;
   }
-  auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
+  auto& shard = getDeviceMemoryInfo().allocatedShard(ptr);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
 
-  auto it = memoryInfo.allocatedBlocks_.find(const_cast<void*>(ptr));
-  if (it == memoryInfo.allocatedBlocks_.end()) {
+  auto it = shard.blocks_.find(const_cast<void*>(ptr));
+  if (it == shard.blocks_.end()) {
     // Follows the behavior of DefaultMemoryManager
-    auto block = new Block(kSmallBuffer, const_cast<void*>(ptr));
+    auto block = new Block(
+        kSmallBuffer,
+        const_cast<void*>(ptr),
+        getActiveStream(*this->deviceInterface));
     block->managerLock_ = false;
     block->userLock_ = true;
-    memoryInfo.allocatedBlocks_[block->ptr_] = block;
+    shard.blocks_[block->ptr_] = block;
   } else {
     it->second->userLock_ = true;
   }
@@ -421,10 +806,10 @@ bool CachingMemoryManager::isUserLocked(const void* ptr) {
   if (!ptr) {
     return false;
   }
-  auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
-  auto it = memoryInfo.allocatedBlocks_.find(const_cast<void*>(ptr));
-  if (it == memoryInfo.allocatedBlocks_.end()) {
+  auto& shard = getDeviceMemoryInfo().allocatedShard(ptr);
+  std::lock_guard<std::mutex> lock(shard.mutex_);
+  auto it = shard.blocks_.find(const_cast<void*>(ptr));
+  if (it == shard.blocks_.end()) {
     return false;
   }
   return it->second->userLock_;
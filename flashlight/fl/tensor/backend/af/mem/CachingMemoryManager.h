@@ -7,16 +7,22 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <ostream>
 #include <set>
+#include <string>
+#include <utility>
 #include <unordered_map>
 #include <vector>
 
+#include "flashlight/fl/common/Histogram.h"
 #include "flashlight/fl/tensor/backend/af/mem/MemoryManagerAdapter.h"
 #include "flashlight/fl/tensor/backend/af/mem/MemoryManagerDeviceInterface.h"
 
@@ -59,6 +65,33 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   // thread safe
   void setRecyclingSizeLimit(size_t);
   void setSplitSizeLimit(size_t);
+  // Compact (see `compact`) when an allocation fails even after releasing the
+  // cached blocks, before giving up. Off by default.
+  void setCompactOnAllocFailure(bool);
+  // Records the last `capacity` allocator events of each device in a timeline,
+  // 0 (the default) disables it.
+  void setTimelineCapacity(size_t capacity);
+
+  /**
+   * Defragments the free memory of the active device:
+   * - waits for the work queued so far on all streams, so that free blocks of
+   *   any stream can be used on the active stream.
+   * - coalesces adjacent free blocks, and releases allocations which are then
+   *   fully free back to the device.
+   *
+   * Blocks the calling thread while streams finish their work.
+   *
+   * @return the number of bytes released to the device.
+   */
+  size_t compact();
+
+  /**
+   * Marks the memory at `ptr`, allocated by this manager, as used by `stream`
+   * in addition to the stream it was allocated on. When freed, the memory only
+   * gets reused once work queued on `stream` until then completed. No-op if
+   * the device interface doesn't support streams.
+   */
+  void recordStream(const void* ptr, void* stream);
 
   // Block denotes a single allocated unit of memory.
   struct Block {
@@ -66,8 +99,12 @@ class CachingMemoryManager : public MemoryManagerAdapter {
     void* ptr_; // memory address
     bool managerLock_; //  whether the memory is locked by the memory manager
     bool userLock_; // whether the memory is locked by the user
+    bool cached_; // whether the block is in a free pool
     Block* prev_; // prev block if split from a larger allocation
     Block* next_; // next block if split from a larger allocation
+    void* stream_; // stream the block was allocated on
+    std::vector<void*> streamUses_; // other streams using the block
+    size_t numPendingEvents_; // # of events to wait for before reuse
 
     bool isSplit() const {
       return (prev_ != nullptr) || (next_ != nullptr);
@@ -77,52 +114,139 @@ class CachingMemoryManager : public MemoryManagerAdapter {
       return managerLock_ || userLock_;
     }
 
-    explicit Block(size_t size, void* ptr = nullptr)
+    explicit Block(size_t size, void* ptr = nullptr, void* stream = nullptr)
         : size_(size),
           ptr_(ptr),
           managerLock_(false),
           userLock_(false),
+          cached_(false),
           prev_(nullptr),
-          next_(nullptr) {}
+          next_(nullptr),
+          stream_(stream),
+          numPendingEvents_(0) {}
   };
 
+  // Orders blocks by stream, then size, so that each stream has its own free
+  // list within a BlockSet.
   typedef bool (*Comparison)(const Block*, const Block*);
   typedef std::set<Block*, Comparison> BlockSet;
 
+  // Requested sizes are bucketed into power-of-two size classes, starting at
+  // the 512 bytes block size. The last one holds all larger sizes.
+  static constexpr size_t kNumSizeClasses = 24;
+
   // A structure to store allocation stats per device.
   struct MemoryAllocationStats {
-    size_t totalNativeMallocs_;
-    size_t totalNativeFrees_;
-    size_t allocatedBytes_; // memory allocated by mem manager for the program
-    size_t cachedBytes_; // memory held by mem manager & not used by the program
-
-    MemoryAllocationStats()
-        : totalNativeMallocs_(0),
-          totalNativeFrees_(0),
-          allocatedBytes_(0),
-          cachedBytes_(0) {}
+    std::atomic<size_t> totalNativeMallocs_{0};
+    std::atomic<size_t> totalNativeFrees_{0};
+    // memory allocated by mem manager for the program
+    std::atomic<size_t> allocatedBytes_{0};
+    // memory held by mem manager & not used by the program
+    std::atomic<size_t> cachedBytes_{0};
+    // allocations served from / missing the cache, per size class
+    std::array<std::atomic<size_t>, kNumSizeClasses> cacheHits_{};
+    std::array<std::atomic<size_t>, kNumSizeClasses> cacheMisses_{};
+    std::atomic<size_t> numCompactions_{0};
+    std::atomic<size_t> compactedBytes_{0}; // released by compactions
+  };
+
+  enum class TimelineAction { Alloc, Free, NativeAlloc, NativeFree, Compact };
+
+  struct TimelineEntry {
+    std::chrono::steady_clock::time_point time;
+    TimelineAction action;
+    size_t size; // bytes of the block, or released by a compaction
+    // device totals after the action
+    size_t allocatedBytes;
+    size_t cachedBytes;
+  };
+
+  struct SizeClassStats {
+    size_t minSize; // inclusive
+    size_t maxSize; // exclusive, max size_t for the last class
+    size_t cacheHits;
+    size_t cacheMisses;
+
+    double hitRate() const;
+  };
+
+  /**
+   * A consistent view of the memory of a device, to diagnose fragmentation.
+   */
+  struct MemorySnapshot {
+    int deviceId;
+    size_t allocatedBytes;
+    size_t cachedBytes;
+    size_t totalNativeMallocs;
+    size_t totalNativeFrees;
+    // largest contiguous free memory that doesn't need a native allocation
+    size_t largestFreeBlock;
+    // cached memory in allocations which are partly in use, which is wasted
+    // for requests larger than its blocks and can't be released
+    size_t splitCachedBytes;
+    size_t numPendingEvents;
+    size_t numCompactions;
+    size_t compactedBytes;
+    HistogramStats<size_t> freeBlockSizes;
+    HistogramStats<size_t> usedBlockSizes;
+    // size classes with at least one allocation
+    std::vector<SizeClassStats> sizeClasses;
+    // oldest first, empty unless enabled with `setTimelineCapacity`
+    std::vector<TimelineEntry> timeline;
+
+    std::string prettyString() const;
   };
 
-  // Stores the mutex and misc variables per device so that we operate in a
-  // thredsafe manner.
+  /**
+   * Returns a snapshot of the memory of the given device, -1 for the active
+   * one. Holds the pool locks while reading the blocks.
+   */
+  MemorySnapshot getMemorySnapshot(
+      int device = -1,
+      size_t numHistogramBuckets = 10);
+
+  static constexpr size_t kNumAllocatedShards = 16;
+
+  // Allocated blocks whose device pointers hash to the same shard.
+  struct AllocatedShard {
+    std::mutex mutex_;
+    std::unordered_map<void*, Block*> blocks_;
+  };
+
+  // Stores the mutexes and misc variables per device so that we operate in a
+  // thredsafe manner. Locks are never nested, and are held for short critical
+  // sections only: native allocations happen outside of them.
   struct DeviceMemoryInfo {
     int deviceId_;
 
-    // lock around all operations
-    std::recursive_mutex mutexAll_; // TODO:: improve perf using R/W locks
-
-    // cached blocks larger than 1 MB
+    // cached blocks larger than 1 MB, and the lock around them and the
+    // prev/next links of blocks split from large allocations
+    std::mutex largeMutex_;
     BlockSet largeBlocks_;
 
-    // cached blocks 1 MB or smaller
+    // cached blocks 1 MB or smaller, and the lock around them and the
+    // prev/next links of blocks split from small allocations
+    std::mutex smallMutex_;
     BlockSet smallBlocks_;
 
-    // allocated blocks by device pointer
-    std::unordered_map<void*, Block*> allocatedBlocks_;
+    // allocated blocks by device pointer, sharded so that concurrent frees and
+    // lookups from different threads rarely contend
+    std::array<AllocatedShard, kNumAllocatedShards> allocatedShards_;
+
+    // freed blocks used by other streams, waiting for an event recorded on
+    // each of these streams, in recording order
+    std::mutex eventsMutex_;
+    std::deque<std::pair<void*, Block*>> pendingEvents_;
+    std::atomic<size_t> numPendingEvents_{0};
 
     MemoryAllocationStats stats_;
 
+    std::mutex timelineMutex_;
+    std::deque<TimelineEntry> timeline_;
+
     explicit DeviceMemoryInfo(int id);
+
+    AllocatedShard& allocatedShard(const void* ptr);
   };
 
  protected:
@@ -137,14 +261,31 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   // Using "-1" will return info for the current active device.
   DeviceMemoryInfo& getDeviceMemoryInfo(int device = -1);
 
+  // The following must be called with the lock of the pool held
   void
   freeBlocks(BlockSet& blocks, BlockSet::iterator it, BlockSet::iterator end);
+  void tryMergeBlocks(Block* dst, Block* src, BlockSet& freeBlocks);
+  // Moves the blocks to `stream` and coalesces them, returns the bytes
+  // released to the device.
+  size_t compactBlocks(
+      DeviceMemoryInfo& memoryInfo,
+      BlockSet& blocks,
+      void* stream);
 
   void mallocWithRetry(size_t size, void** ptr);
 
-  void tryMergeBlocks(Block* dst, Block* src, BlockSet& freeBlocks);
+  // Returns a free block to its pool, merging it with its free neighbors.
   void freeBlock(Block* block);
 
+  // Returns the blocks whose events completed to their pool. If `wait`, first
+  // waits for all pending events.
+  void processEvents(DeviceMemoryInfo& memoryInfo, bool wait = false);
+
+  void recordTimeline(
+      DeviceMemoryInfo& memoryInfo,
+      TimelineAction action,
+      size_t size);
+
  private:
   // Non-const runtime options in order to fine tune the behavior of this
   // manager. Prevents to recycle some buffers, to be set by the user if
@@ -153,6 +294,8 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   // size_t recyclingSizeLimit;
   // Prevents to split big buffers, to be set by the user if desired:
   size_t splitSizeLimit_{std::numeric_limits<size_t>::max()};
+  bool compactOnAllocFailure_{false};
+  std::atomic<size_t> timelineCapacity_{0};
 };
 
 } // namespace fl
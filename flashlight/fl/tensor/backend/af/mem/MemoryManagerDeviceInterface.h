@@ -17,6 +17,11 @@ using NativeAllocFn = std::function<void*(size_t)>;
 using NativeFreeFn = std::function<void(void*)>;
 using GetMemoryPressureThresholdFn = std::function<float()>;
 using SetMemoryPressureThresholdFn = std::function<void(float)>;
+using GetActiveStreamFn = std::function<void*()>;
+using RecordEventFn = std::function<void*(void*)>;
+using IsEventDoneFn = std::function<bool(void*)>;
+using SyncEventFn = std::function<void(void*)>;
+using DestroyEventFn = std::function<void(void*)>;
 
 /**
  * An interface for using native device memory management and JIT-related memory
@@ -45,6 +50,21 @@ struct MemoryManagerDeviceInterface {
   // Memory pressure functions
   GetMemoryPressureThresholdFn getMemoryPressureThreshold;
   SetMemoryPressureThresholdFn setMemoryPressureThreshold;
+  // Stream & event functions, all optional. Streams and events are opaque
+  // native handles (e.g. cudaStream_t and cudaEvent_t). If unset, memory
+  // managers treat all allocations as belonging to a single stream.
+  GetActiveStreamFn getActiveStream;
+  // records a new event on the given stream and returns it
+  RecordEventFn recordEvent;
+  IsEventDoneFn isEventDone;
+  // blocks until the event completed
+  SyncEventFn syncEvent;
+  DestroyEventFn destroyEvent;
+
+  bool supportsStreams() const {
+    return getActiveStream && recordEvent && isEventDone && syncEvent &&
+        destroyEvent;
+  }
 };
 
 } // namespace fl
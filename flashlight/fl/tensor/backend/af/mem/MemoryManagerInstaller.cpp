@@ -16,6 +16,14 @@
 #include "flashlight/fl/tensor/backend/af/Utils.h"
 #include "flashlight/fl/tensor/backend/af/mem/CachingMemoryManager.h"
 
+#if FL_ARRAYFIRE_USE_CUDA
+  #include <cuda_runtime.h>
+
+  #include <af/cuda.h>
+
+  #include "flashlight/fl/runtime/CUDAUtils.h"
+#endif
+
 namespace fl {
 
 // Statics from MemoryManagerInstaller
@@ -204,6 +212,38 @@ MemoryManagerInstaller::MemoryManagerInstaller(
   };
   impl_->deviceInterface->setMemoryPressureThreshold =
       std::move(setMemoryPressureThresholdFn);
+
+#if FL_ARRAYFIRE_USE_CUDA
+  // Stream & event functions. ArrayFire enqueues all work on a single stream
+  // per device, other streams only come from users of the device pointers.
+  auto getActiveStreamFn = [itf]() {
+    int id;
+    AF_CHECK(af_memory_manager_get_active_device_id(itf, &id));
+    return static_cast<void*>(afcu::getStream(id));
+  };
+  impl_->deviceInterface->getActiveStream = std::move(getActiveStreamFn);
+  impl_->deviceInterface->recordEvent = [](void* stream) {
+    cudaEvent_t event;
+    FL_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    FL_CUDA_CHECK(cudaEventRecord(event, static_cast<cudaStream_t>(stream)));
+    return static_cast<void*>(event);
+  };
+  impl_->deviceInterface->isEventDone = [](void* event) {
+    const auto status = cudaEventQuery(static_cast<cudaEvent_t>(event));
+    if (status == cudaErrorNotReady) {
+      cudaGetLastError(); // reset the last error
+      return false;
+    }
+    FL_CUDA_CHECK(status);
+    return true;
+  };
+  impl_->deviceInterface->syncEvent = [](void* event) {
+    FL_CUDA_CHECK(cudaEventSynchronize(static_cast<cudaEvent_t>(event)));
+  };
+  impl_->deviceInterface->destroyEvent = [](void* event) {
+    FL_CUDA_CHECK(cudaEventDestroy(static_cast<cudaEvent_t>(event)));
+  };
+#endif
 }
 
 void MemoryManagerInstaller::setAsMemoryManager() {
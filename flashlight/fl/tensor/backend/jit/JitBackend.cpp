@@ -15,8 +15,12 @@
 #include "flashlight/fl/tensor/TensorBase.h"
 #include "flashlight/fl/tensor/backend/jit/JitTensorBase.h"
 #include "flashlight/fl/tensor/backend/jit/ShapeInference.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
 
 namespace fl {
 
@@ -62,6 +66,19 @@ JitBackend::JitBackend(
       evaluator_(wrappedBackend),
       optimizer_(wrappedBackend) {}
 
+Tensor JitBackend::jitTensorFromNode(NodePtr node) {
+  auto tensor = jitTensorCreator_(node);
+  // a matmul waits for its consumer, which may be fused into its epilogue
+  if (materializationPolicy_ && !node->isMatmul()) {
+    const auto reason = materializationPolicy_->shouldMaterialize(node);
+    if (reason.has_value()) {
+      materializationCounts_[reason.value()]++;
+      toJitTensorBase(tensor).eval();
+    }
+  }
+  return tensor;
+}
+
 TensorBackendType JitBackend::backendType() const {
   return TensorBackendType::Jit;
 }
@@ -78,6 +95,24 @@ TensorBackend& JitBackend::wrappedBackend() {
   return wrappedBackend_;
 }
 
+void JitBackend::setMaterializationPolicy(
+    std::unique_ptr<MaterializationPolicy> policy) {
+  materializationPolicy_ = std::move(policy);
+}
+
+MaterializationPolicy* JitBackend::materializationPolicy() {
+  return materializationPolicy_.get();
+}
+
+const std::unordered_map<MaterializationReason, unsigned>&
+JitBackend::getMaterializationCounts() const {
+  return materializationCounts_;
+}
+
+void JitBackend::clearMaterializationCounts() {
+  materializationCounts_.clear();
+}
+
 /* -------------------------- Compute Functions -------------------------- */
 
 void JitBackend::eval(const Tensor& tensor) {
@@ -117,7 +152,7 @@ void JitBackend::setSeed(const int seed) {
 }
 
 Tensor JitBackend::randn(const Shape& shape, dtype type) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "randn",
       tensorsToNodes(),
       Shape(shape),
@@ -127,7 +162,7 @@ Tensor JitBackend::randn(const Shape& shape, dtype type) {
 }
 
 Tensor JitBackend::rand(const Shape& shape, dtype type) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "rand",
       tensorsToNodes(),
       Shape(shape),
@@ -162,17 +197,17 @@ FL_JIT_BACKEND_CREATE_FUN_LITERAL_DEF_STUB(const unsigned short&);
 
 template <typename T>
 Tensor JitBackend::fullWithType(const Shape& shape, T value, dtype type) {
-  return jitTensorCreator_(ScalarNode::create(shape, type, value));
+  return jitTensorFromNode(ScalarNode::create(shape, type, value));
 }
 
 Tensor JitBackend::identity(const Dim dim, const dtype type) {
-  return jitTensorCreator_(
+  return jitTensorFromNode(
       ValueNode::create(wrappedBackend_.identity(dim, type)));
 }
 
 Tensor
 JitBackend::arange(const Shape& shape, const Dim seqDim, const dtype type) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "arange",
       tensorsToNodes(),
       Shape(shape),
@@ -184,51 +219,30 @@ JitBackend::arange(const Shape& shape, const Dim seqDim, const dtype type) {
 
 Tensor
 JitBackend::iota(const Shape& dims, const Shape& tileDims, const dtype type) {
-  return jitTensorCreator_(
+  return jitTensorFromNode(
       ValueNode::create(wrappedBackend_.iota(dims, tileDims, type)));
 }
 
 /************************ Shaping and Indexing *************************/
 Tensor JitBackend::reshape(const Tensor& tensor, const Shape& shape) {
-  if (tensor.shape().elements() != shape.elements()) {
-    std::ostringstream oss;
-    oss << "[JitBackend::reshape] Cannot reshape from " << tensor.shape()
-        << " to " << shape;
-    throw std::invalid_argument(oss.str());
-  }
-  return jitTensorCreator_(CustomNode::create(
-      "reshape",
-      tensorsToNodes(tensor),
-      Shape(shape),
-      [this, shape](const std::vector<const Tensor*>& inputs) {
-        return wrappedBackend_.reshape(*inputs.at(0), shape);
-      }));
+  return jitTensorFromNode(ViewNode::create(
+      toJitTensorBase(tensor).node(), ViewType::Reshape, shape));
 }
 
 Tensor JitBackend::transpose(const Tensor& tensor, const Shape& axes = {}) {
-  return jitTensorCreator_(CustomNode::create(
-      "transpose",
-      tensorsToNodes(tensor),
-      inferTransposeOutputShape(tensor.shape(), axes),
-      [this, axes](const std::vector<const Tensor*>& inputs) {
-        return wrappedBackend_.transpose(*inputs.at(0), axes);
-      }));
+  return jitTensorFromNode(ViewNode::create(
+      toJitTensorBase(tensor).node(), ViewType::Transpose, axes));
 }
 
 Tensor JitBackend::tile(const Tensor& tensor, const Shape& tileDims) {
-  return jitTensorCreator_(CustomNode::create(
-      "tile",
-      tensorsToNodes(tensor),
-      inferTileOutputShape(tensor.shape(), tileDims),
-      [this, tileDims](const std::vector<const Tensor*>& inputs) {
-        return wrappedBackend_.tile(*inputs[0], tileDims);
-      }));
+  return jitTensorFromNode(ViewNode::create(
+      toJitTensorBase(tensor).node(), ViewType::Tile, tileDims));
 }
 
 Tensor JitBackend::concatenate(
     const std::vector<Tensor>& tensors,
     const unsigned axisToConcat) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "concatenate",
       tensorsToNodes(tensors),
       inferConcatenateOutputShape(tensors, axisToConcat),
@@ -245,7 +259,7 @@ Tensor JitBackend::concatenate(
 Tensor JitBackend::nonzero(const Tensor& tensor) {
   // NOTE must materialize since we can't infer output shape
   const auto& tensorResult = materialize(tensor);
-  return jitTensorCreator_(
+  return jitTensorFromNode(
       ValueNode::create(wrappedBackend_.nonzero(tensorResult)));
 }
 
@@ -253,7 +267,7 @@ Tensor JitBackend::pad(
     const Tensor& input,
     const std::vector<std::pair<int, int>>& padWidths,
     const PadType type) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "pad",
       tensorsToNodes(input),
       inferPadOutputShape(input.shape(), padWidths),
@@ -263,10 +277,14 @@ Tensor JitBackend::pad(
 }
 
 /************************** Unary Operators ***************************/
+Tensor JitBackend::createUnopJitTensor(const Tensor& tensor, UnaryOp op) {
+  const auto inputNode = toJitTensorBase(tensor).node();
+  return jitTensorFromNode(UnaryNode::create(inputNode, op));
+}
 
 #define FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(OP)             \
   {                                                        \
-    return jitTensorCreator_(CustomNode::create(           \
+    return jitTensorFromNode(CustomNode::create(           \
         #OP,                                               \
         tensorsToNodes(tensor),                            \
         Shape(tensor.shape()),                             \
@@ -276,67 +294,67 @@ Tensor JitBackend::pad(
   }
 
 Tensor JitBackend::exp(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(exp);
+  return createUnopJitTensor(tensor, UnaryOp::Exp);
 }
 
 Tensor JitBackend::log(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(log);
+  return createUnopJitTensor(tensor, UnaryOp::Log);
 }
 
 Tensor JitBackend::negative(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(negative);
+  return createUnopJitTensor(tensor, UnaryOp::Negative);
 }
 
 Tensor JitBackend::logicalNot(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(logicalNot);
+  return createUnopJitTensor(tensor, UnaryOp::LogicalNot);
 }
 
 Tensor JitBackend::log1p(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(log1p);
+  return createUnopJitTensor(tensor, UnaryOp::Log1p);
 }
 
 Tensor JitBackend::sin(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(sin);
+  return createUnopJitTensor(tensor, UnaryOp::Sin);
 }
 
 Tensor JitBackend::cos(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(cos);
+  return createUnopJitTensor(tensor, UnaryOp::Cos);
 }
 
 Tensor JitBackend::sqrt(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(sqrt);
+  return createUnopJitTensor(tensor, UnaryOp::Sqrt);
 }
 
 Tensor JitBackend::tanh(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(tanh);
+  return createUnopJitTensor(tensor, UnaryOp::Tanh);
 }
 
 Tensor JitBackend::floor(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(floor);
+  return createUnopJitTensor(tensor, UnaryOp::Floor);
 }
 
 Tensor JitBackend::ceil(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(ceil);
+  return createUnopJitTensor(tensor, UnaryOp::Ceil);
 }
 
 Tensor JitBackend::rint(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(rint);
+  return createUnopJitTensor(tensor, UnaryOp::Rint);
 }
 
 Tensor JitBackend::absolute(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(absolute);
+  return createUnopJitTensor(tensor, UnaryOp::Absolute);
 }
 
 Tensor JitBackend::sigmoid(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(sigmoid);
+  return createUnopJitTensor(tensor, UnaryOp::Sigmoid);
 }
 
 Tensor JitBackend::erf(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(erf);
+  return createUnopJitTensor(tensor, UnaryOp::Erf);
 }
 
 Tensor JitBackend::flip(const Tensor& tensor, const unsigned dim) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "flip",
       tensorsToNodes(tensor),
       Shape(tensor.shape()),
@@ -347,7 +365,7 @@ Tensor JitBackend::flip(const Tensor& tensor, const unsigned dim) {
 
 Tensor
 JitBackend::clip(const Tensor& tensor, const Tensor& low, const Tensor& high) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "clip",
       tensorsToNodes(tensor, low, high),
       Shape(tensor.shape()),
@@ -359,7 +377,7 @@ JitBackend::clip(const Tensor& tensor, const Tensor& low, const Tensor& high) {
 
 Tensor
 JitBackend::roll(const Tensor& tensor, const int shift, const unsigned axis) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "roll",
       tensorsToNodes(tensor),
       Shape(tensor.shape()),
@@ -369,15 +387,15 @@ JitBackend::roll(const Tensor& tensor, const int shift, const unsigned axis) {
 }
 
 Tensor JitBackend::isnan(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(isnan);
+  return createUnopJitTensor(tensor, UnaryOp::IsNan);
 }
 
 Tensor JitBackend::isinf(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(isinf);
+  return createUnopJitTensor(tensor, UnaryOp::IsInf);
 }
 
 Tensor JitBackend::sign(const Tensor& tensor) {
-  FL_JIT_BACKEND_UNARY_FALLBACK_IMPL(sign);
+  return createUnopJitTensor(tensor, UnaryOp::Sign);
 }
 
 Tensor JitBackend::tril(const Tensor& tensor) {
@@ -391,7 +409,7 @@ Tensor JitBackend::triu(const Tensor& tensor) {
 
 Tensor
 JitBackend::where(const Tensor& condition, const Tensor& x, const Tensor& y) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "where",
       tensorsToNodes(condition, x, y),
       Shape(condition.shape()),
@@ -413,13 +431,13 @@ void JitBackend::topk(
   auto indicesResult = this->full({1}, 0, dtype::s32);
   wrappedBackend_.topk(
       valuesResult, indicesResult, inputResult, k, axis, sortMode);
-  values = jitTensorCreator_(ValueNode::create(std::move(valuesResult)));
-  indices = jitTensorCreator_(ValueNode::create(std::move(indicesResult)));
+  values = jitTensorFromNode(ValueNode::create(std::move(valuesResult)));
+  indices = jitTensorFromNode(ValueNode::create(std::move(indicesResult)));
 }
 
 Tensor
 JitBackend::sort(const Tensor& input, const Dim axis, const SortMode sortMode) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "sort",
       tensorsToNodes(input),
       Shape(input.shape()),
@@ -439,15 +457,15 @@ void JitBackend::sort(
   auto indicesResult = this->full({1}, 0, dtype::s32);
   wrappedBackend_.sort(
       valuesResult, indicesResult, inputResult, axis, sortMode);
-  values = jitTensorCreator_(ValueNode::create(std::move(valuesResult)));
-  indices = jitTensorCreator_(ValueNode::create(std::move(indicesResult)));
+  values = jitTensorFromNode(ValueNode::create(std::move(valuesResult)));
+  indices = jitTensorFromNode(ValueNode::create(std::move(indicesResult)));
 }
 
 Tensor JitBackend::argsort(
     const Tensor& input,
     const Dim axis,
     const SortMode sortMode) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "argsort",
       tensorsToNodes(input),
       Shape(input.shape()),
@@ -463,7 +481,7 @@ Tensor JitBackend::createBinopJitTensor(
     BinaryOp op) {
   const auto lhsNode = toJitTensorBase(lhs).node();
   const auto rhsNode = toJitTensorBase(rhs).node();
-  return jitTensorCreator_(BinaryNode::create(lhsNode, rhsNode, op));
+  return jitTensorFromNode(BinaryNode::create(lhsNode, rhsNode, op));
 }
 
 // TODO remove once onednn backend supports horizontal broadcast
@@ -544,21 +562,26 @@ Tensor JitBackend::matmul(
     const Tensor& rhs,
     MatrixProperty lhsProp,
     MatrixProperty rhsProp) {
-  return jitTensorCreator_(CustomNode::create(
-      "matmul",
-      tensorsToNodes(lhs, rhs),
-      inferMatmulOutputShape(lhs.shape(), rhs.shape(), lhsProp, rhsProp),
-      [this, lhsProp, rhsProp](const std::vector<const Tensor*>& inputs) {
-        return wrappedBackend_.matmul(
-            *inputs.at(0), *inputs.at(1), lhsProp, rhsProp);
-      }));
+  const auto lhsNode = toJitTensorBase(lhs).node();
+  const auto rhsNode = toJitTensorBase(rhs).node();
+  return jitTensorFromNode(
+      MatmulNode::create(lhsNode, rhsNode, lhsProp, rhsProp));
 }
 
 /************************** Reductions ***************************/
+Tensor JitBackend::createReductionJitTensor(
+    const Tensor& input,
+    ReductionOp op,
+    const std::vector<int>& axes,
+    const bool keepDims) {
+  const auto inputNode = toJitTensorBase(input).node();
+  return jitTensorFromNode(
+      ReductionNode::create(inputNode, op, axes, keepDims));
+}
 
 #define FL_JIT_BACKEND_REDUCTION_FALLBACK_IMPL(OP)                         \
   {                                                                        \
-    return jitTensorCreator_(CustomNode::create(                           \
+    return jitTensorFromNode(CustomNode::create(                           \
         #OP,                                                               \
         tensorsToNodes(input),                                             \
         inferReductionOutputShape(input.shape(), axes, keepDims),          \
@@ -571,14 +594,14 @@ Tensor JitBackend::amin(
     const Tensor& input,
     const std::vector<int>& axes,
     const bool keepDims) {
-  FL_JIT_BACKEND_REDUCTION_FALLBACK_IMPL(amin);
+  return createReductionJitTensor(input, ReductionOp::Min, axes, keepDims);
 }
 
 Tensor JitBackend::amax(
     const Tensor& input,
     const std::vector<int>& axes,
     const bool keepDims) {
-  FL_JIT_BACKEND_REDUCTION_FALLBACK_IMPL(amax);
+  return createReductionJitTensor(input, ReductionOp::Max, axes, keepDims);
 }
 
 void JitBackend::min(
@@ -593,8 +616,8 @@ void JitBackend::min(
   auto valuesResult = this->wrappedBackend_.full({}, 0, dtype::s32);
   auto indicesResult = this->wrappedBackend_.full({}, 0, dtype::s32);
   wrappedBackend_.min(valuesResult, indicesResult, inputResult, axis, keepDims);
-  values = jitTensorCreator_(ValueNode::create(std::move(valuesResult)));
-  indices = jitTensorCreator_(ValueNode::create(std::move(indicesResult)));
+  values = jitTensorFromNode(ValueNode::create(std::move(valuesResult)));
+  indices = jitTensorFromNode(ValueNode::create(std::move(indicesResult)));
 }
 
 void JitBackend::max(
@@ -607,19 +630,19 @@ void JitBackend::max(
   auto valuesResult = this->wrappedBackend_.full({}, 0, dtype::s32);
   auto indicesResult = this->wrappedBackend_.full({}, 0, dtype::s32);
   wrappedBackend_.max(valuesResult, indicesResult, inputResult, axis, keepDims);
-  values = jitTensorCreator_(ValueNode::create(std::move(valuesResult)));
-  indices = jitTensorCreator_(ValueNode::create(std::move(indicesResult)));
+  values = jitTensorFromNode(ValueNode::create(std::move(valuesResult)));
+  indices = jitTensorFromNode(ValueNode::create(std::move(indicesResult)));
 }
 
 Tensor JitBackend::sum(
     const Tensor& input,
     const std::vector<int>& axes,
     const bool keepDims) {
-  FL_JIT_BACKEND_REDUCTION_FALLBACK_IMPL(sum);
+  return createReductionJitTensor(input, ReductionOp::Sum, axes, keepDims);
 }
 
 Tensor JitBackend::cumsum(const Tensor& input, const unsigned axis) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "cumsum",
       tensorsToNodes(input),
       Shape(input.shape()),
@@ -632,7 +655,7 @@ Tensor JitBackend::argmax(
     const Tensor& input,
     const unsigned axis,
     const bool keepDims) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "argmax",
       tensorsToNodes(input),
       inferReductionOutputShape(
@@ -646,7 +669,7 @@ Tensor JitBackend::argmin(
     const Tensor& input,
     const unsigned axis,
     const bool keepDims) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "argmax",
       tensorsToNodes(input),
       inferReductionOutputShape(
@@ -660,7 +683,7 @@ Tensor JitBackend::mean(
     const Tensor& input,
     const std::vector<int>& axes,
     const bool keepDims) {
-  FL_JIT_BACKEND_REDUCTION_FALLBACK_IMPL(mean);
+  return createReductionJitTensor(input, ReductionOp::Mean, axes, keepDims);
 }
 
 Tensor JitBackend::median(
@@ -675,7 +698,7 @@ Tensor JitBackend::var(
     const std::vector<int>& axes,
     const bool bias,
     const bool keepDims) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "var",
       tensorsToNodes(input),
       inferReductionOutputShape(input.shape(), axes, keepDims),
@@ -696,7 +719,7 @@ Tensor JitBackend::norm(
     const std::vector<int>& axes,
     double p /* = 2 */,
     const bool keepDims) {
-  return jitTensorCreator_(CustomNode::create(
+  return jitTensorFromNode(CustomNode::create(
       "norm",
       tensorsToNodes(input),
       inferReductionOutputShape(input.shape(), axes, keepDims),
@@ -9,9 +9,12 @@
 
 #include "flashlight/fl/tensor/TensorAdapter.h"
 #include "flashlight/fl/tensor/TensorBackend.h"
+#include "flashlight/fl/tensor/backend/jit/MaterializationPolicy.h"
 #include "flashlight/fl/tensor/backend/jit/eval/Evaluator.h"
 #include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/opt/Optimizer.h"
 
 namespace fl {
@@ -25,11 +28,24 @@ class JitBackend : public TensorBackend {
   std::function<Tensor(NodePtr)> jitTensorCreator_;
   Evaluator evaluator_;
   Optimizer optimizer_;
+  // null means trees are only evaluated when some consumer forces it
+  std::unique_ptr<MaterializationPolicy> materializationPolicy_;
+  std::unordered_map<MaterializationReason, unsigned> materializationCounts_;
+
+  // wrap `node` in a JIT tensor, and evaluate it if the materialization policy
+  // says so
+  Tensor jitTensorFromNode(NodePtr node);
 
   template <typename T>
   Tensor fullWithType(const Shape& shape, T value, dtype type);
   Tensor
   createBinopJitTensor(const Tensor& lhs, const Tensor& rhs, BinaryOp op);
+  Tensor createUnopJitTensor(const Tensor& tensor, UnaryOp op);
+  Tensor createReductionJitTensor(
+      const Tensor& input,
+      ReductionOp op,
+      const std::vector<int>& axes,
+      const bool keepDims);
 
   template <typename T>
   Tensor createScalarTensor(unsigned ndim, T val);
@@ -51,6 +67,22 @@ class JitBackend : public TensorBackend {
   Optimizer& optimizer();
   TensorBackend& wrappedBackend();
 
+  /**
+   * Set the policy that decides whether a newly built JIT tree should be
+   * evaluated right away, e.g., ThresholdMaterializationPolicy. A null policy
+   * (the default) leaves evaluation entirely to consumers.
+   */
+  void setMaterializationPolicy(std::unique_ptr<MaterializationPolicy> policy);
+  MaterializationPolicy* materializationPolicy();
+
+  /**
+   * Return # of trees evaluated by the materialization policy (i.e., not
+   * forced by consumers), grouped by the reason.
+   */
+  const std::unordered_map<MaterializationReason, unsigned>&
+  getMaterializationCounts() const;
+  void clearMaterializationCounts();
+
   /* -------------------------- Compute Functions -------------------------- */
   void eval(const Tensor& tensor) override;
   bool supportsDataType(const fl::dtype& dtype) const override;
@@ -193,7 +193,8 @@ void JitTensorBase::scalar(void* out) {
   const auto& tensor = getTensorOrEvalNode();
   switch (type()) {
     case dtype::f16:
-      throw std::runtime_error("[JitTensorBase::scalar] f16 unsupported");
+    case dtype::bf16:
+      throw std::runtime_error("[JitTensorBase::scalar] f16/bf16 unsupported");
     case dtype::f32:
       *((float*)out) = tensor.scalar<float>();
       return;
@@ -395,8 +396,9 @@ NodePtr JitTensorBase::node() const {
 
 void JitTensorBase::eval() const {
   if (!node()->getResult().has_value()) {
-    sharedData_->replaceNode(optimizer().optimize(node()));
-    evaluator().eval(node());
+    std::vector<NodePtr> schedule;
+    sharedData_->replaceNode(optimizer().optimize(node(), schedule));
+    evaluator().eval(node(), schedule);
   }
 }
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/MaterializationPolicy.h"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+
+namespace fl {
+
+namespace {
+
+double getMatmulFlops(const MatmulNode& node) {
+  // each output element is a dot product of length K
+  const auto& lhsShape = node.lhs()->shape();
+  Dim innerDim = lhsShape.elements(); // vector lhs is padded to (1 x K)
+  if (lhsShape.ndim() >= 2) {
+    innerDim = node.lhsProp() == MatrixProperty::Transpose ? lhsShape.dim(0)
+                                                           : lhsShape.dim(1);
+  }
+  return 2.0 * node.shape().elements() * innerDim;
+}
+
+double getNodeFlops(const Node& node) {
+  switch (node.type()) {
+    case NodeType::Binary:
+    case NodeType::Custom: // opaque, assume ~1 op per output element
+    case NodeType::IndexedUpdate:
+    case NodeType::Unary:
+      return node.shape().elements();
+    case NodeType::Matmul:
+      return getMatmulFlops(node.impl<MatmulNode>());
+    case NodeType::Reduction:
+      return node.impl<ReductionNode>().input()->shape().elements();
+    case NodeType::Index:
+    case NodeType::Scalar:
+    case NodeType::Value:
+    case NodeType::View:
+      return 0;
+  }
+  throw std::runtime_error("[getNodeFlops] Unknown node type");
+}
+
+// Cost of the tree rooted at `node`, ASSUME all of its unevaluated inputs
+// have a cached tree cost.
+TreeCost combineInputCosts(const Node& node) {
+  TreeCost cost{1, getNodeFlops(node), double(node.shape().elements())};
+  for (const auto& input : node.inputs()) {
+    if (!input->getResult().has_value()) {
+      const auto& inputCost = input->getTreeCost().value();
+      cost.numNodes += inputCost.numNodes;
+      cost.flops += inputCost.flops;
+      cost.intermediateElements += inputCost.intermediateElements;
+    }
+  }
+  return cost;
+}
+
+} // namespace
+
+std::string materializationReasonToString(const MaterializationReason reason) {
+  switch (reason) {
+    case MaterializationReason::NodeCount:
+      return "NodeCount";
+    case MaterializationReason::Flops:
+      return "Flops";
+    case MaterializationReason::IntermediateMemory:
+      return "IntermediateMemory";
+  }
+  throw std::runtime_error("Unknown materialization reason");
+}
+
+std::ostream& operator<<(
+    std::ostream& os,
+    const MaterializationReason& reason) {
+  return os << materializationReasonToString(reason);
+}
+
+TreeCost estimateTreeCost(const NodePtr& root) {
+  if (root->getResult().has_value()) {
+    return {};
+  }
+  // Post-order walk over nodes without cached cost (usually just `root`, whose
+  // inputs were estimated when they were created). `root` is always
+  // re-estimated, since some of its inputs may have been evaluated since.
+  std::vector<std::pair<Node*, bool>> worklist{{root.get(), false}};
+  while (!worklist.empty()) {
+    auto* node = worklist.back().first;
+    if (worklist.back().second) {
+      node->setTreeCost(combineInputCosts(*node));
+      worklist.pop_back();
+      continue;
+    }
+    if (node != root.get() && node->getTreeCost().has_value()) {
+      worklist.pop_back(); // reached through another path
+      continue;
+    }
+    worklist.back().second = true;
+    for (const auto& input : node->inputs()) {
+      if (!input->getResult().has_value() &&
+          !input->getTreeCost().has_value()) {
+        worklist.emplace_back(input.get(), false);
+      }
+    }
+  }
+  return root->getTreeCost().value();
+}
+
+ThresholdMaterializationPolicy::ThresholdMaterializationPolicy()
+    : thresholds_(Thresholds()) {}
+
+ThresholdMaterializationPolicy::ThresholdMaterializationPolicy(
+    Thresholds thresholds)
+    : thresholds_(thresholds) {}
+
+const ThresholdMaterializationPolicy::Thresholds&
+ThresholdMaterializationPolicy::thresholds() const {
+  return thresholds_;
+}
+
+std::optional<MaterializationReason>
+ThresholdMaterializationPolicy::shouldMaterialize(const NodePtr& root) {
+  const auto cost = estimateTreeCost(root);
+  if (cost.numNodes > thresholds_.maxNodes) {
+    return MaterializationReason::NodeCount;
+  }
+  if (cost.flops > thresholds_.maxFlops) {
+    return MaterializationReason::Flops;
+  }
+  if (cost.intermediateElements > thresholds_.maxIntermediateElements) {
+    return MaterializationReason::IntermediateMemory;
+  }
+  return std::nullopt;
+}
+
+} // namespace fl
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <optional>
+#include <ostream>
+#include <string>
+
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+
+namespace fl {
+
+/**
+ * Why a JIT tree was evaluated before any consumer forced it.
+ */
+enum class MaterializationReason {
+  NodeCount,
+  Flops,
+  IntermediateMemory,
+};
+
+/**
+ * Return a readable string representation of the given reason.
+ */
+std::string materializationReasonToString(const MaterializationReason reason);
+
+/**
+ * Output a string representation of `reason` to `os`.
+ */
+std::ostream& operator<<(std::ostream& os, const MaterializationReason& reason);
+
+/**
+ * Estimate the cost of evaluating the tree rooted at `root`.
+ *
+ * The estimate is built incrementally: each node caches the cost of its tree
+ * as the sum of its own cost and that of its unevaluated inputs, so a newly
+ * created node only looks at its inputs. Shared subtrees are counted once per
+ * use, and cached costs don't shrink when part of the tree is evaluated later
+ * (except for `root`'s direct inputs), so this is an upper bound.
+ */
+TreeCost estimateTreeCost(const NodePtr& root);
+
+/**
+ * Decides whether a newly built JIT tree should be evaluated right away, e.g.,
+ * to bound the size of graphs built by long loops, which would otherwise grow
+ * until some consumer forces evaluation.
+ */
+class MaterializationPolicy {
+ public:
+  virtual ~MaterializationPolicy() = default;
+
+  /**
+   * @param[in] root the root of a newly built JIT tree.
+   * @return why the tree should be evaluated now, or nullopt if it can wait.
+   */
+  virtual std::optional<MaterializationReason> shouldMaterialize(
+      const NodePtr& root) = 0;
+};
+
+/**
+ * Materialize a tree once its estimated cost exceeds any of the thresholds.
+ */
+class ThresholdMaterializationPolicy : public MaterializationPolicy {
+ public:
+  struct Thresholds {
+    unsigned maxNodes{1024};
+    double maxFlops{1e10};
+    double maxIntermediateElements{1 << 28};
+  };
+
+ private:
+  const Thresholds thresholds_;
+
+ public:
+  // uses default thresholds
+  ThresholdMaterializationPolicy();
+  explicit ThresholdMaterializationPolicy(Thresholds thresholds);
+  ~ThresholdMaterializationPolicy() override = default;
+
+  const Thresholds& thresholds() const;
+  std::optional<MaterializationReason> shouldMaterialize(
+      const NodePtr& root) override;
+};
+
+} // namespace fl
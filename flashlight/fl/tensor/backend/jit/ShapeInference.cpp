@@ -10,6 +10,7 @@
 #include <cassert>
 #include <numeric>
 #include <sstream>
+#include <stdexcept>
 #include <unordered_set>
 
 namespace fl {
@@ -73,6 +74,16 @@ std::vector<Shape> broadcastShapesToMaxRank(
   return shapes;
 }
 
+Shape inferReshapeOutputShape(const Shape& inputShape, const Shape& shape) {
+  if (inputShape.elements() != shape.elements()) {
+    std::ostringstream oss;
+    oss << "[inferReshapeOutputShape] Cannot reshape from " << inputShape
+        << " to " << shape;
+    throw std::invalid_argument(oss.str());
+  }
+  return shape;
+}
+
 Shape inferTransposeOutputShape(const Shape& inputShape, const Shape& axes) {
   const auto inputRank = inputShape.ndim();
   std::vector<Dim> outputDims = inputShape.get();
@@ -180,29 +191,25 @@ Shape inferMatmulOutputShape(
   } else if (rhsProp == MatrixProperty::Transpose) {
     std::swap(rhsDims[0], rhsDims[1]);
   }
-  // shape compatibility check
-  bool onlyOneIsBatched = lhsRank >= 3 ^ rhsRank >= 3;
-  if (!(lhsDims.at(1) == rhsDims.at(0) &&
-        (onlyOneIsBatched ||
-         std::equal(
-             lhsDims.begin() + 2,
-             lhsDims.end(),
-             rhsDims.begin() + 2,
-             rhsDims.end())))) {
+  // pad batch dims with 1s to the same # of dims, batch dims of size 1 are
+  // broadcast (like OneDnnBackend::matmul)
+  const auto ndim = std::max(lhsDims.size(), rhsDims.size());
+  lhsDims.resize(ndim, 1);
+  rhsDims.resize(ndim, 1);
+  bool isValid = lhsDims[1] == rhsDims[0];
+  std::vector<Dim> outputDims = {lhsDims[0], rhsDims[1]};
+  for (size_t i = 2; i < ndim; i++) {
+    const auto lhsDim = lhsDims[i];
+    const auto rhsDim = rhsDims[i];
+    isValid &= lhsDim == rhsDim || lhsDim == 1 || rhsDim == 1;
+    outputDims.push_back(lhsDim == 1 ? rhsDim : lhsDim);
+  }
+  if (!isValid) {
     std::ostringstream oss;
     oss << "Cannot perform matmul for tensors of shapes: " << lhsShape
         << " and " << rhsShape;
     throw std::invalid_argument(oss.str());
   }
-  // take dims from bigger rank in case batch broadcasting occurred
-  std::vector<Dim> outputDims;
-  if (lhsRank > rhsRank) {
-    outputDims = lhsDims;
-    outputDims[1] = rhsDims[1];
-  } else {
-    outputDims = rhsDims;
-    outputDims[0] = lhsDims[0];
-  }
   Shape outputShape(outputDims);
   if (isLhsScalarOrVector || isRhsScalarOrVector) {
     outputShape = {outputShape.elements()};
@@ -23,6 +23,8 @@ std::vector<Shape> broadcastShapesToMaxRank(
     const std::vector<Tensor>& tensors,
     const unsigned minOutputRank);
 
+Shape inferReshapeOutputShape(const Shape& inputShape, const Shape& shape);
+
 Shape inferTransposeOutputShape(const Shape& inputShape, const Shape& axes);
 
 Shape inferTileOutputShape(const Shape& inputShape, const Shape& tileDims);
@@ -0,0 +1,773 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/eval/ElementwiseKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+#include "flashlight/fl/tensor/TensorAdapter.h"
+
+namespace fl {
+
+namespace {
+
+// Number of output elements processed per iteration of the native loop nest.
+// Small enough for all live registers to stay in L1 for typical kernels.
+constexpr Dim kBlockSize = 256;
+
+// Maps output elements to elements of an input whose shape is broadcastable
+// to the output shape (column-major).
+struct BroadcastLayout {
+  enum class Kind { Contiguous, Splat, Strided };
+  Kind kind;
+  std::vector<Dim> outDims;
+  // input stride along each output dimension, 0 if broadcast
+  std::vector<Dim> strides;
+  // coordinate along each output dimension wraps around at its period, which
+  // is the output dimension unless the input was tiled along it
+  std::vector<Dim> periods;
+};
+
+BroadcastLayout getBroadcastLayout(const Shape& inShape, const Shape& outShape) {
+  if (inShape.elements() == 1) {
+    return {BroadcastLayout::Kind::Splat, {}, {}, {}};
+  }
+  if (inShape.elements() == outShape.elements()) {
+    return {BroadcastLayout::Kind::Contiguous, {}, {}, {}};
+  }
+  BroadcastLayout layout{BroadcastLayout::Kind::Strided, {}, {}, {}};
+  Dim stride = 1;
+  for (int i = 0; i < outShape.ndim(); i++) {
+    const auto inDim = i < inShape.ndim() ? inShape.dim(i) : 1;
+    layout.outDims.push_back(outShape.dim(i));
+    layout.strides.push_back(inDim == 1 ? 0 : stride);
+    layout.periods.push_back(outShape.dim(i));
+    stride *= inDim;
+  }
+  return layout;
+}
+
+// Maps elements of a view to elements of the (contiguous) input it's taken
+// from, along each dimension of the view.
+struct ViewLayout {
+  std::vector<Dim> dims;
+  std::vector<Dim> strides;
+  std::vector<Dim> periods;
+};
+
+ViewLayout getContiguousLayout(const Shape& shape) {
+  ViewLayout layout;
+  Dim stride = 1;
+  for (int i = 0; i < shape.ndim(); i++) {
+    layout.dims.push_back(shape.dim(i));
+    layout.strides.push_back(stride);
+    layout.periods.push_back(shape.dim(i));
+    stride *= shape.dim(i);
+  }
+  return layout;
+}
+
+// axes of size 1 don't affect addressing
+bool isContiguous(const ViewLayout& layout) {
+  Dim stride = 1;
+  for (unsigned i = 0; i < layout.dims.size(); i++) {
+    if (layout.dims[i] != 1 &&
+        (layout.strides[i] != stride || layout.periods[i] != layout.dims[i])) {
+      return false;
+    }
+    stride *= layout.dims[i];
+  }
+  return true;
+}
+
+std::optional<ViewLayout> reshapeLayout(
+    const ViewLayout& layout,
+    const Shape& shape) {
+  if (isContiguous(layout)) {
+    return getContiguousLayout(shape);
+  }
+  // only axes of size 1 are added or removed
+  ViewLayout reshaped;
+  unsigned oldAxis = 0;
+  for (int i = 0; i < shape.ndim(); i++) {
+    const auto dim = shape.dim(i);
+    reshaped.dims.push_back(dim);
+    if (dim == 1) {
+      reshaped.strides.push_back(0);
+      reshaped.periods.push_back(1);
+      continue;
+    }
+    while (oldAxis < layout.dims.size() && layout.dims[oldAxis] == 1) {
+      oldAxis++;
+    }
+    if (oldAxis == layout.dims.size() || layout.dims[oldAxis] != dim) {
+      return std::nullopt;
+    }
+    reshaped.strides.push_back(layout.strides[oldAxis]);
+    reshaped.periods.push_back(layout.periods[oldAxis]);
+    oldAxis++;
+  }
+  return reshaped;
+}
+
+ViewLayout transposeLayout(const ViewLayout& layout, const Shape& axes) {
+  const unsigned ndim = layout.dims.size();
+  ViewLayout transposed;
+  for (unsigned i = 0; i < ndim; i++) {
+    // default axes reverse all axes
+    const auto oldAxis = axes.ndim() == 0 ? ndim - 1 - i : axes.dim(i);
+    transposed.dims.push_back(layout.dims[oldAxis]);
+    transposed.strides.push_back(layout.strides[oldAxis]);
+    transposed.periods.push_back(layout.periods[oldAxis]);
+  }
+  return transposed;
+}
+
+ViewLayout tileLayout(const ViewLayout& layout, const Shape& tileDims) {
+  const unsigned ndim =
+      std::max<unsigned>(layout.dims.size(), tileDims.ndim());
+  ViewLayout tiled;
+  for (unsigned i = 0; i < ndim; i++) {
+    const auto tileDim = static_cast<int>(i) < tileDims.ndim() ? tileDims.dim(i) : 1;
+    if (i < layout.dims.size()) {
+      // periods of the input divide its dims, so they still hold when tiled
+      tiled.dims.push_back(layout.dims[i] * tileDim);
+      tiled.strides.push_back(layout.strides[i]);
+      tiled.periods.push_back(layout.periods[i]);
+    } else {
+      tiled.dims.push_back(tileDim);
+      tiled.strides.push_back(0);
+      tiled.periods.push_back(1);
+    }
+  }
+  return tiled;
+}
+
+std::optional<ViewLayout> getViewLayout(
+    const Shape& inputShape,
+    const std::vector<ElementwiseKernel::LoadView>& views) {
+  auto layout = getContiguousLayout(inputShape);
+  for (const auto& view : views) {
+    switch (view.type) {
+      case ViewType::Reshape: {
+        auto reshaped = reshapeLayout(layout, view.params);
+        if (!reshaped.has_value()) {
+          return std::nullopt;
+        }
+        layout = std::move(reshaped.value());
+        break;
+      }
+      case ViewType::Transpose:
+        layout = transposeLayout(layout, view.params);
+        break;
+      case ViewType::Tile:
+        layout = tileLayout(layout, view.params);
+        break;
+    }
+  }
+  return layout;
+}
+
+BroadcastLayout getLoadLayout(
+    const Shape& inputShape,
+    const ElementwiseKernel::Instruction& inst,
+    const Shape& outShape) {
+  if (inst.views.empty()) {
+    return getBroadcastLayout(inst.shape, outShape);
+  }
+  // ASSUME the kernel has been checked with `canLoadThrough`
+  const auto viewLayout = getViewLayout(inputShape, inst.views).value();
+  if (isContiguous(viewLayout)) {
+    // e.g., a reshape, which reads the input as if it had the view's shape
+    return getBroadcastLayout(inst.shape, outShape);
+  }
+  BroadcastLayout layout{BroadcastLayout::Kind::Strided, {}, {}, {}};
+  for (int i = 0; i < outShape.ndim(); i++) {
+    layout.outDims.push_back(outShape.dim(i));
+    // axes of size 1 have period 1, so they are broadcast as well
+    if (static_cast<unsigned>(i) < viewLayout.dims.size()) {
+      layout.strides.push_back(viewLayout.strides[i]);
+      layout.periods.push_back(viewLayout.periods[i]);
+    } else {
+      layout.strides.push_back(0);
+      layout.periods.push_back(1);
+    }
+  }
+  return layout;
+}
+
+Tensor applyViewWithBackend(
+    TensorBackend& backend,
+    const ElementwiseKernel::LoadView& view,
+    const Tensor& in) {
+  switch (view.type) {
+    case ViewType::Reshape:
+      return backend.reshape(in, view.params);
+    case ViewType::Transpose:
+      return backend.transpose(in, view.params);
+    case ViewType::Tile:
+      return backend.tile(in, view.params);
+  }
+  throw std::runtime_error(
+      "[ElementwiseKernel::applyViewWithBackend] Unknown view type");
+}
+
+// dst[i] = src[mapped index of (start + i)], for i in [0, n)
+template <typename T>
+void load(
+    const T* src,
+    const BroadcastLayout& layout,
+    const Dim start,
+    const Dim n,
+    T* dst) {
+  switch (layout.kind) {
+    case BroadcastLayout::Kind::Contiguous:
+      std::copy(src + start, src + start + n, dst);
+      return;
+    case BroadcastLayout::Kind::Splat:
+      std::fill(dst, dst + n, src[0]);
+      return;
+    case BroadcastLayout::Kind::Strided:
+      break;
+  }
+  const auto& dims = layout.outDims;
+  const auto& strides = layout.strides;
+  const auto& periods = layout.periods;
+  const auto ndim = dims.size();
+  // coordinate of `start` in the output, its wrapped around coordinate, and
+  // its offset in the input
+  std::vector<Dim> coords(ndim);
+  std::vector<Dim> wrapped(ndim);
+  Dim offset = 0;
+  Dim remainder = start;
+  for (unsigned d = 0; d < ndim; d++) {
+    coords[d] = remainder % dims[d];
+    wrapped[d] = coords[d] % periods[d];
+    remainder /= dims[d];
+    offset += wrapped[d] * strides[d];
+  }
+  for (Dim i = 0; i < n; i++) {
+    dst[i] = src[offset];
+    for (unsigned d = 0; d < ndim; d++) {
+      coords[d]++;
+      wrapped[d]++;
+      offset += strides[d];
+      if (wrapped[d] == periods[d]) {
+        offset -= wrapped[d] * strides[d];
+        wrapped[d] = 0;
+      }
+      if (coords[d] < dims[d]) {
+        break;
+      }
+      offset -= wrapped[d] * strides[d];
+      coords[d] = 0;
+      wrapped[d] = 0;
+    }
+  }
+}
+
+// NOTE the loops below are kept trivially simple so that compilers can
+// auto-vectorize them; dispatching on the op _outside_ the loop is what makes
+// this interpreter cheap.
+template <typename T, typename Func>
+void applyUnary(const T* in, T* out, const Dim n, Func func) {
+  for (Dim i = 0; i < n; i++) {
+    out[i] = func(in[i]);
+  }
+}
+
+template <typename T, typename Func>
+void applyBinary(const T* lhs, const T* rhs, T* out, const Dim n, Func func) {
+  for (Dim i = 0; i < n; i++) {
+    out[i] = func(lhs[i], rhs[i]);
+  }
+}
+
+template <typename T>
+void applyUnaryOp(const UnaryOp op, const T* in, T* out, const Dim n) {
+  switch (op) {
+    case UnaryOp::Exp:
+      return applyUnary(in, out, n, [](T x) { return std::exp(x); });
+    case UnaryOp::Log:
+      return applyUnary(in, out, n, [](T x) { return std::log(x); });
+    case UnaryOp::Negative:
+      return applyUnary(in, out, n, [](T x) { return -x; });
+    case UnaryOp::Log1p:
+      return applyUnary(in, out, n, [](T x) { return std::log1p(x); });
+    case UnaryOp::Sin:
+      return applyUnary(in, out, n, [](T x) { return std::sin(x); });
+    case UnaryOp::Cos:
+      return applyUnary(in, out, n, [](T x) { return std::cos(x); });
+    case UnaryOp::Sqrt:
+      return applyUnary(in, out, n, [](T x) { return std::sqrt(x); });
+    case UnaryOp::Tanh:
+      return applyUnary(in, out, n, [](T x) { return std::tanh(x); });
+    case UnaryOp::Floor:
+      return applyUnary(in, out, n, [](T x) { return std::floor(x); });
+    case UnaryOp::Ceil:
+      return applyUnary(in, out, n, [](T x) { return std::ceil(x); });
+    case UnaryOp::Rint:
+      return applyUnary(in, out, n, [](T x) { return std::rint(x); });
+    case UnaryOp::Absolute:
+      return applyUnary(in, out, n, [](T x) { return std::abs(x); });
+    case UnaryOp::Sigmoid:
+      return applyUnary(
+          in, out, n, [](T x) { return T(1) / (T(1) + std::exp(-x)); });
+    case UnaryOp::Erf:
+      return applyUnary(in, out, n, [](T x) { return std::erf(x); });
+    case UnaryOp::Sign:
+      return applyUnary(
+          in, out, n, [](T x) { return static_cast<T>((0 < x) - (x < 0)); });
+    case UnaryOp::LogicalNot:
+    case UnaryOp::IsNan:
+    case UnaryOp::IsInf:
+      break;
+  }
+  throw std::runtime_error(
+      "[ElementwiseKernel::applyUnaryOp] Unsupported unary operation type");
+}
+
+template <typename T>
+void applyBinaryOp(
+    const BinaryOp op,
+    const T* lhs,
+    const T* rhs,
+    T* out,
+    const Dim n) {
+  switch (op) {
+    case BinaryOp::Add:
+      return applyBinary(lhs, rhs, out, n, [](T l, T r) { return l + r; });
+    case BinaryOp::Sub:
+      return applyBinary(lhs, rhs, out, n, [](T l, T r) { return l - r; });
+    case BinaryOp::Mul:
+      return applyBinary(lhs, rhs, out, n, [](T l, T r) { return l * r; });
+    case BinaryOp::Div:
+      return applyBinary(lhs, rhs, out, n, [](T l, T r) { return l / r; });
+    case BinaryOp::Min:
+      return applyBinary(
+          lhs, rhs, out, n, [](T l, T r) { return std::min(l, r); });
+    case BinaryOp::Max:
+      return applyBinary(
+          lhs, rhs, out, n, [](T l, T r) { return std::max(l, r); });
+    case BinaryOp::Pow:
+      return applyBinary(
+          lhs, rhs, out, n, [](T l, T r) { return std::pow(l, r); });
+    default:
+      break;
+  }
+  throw std::runtime_error(
+      "[ElementwiseKernel::applyBinaryOp] Unsupported binary operation type");
+}
+
+Tensor applyUnaryOpWithBackend(
+    TensorBackend& backend,
+    const UnaryOp op,
+    const Tensor& in) {
+  switch (op) {
+    case UnaryOp::Exp:
+      return backend.exp(in);
+    case UnaryOp::Log:
+      return backend.log(in);
+    case UnaryOp::Negative:
+      return backend.negative(in);
+    case UnaryOp::Log1p:
+      return backend.log1p(in);
+    case UnaryOp::Sin:
+      return backend.sin(in);
+    case UnaryOp::Cos:
+      return backend.cos(in);
+    case UnaryOp::Sqrt:
+      return backend.sqrt(in);
+    case UnaryOp::Tanh:
+      return backend.tanh(in);
+    case UnaryOp::Floor:
+      return backend.floor(in);
+    case UnaryOp::Ceil:
+      return backend.ceil(in);
+    case UnaryOp::Rint:
+      return backend.rint(in);
+    case UnaryOp::Absolute:
+      return backend.absolute(in);
+    case UnaryOp::Sigmoid:
+      return backend.sigmoid(in);
+    case UnaryOp::Erf:
+      return backend.erf(in);
+    case UnaryOp::Sign:
+      return backend.sign(in);
+    case UnaryOp::LogicalNot:
+    case UnaryOp::IsNan:
+    case UnaryOp::IsInf:
+      break;
+  }
+  throw std::runtime_error(
+      "[ElementwiseKernel::applyUnaryOpWithBackend] Unsupported unary operation type");
+}
+
+Tensor applyBinaryOpWithBackend(
+    TensorBackend& backend,
+    const BinaryOp op,
+    const Tensor& lhs,
+    const Tensor& rhs) {
+  switch (op) {
+    case BinaryOp::Add:
+      return backend.add(lhs, rhs);
+    case BinaryOp::Sub:
+      return backend.sub(lhs, rhs);
+    case BinaryOp::Mul:
+      return backend.mul(lhs, rhs);
+    case BinaryOp::Div:
+      return backend.div(lhs, rhs);
+    case BinaryOp::Min:
+      return backend.minimum(lhs, rhs);
+    case BinaryOp::Max:
+      return backend.maximum(lhs, rhs);
+    case BinaryOp::Pow:
+      return backend.power(lhs, rhs);
+    default:
+      break;
+  }
+  throw std::runtime_error(
+      "[ElementwiseKernel::applyBinaryOpWithBackend] Unsupported binary operation type");
+}
+
+bool isFloatingPoint(const dtype type) {
+  return type == dtype::f32 || type == dtype::f64;
+}
+
+bool isIntegral(const dtype type) {
+  switch (type) {
+    case dtype::b8:
+    case dtype::s16:
+    case dtype::s32:
+    case dtype::s64:
+    case dtype::u8:
+    case dtype::u16:
+    case dtype::u32:
+    case dtype::u64:
+      return true;
+    case dtype::f16:
+    case dtype::bf16:
+    case dtype::f32:
+    case dtype::f64:
+      return false;
+  }
+  throw std::runtime_error("[ElementwiseKernel::isIntegral] Unknown dtype");
+}
+
+// The type native execution computes in, if it can run natively at all, i.e.:
+// 1. all inputs are host-resident & contiguous and share the same f32/f64 type
+// 2. constants either share that type or are integral (backends promote
+//    integral scalars to the floating point type of the other operand)
+std::optional<dtype> getNativeType(
+    const std::vector<const Tensor*>& inputs,
+    const std::vector<ScalarNodePtr>& constants) {
+  if (inputs.empty()) {
+    return std::nullopt;
+  }
+  const auto type = inputs.front()->type();
+  if (!isFloatingPoint(type)) {
+    return std::nullopt;
+  }
+  for (const auto* input : inputs) {
+    if (input->type() != type || input->location() != Location::Host ||
+        !input->isContiguous()) {
+      return std::nullopt;
+    }
+  }
+  for (const auto& constant : constants) {
+    const auto constantType = constant->dataType();
+    if (constantType != type && !isIntegral(constantType)) {
+      return std::nullopt;
+    }
+  }
+  return type;
+}
+
+} // namespace
+
+ElementwiseKernel::ElementwiseKernel(
+    std::vector<Instruction>&& instructions,
+    const Shape& shape)
+    : instructions_(std::move(instructions)),
+      shape_(shape),
+      signature_(signatureOf(instructions_, shape_)) {
+  if (instructions_.empty()) {
+    throw std::invalid_argument(
+        "[ElementwiseKernel::ElementwiseKernel] Kernel has no instructions");
+  }
+  // index of the last instruction that reads each instruction's result
+  const unsigned numInsts = instructions_.size();
+  std::vector<unsigned> lastUse(numInsts, 0);
+  for (unsigned i = 0; i < numInsts; i++) {
+    const auto& inst = instructions_[i];
+    if (inst.opCode == OpCode::Load && !inst.views.empty() &&
+        std::find(
+            viewedInputIdxs_.begin(),
+            viewedInputIdxs_.end(),
+            inst.operandIdx) == viewedInputIdxs_.end()) {
+      viewedInputIdxs_.push_back(inst.operandIdx);
+    }
+    if (inst.opCode == OpCode::Unary || inst.opCode == OpCode::Binary) {
+      if (inst.lhs >= i || (inst.opCode == OpCode::Binary && inst.rhs >= i)) {
+        throw std::invalid_argument(
+            "[ElementwiseKernel::ElementwiseKernel] Instructions must be in topological order");
+      }
+      lastUse[inst.lhs] = i;
+      if (inst.opCode == OpCode::Binary) {
+        lastUse[inst.rhs] = i;
+      }
+    }
+  }
+  // linear scan register allocation -- operands whose last use is the current
+  // instruction are released first, so the result can overwrite them in place.
+  instToReg_.resize(numInsts);
+  std::vector<unsigned> freeRegs;
+  for (unsigned i = 0; i < numInsts; i++) {
+    const auto& inst = instructions_[i];
+    auto release = [&](unsigned operand) {
+      if (lastUse[operand] == i &&
+          std::find(freeRegs.begin(), freeRegs.end(), instToReg_[operand]) ==
+              freeRegs.end()) {
+        freeRegs.push_back(instToReg_[operand]);
+      }
+    };
+    if (inst.opCode == OpCode::Unary || inst.opCode == OpCode::Binary) {
+      release(inst.lhs);
+      if (inst.opCode == OpCode::Binary) {
+        release(inst.rhs);
+      }
+    }
+    if (freeRegs.empty()) {
+      instToReg_[i] = numRegisters_++;
+    } else {
+      instToReg_[i] = freeRegs.back();
+      freeRegs.pop_back();
+    }
+  }
+}
+
+std::string ElementwiseKernel::signatureOf(
+    const std::vector<Instruction>& instructions,
+    const Shape& shape) {
+  std::ostringstream oss;
+  oss << shape << ":";
+  for (const auto& inst : instructions) {
+    switch (inst.opCode) {
+      case OpCode::Load:
+        oss << "L" << inst.operandIdx << inst.shape;
+        for (const auto& view : inst.views) {
+          oss << "v" << static_cast<int>(view.type) << view.params;
+        }
+        break;
+      case OpCode::Constant:
+        oss << "C" << inst.operandIdx << inst.shape;
+        break;
+      case OpCode::Unary:
+        oss << "U" << static_cast<int>(inst.unop) << "(" << inst.lhs << ")";
+        break;
+      case OpCode::Binary:
+        oss << "B" << static_cast<int>(inst.binop) << "(" << inst.lhs << ","
+            << inst.rhs << ")";
+        break;
+    }
+    oss << ";";
+  }
+  return oss.str();
+}
+
+bool ElementwiseKernel::canLoadThrough(
+    const Shape& inputShape,
+    const std::vector<LoadView>& views) {
+  return getViewLayout(inputShape, views).has_value();
+}
+
+const std::vector<ElementwiseKernel::Instruction>&
+ElementwiseKernel::instructions() const {
+  return instructions_;
+}
+
+const Shape& ElementwiseKernel::shape() const {
+  return shape_;
+}
+
+const std::string& ElementwiseKernel::signature() const {
+  return signature_;
+}
+
+unsigned ElementwiseKernel::numRegisters() const {
+  return numRegisters_;
+}
+
+Tensor ElementwiseKernel::run(
+    const std::vector<const Tensor*>& inputs,
+    const std::vector<ScalarNodePtr>& constants,
+    TensorBackend& backend) const {
+  return runInPlace(inputs, constants, backend, {}).first;
+}
+
+std::pair<Tensor, std::optional<unsigned>> ElementwiseKernel::runInPlace(
+    const std::vector<const Tensor*>& inputs,
+    const std::vector<ScalarNodePtr>& constants,
+    TensorBackend& backend,
+    const std::vector<unsigned>& donatedInputIdxs) const {
+  if (shape_.elements() > 0) {
+    const auto nativeType = getNativeType(inputs, constants);
+    if (nativeType.has_value()) {
+      // native inputs share the output type, and each block of the output is
+      // written after the corresponding block of every input has been read.
+      std::optional<unsigned> outputInputIdx;
+      for (const auto idx : donatedInputIdxs) {
+        // elements read through a view may be read after the output element
+        // at the same position has been written
+        if (inputs.at(idx)->shape() == shape_ &&
+            std::find(
+                viewedInputIdxs_.begin(), viewedInputIdxs_.end(), idx) ==
+                viewedInputIdxs_.end()) {
+          outputInputIdx = idx;
+          break;
+        }
+      }
+      if (nativeType == dtype::f32) {
+        return {
+            runNative<float>(inputs, constants, backend, outputInputIdx),
+            outputInputIdx};
+      } else if (nativeType == dtype::f64) {
+        return {
+            runNative<double>(inputs, constants, backend, outputInputIdx),
+            outputInputIdx};
+      }
+    }
+  }
+  return {runWithBackend(inputs, constants, backend), std::nullopt};
+}
+
+template <typename T>
+Tensor ElementwiseKernel::runNative(
+    const std::vector<const Tensor*>& inputs,
+    const std::vector<ScalarNodePtr>& constants,
+    TensorBackend& backend,
+    std::optional<unsigned> outputInputIdx) const {
+  // resolve operands once, outside of the loop nest
+  std::vector<const T*> inputData;
+  for (const auto* input : inputs) {
+    inputData.push_back(input->device<T>());
+  }
+  std::vector<BroadcastLayout> layouts(instructions_.size());
+  std::vector<T> constantValues(instructions_.size());
+  for (unsigned i = 0; i < instructions_.size(); i++) {
+    const auto& inst = instructions_[i];
+    if (inst.opCode == OpCode::Load) {
+      layouts[i] =
+          getLoadLayout(inputs.at(inst.operandIdx)->shape(), inst, shape_);
+    } else if (inst.opCode == OpCode::Constant) {
+      constantValues[i] = constants.at(inst.operandIdx)->scalar<T>();
+    }
+  }
+
+  Tensor result = outputInputIdx.has_value()
+      ? inputs[outputInputIdx.value()]
+            ->getAdapter<TensorAdapterBase>()
+            .shallowCopy()
+      : backend.full(shape_, 0, dtype_traits<T>::fl_type);
+  T* resultData = result.device<T>();
+  std::vector<T> registers(numRegisters_ * kBlockSize);
+  auto regData = [&](unsigned instIdx) {
+    return registers.data() + instToReg_[instIdx] * kBlockSize;
+  };
+
+  const Dim numElements = shape_.elements();
+  for (Dim start = 0; start < numElements; start += kBlockSize) {
+    const Dim n = std::min(kBlockSize, numElements - start);
+    for (unsigned i = 0; i < instructions_.size(); i++) {
+      const auto& inst = instructions_[i];
+      T* dst = regData(i);
+      switch (inst.opCode) {
+        case OpCode::Load:
+          load(inputData[inst.operandIdx], layouts[i], start, n, dst);
+          break;
+        case OpCode::Constant:
+          std::fill(dst, dst + n, constantValues[i]);
+          break;
+        case OpCode::Unary:
+          applyUnaryOp(inst.unop, regData(inst.lhs), dst, n);
+          break;
+        case OpCode::Binary:
+          applyBinaryOp(inst.binop, regData(inst.lhs), regData(inst.rhs), dst, n);
+          break;
+      }
+    }
+    const T* out = regData(instructions_.size() - 1);
+    std::copy(out, out + n, resultData + start);
+  }
+
+  result.unlock();
+  for (const auto* input : inputs) {
+    input->unlock();
+  }
+  return result;
+}
+
+Tensor ElementwiseKernel::runWithBackend(
+    const std::vector<const Tensor*>& inputs,
+    const std::vector<ScalarNodePtr>& constants,
+    TensorBackend& backend) const {
+  std::vector<std::optional<Tensor>> results(instructions_.size());
+  auto resultOf = [&](unsigned instIdx) -> const Tensor& {
+    const auto& inst = instructions_[instIdx];
+    if (inst.opCode == OpCode::Load && inst.views.empty()) {
+      return *inputs.at(inst.operandIdx);
+    }
+    return results[instIdx].value();
+  };
+  for (unsigned i = 0; i < instructions_.size(); i++) {
+    const auto& inst = instructions_[i];
+    switch (inst.opCode) {
+      case OpCode::Load: {
+        // materialize the view, like node-by-node evaluation would
+        if (inst.views.empty()) {
+          break;
+        }
+        Tensor viewed = applyViewWithBackend(
+            backend, inst.views.front(), *inputs.at(inst.operandIdx));
+        for (unsigned j = 1; j < inst.views.size(); j++) {
+          viewed = applyViewWithBackend(backend, inst.views[j], viewed);
+        }
+        results[i] = std::move(viewed);
+        break;
+      }
+      case OpCode::Constant: {
+        const auto& constant = constants.at(inst.operandIdx);
+        const auto type = constant->dataType();
+        if (type == dtype::u64) {
+          results[i] = backend.full(
+              inst.shape, constant->scalar<unsigned long long>(), type);
+        } else if (isIntegral(type)) {
+          results[i] =
+              backend.full(inst.shape, constant->scalar<long long>(), type);
+        } else {
+          results[i] = backend.full(inst.shape, constant->scalar<double>(), type);
+        }
+        break;
+      }
+      case OpCode::Unary:
+        results[i] =
+            applyUnaryOpWithBackend(backend, inst.unop, resultOf(inst.lhs));
+        break;
+      case OpCode::Binary:
+        results[i] = applyBinaryOpWithBackend(
+            backend, inst.binop, resultOf(inst.lhs), resultOf(inst.rhs));
+        break;
+    }
+  }
+  return resultOf(instructions_.size() - 1);
+}
+
+} // namespace fl
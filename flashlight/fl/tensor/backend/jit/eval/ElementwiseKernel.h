@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/TensorBackend.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
+
+namespace fl {
+
+/**
+ * A fused element-wise kernel, i.e., a tree of element-wise (and implicitly
+ * broadcasting) ops lowered into a flat instruction sequence.
+ *
+ * Running the kernel on host-resident, contiguous f32/f64 inputs executes the
+ * whole sequence in a single loop nest over small, fixed-size blocks of the
+ * output, so every input is read once and the output is written once no
+ * matter how many ops were fused. All other cases dispatch each instruction to
+ * the given backend, which matches node-by-node evaluation.
+ *
+ * Inputs may be read through views (see `ViewNode`), e.g., a tiled mask is
+ * read with a stride of 0 along the tiled axes rather than being materialized.
+ *
+ * A kernel only depends on the _structure_ of the tree it was lowered from
+ * (see `signature()`), scalar values and input tensors are supplied at run
+ * time; this allows kernels to be cached & shared across JIT graphs.
+ */
+class ElementwiseKernel {
+ public:
+  enum class OpCode {
+    Load, // read `inputs[operandIdx]` through `views` (broadcast to output)
+    Constant, // splat `constants[operandIdx]`
+    Unary, // unop(lhs)
+    Binary, // binop(lhs, rhs)
+  };
+
+  // a view applied to an input as it's read
+  struct LoadView {
+    ViewType type;
+    // same as `ViewNode::params()`
+    Shape params;
+  };
+
+  struct Instruction {
+    OpCode opCode;
+    // index into kernel inputs (Load) or constants (Constant)
+    unsigned operandIdx{0};
+    // indices of earlier instructions (Unary only uses lhs)
+    unsigned lhs{0};
+    unsigned rhs{0};
+    UnaryOp unop{UnaryOp::Exp};
+    BinaryOp binop{BinaryOp::Add};
+    // applied in order to the input (Load only)
+    std::vector<LoadView> views;
+    // shape of the instruction's result
+    Shape shape;
+  };
+
+ private:
+  const std::vector<Instruction> instructions_;
+  const Shape shape_;
+  const std::string signature_;
+  // instruction index -> register index, registers are reused once dead
+  std::vector<unsigned> instToReg_;
+  unsigned numRegisters_{0};
+  // inputs read through a view, i.e., not element-wise aligned with output
+  std::vector<unsigned> viewedInputIdxs_;
+
+  // writes result into `inputs[outputInputIdx]` if present
+  template <typename T>
+  Tensor runNative(
+      const std::vector<const Tensor*>& inputs,
+      const std::vector<ScalarNodePtr>& constants,
+      TensorBackend& backend,
+      std::optional<unsigned> outputInputIdx) const;
+
+  Tensor runWithBackend(
+      const std::vector<const Tensor*>& inputs,
+      const std::vector<ScalarNodePtr>& constants,
+      TensorBackend& backend) const;
+
+ public:
+  /**
+   * Build a kernel from instructions, whose last instruction is the result.
+   *
+   * @param[in] instructions in topological order, i.e., operands of an
+   * instruction must come before it.
+   * @param[in] shape the output shape of the kernel.
+   */
+  ElementwiseKernel(std::vector<Instruction>&& instructions, const Shape& shape);
+
+  /**
+   * Returns a string that uniquely identifies the instructions & shapes of the
+   * kernel, suitable as a cache key.
+   */
+  static std::string signatureOf(
+      const std::vector<Instruction>& instructions,
+      const Shape& shape);
+
+  /**
+   * Returns true if the kernel can read an input of `inputShape` through
+   * `views` directly, i.e., each output element maps to an input element by
+   * strides (0 for broadcast axes), possibly wrapped around for tiled axes.
+   * Reshapes are only supported on contiguous layouts, or if they only add or
+   * remove axes of size 1.
+   */
+  static bool canLoadThrough(
+      const Shape& inputShape,
+      const std::vector<LoadView>& views);
+
+  const std::vector<Instruction>& instructions() const;
+  const Shape& shape() const;
+  const std::string& signature() const;
+  unsigned numRegisters() const;
+
+  /**
+   * Execute the kernel.
+   *
+   * @param[in] inputs tensors referred to by Load instructions.
+   * @param[in] constants scalars referred to by Constant instructions.
+   * @param[in] backend used for output allocation & as the fallback executor.
+   * @return the result of the last instruction.
+   */
+  Tensor run(
+      const std::vector<const Tensor*>& inputs,
+      const std::vector<ScalarNodePtr>& constants,
+      TensorBackend& backend) const;
+
+  /**
+   * Same as above, but the result may be written into the buffer of one of
+   * the donated inputs, i.e., inputs no one else will read afterwards. Only
+   * the native path does so, for inputs of the output's shape & type that
+   * aren't read through views.
+   *
+   * @param[in] donatedInputIdxs indices into `inputs` whose buffers may be
+   * overwritten.
+   * @return the result, and the index of the input whose buffer it reuses.
+   */
+  std::pair<Tensor, std::optional<unsigned>> runInPlace(
+      const std::vector<const Tensor*>& inputs,
+      const std::vector<ScalarNodePtr>& constants,
+      TensorBackend& backend,
+      const std::vector<unsigned>& donatedInputIdxs) const;
+};
+
+} // namespace fl
@@ -7,37 +7,42 @@
 
 #include "flashlight/fl/tensor/backend/jit/eval/Evaluator.h"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <functional>
-#include <queue>
 
+#include "flashlight/fl/tensor/TensorAdapter.h"
 #include "flashlight/fl/tensor/backend/jit/JitTensorBase.h"
+#include "flashlight/fl/tensor/backend/jit/eval/Scheduler.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
 
 namespace fl {
 
 namespace {
 
-// Build a map from each node in the tree to the # of its current uses
-// (including external use).
-std::unordered_map<NodePtr, unsigned> getNodeToUseCountInTree(NodePtr root) {
-  auto getUseCount = [](NodePtr node) {
-    return node->uses().size() + node->externalUses().size();
-  };
-  std::unordered_map<NodePtr, unsigned> nodeToUseCount{
-      {root, getUseCount(root)}};
-  std::queue<NodePtr> worklist({root}); // nodes to be visited
-  while (!worklist.empty()) {
-    NodePtr node = worklist.front();
-    worklist.pop();
-    for (const auto& input : node->inputs()) {
-      if (nodeToUseCount.find(input) == nodeToUseCount.end()) {
-        worklist.push(input);
-        nodeToUseCount.emplace(input, getUseCount(input));
-      }
-    }
+// Whether `node`'s result is a buffer of its own, rather than a view of (or a
+// lazy expression over) its inputs that'd be affected by overwriting them.
+bool ownsResultBuffer(const NodePtr& node) {
+  switch (node->type()) {
+    case NodeType::Binary:
+    case NodeType::IndexedUpdate:
+    case NodeType::Matmul:
+    case NodeType::Reduction:
+    case NodeType::Scalar:
+    case NodeType::Unary:
+      return true;
+    // opaque logic may return (a view of) an input as is
+    case NodeType::Custom:
+      return node->impl<CustomNode>().supportsInPlace();
+    // views, or owned by someone else
+    case NodeType::Index:
+    case NodeType::Value:
+    case NodeType::View:
+      return false;
   }
-  return nodeToUseCount;
+  throw std::runtime_error("[ownsResultBuffer] Unknown node type");
 }
 
 } // namespace
@@ -49,13 +54,25 @@ void Evaluator::profile(std::function<void()> func, NodePtr nodePtr) {
     func();
     return;
   }
-  const auto start = std::chrono::high_resolution_clock::now();
+  using Micros = std::chrono::duration<double, std::micro>;
+  const auto start = std::chrono::steady_clock::now();
   func();
-  const auto end = std::chrono::high_resolution_clock::now();
+  const auto end = std::chrono::steady_clock::now();
   const auto durNs =
       std::chrono::duration_cast<std::chrono::duration<float>>(end - start)
           .count();
+  NodeTrace trace;
+  trace.startUs = Micros(start.time_since_epoch()).count();
+  trace.durationUs = Micros(end - start).count();
+  // inputs haven't been released yet
+  for (const auto& input : nodePtr->inputs()) {
+    trace.inputBytes += input->getResult()->bytes();
+  }
+  trace.outputBytes = nodePtr->getResult()->bytes();
+  trace.threadId = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(stateMutex_);
   nodeToTotTimeMs_.insert({nodePtr, durNs * 1000});
+  nodeToTrace_.insert({nodePtr, trace});
 }
 
 void Evaluator::evalBinaryNode(BinaryNodePtr node) {
@@ -69,13 +86,32 @@ void Evaluator::evalBinaryNode(BinaryNodePtr node) {
 
 void Evaluator::evalCustomNode(CustomNodePtr node) {
   std::vector<const Tensor*> inputTensors;
-  for (auto& inputNode : node->inputs()) {
+  std::vector<unsigned> donatedInputIdxs;
+  for (unsigned i = 0; i < node->inputs().size(); i++) {
+    const auto& inputNode = node->inputs()[i];
     inputTensors.push_back(&inputNode->getResult().value());
+    if (node->supportsInPlace() && isDonatable(inputNode, node)) {
+      donatedInputIdxs.push_back(i);
+    }
   }
-  std::function<void()> func = [node, inputTensors = std::move(inputTensors)] {
-    node->setResult(node->evalFunc()(inputTensors));
+  std::optional<unsigned> reusedInputIdx;
+  std::function<void()> func = [node,
+                                &reusedInputIdx,
+                                &donatedInputIdxs,
+                                inputTensors = std::move(inputTensors)] {
+    if (node->supportsInPlace()) {
+      auto [result, reusedIdx] =
+          node->inPlaceEvalFunc()(inputTensors, donatedInputIdxs);
+      reusedInputIdx = reusedIdx;
+      node->setResult(std::move(result));
+    } else {
+      node->setResult(node->evalFunc()(inputTensors));
+    }
   };
   profile(func, node);
+  if (reusedInputIdx.has_value()) {
+    trackInPlaceResult(node, node->inputs().at(reusedInputIdx.value()));
+  }
 }
 
 void Evaluator::evalIndexNode(IndexNodePtr node) {
@@ -87,9 +123,15 @@ void Evaluator::evalIndexNode(IndexNodePtr node) {
 }
 
 void Evaluator::evalIndexedUpdateNode(IndexedUpdateNodePtr node) {
-  // TODO no need to copy if indexedNode has only 1 user here
-  std::function<void()> func = [this, node]() {
-    auto indexedTensor = node->indexedNode()->getResult().value().copy();
+  // no need to copy if no one else reads the indexed tensor afterwards, as
+  // long as it's not also the update data (e.g., `x(0) = x`).
+  const bool inPlace = node->indexedNode() != node->updateDataNode() &&
+      isDonatable(node->indexedNode(), node);
+  std::function<void()> func = [this, node, inPlace]() {
+    const auto& indexedResult = node->indexedNode()->getResult().value();
+    auto indexedTensor = inPlace
+        ? indexedResult.getAdapter<TensorAdapterBase>().shallowCopy()
+        : indexedResult.copy();
     const auto firstUnwrappedIndices =
         unwrapTensorInIndices(node->indexings().front());
     const auto& updateDataTensor = node->updateDataNode()->getResult().value();
@@ -110,6 +152,19 @@ void Evaluator::evalIndexedUpdateNode(IndexedUpdateNodePtr node) {
     node->setResult(std::move(indexedTensor));
   };
   profile(func, node);
+  if (inPlace) {
+    trackInPlaceResult(node, node->indexedNode());
+  }
+}
+
+void Evaluator::evalMatmulNode(MatmulNodePtr node) {
+  std::function<void()> func = [this, node] {
+    const auto& lhs = node->lhs()->getResult().value();
+    const auto& rhs = node->rhs()->getResult().value();
+    node->setResult(
+        backend_.matmul(lhs, rhs, node->lhsProp(), node->rhsProp()));
+  };
+  profile(func, node);
 }
 
 std::vector<Index> Evaluator::unwrapTensorInIndices(
@@ -131,6 +186,43 @@ void Evaluator::evalScalarNode(ScalarNodePtr node) {
   profile(func, node);
 }
 
+void Evaluator::evalUnaryNode(UnaryNodePtr node) {
+  std::function<void()> func = [this, node] {
+    const auto& input = node->input()->getResult().value();
+    node->setResult(evalUnaryOp(node->op(), input));
+  };
+  profile(func, node);
+}
+
+void Evaluator::evalReductionNode(ReductionNodePtr node) {
+  std::function<void()> func = [this, node] {
+    const auto& input = node->input()->getResult().value();
+    node->setResult(
+        evalReductionOp(node->op(), input, node->axes(), node->keepDims()));
+  };
+  profile(func, node);
+}
+
+void Evaluator::evalViewNode(ViewNodePtr node) {
+  std::function<void()> func = [this, node] {
+    const auto& input = node->input()->getResult().value();
+    node->setResult(evalViewOp(node, input));
+  };
+  profile(func, node);
+}
+
+Tensor Evaluator::evalViewOp(ViewNodePtr node, const Tensor& input) {
+  switch (node->viewType()) {
+    case ViewType::Reshape:
+      return backend_.reshape(input, node->params());
+    case ViewType::Transpose:
+      return backend_.transpose(input, node->params());
+    case ViewType::Tile:
+      return backend_.tile(input, node->params());
+  }
+  throw std::runtime_error("[Evaluator::evalViewOp] Unknown view type");
+}
+
 Tensor
 Evaluator::evalBinaryOp(BinaryOp op, const Tensor& lhs, const Tensor& rhs) {
   switch (op) {
@@ -181,11 +273,74 @@ Evaluator::evalBinaryOp(BinaryOp op, const Tensor& lhs, const Tensor& rhs) {
       "[Evaluator::evalBinaryOp] Unknown binary operation type");
 }
 
+Tensor Evaluator::evalUnaryOp(UnaryOp op, const Tensor& input) {
+  switch (op) {
+    case UnaryOp::Exp:
+      return backend_.exp(input);
+    case UnaryOp::Log:
+      return backend_.log(input);
+    case UnaryOp::Negative:
+      return backend_.negative(input);
+    case UnaryOp::LogicalNot:
+      return backend_.logicalNot(input);
+    case UnaryOp::Log1p:
+      return backend_.log1p(input);
+    case UnaryOp::Sin:
+      return backend_.sin(input);
+    case UnaryOp::Cos:
+      return backend_.cos(input);
+    case UnaryOp::Sqrt:
+      return backend_.sqrt(input);
+    case UnaryOp::Tanh:
+      return backend_.tanh(input);
+    case UnaryOp::Floor:
+      return backend_.floor(input);
+    case UnaryOp::Ceil:
+      return backend_.ceil(input);
+    case UnaryOp::Rint:
+      return backend_.rint(input);
+    case UnaryOp::Absolute:
+      return backend_.absolute(input);
+    case UnaryOp::Sigmoid:
+      return backend_.sigmoid(input);
+    case UnaryOp::Erf:
+      return backend_.erf(input);
+    case UnaryOp::IsNan:
+      return backend_.isnan(input);
+    case UnaryOp::IsInf:
+      return backend_.isinf(input);
+    case UnaryOp::Sign:
+      return backend_.sign(input);
+  }
+  throw std::runtime_error(
+      "[Evaluator::evalUnaryOp] Unknown unary operation type");
+}
+
+Tensor Evaluator::evalReductionOp(
+    ReductionOp op,
+    const Tensor& input,
+    const std::vector<int>& axes,
+    bool keepDims) {
+  switch (op) {
+    case ReductionOp::Min:
+      return backend_.amin(input, axes, keepDims);
+    case ReductionOp::Max:
+      return backend_.amax(input, axes, keepDims);
+    case ReductionOp::Sum:
+      return backend_.sum(input, axes, keepDims);
+    case ReductionOp::Mean:
+      return backend_.mean(input, axes, keepDims);
+  }
+  throw std::runtime_error(
+      "[Evaluator::evalReductionOp] Unknown reduction operation type");
+}
+
 Tensor Evaluator::evalScalar(ScalarNodePtr node) {
   const Shape& shape = node->shape();
   const auto dtype = node->dataType();
   switch (dtype) {
     case dtype::f16:
+    case dtype::bf16:
     case dtype::f32:
     case dtype::f64:
       return backend_.full(shape, node->scalar<double>(), dtype);
@@ -213,41 +368,191 @@ void Evaluator::evalNodeDispatch(NodePtr node) {
       return evalIndexNode(Node::cast<IndexNodePtr>(node));
     case NodeType::IndexedUpdate:
       return evalIndexedUpdateNode(Node::cast<IndexedUpdateNodePtr>(node));
+    case NodeType::Matmul:
+      return evalMatmulNode(Node::cast<MatmulNodePtr>(node));
     case NodeType::Scalar:
       return evalScalarNode(Node::cast<ScalarNodePtr>(node));
+    case NodeType::Unary:
+      return evalUnaryNode(Node::cast<UnaryNodePtr>(node));
+    case NodeType::Reduction:
+      return evalReductionNode(Node::cast<ReductionNodePtr>(node));
     case NodeType::Value:
       return; // already has a result
+    case NodeType::View:
+      return evalViewNode(Node::cast<ViewNodePtr>(node));
   }
   throw std::runtime_error("[Evaluator::evalNodeDispatch] Unknown node type");
 }
 
-void Evaluator::evalNode(NodePtr node) {
-  if (!node->getResult().has_value()) {
-    for (const auto& input : node->inputs()) {
-      evalNode(input);
-    }
-    evalNodeDispatch(node);
-    for (const auto& input : node->inputs()) {
-      auto& count = nodeToResultUseCount_.at(input);
-      count--;
-      if (count == 0 && !input->isValue()) {
-        // This helps reduce memory footprint during evaluation, allowing the
-        // result tensor memory to be reused. This has a non-trivial performance
-        // impact on graph with high intermediate tensor memory usage.
-        input->unsetResult();
+bool Evaluator::isDonatable(NodePtr input, NodePtr user) {
+  std::lock_guard<std::mutex> lock(stateMutex_);
+  // only intermediate results produced by this evaluation, so no one outside
+  // could've obtained a reference to them
+  if (nodeToLiveBytes_.count(input) == 0 || !input->externalUses().empty() ||
+      !ownsResultBuffer(input)) {
+    return false;
+  }
+  // other users may have taken a view of the result, even if they have been
+  // evaluated already
+  return std::all_of(
+      input->uses().begin(), input->uses().end(), [&user](const auto& use) {
+        return &use->user() == user.get();
+      });
+}
+
+void Evaluator::trackInPlaceResult(NodePtr node, NodePtr donor) {
+  // the buffer now belongs to `node`
+  std::lock_guard<std::mutex> lock(stateMutex_);
+  const auto donorIter = nodeToLiveBytes_.find(donor);
+  nodeToLiveBytes_.emplace(node, donorIter->second);
+  nodeToLiveBytes_.erase(donorIter);
+  memoryStats_.numInPlaceEvals++;
+}
+
+void Evaluator::trackResult(NodePtr node) {
+  std::lock_guard<std::mutex> lock(stateMutex_);
+  if (nodeToLiveBytes_.count(node) == 0) {
+    const auto bytes = node->getResult()->bytes();
+    nodeToLiveBytes_.emplace(node, bytes);
+    liveBytes_ += bytes;
+  }
+  // inputs are still alive at this point
+  memoryStats_.peakIntermediateBytes =
+      std::max(memoryStats_.peakIntermediateBytes, liveBytes_);
+}
+
+void Evaluator::releaseInputResults(NodePtr node) {
+  std::lock_guard<std::mutex> lock(stateMutex_);
+  for (const auto& input : node->inputs()) {
+    auto& count = nodeToResultUseCount_.at(input);
+    count--;
+    if (count == 0 && !input->isValue()) {
+      // This helps reduce memory footprint during evaluation, allowing the
+      // result tensor memory to be reused. This has a non-trivial performance
+      // impact on graph with high intermediate tensor memory usage.
+      input->unsetResult();
+      const auto iter = nodeToLiveBytes_.find(input);
+      if (iter != nodeToLiveBytes_.end()) {
+        liveBytes_ -= iter->second;
+        nodeToLiveBytes_.erase(iter);
       }
     }
   }
 }
 
-void Evaluator::eval(NodePtr node) {
-  nodeToResultUseCount_ = getNodeToUseCountInTree(node);
-  evalNode(node);
+void Evaluator::runPostEvalCallbacks(NodePtr node) {
   for (const auto& callback : postEvalCallbacks_) {
     callback(node, nodeToTotTimeMs_);
   }
   nodeToTotTimeMs_.clear();
+  nodeToTrace_.clear();
   nodeToResultUseCount_.clear();
+  nodeToLiveBytes_.clear();
+  liveBytes_ = 0;
+}
+
+void Evaluator::eval(NodePtr node) {
+  eval(node, getEvaluationSchedule(node));
+}
+
+void Evaluator::eval(NodePtr node, const std::vector<NodePtr>& schedule) {
+  if (schedule.empty()) {
+    return eval(node);
+  }
+  memoryStats_ = MemoryStats();
+  for (const auto& scheduledNode : schedule) {
+    nodeToResultUseCount_.emplace(
+        scheduledNode,
+        scheduledNode->uses().size() + scheduledNode->externalUses().size());
+  }
+  if (maxParallelism_ > 1) {
+    evalParallel(schedule);
+  } else {
+    for (const auto& scheduledNode : schedule) {
+      if (!scheduledNode->getResult().has_value()) {
+        evalNodeDispatch(scheduledNode);
+        trackResult(scheduledNode);
+        releaseInputResults(scheduledNode);
+      }
+    }
+  }
+  runPostEvalCallbacks(node);
+}
+
+void Evaluator::evalParallel(const std::vector<NodePtr>& schedule) {
+  // # of distinct unevaluated inputs of each node yet to be evaluated, and
+  // nodes waiting on each node, in schedule order for deterministic dispatch
+  std::unordered_map<NodePtr, unsigned> nodeToNumPendingInputs;
+  std::unordered_map<NodePtr, std::vector<NodePtr>> nodeToDependents;
+  std::vector<NodePtr> readyNodes;
+  for (const auto& node : schedule) {
+    if (node->getResult().has_value()) {
+      continue;
+    }
+    unsigned numPendingInputs = 0;
+    for (const auto& input : node->inputs()) {
+      auto& dependents = nodeToDependents[input];
+      if (!input->getResult().has_value() &&
+          (dependents.empty() || dependents.back() != node)) {
+        dependents.push_back(node);
+        numPendingInputs++;
+      }
+    }
+    nodeToNumPendingInputs.emplace(node, numPendingInputs);
+    if (numPendingInputs == 0) {
+      readyNodes.push_back(node);
+    }
+  }
+
+  // guarded by `stateMutex_`
+  unsigned numInFlight = 0;
+  std::exception_ptr exception;
+  std::condition_variable doneCondition;
+
+  std::function<void(NodePtr)> submit = [&](NodePtr node) {
+    pool_->submit([&, node] {
+      std::vector<NodePtr> newReadyNodes;
+      try {
+        evalNodeDispatch(node);
+        trackResult(node);
+        releaseInputResults(node);
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        for (const auto& dependent : nodeToDependents[node]) {
+          if (--nodeToNumPendingInputs.at(dependent) == 0) {
+            newReadyNodes.push_back(dependent);
+          }
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+      std::lock_guard<std::mutex> lock(stateMutex_);
+      // stop dispatching once something went wrong
+      if (!exception) {
+        for (const auto& readyNode : newReadyNodes) {
+          numInFlight++;
+          submit(readyNode);
+        }
+      }
+      if (--numInFlight == 0) {
+        doneCondition.notify_all();
+      }
+    });
+  };
+
+  std::unique_lock<std::mutex> lock(stateMutex_);
+  for (const auto& node : readyNodes) {
+    numInFlight++;
+    submit(node);
+  }
+  doneCondition.wait(lock, [&numInFlight] { return numInFlight == 0; });
+  lock.unlock();
+  if (exception) {
+    // results of nodes that did get evaluated are left as is
+    std::rethrow_exception(exception);
+  }
 }
 
 void Evaluator::setProfilerState(bool active) {
@@ -262,8 +567,36 @@ const std::unordered_map<NodePtr, float>& Evaluator::getProfilerStats() {
   return nodeToTotTimeMs_;
 }
 
+const std::unordered_map<NodePtr, Evaluator::NodeTrace>&
+Evaluator::getNodeTraces() const {
+  return nodeToTrace_;
+}
+
 void Evaluator::clearProfilerStats() {
   nodeToTotTimeMs_.clear();
+  nodeToTrace_.clear();
+}
+
+void Evaluator::setMaxParallelism(unsigned maxParallelism) {
+  if (maxParallelism == 0) {
+    throw std::invalid_argument(
+        "[Evaluator::setMaxParallelism] max parallelism must be positive");
+  }
+  if (maxParallelism != maxParallelism_) {
+    pool_.reset();
+    if (maxParallelism > 1) {
+      pool_ = std::make_unique<WorkStealingPool>(maxParallelism);
+    }
+    maxParallelism_ = maxParallelism;
+  }
+}
+
+unsigned Evaluator::getMaxParallelism() const {
+  return maxParallelism_;
+}
+
+const Evaluator::MemoryStats& Evaluator::getMemoryStats() const {
+  return memoryStats_;
 }
 
 Evaluator::PostEvalCallbackHandle Evaluator::addPostEvalCallback(
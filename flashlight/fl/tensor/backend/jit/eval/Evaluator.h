@@ -7,15 +7,23 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include "flashlight/fl/tensor/TensorBackend.h"
 #include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/jit/eval/WorkStealingPool.h"
 #include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/IndexNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/IndexedUpdateNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
 
 namespace fl {
 
@@ -32,6 +40,25 @@ class Evaluator {
   using PostEvalCallbackList = std::list<PostEvalCallback>;
   using PostEvalCallbackHandle = PostEvalCallbackList::iterator;
 
+  // detailed execution record of a node, collected only while profiling
+  struct NodeTrace {
+    // start time in microseconds since the (steady) clock's epoch
+    double startUs{0};
+    double durationUs{0};
+    // bytes of input results read & bytes of the result produced
+    size_t inputBytes{0};
+    size_t outputBytes{0};
+    std::thread::id threadId;
+  };
+
+  // memory usage of intermediate results, i.e., those produced during `eval`
+  struct MemoryStats {
+    // max total bytes of intermediate results alive at the same time
+    size_t peakIntermediateBytes{0};
+    // # of nodes whose result reused the buffer of an input
+    unsigned numInPlaceEvals{0};
+  };
+
  private:
   // backend used for dispatching Tensor ops.
   TensorBackend& backend_;
@@ -39,11 +66,32 @@ class Evaluator {
   std::unordered_map<NodePtr, unsigned> nodeToResultUseCount_{};
   // track time spent on executing a node alone (not its inputs)
   std::unordered_map<NodePtr, float> nodeToTotTimeMs_{};
+  std::unordered_map<NodePtr, NodeTrace> nodeToTrace_{};
   bool profilerEnabled_{false};
   PostEvalCallbackList postEvalCallbacks_;
+  // bytes of intermediate results that are currently alive
+  std::unordered_map<NodePtr, size_t> nodeToLiveBytes_{};
+  size_t liveBytes_{0};
+  MemoryStats memoryStats_;
+  // max # of nodes evaluated concurrently, 1 means evaluating on caller thread
+  unsigned maxParallelism_{1};
+  std::unique_ptr<WorkStealingPool> pool_;
+  // guards the bookkeeping above when evaluating in parallel
+  std::mutex stateMutex_;
 
-  void evalNode(NodePtr node);
+  // evaluate nodes in `schedule` on `pool_`, as soon as their inputs are ready
+  void evalParallel(const std::vector<NodePtr>& schedule);
   void evalNodeDispatch(NodePtr node);
+  // decrement use count of `node`'s inputs, and drop results no longer needed
+  void releaseInputResults(NodePtr node);
+  // account for the memory of `node`'s newly set result
+  void trackResult(NodePtr node);
+  // whether `user` may overwrite the result buffer of `input`, i.e., no one
+  // else reads it afterwards, and it doesn't alias other results.
+  bool isDonatable(NodePtr input, NodePtr user);
+  // `node`'s result reuses the buffer of `donor`'s result
+  void trackInPlaceResult(NodePtr node, NodePtr donor);
+  void runPostEvalCallbacks(NodePtr node);
   // profile execution time of `func` and associate it with `nodePtr`
   void profile(std::function<void()> func, NodePtr nodePtr);
 
@@ -53,13 +101,24 @@ class Evaluator {
   void evalCustomNode(CustomNodePtr node);
   void evalIndexNode(IndexNodePtr node);
   void evalIndexedUpdateNode(IndexedUpdateNodePtr node);
+  void evalMatmulNode(MatmulNodePtr node);
   // JitTensor in indices becomes the backing tensor
   std::vector<Index> unwrapTensorInIndices(const std::vector<Index>& indices);
   void evalScalarNode(ScalarNodePtr node);
+  void evalUnaryNode(UnaryNodePtr node);
+  void evalReductionNode(ReductionNodePtr node);
+  void evalViewNode(ViewNodePtr node);
 
   // helpers that evaluates without setting results
   Tensor evalBinaryOp(BinaryOp op, const Tensor& lhs, const Tensor& rhs);
+  Tensor evalUnaryOp(UnaryOp op, const Tensor& input);
+  Tensor evalReductionOp(
+      ReductionOp op,
+      const Tensor& input,
+      const std::vector<int>& axes,
+      bool keepDims);
   Tensor evalScalar(ScalarNodePtr node);
+  Tensor evalViewOp(ViewNodePtr node, const Tensor& input);
 
  public:
   /**
@@ -77,17 +136,48 @@ class Evaluator {
    * Execute the entire computation tree rooted at `node`.
    * 1. no op if result already set
    * 2. set result for intermediate nodes if they have external uses
+   * 3. nodes are executed in an order that keeps peak memory low (see
+   *    `getEvaluationSchedule`), and may reuse buffers of dead inputs.
+   * 4. independent subtrees are executed concurrently if max parallelism > 1.
    */
   void eval(NodePtr node);
 
+  /**
+   * Same as above, but nodes are executed in the order of `schedule` (e.g.,
+   * memoized by the Optimizer) instead of scheduling the tree.
+   *
+   * @param[in] node the root node, which must be the last node in `schedule`
+   * @param[in] schedule all nodes in the tree (stopping at nodes with results)
+   * in topological order; falls back to the above if empty.
+   */
+  void eval(NodePtr node, const std::vector<NodePtr>& schedule);
+
   /**
    * TODO document
    */
   void setProfilerState(bool active);
   bool getProfilerState();
   const std::unordered_map<NodePtr, float>& getProfilerStats();
+  // same nodes as above, with start time and bytes moved as well
+  const std::unordered_map<NodePtr, NodeTrace>& getNodeTraces() const;
   void clearProfilerStats();
 
+  /**
+   * Set the max # of nodes that may be evaluated concurrently (default 1).
+   * With more than 1, independent subtrees are evaluated in parallel on a
+   * work-stealing pool, so the backend must support concurrent dispatch from
+   * multiple threads.
+   *
+   * Results are the same as serial evaluation, since each node only depends
+   * on its inputs, and buffer reuse decisions only depend on the tree. Memory
+   * and profiler stats may vary across runs.
+   */
+  void setMaxParallelism(unsigned maxParallelism);
+  unsigned getMaxParallelism() const;
+
+  // stats of the last `eval`
+  const MemoryStats& getMemoryStats() const;
+
   PostEvalCallbackHandle addPostEvalCallback(PostEvalCallback callback);
   void removePostEvalCallback(PostEvalCallbackHandle handle);
 };
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/eval/Scheduler.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace fl {
+
+namespace {
+
+class Scheduler {
+  struct Cost {
+    // peak # of live elements while evaluating the subtree, including output
+    Dim peak{0};
+    // # of elements of the output
+    Dim output{0};
+    // unevaluated inputs, in the order they should be evaluated
+    std::vector<NodePtr> orderedInputs;
+  };
+
+  std::unordered_map<NodePtr, Cost> nodeToCost_;
+  std::unordered_set<NodePtr> scheduled_;
+  std::vector<NodePtr> schedule_;
+
+  const Cost& getCost(const NodePtr& node) {
+    const auto iter = nodeToCost_.find(node);
+    if (iter != nodeToCost_.end()) {
+      return iter->second;
+    }
+    Cost cost;
+    // evaluated nodes are already live, evaluating them costs nothing
+    if (!node->getResult().has_value()) {
+      for (const auto& input : node->inputs()) {
+        if (!input->getResult().has_value() &&
+            std::find(
+                cost.orderedInputs.begin(), cost.orderedInputs.end(), input) ==
+                cost.orderedInputs.end()) {
+          cost.orderedInputs.push_back(input);
+        }
+      }
+      // NOTE stable, so ties are broken deterministically by input order
+      std::stable_sort(
+          cost.orderedInputs.begin(),
+          cost.orderedInputs.end(),
+          [this](const NodePtr& lhs, const NodePtr& rhs) {
+            const auto& lhsCost = getCost(lhs);
+            const auto& rhsCost = getCost(rhs);
+            return lhsCost.peak - lhsCost.output >
+                rhsCost.peak - rhsCost.output;
+          });
+      Dim live = 0; // outputs of inputs evaluated so far
+      for (const auto& input : cost.orderedInputs) {
+        const auto& inputCost = getCost(input);
+        cost.peak = std::max(cost.peak, live + inputCost.peak);
+        live += inputCost.output;
+      }
+      cost.output = node->shape().elements();
+      cost.peak = std::max(cost.peak, live + cost.output);
+    }
+    return nodeToCost_.emplace(node, std::move(cost)).first->second;
+  }
+
+  void scheduleFrom(const NodePtr& node) {
+    if (!scheduled_.insert(node).second) {
+      return;
+    }
+    if (!node->getResult().has_value()) {
+      // evaluated inputs come first, they don't contribute to peak memory
+      for (const auto& input : node->inputs()) {
+        if (input->getResult().has_value()) {
+          scheduleFrom(input);
+        }
+      }
+      for (const auto& input : getCost(node).orderedInputs) {
+        scheduleFrom(input);
+      }
+    }
+    schedule_.push_back(node);
+  }
+
+ public:
+  std::vector<NodePtr> run(const NodePtr& root) {
+    scheduleFrom(root);
+    return std::move(schedule_);
+  }
+};
+
+} // namespace
+
+std::vector<NodePtr> getEvaluationSchedule(NodePtr root) {
+  return Scheduler().run(root);
+}
+
+} // namespace fl
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+
+namespace fl {
+
+/**
+ * Returns all nodes in the tree rooted at `root` (stopping at nodes with
+ * results) in an evaluation order that keeps peak memory of intermediate
+ * results low.
+ *
+ * Inputs of a node are scheduled in decreasing order of (peak memory needed
+ * to evaluate the input) - (memory of the input's result), i.e., Sethi-Ullman
+ * ordering generalized to sized results, which is optimal for trees and a
+ * heuristic for DAGs. Since result types aren't known before evaluation, # of
+ * elements is used as a proxy for bytes.
+ *
+ * @param[in] root the root node of the JIT tree to be scheduled.
+ * @return the nodes in topological order, ending with `root`.
+ */
+std::vector<NodePtr> getEvaluationSchedule(NodePtr root);
+
+} // namespace fl
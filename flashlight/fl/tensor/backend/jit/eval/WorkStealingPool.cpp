@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/eval/WorkStealingPool.h"
+
+#include <stdexcept>
+
+namespace fl {
+
+namespace {
+
+// the pool (if any) the current thread is a worker of, and its index there
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local unsigned currentWorkerIdx = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned numWorkers) {
+  if (numWorkers == 0) {
+    throw std::invalid_argument(
+        "[WorkStealingPool::WorkStealingPool] numWorkers must be positive");
+  }
+  for (unsigned i = 0; i < numWorkers; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (unsigned i = 0; i < numWorkers; i++) {
+    threads_.emplace_back([this, i] { workerLoop(i); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::submit(Task task) {
+  unsigned workerIdx;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+      throw std::runtime_error(
+          "[WorkStealingPool::submit] submit on stopped pool");
+    }
+    workerIdx = currentPool == this
+        ? currentWorkerIdx
+        : nextWorkerIdx_++ % workers_.size();
+  }
+  {
+    auto& worker = *workers_[workerIdx];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.push_back(std::move(task));
+  }
+  // only announce the task once it can be popped
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    numUnclaimed_++;
+  }
+  condition_.notify_one();
+}
+
+unsigned WorkStealingPool::numWorkers() const {
+  return workers_.size();
+}
+
+void WorkStealingPool::workerLoop(unsigned workerIdx) {
+  currentPool = this;
+  currentWorkerIdx = workerIdx;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return stop_ || numUnclaimed_ > 0; });
+      if (numUnclaimed_ == 0) {
+        return; // stopped, and nothing left to run
+      }
+      numUnclaimed_--;
+    }
+    // A claimed task is guaranteed to be in some deque, though another worker
+    // may steal the one we see first, hence the retry.
+    Task task;
+    while (!tryPop(workerIdx, task)) {
+      std::this_thread::yield();
+    }
+    task();
+  }
+}
+
+bool WorkStealingPool::tryPop(unsigned workerIdx, Task& task) {
+  {
+    auto& worker = *workers_[workerIdx];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      return true;
+    }
+  }
+  for (unsigned i = 1; i < workers_.size(); i++) {
+    auto& victim = *workers_[(workerIdx + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace fl
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fl {
+
+/**
+ * A fixed-size thread pool where each worker has its own task deque.
+ *
+ * Tasks submitted by a worker go to the back of its own deque, and workers
+ * pop from the back of their own deque (LIFO, good for locality of dependent
+ * tasks), or steal from the front of others' deques when theirs is empty.
+ * Tasks submitted from outside the pool are distributed round-robin.
+ *
+ * Tasks must not throw.
+ */
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * Launches `numWorkers` (must be positive) worker threads.
+   */
+  explicit WorkStealingPool(unsigned numWorkers);
+  // joins all workers after finishing the queued tasks
+  ~WorkStealingPool();
+
+  // no copy/move
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool(WorkStealingPool&&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+
+  void submit(Task task);
+  unsigned numWorkers() const;
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  // guards `numUnclaimed_` and `stop_`
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  // # of queued tasks not yet claimed by a worker
+  unsigned numUnclaimed_{0};
+  unsigned nextWorkerIdx_{0};
+  bool stop_{false};
+
+  void workerLoop(unsigned workerIdx);
+  // pop from the back of the own deque, or steal from the front of others'
+  bool tryPop(unsigned workerIdx, Task& task);
+};
+
+} // namespace fl
@@ -21,6 +21,19 @@ CustomNode::CustomNode(
       name_(name),
       evalFunc_(std::move(evalFunc)) {}
 
+CustomNode::CustomNode(
+    std::string&& name,
+    std::vector<NodePtr>&& inputs,
+    const Shape& shape,
+    InPlaceEvalFunc&& inPlaceEvalFunc,
+    PrivateHelper)
+    : NodeTrait(std::move(inputs), shape),
+      name_(name),
+      evalFunc_([inPlaceEvalFunc](const std::vector<const Tensor*>& inputs) {
+        return inPlaceEvalFunc(inputs, {}).first;
+      }),
+      inPlaceEvalFunc_(std::move(inPlaceEvalFunc)) {}
+
 CustomNodePtr CustomNode::create(
     std::string&& name,
     std::vector<NodePtr>&& inputs,
@@ -31,6 +44,16 @@ CustomNodePtr CustomNode::create(
       PrivateHelper{});
 }
 
+CustomNodePtr CustomNode::create(
+    std::string&& name,
+    std::vector<NodePtr>&& inputs,
+    const Shape& shape,
+    InPlaceEvalFunc&& inPlaceEvalFunc) {
+  return std::make_shared<CustomNode>(
+      std::move(name), std::move(inputs), shape, std::move(inPlaceEvalFunc),
+      PrivateHelper{});
+}
+
 const std::string& CustomNode::name() const {
   return name_;
 }
@@ -39,4 +62,12 @@ const CustomNode::EvalFunc& CustomNode::evalFunc() const {
   return evalFunc_;
 }
 
+const CustomNode::InPlaceEvalFunc& CustomNode::inPlaceEvalFunc() const {
+  return inPlaceEvalFunc_;
+}
+
+bool CustomNode::supportsInPlace() const {
+  return static_cast<bool>(inPlaceEvalFunc_);
+}
+
 } // namespace fl
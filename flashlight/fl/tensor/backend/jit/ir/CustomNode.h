@@ -12,8 +12,10 @@
 #include "flashlight/fl/tensor/backend/jit/ir/Node.h"
 
 #include <functional>
-#include <vector>
 #include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace fl {
 
@@ -27,6 +29,14 @@ using CustomNodePtr = std::shared_ptr<CustomNode>;
 class CustomNode : public NodeTrait<CustomNode> {
  public:
   using EvalFunc = std::function<Tensor(const std::vector<const Tensor*>&)>;
+  // Like EvalFunc, but may write the result into the buffer of an input at
+  // one of the donated indices (no one else will read it afterwards), and
+  // returns the index of that input if it did so. The result must not alias
+  // any other input.
+  using InPlaceEvalFunc =
+      std::function<std::pair<Tensor, std::optional<unsigned>>(
+          const std::vector<const Tensor*>& inputs,
+          const std::vector<unsigned>& donatedInputIdxs)>;
 
   // help control allocation while allowing `std::make_shared`
   struct PrivateHelper{};
@@ -34,6 +44,7 @@ class CustomNode : public NodeTrait<CustomNode> {
  private:
   const std::string name_;
   const EvalFunc evalFunc_;
+  const InPlaceEvalFunc inPlaceEvalFunc_; // empty if not supported
 
  public:
   static constexpr NodeType nodeType = NodeType::Custom;
@@ -43,6 +54,12 @@ class CustomNode : public NodeTrait<CustomNode> {
       const Shape& shape,
       EvalFunc&& evalFunc,
       PrivateHelper);
+  CustomNode(
+      std::string&& name,
+      std::vector<NodePtr>&& inputs,
+      const Shape& shape,
+      InPlaceEvalFunc&& inPlaceEvalFunc,
+      PrivateHelper);
 
   static CustomNodePtr create(
       std::string&& debugName,
@@ -50,8 +67,17 @@ class CustomNode : public NodeTrait<CustomNode> {
       const Shape& shape,
       EvalFunc&& evalFunc);
 
+  static CustomNodePtr create(
+      std::string&& debugName,
+      std::vector<NodePtr>&& inputs,
+      const Shape& shape,
+      InPlaceEvalFunc&& inPlaceEvalFunc);
+
   const std::string& name() const;
+  // always available, even if the node was created with an InPlaceEvalFunc
   const EvalFunc& evalFunc() const;
+  const InPlaceEvalFunc& inPlaceEvalFunc() const;
+  bool supportsInPlace() const;
 };
 
 } // namespace fl
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+
+#include "flashlight/fl/tensor/backend/jit/ShapeInference.h"
+
+namespace fl {
+
+MatmulNode::MatmulNode(
+    NodePtr lhs,
+    NodePtr rhs,
+    MatrixProperty lhsProp,
+    MatrixProperty rhsProp,
+    const Shape& shape,
+    PrivateHelper)
+    : NodeTrait({lhs, rhs}, shape), lhsProp_(lhsProp), rhsProp_(rhsProp) {}
+
+MatmulNodePtr MatmulNode::create(
+    NodePtr lhs,
+    NodePtr rhs,
+    MatrixProperty lhsProp,
+    MatrixProperty rhsProp) {
+  const auto outputShape =
+      inferMatmulOutputShape(lhs->shape(), rhs->shape(), lhsProp, rhsProp);
+  return std::make_shared<MatmulNode>(
+      lhs, rhs, lhsProp, rhsProp, outputShape, PrivateHelper{});
+}
+
+NodePtr MatmulNode::lhs() const {
+  return getInput(kLhsIdx);
+}
+
+NodePtr MatmulNode::rhs() const {
+  return getInput(kRhsIdx);
+}
+
+MatrixProperty MatmulNode::lhsProp() const {
+  return lhsProp_;
+}
+
+MatrixProperty MatmulNode::rhsProp() const {
+  return rhsProp_;
+}
+
+} // namespace fl
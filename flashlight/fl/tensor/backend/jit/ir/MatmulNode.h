@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+
+namespace fl {
+
+class MatmulNode;
+using MatmulNodePtr = std::shared_ptr<MatmulNode>;
+
+/**
+ * A node that represents matrix multiplication, i.e., `fl::matmul`.
+ */
+class MatmulNode : public NodeTrait<MatmulNode> {
+  const MatrixProperty lhsProp_;
+  const MatrixProperty rhsProp_;
+
+  // helps indexing into inputs
+  static constexpr unsigned kLhsIdx = 0;
+  static constexpr unsigned kRhsIdx = 1;
+
+  // help control allocation while allowing `std::make_shared`
+  struct PrivateHelper{};
+
+ public:
+  static constexpr NodeType nodeType = NodeType::Matmul;
+  MatmulNode(
+      NodePtr lhs,
+      NodePtr rhs,
+      MatrixProperty lhsProp,
+      MatrixProperty rhsProp,
+      const Shape& shape,
+      PrivateHelper);
+
+  static MatmulNodePtr create(
+      NodePtr lhs,
+      NodePtr rhs,
+      MatrixProperty lhsProp,
+      MatrixProperty rhsProp);
+
+  NodePtr lhs() const;
+  NodePtr rhs() const;
+  MatrixProperty lhsProp() const;
+  MatrixProperty rhsProp() const;
+};
+
+} // namespace fl
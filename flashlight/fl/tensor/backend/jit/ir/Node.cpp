@@ -73,6 +73,14 @@ void Node::setInput(unsigned inputIdx, NodePtr newInput) {
   linkInput(inputIdx, newInput);
 }
 
+void Node::unlinkInputs() {
+  for (unsigned inputIdx = 0; inputIdx < inputs_.size(); inputIdx++) {
+    unlinkInput(inputIdx);
+  }
+  inputs_.clear();
+  inputUseIters_.clear();
+}
+
 const Shape& Node::shape() const {
   return shape_;
 }
@@ -120,6 +128,14 @@ void Node::unsetResult() {
   }
 }
 
+const std::optional<TreeCost>& Node::getTreeCost() const {
+  return treeCost_;
+}
+
+void Node::setTreeCost(const TreeCost& cost) {
+  treeCost_ = cost;
+}
+
 bool Node::isBinary() const {
   return type() == NodeType::Binary;
 }
@@ -144,4 +160,20 @@ bool Node::isValue() const {
   return type() == NodeType::Value;
 }
 
+bool Node::isUnary() const {
+  return type() == NodeType::Unary;
+}
+
+bool Node::isReduction() const {
+  return type() == NodeType::Reduction;
+}
+
+bool Node::isMatmul() const {
+  return type() == NodeType::Matmul;
+}
+
+bool Node::isView() const {
+  return type() == NodeType::View;
+}
+
 } // namespace fl
@@ -24,6 +24,20 @@ using ExternalUseList = std::list<ExternalUse*>;
 using UseList = std::list<std::unique_ptr<Use>>;
 using NodePtr = std::shared_ptr<Node>;
 
+/**
+ * Estimated cost of evaluating a JIT tree (stopping at nodes with results).
+ * Since result types aren't known before evaluation, # of elements is used as
+ * a proxy for bytes.
+ */
+struct TreeCost {
+  // # of nodes to be evaluated
+  unsigned numNodes{0};
+  // approximate # of floating point (or integer) operations
+  double flops{0};
+  // total # of elements of all results to be produced
+  double intermediateElements{0};
+};
+
 /**
  * A Node represents a step in some Tensor computation.
  *
@@ -40,6 +54,9 @@ class Node {
   // present if this node has been evaluated
   std::optional<Tensor> result_{std::nullopt};
 
+  // cached cost of the tree rooted at this node, see `estimateTreeCost`
+  std::optional<TreeCost> treeCost_{std::nullopt};
+
   // set the input at `inputIdx` -- `unlinkInput` should be used to clear the
   // old input at `inputIdx`, if any.
   void linkInput(unsigned inputIdx, NodePtr input);
@@ -60,6 +77,9 @@ class Node {
   // Inputs
   const std::vector<NodePtr>& inputs() const;
   void setInput(unsigned inputIdx, NodePtr newInput);
+  // drop all inputs, e.g., to prune a node that's been rewritten away, so it
+  // no longer counts as a use of its inputs -- ASSUME the node is dead.
+  void unlinkInputs();
 
   // Shape
   const Shape& shape() const;
@@ -75,6 +95,10 @@ class Node {
   void setResult(Tensor&& tensor);
   void unsetResult();
 
+  // Useful for incremental cost estimation
+  const std::optional<TreeCost>& getTreeCost() const;
+  void setTreeCost(const TreeCost& cost);
+
   // Convenient type checks
   bool isBinary() const;
   bool isCustom() const;
@@ -82,6 +106,10 @@ class Node {
   bool isScalar() const;
   bool isValue() const;
   bool isIndexedUpdate() const;
+  bool isUnary() const;
+  bool isReduction() const;
+  bool isMatmul() const;
+  bool isView() const;
 
   // Fast & safe casts
   virtual NodeType type() const = 0;
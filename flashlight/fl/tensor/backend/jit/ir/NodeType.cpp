@@ -25,6 +25,14 @@ std::string nodeTypeToString(const NodeType type) {
       return "Index";
     case NodeType::IndexedUpdate:
       return "IndexedUpdate";
+    case NodeType::Unary:
+      return "Unary";
+    case NodeType::Reduction:
+      return "Reduction";
+    case NodeType::Matmul:
+      return "Matmul";
+    case NodeType::View:
+      return "View";
   }
   throw std::runtime_error("Unknown node type");
 }
@@ -22,6 +22,10 @@ enum class NodeType {
   Value,
   Index,
   IndexedUpdate,
+  Unary,
+  Reduction,
+  Matmul,
+  View,
 };
 
 /**
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+
+#include "flashlight/fl/tensor/backend/jit/ShapeInference.h"
+
+namespace fl {
+
+ReductionNode::ReductionNode(
+    NodePtr input,
+    ReductionOp op,
+    const std::vector<int>& axes,
+    bool keepDims,
+    const Shape& shape,
+    PrivateHelper)
+    : NodeTrait({input}, shape), op_(op), axes_(axes), keepDims_(keepDims) {}
+
+ReductionNodePtr ReductionNode::create(
+    NodePtr input,
+    ReductionOp op,
+    const std::vector<int>& axes,
+    bool keepDims) {
+  const auto outputShape =
+      inferReductionOutputShape(input->shape(), axes, keepDims);
+  return std::make_shared<ReductionNode>(
+      input, op, axes, keepDims, outputShape, PrivateHelper{});
+}
+
+ReductionOp ReductionNode::op() const {
+  return op_;
+}
+
+NodePtr ReductionNode::input() const {
+  return getInput(kInputIdx);
+}
+
+const std::vector<int>& ReductionNode::axes() const {
+  return axes_;
+}
+
+bool ReductionNode::keepDims() const {
+  return keepDims_;
+}
+
+} // namespace fl
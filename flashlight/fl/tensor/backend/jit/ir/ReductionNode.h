@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+
+namespace fl {
+
+/**
+ * Types of reduction operations.
+ */
+enum class ReductionOp {
+  Min,
+  Max,
+  Sum,
+  Mean,
+};
+
+class ReductionNode;
+using ReductionNodePtr = std::shared_ptr<ReductionNode>;
+
+/**
+ * A node that represents reduction of the input along some axes.
+ * Empty `axes` means reduction along all axes, following `fl::sum` etc.
+ */
+class ReductionNode : public NodeTrait<ReductionNode> {
+  const ReductionOp op_;
+  const std::vector<int> axes_;
+  const bool keepDims_;
+
+  // helps indexing into inputs
+  static constexpr unsigned kInputIdx = 0;
+
+  // help control allocation while allowing `std::make_shared`
+  struct PrivateHelper{};
+
+ public:
+  static constexpr NodeType nodeType = NodeType::Reduction;
+  ReductionNode(
+      NodePtr input,
+      ReductionOp op,
+      const std::vector<int>& axes,
+      bool keepDims,
+      const Shape& shape,
+      PrivateHelper);
+
+  static ReductionNodePtr create(
+      NodePtr input,
+      ReductionOp op,
+      const std::vector<int>& axes,
+      bool keepDims);
+
+  ReductionOp op() const;
+  NodePtr input() const;
+  const std::vector<int>& axes() const;
+  bool keepDims() const;
+};
+
+} // namespace fl
@@ -52,6 +52,7 @@ class ScalarNode : public NodeTrait<ScalarNode> {
         return std::make_shared<ScalarNode>(
             shape, type, static_cast<unsigned long long>(scalar), PrivateHelper{});
       case dtype::f16:
+      case dtype::bf16:
       case dtype::f32:
       case dtype::f64:
         return std::make_shared< ScalarNode>(shape, type, static_cast<double>(scalar), PrivateHelper{});
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+
+namespace fl {
+
+UnaryNode::UnaryNode(NodePtr input, UnaryOp op, PrivateHelper)
+    : NodeTrait({input}, input->shape()), op_(op) {}
+
+UnaryNodePtr UnaryNode::create(NodePtr input, UnaryOp op) {
+  return std::make_shared<UnaryNode>(input, op, PrivateHelper{});
+}
+
+UnaryOp UnaryNode::op() const {
+  return op_;
+}
+
+NodePtr UnaryNode::input() const {
+  return getInput(kInputIdx);
+}
+
+} // namespace fl
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+
+namespace fl {
+
+/**
+ * Types of element-wise unary operations.
+ */
+enum class UnaryOp {
+  Exp,
+  Log,
+  Negative,
+  LogicalNot,
+  Log1p,
+  Sin,
+  Cos,
+  Sqrt,
+  Tanh,
+  Floor,
+  Ceil,
+  Rint,
+  Absolute,
+  Sigmoid,
+  Erf,
+  IsNan,
+  IsInf,
+  Sign,
+};
+
+class UnaryNode;
+using UnaryNodePtr = std::shared_ptr<UnaryNode>;
+
+/**
+ * A node that represents element-wise unary operations, i.e., output has the
+ * same shape as input.
+ */
+class UnaryNode : public NodeTrait<UnaryNode> {
+  const UnaryOp op_;
+
+  // helps indexing into inputs
+  static constexpr unsigned kInputIdx = 0;
+
+  // help control allocation while allowing `std::make_shared`
+  struct PrivateHelper{};
+
+ public:
+  static constexpr NodeType nodeType = NodeType::Unary;
+  UnaryNode(NodePtr input, UnaryOp op, PrivateHelper);
+
+  static UnaryNodePtr create(NodePtr input, UnaryOp op);
+
+  UnaryOp op() const;
+  NodePtr input() const;
+};
+
+} // namespace fl
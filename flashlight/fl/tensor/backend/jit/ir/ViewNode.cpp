@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
+
+#include <numeric>
+#include <stdexcept>
+
+#include "flashlight/fl/tensor/backend/jit/ShapeInference.h"
+
+namespace fl {
+
+namespace {
+
+Shape inferViewOutputShape(
+    const Shape& inputShape,
+    ViewType viewType,
+    const Shape& params) {
+  switch (viewType) {
+    case ViewType::Reshape:
+      return inferReshapeOutputShape(inputShape, params);
+    case ViewType::Transpose:
+      return inferTransposeOutputShape(inputShape, params);
+    case ViewType::Tile:
+      return inferTileOutputShape(inputShape, params);
+  }
+  throw std::runtime_error("[inferViewOutputShape] Unknown view type");
+}
+
+} // namespace
+
+ViewNode::ViewNode(
+    NodePtr input,
+    ViewType viewType,
+    const Shape& params,
+    const Shape& shape,
+    PrivateHelper)
+    : NodeTrait({input}, shape), viewType_(viewType), params_(params) {}
+
+ViewNodePtr
+ViewNode::create(NodePtr input, ViewType viewType, const Shape& params) {
+  const auto outputShape =
+      inferViewOutputShape(input->shape(), viewType, params);
+  return std::make_shared<ViewNode>(
+      input, viewType, params, outputShape, PrivateHelper{});
+}
+
+ViewType ViewNode::viewType() const {
+  return viewType_;
+}
+
+NodePtr ViewNode::input() const {
+  return getInput(kInputIdx);
+}
+
+const Shape& ViewNode::params() const {
+  return params_;
+}
+
+std::vector<int> ViewNode::transposeAxes() const {
+  const auto rank = input()->shape().ndim();
+  std::vector<int> axes(rank);
+  if (params_.ndim() == 0) { // default, reverse all axes
+    std::iota(axes.rbegin(), axes.rend(), 0);
+  } else {
+    for (int i = 0; i < rank; i++) {
+      axes[i] = params_.dim(i);
+    }
+  }
+  return axes;
+}
+
+} // namespace fl
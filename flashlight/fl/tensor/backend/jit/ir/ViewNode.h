@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+
+namespace fl {
+
+/**
+ * Types of view operations, i.e., ones that only change how elements of the
+ * input are addressed, not their values.
+ */
+enum class ViewType {
+  Reshape,
+  Transpose,
+  Tile,
+};
+
+class ViewNode;
+using ViewNodePtr = std::shared_ptr<ViewNode>;
+
+/**
+ * A node that represents a view of the input, following `fl::reshape`,
+ * `fl::transpose` & `fl::tile`. The view is described by metadata rather than
+ * a copy, so consumers like fused kernels may read the input through it
+ * directly; the view is only materialized if evaluated on its own.
+ */
+class ViewNode : public NodeTrait<ViewNode> {
+  const ViewType viewType_;
+  // output shape (Reshape), axes (Transpose), or tile dims (Tile)
+  const Shape params_;
+
+  // helps indexing into inputs
+  static constexpr unsigned kInputIdx = 0;
+
+  // help control allocation while allowing `std::make_shared`
+  struct PrivateHelper{};
+
+ public:
+  static constexpr NodeType nodeType = NodeType::View;
+  ViewNode(
+      NodePtr input,
+      ViewType viewType,
+      const Shape& params,
+      const Shape& shape,
+      PrivateHelper);
+
+  static ViewNodePtr
+  create(NodePtr input, ViewType viewType, const Shape& params);
+
+  ViewType viewType() const;
+  NodePtr input() const;
+  const Shape& params() const;
+
+  /**
+   * Returns the input axis each output axis is read from, i.e., the transpose
+   * axes with the default (empty) axes made explicit.
+   * ASSUME view type is Transpose.
+   */
+  std::vector<int> transposeAxes() const;
+};
+
+} // namespace fl
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/opt/GraphCache.h"
+
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+#include "flashlight/fl/tensor/backend/jit/eval/Scheduler.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
+#include "flashlight/fl/tensor/backend/jit/opt/ScalarKey.h"
+
+namespace fl {
+
+// A replayable record of how optimization rewrote a tree.
+struct GraphCache::Plan {
+  // A node in the optimized tree, entries are in topological order.
+  struct Entry {
+    // position in the input tree, or nullopt if created by optimization
+    std::optional<unsigned> treeIdx;
+    // creates the node from its inputs, iff `treeIdx` is nullopt
+    std::function<NodePtr(std::vector<NodePtr>&&)> factory;
+    // entry indices of inputs, empty for leaves of the input tree
+    std::vector<unsigned> inputs;
+  };
+
+  std::vector<Entry> entries;
+  // (tree index, entry index), i.e., uses of some node in the input tree were
+  // moved to some node in the optimized tree.
+  std::vector<std::pair<unsigned, unsigned>> useMoves;
+};
+
+namespace {
+
+// A tree in canonical (post-)order, along with its structural key.
+struct CanonicalTree {
+  std::vector<NodePtr> nodes;
+  std::unordered_map<NodePtr, unsigned> nodeToIdx;
+  std::ostringstream key;
+  bool cacheable{true};
+};
+
+// Evaluated nodes are leaves -- optimization doesn't look past them, and the
+// history of computation behind them can be arbitrarily long.
+bool isLeaf(const NodePtr& node) {
+  return node->getResult().has_value();
+}
+
+ScalarNodePtr cloneScalar(const ScalarNode& node) {
+  const auto type = node.dataType();
+  switch (type) {
+    case dtype::f16:
+    case dtype::bf16:
+    case dtype::f32:
+    case dtype::f64:
+      return ScalarNode::create(node.shape(), type, node.scalar<double>());
+    case dtype::u64:
+      return ScalarNode::create(
+          node.shape(), type, node.scalar<unsigned long long>());
+    case dtype::b8:
+    case dtype::s16:
+    case dtype::s32:
+    case dtype::s64:
+    case dtype::u8:
+    case dtype::u16:
+    case dtype::u32:
+      return ScalarNode::create(node.shape(), type, node.scalar<long long>());
+  }
+  throw std::runtime_error("[GraphCache::cloneScalar] Unknown dtype");
+}
+
+// Returns false if `node`'s semantics can't be fully captured in the key.
+bool writeNodeKey(std::ostream& os, const NodePtr& node) {
+  os << static_cast<int>(node->type()) << node->shape() << "u"
+     << node->uses().size() + node->externalUses().size();
+  if (node->isScalar()) {
+    const auto& scalarNode = node->impl<ScalarNode>();
+    os << "s" << static_cast<int>(scalarNode.dataType()) << "=";
+    detail::writeScalar(os, scalarNode);
+  }
+  if (isLeaf(node)) {
+    // value abstracted away
+    os << "r" << static_cast<int>(node->getResult()->type());
+    return true;
+  }
+  switch (node->type()) {
+    case NodeType::Binary:
+      os << "b" << static_cast<int>(node->impl<BinaryNode>().op());
+      return true;
+    case NodeType::Unary:
+      os << "n" << static_cast<int>(node->impl<UnaryNode>().op());
+      return true;
+    case NodeType::Reduction: {
+      const auto& reductionNode = node->impl<ReductionNode>();
+      os << "r" << static_cast<int>(reductionNode.op()) << "k"
+         << reductionNode.keepDims() << "a";
+      for (const auto axis : reductionNode.axes()) {
+        os << axis << ",";
+      }
+      return true;
+    }
+    case NodeType::Matmul: {
+      const auto& matmulNode = node->impl<MatmulNode>();
+      os << "m" << static_cast<int>(matmulNode.lhsProp())
+         << static_cast<int>(matmulNode.rhsProp());
+      return true;
+    }
+    case NodeType::View: {
+      const auto& viewNode = node->impl<ViewNode>();
+      os << "v" << static_cast<int>(viewNode.viewType()) << viewNode.params();
+      return true;
+    }
+    case NodeType::Scalar:
+      return true;
+    // CustomNode's evaluation logic is opaque, and IndexNode may have tensor
+    // indices, which are outside the tree.
+    case NodeType::Custom:
+    case NodeType::Index:
+    case NodeType::IndexedUpdate:
+    case NodeType::Value:
+      return false;
+  }
+  throw std::runtime_error("[GraphCache::writeNodeKey] Unknown node type");
+}
+
+void visitForTree(const NodePtr& node, CanonicalTree& tree) {
+  if (!tree.cacheable || tree.nodeToIdx.count(node) != 0) {
+    return;
+  }
+  const bool leaf = isLeaf(node);
+  if (!leaf) {
+    for (const auto& input : node->inputs()) {
+      visitForTree(input, tree);
+    }
+  }
+  const unsigned idx = tree.nodes.size();
+  tree.nodes.push_back(node);
+  tree.nodeToIdx.emplace(node, idx);
+  tree.cacheable = tree.cacheable && writeNodeKey(tree.key, node);
+  if (!leaf) {
+    tree.key << "(";
+    for (const auto& input : node->inputs()) {
+      tree.key << tree.nodeToIdx.at(input) << ",";
+    }
+    tree.key << ")";
+  }
+  tree.key << ";";
+}
+
+using NodeFactory = std::function<NodePtr(std::vector<NodePtr>&&)>;
+
+// Returns a factory that re-creates `node` from new inputs, if possible.
+std::optional<NodeFactory> getFactory(const NodePtr& node) {
+  switch (node->type()) {
+    case NodeType::Binary: {
+      const auto op = node->impl<BinaryNode>().op();
+      return [op](std::vector<NodePtr>&& inputs) -> NodePtr {
+        return BinaryNode::create(inputs.at(0), inputs.at(1), op);
+      };
+    }
+    case NodeType::Unary: {
+      const auto op = node->impl<UnaryNode>().op();
+      return [op](std::vector<NodePtr>&& inputs) -> NodePtr {
+        return UnaryNode::create(inputs.at(0), op);
+      };
+    }
+    case NodeType::Reduction: {
+      const auto& reductionNode = node->impl<ReductionNode>();
+      return [op = reductionNode.op(),
+              axes = reductionNode.axes(),
+              keepDims = reductionNode.keepDims()](
+                 std::vector<NodePtr>&& inputs) -> NodePtr {
+        return ReductionNode::create(inputs.at(0), op, axes, keepDims);
+      };
+    }
+    case NodeType::Matmul: {
+      const auto& matmulNode = node->impl<MatmulNode>();
+      return [lhsProp = matmulNode.lhsProp(), rhsProp = matmulNode.rhsProp()](
+                 std::vector<NodePtr>&& inputs) -> NodePtr {
+        return MatmulNode::create(inputs.at(0), inputs.at(1), lhsProp, rhsProp);
+      };
+    }
+    case NodeType::View: {
+      const auto& viewNode = node->impl<ViewNode>();
+      return [viewType = viewNode.viewType(), params = viewNode.params()](
+                 std::vector<NodePtr>&& inputs) -> NodePtr {
+        return ViewNode::create(inputs.at(0), viewType, params);
+      };
+    }
+    case NodeType::Scalar: {
+      const auto prototype = Node::cast<ScalarNodePtr>(node);
+      return [prototype](std::vector<NodePtr>&& /* inputs */) -> NodePtr {
+        return cloneScalar(*prototype);
+      };
+    }
+    case NodeType::Custom: {
+      // optimization passes build self-contained evaluation logic, so it can
+      // be shared across trees of the same key
+      const auto& customNode = node->impl<CustomNode>();
+      return [name = customNode.name(),
+              shape = customNode.shape(),
+              evalFunc = customNode.evalFunc(),
+              inPlaceEvalFunc = customNode.inPlaceEvalFunc()](
+                 std::vector<NodePtr>&& inputs) -> NodePtr {
+        if (inPlaceEvalFunc) {
+          return CustomNode::create(
+              std::string(name),
+              std::move(inputs),
+              shape,
+              CustomNode::InPlaceEvalFunc(inPlaceEvalFunc));
+        }
+        return CustomNode::create(
+            std::string(name),
+            std::move(inputs),
+            shape,
+            CustomNode::EvalFunc(evalFunc));
+      };
+    }
+    case NodeType::Index:
+    case NodeType::IndexedUpdate:
+    case NodeType::Value:
+      return std::nullopt;
+  }
+  throw std::runtime_error("[GraphCache::getFactory] Unknown node type");
+}
+
+} // namespace
+
+GraphCache::GraphCache(unsigned capacity) : capacity_(capacity) {}
+
+GraphCache::~GraphCache() = default;
+
+std::shared_ptr<const GraphCache::Plan> GraphCache::recordPlan(
+    const std::vector<NodePtr>& treeNodes,
+    const std::vector<std::pair<ExternalUse*, unsigned>>& externalUses,
+    NodePtr root,
+    std::vector<NodePtr>& schedule) {
+  std::unordered_map<NodePtr, unsigned> treeNodeToIdx;
+  for (unsigned i = 0; i < treeNodes.size(); i++) {
+    treeNodeToIdx.emplace(treeNodes[i], i);
+  }
+  auto plan = std::make_shared<Plan>();
+  std::unordered_map<NodePtr, unsigned> nodeToEntryIdx;
+  bool replayable = true;
+  // replaying in this order yields a memory-friendly schedule for free
+  for (const auto& node : getEvaluationSchedule(root)) {
+    Plan::Entry entry;
+    const auto treeIter = treeNodeToIdx.find(node);
+    const bool isTreeNode = treeIter != treeNodeToIdx.end();
+    if (!isTreeNode || !isLeaf(node)) {
+      for (const auto& input : node->inputs()) {
+        entry.inputs.push_back(nodeToEntryIdx.at(input));
+      }
+    }
+    if (isTreeNode) {
+      entry.treeIdx = treeIter->second;
+    } else {
+      auto factory = getFactory(node);
+      if (!factory.has_value()) {
+        replayable = false;
+        break;
+      }
+      entry.factory = std::move(factory.value());
+    }
+    nodeToEntryIdx.emplace(node, plan->entries.size());
+    plan->entries.push_back(std::move(entry));
+    schedule.push_back(node);
+  }
+
+  for (const auto& [externalUse, treeIdx] : externalUses) {
+    const auto usee = externalUse->usee();
+    if (usee == treeNodes[treeIdx]) {
+      continue;
+    }
+    const auto iter = nodeToEntryIdx.find(usee);
+    if (iter == nodeToEntryIdx.end()) {
+      replayable = false;
+      break;
+    }
+    plan->useMoves.emplace_back(treeIdx, iter->second);
+  }
+  if (!replayable) {
+    schedule.clear();
+    return nullptr;
+  }
+  return plan;
+}
+
+NodePtr GraphCache::replayPlan(
+    const Plan& plan,
+    const std::vector<NodePtr>& treeNodes,
+    std::vector<NodePtr>& schedule) {
+  for (const auto& entry : plan.entries) {
+    std::vector<NodePtr> inputs;
+    for (const auto inputIdx : entry.inputs) {
+      inputs.push_back(schedule[inputIdx]);
+    }
+    if (entry.treeIdx.has_value()) {
+      const auto& node = treeNodes[entry.treeIdx.value()];
+      for (unsigned i = 0; i < inputs.size(); i++) {
+        if (node->inputs()[i] != inputs[i]) {
+          node->setInput(i, inputs[i]);
+        }
+      }
+      schedule.push_back(node);
+    } else {
+      schedule.push_back(entry.factory(std::move(inputs)));
+    }
+  }
+  for (const auto& [treeIdx, entryIdx] : plan.useMoves) {
+    treeNodes[treeIdx]->replaceAllUsesWith(schedule[entryIdx]);
+  }
+  return schedule.back();
+}
+
+void GraphCache::insert(
+    const std::string& key,
+    std::shared_ptr<const Plan> plan) {
+  keys_.push_front(key);
+  keyToPlan_.emplace(key, std::make_pair(std::move(plan), keys_.begin()));
+  if (keys_.size() > capacity_) {
+    keyToPlan_.erase(keys_.back());
+    keys_.pop_back();
+  }
+}
+
+NodePtr GraphCache::optimize(
+    NodePtr root,
+    const OptimizeFunc& optimizeFunc,
+    std::vector<NodePtr>& schedule) {
+  schedule.clear();
+  CanonicalTree tree;
+  visitForTree(root, tree);
+  if (!tree.cacheable || capacity_ == 0) {
+    stats_.misses++;
+    return optimizeFunc(root);
+  }
+
+  const auto key = tree.key.str();
+  const auto iter = keyToPlan_.find(key);
+  if (iter != keyToPlan_.end()) {
+    stats_.hits++;
+    auto& [plan, keyIter] = iter->second;
+    keys_.splice(keys_.begin(), keys_, keyIter);
+    return replayPlan(*plan, tree.nodes, schedule);
+  }
+
+  stats_.misses++;
+  std::vector<std::pair<ExternalUse*, unsigned>> externalUses;
+  for (unsigned i = 0; i < tree.nodes.size(); i++) {
+    for (auto* externalUse : tree.nodes[i]->externalUses()) {
+      externalUses.emplace_back(externalUse, i);
+    }
+  }
+  const auto optimizedRoot = optimizeFunc(root);
+  auto plan = recordPlan(tree.nodes, externalUses, optimizedRoot, schedule);
+  if (plan) {
+    insert(key, std::move(plan));
+  }
+  return optimizedRoot;
+}
+
+const GraphCache::Stats& GraphCache::getStats() const {
+  return stats_;
+}
+
+void GraphCache::clearStats() {
+  stats_ = Stats();
+}
+
+void GraphCache::clear() {
+  keys_.clear();
+  keyToPlan_.clear();
+}
+
+} // namespace fl
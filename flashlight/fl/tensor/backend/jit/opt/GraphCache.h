@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flashlight/fl/tensor/backend/jit/ir/ExternalUse.h"
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+
+namespace fl {
+
+/**
+ * A cache of optimization results, keyed by the _structure_ of JIT trees.
+ *
+ * The key of a tree encodes its node types, ops, shapes, dtypes, scalar values
+ * and use counts (optimization decisions depend on them); values of leaf
+ * tensors (nodes with results, e.g., ValueNode) are abstracted away.
+ *
+ * On a miss, the tree is optimized and the rewrite is recorded as a "plan":
+ * 1. nodes that survived optimization are referred to by their position in
+ *    the tree, along with their (possibly updated) inputs.
+ * 2. nodes created by optimization are recorded as factories.
+ * On a hit, the plan is replayed on the new tree without running any pass.
+ * In both cases, the plan also yields an evaluation schedule, i.e., the
+ * optimized tree in topological order. Once full, the least recently used
+ * plan is evicted, so one-off trees don't push out recurring ones (e.g., a
+ * training step).
+ *
+ * Trees with nodes whose semantics can't be captured structurally (e.g.,
+ * CustomNode & IndexNode) are never cached.
+ */
+class GraphCache {
+ public:
+  using OptimizeFunc = std::function<NodePtr(NodePtr)>;
+
+  struct Stats {
+    unsigned hits{0};
+    unsigned misses{0};
+  };
+
+ private:
+  struct Plan;
+
+  const unsigned capacity_;
+  // most recently used at front, for LRU eviction
+  std::list<std::string> keys_;
+  std::unordered_map<
+      std::string,
+      std::pair<std::shared_ptr<const Plan>, std::list<std::string>::iterator>>
+      keyToPlan_;
+  Stats stats_;
+
+  // Record how `root` was derived from `treeNodes` (in canonical order) via
+  // optimization, or nullptr if the rewrite can't be replayed.
+  static std::shared_ptr<const Plan> recordPlan(
+      const std::vector<NodePtr>& treeNodes,
+      const std::vector<std::pair<ExternalUse*, unsigned>>& externalUses,
+      NodePtr root,
+      std::vector<NodePtr>& schedule);
+
+  // Apply `plan` to `treeNodes` (in canonical order), returns the new root.
+  static NodePtr replayPlan(
+      const Plan& plan,
+      const std::vector<NodePtr>& treeNodes,
+      std::vector<NodePtr>& schedule);
+
+  void insert(const std::string& key, std::shared_ptr<const Plan> plan);
+
+ public:
+  static constexpr unsigned kDefaultCapacity = 256;
+
+  explicit GraphCache(unsigned capacity = kDefaultCapacity);
+  ~GraphCache();
+
+  /**
+   * Optimize the tree rooted at `root` via a cached plan if there's one,
+   * otherwise via `optimizeFunc`, whose result will be cached.
+   *
+   * @param[in] root the root node of the JIT tree to be optimized
+   * @param[in] optimizeFunc the optimization to be memoized.
+   * @param[out] schedule nodes of the optimized tree in topological order, or
+   * empty if the tree can't be cached.
+   * @return root to the optimized tree
+   */
+  NodePtr optimize(
+      NodePtr root,
+      const OptimizeFunc& optimizeFunc,
+      std::vector<NodePtr>& schedule);
+
+  const Stats& getStats() const;
+  void clearStats();
+  // drop all cached plans
+  void clear();
+};
+
+} // namespace fl
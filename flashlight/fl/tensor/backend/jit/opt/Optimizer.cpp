@@ -12,6 +12,10 @@
 #include "flashlight/fl/tensor/TensorBackend.h"
 #include "flashlight/fl/tensor/backend/jit/opt/JitOptimizerExtension.h"
 #include "flashlight/fl/tensor/backend/jit/opt/JitOptimizerExtensionBackends.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/AlgebraicSimplification.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/CommonSubexpressionElimination.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/DeadNodePruning.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/ElementwiseFusion.h"
 #include "flashlight/fl/tensor/backend/jit/opt/passes/ScalarFolding.h"
 
 namespace fl {
@@ -33,18 +37,57 @@ Optimizer::Optimizer(TensorBackend& backend) : backend_(backend) {
   // 1. figure out a configuration API (e.g., LLVM pass style macro)
   // 2. think about ordering
   passes_.emplace_back(std::make_unique<ScalarFolding>());
+  passes_.emplace_back(std::make_unique<AlgebraicSimplification>());
+  passes_.emplace_back(std::make_unique<CommonSubexpressionElimination>());
+  // clean up after the rewrites above, so use counts are accurate for fusion
+  passes_.emplace_back(std::make_unique<DeadNodePruning>());
   auto& registrar = detail::TensorExtensionRegistrar::getInstance();
   if (registrar.isTensorExtensionRegistered(
           backend_.backendType(), TensorExtensionType::JitOptimizer)) {
     extend(passes_, backend_.getExtension<JitOptimizerExtension>().passes());
   }
+  // runs after backend-specific passes, which may know better ways to fuse
+  passes_.emplace_back(std::make_unique<ElementwiseFusion>(backend_));
 }
 
-NodePtr Optimizer::optimize(NodePtr node) {
+NodePtr Optimizer::runPasses(NodePtr node) {
   for (const auto& pass : passes_) {
     node = pass->apply(node);
   }
   return node;
 }
 
+NodePtr Optimizer::optimize(NodePtr node) {
+  std::vector<NodePtr> schedule;
+  return optimize(node, schedule);
+}
+
+NodePtr Optimizer::optimize(NodePtr node, std::vector<NodePtr>& schedule) {
+  if (!graphCacheEnabled_) {
+    schedule.clear();
+    return runPasses(node);
+  }
+  return graphCache_.optimize(
+      node, [this](NodePtr root) { return runPasses(root); }, schedule);
+}
+
+void Optimizer::setGraphCacheState(bool active) {
+  graphCacheEnabled_ = active;
+  if (!active) {
+    graphCache_.clear();
+  }
+}
+
+bool Optimizer::getGraphCacheState() {
+  return graphCacheEnabled_;
+}
+
+const GraphCache::Stats& Optimizer::getGraphCacheStats() {
+  return graphCache_.getStats();
+}
+
+void Optimizer::clearGraphCacheStats() {
+  graphCache_.clearStats();
+}
+
 } // namespace fl
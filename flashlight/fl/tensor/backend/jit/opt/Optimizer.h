@@ -8,8 +8,10 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+#include "flashlight/fl/tensor/backend/jit/opt/GraphCache.h"
 #include "flashlight/fl/tensor/backend/jit/opt/Pass.h"
 
 namespace fl {
@@ -21,6 +23,11 @@ class Optimizer {
   std::vector<std::unique_ptr<Pass>> passes_;
   // backend used for optional JIT optimizer extension
   TensorBackend& backend_;
+  // memoizes `runPasses` across structurally identical trees
+  GraphCache graphCache_;
+  bool graphCacheEnabled_{true};
+
+  NodePtr runPasses(NodePtr node);
 
  public:
   explicit Optimizer(TensorBackend& backend);
@@ -32,6 +39,26 @@ class Optimizer {
    * @return root to the updated tree
    */
   NodePtr optimize(NodePtr node);
+
+  /**
+   * Same as above, but also returns an evaluation schedule for the optimized
+   * tree (see `Evaluator::eval`), which is memoized along with the
+   * optimization.
+   *
+   * @param[in] node the root node of the JIT tree to be optimized
+   * @param[out] schedule nodes of the updated tree in topological order, or
+   * empty if no schedule is available.
+   * @return root to the updated tree
+   */
+  NodePtr optimize(NodePtr node, std::vector<NodePtr>& schedule);
+
+  /**
+   * Enable/disable memoization of optimization results, see GraphCache.
+   */
+  void setGraphCacheState(bool active);
+  bool getGraphCacheState();
+  const GraphCache::Stats& getGraphCacheStats();
+  void clearGraphCacheStats();
 };
 
 } // namespace fl
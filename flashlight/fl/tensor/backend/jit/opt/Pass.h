@@ -11,6 +11,15 @@
 
 namespace fl {
 
+/**
+ * Returns true if passes should leave `node` alone, and not look at its inputs
+ * either: it's already been evaluated, so there's nothing to gain from
+ * optimizing the computation behind it.
+ */
+inline bool isOptimizationLeaf(const NodePtr& node) {
+  return node->getResult().has_value();
+}
+
 /**
  * A transformation pass over a JIT tree.
  */
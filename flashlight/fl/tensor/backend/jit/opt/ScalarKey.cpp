@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/opt/ScalarKey.h"
+
+#include <stdexcept>
+
+namespace fl::detail {
+
+void writeScalar(std::ostream& os, const ScalarNode& node) {
+  switch (node.dataType()) {
+    case dtype::f16:
+    case dtype::bf16:
+    case dtype::f32:
+    case dtype::f64:
+      os << std::hexfloat << node.scalar<double>() << std::defaultfloat;
+      return;
+    case dtype::u64:
+      os << node.scalar<unsigned long long>();
+      return;
+    case dtype::b8:
+    case dtype::s16:
+    case dtype::s32:
+    case dtype::s64:
+    case dtype::u8:
+    case dtype::u16:
+    case dtype::u32:
+      os << node.scalar<long long>();
+      return;
+  }
+  throw std::runtime_error("[writeScalar] Unknown dtype");
+}
+
+} // namespace fl::detail
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <ostream>
+
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+
+namespace fl::detail {
+
+/**
+ * Writes the value of `node` to `os` for use in a structural key, i.e.,
+ * without loss of precision, so that distinct values have distinct keys.
+ */
+void writeScalar(std::ostream& os, const ScalarNode& node);
+
+} // namespace fl::detail
@@ -10,33 +10,39 @@
 
 #include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
 #include "flashlight/fl/tensor/backend/onednn/OneDnnBackend.h"
 #include "flashlight/fl/tensor/backend/onednn/OneDnnTensor.h"
+#include "flashlight/fl/tensor/backend/onednn/PrimitiveCache.h"
 #include "flashlight/fl/tensor/backend/onednn/Utils.h"
 
 #include "dnnl.hpp"
 
 namespace fl {
 
-struct BinopInfo {
-  NodePtr rhsNode;
-  BinaryOp op;
+// A fusable op, i.e., the primitive op itself or a post-op.
+struct OpInfo {
+  NodePtr node; // either a BinaryNode or a UnaryNode
+  NodePtr rhsNode; // only present for BinaryNode
 };
 
 struct OneDnnOpFusion::SearchState {
-  SearchState(NodePtr root, std::vector<BinopInfo> binopInfos)
-      : searchRoot(root), accumulatedBinopInfos(binopInfos) {}
+  SearchState(NodePtr root, std::vector<OpInfo> opInfos)
+      : searchRoot(root), accumulatedOpInfos(opInfos) {}
   NodePtr searchRoot;
-  // Assume `searchRoot == binop2`
+  // Assume `searchRoot == unop`
   //
   // x0  x1
   //  \  /
   //  binop1  x2
   //     \  /
   //    binop2
+  //      |
+  //     unop
   //
-  // accumulatedBinopInfos: { { binop2->op(), x2 }, { binop1->op(), x1 } }
-  std::vector<BinopInfo> accumulatedBinopInfos;
+  // accumulatedOpInfos: { { unop, null }, { binop2, x2 }, { binop1, x1 } }
+  std::vector<OpInfo> accumulatedOpInfos;
 };
 
 namespace {
@@ -96,6 +102,54 @@ std::optional<dnnl::algorithm> tryBinopToOneDnnAlg(const BinaryOp op) {
       "[tryBinopToOneDnnAlg] Unexpected binary operation type");
 }
 
+struct EltwiseAlg {
+  dnnl::algorithm alg;
+  float alpha{0};
+  float beta{0};
+};
+
+std::optional<EltwiseAlg> tryUnopToOneDnnAlg(const UnaryOp op) {
+  switch (op) {
+    case UnaryOp::Exp:
+      return EltwiseAlg{dnnl::algorithm::eltwise_exp};
+    case UnaryOp::Log:
+      return EltwiseAlg{dnnl::algorithm::eltwise_log};
+    case UnaryOp::Negative:
+      return EltwiseAlg{dnnl::algorithm::eltwise_linear, -1, 0};
+    case UnaryOp::Sqrt:
+      return EltwiseAlg{dnnl::algorithm::eltwise_sqrt};
+    case UnaryOp::Tanh:
+      return EltwiseAlg{dnnl::algorithm::eltwise_tanh};
+    case UnaryOp::Rint:
+      return EltwiseAlg{dnnl::algorithm::eltwise_round};
+    case UnaryOp::Absolute:
+      return EltwiseAlg{dnnl::algorithm::eltwise_abs};
+    case UnaryOp::Sigmoid:
+      return EltwiseAlg{dnnl::algorithm::eltwise_logistic};
+    case UnaryOp::LogicalNot:
+    case UnaryOp::Log1p:
+    case UnaryOp::Sin:
+    case UnaryOp::Cos:
+    case UnaryOp::Floor:
+    case UnaryOp::Ceil:
+    case UnaryOp::Erf:
+    case UnaryOp::IsNan:
+    case UnaryOp::IsInf:
+    case UnaryOp::Sign:
+      return std::nullopt;
+  }
+  throw std::runtime_error(
+      "[tryUnopToOneDnnAlg] Unexpected unary operation type");
+}
+
+EltwiseAlg unopToOneDnnAlg(const UnaryOp op) {
+  const auto alg = tryUnopToOneDnnAlg(op);
+  if (!alg.has_value()) {
+    throw std::runtime_error("[unopToOneDnnAlg] unsupported unop for OneDNN");
+  }
+  return alg.value();
+}
+
 dnnl::algorithm binopToOneDnnAlg(const BinaryOp op) {
   const auto alg = tryBinopToOneDnnAlg(op);
   if (!alg.has_value()) {
@@ -108,10 +162,23 @@ bool isOpFusable(const BinaryOp op) {
   return tryBinopToOneDnnAlg(op).has_value();
 }
 
+bool isOpFusable(const UnaryOp op) {
+  return tryUnopToOneDnnAlg(op).has_value();
+}
+
 bool isNodeFusable(const NodePtr node) {
-  return node->isBinary() && isOpFusable(node->impl<BinaryNode>().op());
+  return (node->isBinary() && isOpFusable(node->impl<BinaryNode>().op())) ||
+      (node->isUnary() && isOpFusable(node->impl<UnaryNode>().op()));
 }
 
+// Describes how to build a post-op (or the primitive itself)
+struct FusedOp {
+  bool isBinary;
+  dnnl::algorithm alg;
+  float alpha;
+  float beta;
+};
+
 bool isFusionProfitable(const NodePtr node) {
   // TODO
   // Even if we have multiple uses, it might be possible & profitable to fuse,
@@ -120,13 +187,55 @@ bool isFusionProfitable(const NodePtr node) {
 }
 
 bool shouldNodeBeFused(const NodePtr node) {
-  return isNodeFusable(node) && isFusionProfitable(node);
+  // already evaluated nodes are just inputs
+  return !node->getResult().has_value() && isNodeFusable(node) &&
+      isFusionProfitable(node);
+}
+
+bool shouldMatmulBeFused(const NodePtr node) {
+  if (!node->isMatmul() || node->getResult().has_value() ||
+      !isFusionProfitable(node)) {
+    return false;
+  }
+  // OneDnnBackend pads vectors and batch dims, stick to the plain case of
+  // equal ranks, where OneDNN broadcasts batch dims without any reshaping.
+  const auto& matmulNode = node->impl<MatmulNode>();
+  const auto lhsRank = matmulNode.lhs()->shape().ndim();
+  const auto rhsRank = matmulNode.rhs()->shape().ndim();
+  return lhsRank >= 2 && lhsRank == rhsRank;
+}
+
+void appendPostOps(
+    const std::vector<FusedOp>& ops,
+    unsigned firstPostOpIdx,
+    const std::vector<const Tensor*>& inputs,
+    unsigned firstPostOpInputIdx,
+    dnnl::post_ops& postOps,
+    std::unordered_map<int, dnnl::memory>& args) {
+  unsigned nextInputIdx = firstPostOpInputIdx;
+  for (unsigned i = firstPostOpIdx; i < ops.size(); i++) {
+    const auto& op = ops[i];
+    const auto postOpIdx = i - firstPostOpIdx;
+    if (op.isBinary) {
+      // set up the other input for post-op
+      auto& otherMem = toOneDnnTensor(*inputs[nextInputIdx++]).memory();
+      postOps.append_binary(op.alg, otherMem.get_desc());
+      args.insert( // DNNL_ARG_SRC_1 feels totally arbitrary...
+          {DNNL_ARG_ATTR_MULTIPLE_POST_OP(postOpIdx) | DNNL_ARG_SRC_1,
+           otherMem});
+    } else {
+      postOps.append_eltwise(op.alg, op.alpha, op.beta);
+    }
+  }
 }
 
 } // namespace
 
 NodePtr OneDnnOpFusion::rewriteFrom(NodePtr node) {
-  SearchState state(node, /* accumulatedBinopInfos = */ {});
+  if (isOptimizationLeaf(node)) {
+    return node;
+  }
+  SearchState state(node, /* accumulatedOpInfos = */ {});
   auto fusedNode = searchAndFuse(node, state);
   node->replaceAllUsesWith(fusedNode);
   return fusedNode;
@@ -135,7 +244,7 @@ NodePtr OneDnnOpFusion::rewriteFrom(NodePtr node) {
 NodePtr OneDnnOpFusion::searchAndFuse(NodePtr node, SearchState& state) {
   // TODO for now we just skip shared input, need to think more.
   if (visited_.find(node) != visited_.end() || !shouldNodeBeFused(node) ||
-      state.accumulatedBinopInfos.size() > kOneDnnMaxNumPostOps) {
+      state.accumulatedOpInfos.size() > kOneDnnMaxNumPostOps) {
     return fuseNodes(node, state);
   }
   visited_.insert(node);
@@ -144,13 +253,15 @@ NodePtr OneDnnOpFusion::searchAndFuse(NodePtr node, SearchState& state) {
     const auto& binaryNode = node->impl<BinaryNode>();
     const auto lhs = binaryNode.lhs();
     const auto rhs = binaryNode.rhs();
-    const auto op = binaryNode.op();
-    state.accumulatedBinopInfos.push_back({rewriteFrom(rhs), op});
+    state.accumulatedOpInfos.push_back({node, rewriteFrom(rhs)});
     return searchAndFuse(lhs, state);
+  } else if (node->isUnary()) {
+    state.accumulatedOpInfos.push_back({node, nullptr});
+    return searchAndFuse(node->impl<UnaryNode>().input(), state);
   } else {
     // TODO support more fusion for more kinds of op (e.g., reduction)
     throw std::runtime_error(
-        "[OneDnnOpFusion::rewriteFrom] If node should be fused, it must be binary node");
+        "[OneDnnOpFusion::rewriteFrom] If node should be fused, it must be binary or unary node");
   }
 }
 
@@ -158,36 +269,79 @@ NodePtr OneDnnOpFusion::fuseNodes(NodePtr node, SearchState& state) {
   for (const auto& input : node->inputs()) {
     rewriteFrom(input);
   }
+  auto& opInfos = state.accumulatedOpInfos;
+  if (!opInfos.empty() && shouldMatmulBeFused(node)) {
+    if (opInfos.size() <= kOneDnnMaxNumPostOps) {
+      return fuseMatmulEpilogue(node, state);
+    }
+    // A matmul has no spare op for the primitive itself, so all accumulated
+    // ops would become post-ops. Only the ones closest to the matmul go into
+    // its epilogue, the rest are fused on top of it like any other leaf.
+    const auto numRemainingOps = opInfos.size() - kOneDnnMaxNumPostOps;
+    const auto epilogueRoot = opInfos[numRemainingOps].node;
+    SearchState epilogueState(
+        epilogueRoot,
+        std::vector<OpInfo>(opInfos.begin() + numRemainingOps, opInfos.end()));
+    const auto epilogue = fuseMatmulEpilogue(node, epilogueState);
+    epilogueRoot->replaceAllUsesWith(epilogue);
+    opInfos.resize(numRemainingOps);
+    node = epilogue;
+  }
+
+  // OneDNN binary primitive must start with a binary op, so unary ops right
+  // above the leaf are left alone, e.g., `x1` becomes `op0` below.
+  //
+  //  x0
+  //  |
+  //  op0  x2
+  //    \  /
+  //    op1
+  NodePtr leaf = node;
+  while (!opInfos.empty() && !opInfos.back().node->isBinary()) {
+    leaf = opInfos.back().node;
+    opInfos.pop_back();
+  }
+
   // Nothing to fuse, it's one of the following:
   // 1. node
   //
   // 2. node  ...
   //      \  /
   //    searchRoot
-  if (state.accumulatedBinopInfos.size() < 2) {
+  if (opInfos.size() < 2) {
     return state.searchRoot;
   }
 
-  // In the following case `node` is `x1`
+  // In the following case `leaf` is `x1`
   //
   // x1  x2
   //  \  /
   //   op1  x3
   //     \  /
   //     op2
+  //      |
+  //     op3
   // becomes
   // inputNodes: { x1, x2, x3 }
-  // algs:       { op1, op2 }
-  std::vector<NodePtr> inputNodes{node};
-  std::vector<dnnl::algorithm> algs;
-  for (int i = state.accumulatedBinopInfos.size() - 1; i >= 0; i--) {
-    const auto& info = state.accumulatedBinopInfos[i];
-    algs.push_back(binopToOneDnnAlg(info.op));
-    inputNodes.push_back(info.rhsNode);
+  // ops:        { op1, op2, op3 }
+  std::vector<NodePtr> inputNodes{leaf};
+  std::vector<FusedOp> ops;
+  for (int i = opInfos.size() - 1; i >= 0; i--) {
+    const auto& info = opInfos[i];
+    if (info.node->isBinary()) {
+      const auto alg = binopToOneDnnAlg(info.node->impl<BinaryNode>().op());
+      ops.push_back({/* isBinary = */ true, alg, 0, 0});
+      inputNodes.push_back(info.rhsNode);
+    } else {
+      const auto eltwise = unopToOneDnnAlg(info.node->impl<UnaryNode>().op());
+      ops.push_back(
+          {/* isBinary = */ false, eltwise.alg, eltwise.alpha, eltwise.beta});
+    }
   }
 
-  // TODO refactor with common logic in OneDnnBackend
-  auto evalFunc = [algs = std::move(algs),
+  // like OneDnnBackend's ops, the dst buffer comes from the backend's host
+  // memory manager and the primitive from its cache
+  auto evalFunc = [ops = std::move(ops),
                    dstShape = state.searchRoot->shape()](
                       const std::vector<const Tensor*>& inputs) {
     const Tensor* lhs = inputs[0];
@@ -200,14 +354,14 @@ NodePtr OneDnnOpFusion::fuseNodes(NodePtr node, SearchState& state) {
     auto& engine = backend.engine();
 
     // prepare memories
-    dnnl::algorithm alg = algs.front();
+    dnnl::algorithm alg = ops.front().alg;
     auto& lhsMem = toOneDnnTensor(*lhs).memory();
     auto& rhsMem = toOneDnnTensor(*rhs).memory();
     const auto lhsMemDesc = lhsMem.get_desc();
     const auto rhsMemDesc = rhsMem.get_desc();
     const auto dstMemDesc =
         detail::oneDnnContiguousMemDescFromShape(dstShape, dstType);
-    auto dstMem = dnnl::memory(dstMemDesc, engine);
+    auto [dstMem, dstBuffer] = backend.createMemory(dstMemDesc, engine);
 
     // prepare part of arguments
     std::unordered_map<int, dnnl::memory> args = {
@@ -216,34 +370,155 @@ NodePtr OneDnnOpFusion::fuseNodes(NodePtr node, SearchState& state) {
         {DNNL_ARG_DST, dstMem},
     };
 
-    // prepare post ops
-    dnnl::post_ops binops;
-    for (unsigned i = 1; i < algs.size(); i++) {
-      // set up the other input for post-op
-      auto& otherMem = toOneDnnTensor(*inputs[i + 1]).memory();
-      binops.append_binary(algs[i], otherMem.get_desc());
-      args.insert( // DNNL_ARG_SRC_1 feels totally arbitrary...
-          {DNNL_ARG_ATTR_MULTIPLE_POST_OP(i - 1) | DNNL_ARG_SRC_1, otherMem});
-    }
+    // prepare post ops, first 2 inputs are used by the primitive
+    dnnl::post_ops postOps;
+    appendPostOps(
+        ops,
+        /* firstPostOpIdx = */ 1,
+        inputs,
+        /* firstPostOpInputIdx = */ 2,
+        postOps,
+        args);
 
     // finish building primitive
     dnnl::primitive_attr binaryAttr;
-    binaryAttr.set_post_ops(binops);
-
-    // prepare part of primitive
-    const dnnl::binary::primitive_desc binaryPrimitiveDesc(
-        engine, alg, lhsMemDesc, rhsMemDesc, dstMemDesc, binaryAttr);
-    const auto binaryPrimitive = dnnl::binary(binaryPrimitiveDesc);
+    binaryAttr.set_post_ops(postOps);
+
+    // prepare primitive
+    const auto key = detail::PrimitiveCacheKeyBuilder()
+                         .add(engine)
+                         .add(dnnl::primitive::kind::binary)
+                         .add(alg)
+                         .add(lhsMemDesc)
+                         .add(rhsMemDesc)
+                         .add(dstMemDesc)
+                         .add(binaryAttr)
+                         .build();
+    const auto binaryPrimitive =
+        backend.primitiveCache().getOrCreate(key, [&]() {
+          return dnnl::binary(dnnl::binary::primitive_desc(
+              engine, alg, lhsMemDesc, rhsMemDesc, dstMemDesc, binaryAttr));
+        });
 
     // execute primitive
-    binaryPrimitive.execute(backend.nativeStream(), args);
-    return toTensor<OneDnnTensor>(dstShape, std::move(dstMem));
+    backend.cpuStream().execute(binaryPrimitive, args);
+    return toTensor<OneDnnTensor>(
+        dstShape, std::move(dstMem), std::move(dstBuffer));
   };
 
   return CustomNode::create(
       "OneDnnFusedBinaryOp",
       std::move(inputNodes),
-      node->shape(),
+      state.searchRoot->shape(),
+      std::move(evalFunc));
+}
+
+NodePtr OneDnnOpFusion::fuseMatmulEpilogue(
+    NodePtr matmulNode,
+    SearchState& state) {
+  // In the following case, all of `op1`, `op2` and `op3` become post-ops
+  //
+  //  w   x
+  //   \ /
+  //  matmul  b
+  //      \  /
+  //       op1
+  //        |
+  //       op2  r
+  //         \ /
+  //         op3
+  // becomes
+  // inputNodes: { w, x, b, r }
+  // ops:        { op1, op2, op3 }
+  const auto& matmul = matmulNode->impl<MatmulNode>();
+  const auto& opInfos = state.accumulatedOpInfos;
+  std::vector<NodePtr> inputNodes{matmul.lhs(), matmul.rhs()};
+  std::vector<FusedOp> ops;
+  for (int i = opInfos.size() - 1; i >= 0; i--) {
+    const auto& info = opInfos[i];
+    if (info.node->isBinary()) {
+      const auto alg = binopToOneDnnAlg(info.node->impl<BinaryNode>().op());
+      ops.push_back({/* isBinary = */ true, alg, 0, 0});
+      inputNodes.push_back(info.rhsNode);
+    } else {
+      const auto eltwise = unopToOneDnnAlg(info.node->impl<UnaryNode>().op());
+      ops.push_back(
+          {/* isBinary = */ false, eltwise.alg, eltwise.alpha, eltwise.beta});
+    }
+  }
+
+  auto evalFunc = [ops = std::move(ops),
+                   lhsProp = matmul.lhsProp(),
+                   rhsProp = matmul.rhsProp(),
+                   dstShape = state.searchRoot->shape()](
+                      const std::vector<const Tensor*>& inputs) {
+    // NOTE this simulates OneDNNBackend's "typing rule", where the result of
+    // each op has the type with larger range among its operands.
+    const auto dstType = getOneDnnTypeWithLargestRange(inputs);
+
+    auto& backend = OneDnnBackend::getInstance();
+    auto& engine = backend.engine();
+
+    // prepare memories
+    auto& lhsTensor = toOneDnnTensor(*inputs[0]);
+    auto& rhsTensor = toOneDnnTensor(*inputs[1]);
+    auto lhsMemDesc = lhsTensor.memoryDesc();
+    auto rhsMemDesc = rhsTensor.memoryDesc();
+    if (lhsProp == MatrixProperty::Transpose) {
+      lhsMemDesc = detail::transposeInnerMatrix(lhsMemDesc);
+    }
+    if (rhsProp == MatrixProperty::Transpose) {
+      rhsMemDesc = detail::transposeInnerMatrix(rhsMemDesc);
+    }
+    const auto dstMemDesc =
+        detail::oneDnnContiguousMemDescFromShape(dstShape, dstType);
+    auto [dstMem, dstBuffer] = backend.createMemory(dstMemDesc, engine);
+
+    // NOTE like OneDnnBackend::matmul, lhs/rhs are switched since our
+    // physical representation is a transpose of the logical representation.
+    std::unordered_map<int, dnnl::memory> args = {
+        {DNNL_ARG_SRC, rhsTensor.memory()},
+        {DNNL_ARG_WEIGHTS, lhsTensor.memory()},
+        {DNNL_ARG_DST, dstMem},
+    };
+
+    // all ops are post-ops, first 2 inputs are used by the primitive
+    dnnl::post_ops postOps;
+    appendPostOps(
+        ops,
+        /* firstPostOpIdx = */ 0,
+        inputs,
+        /* firstPostOpInputIdx = */ 2,
+        postOps,
+        args);
+    dnnl::primitive_attr matmulAttr;
+    matmulAttr.set_post_ops(postOps);
+
+    // prepare primitive
+    const auto key = detail::PrimitiveCacheKeyBuilder()
+                         .add(engine)
+                         .add(dnnl::primitive::kind::matmul)
+                         .add(rhsMemDesc)
+                         .add(lhsMemDesc)
+                         .add(dstMemDesc)
+                         .add(matmulAttr)
+                         .build();
+    const auto matmulPrimitive =
+        backend.primitiveCache().getOrCreate(key, [&]() {
+          return dnnl::matmul(dnnl::matmul::primitive_desc(
+              engine, rhsMemDesc, lhsMemDesc, dstMemDesc, matmulAttr));
+        });
+
+    // execute primitive
+    backend.cpuStream().execute(matmulPrimitive, args);
+    return toTensor<OneDnnTensor>(
+        dstShape, std::move(dstMem), std::move(dstBuffer));
+  };
+
+  return CustomNode::create(
+      "OneDnnFusedMatmul",
+      std::move(inputNodes),
+      state.searchRoot->shape(),
       std::move(evalFunc));
 }
 
@@ -21,6 +21,9 @@ namespace fl {
  *
  * NOTE
  * 1. due to OneDNN limitation, binary post-op only supports rhs argument.
+ *    Unary ops are fused as eltwise post-ops, but the fused chain must start
+ *    with a binary op or a matmul (the primitive itself), e.g., the epilogue
+ *    of `relu(matmul(w, x) + b)` is fused into the matmul primitive.
  * 2. currently we avoid recomputation -- fuse iff intermediate nodes are _only_
  *    used as input nodes in the chain. There might be places where benefit of
  *    aggressive fusion outweighs cost of recomputation, need to investigate
@@ -44,7 +47,7 @@ namespace fl {
  * TODO
  * - leverage commutativity of certain binops to bypass the rhs-only limitation
  *   of OneDNN binary post-ops.
- * - support more than just binop fusion
+ * - support more than just binop & eltwise fusion (e.g., reduction)
  */
 class OneDnnOpFusion : public Pass {
   struct SearchState;
@@ -62,6 +65,9 @@ class OneDnnOpFusion : public Pass {
   // Actual fusion of an op-chain, `node` is a leaf input.
   NodePtr fuseNodes(NodePtr node, SearchState& state);
 
+  // Fuse the op-chain as post-ops of `matmulNode`'s primitive.
+  NodePtr fuseMatmulEpilogue(NodePtr matmulNode, SearchState& state);
+
  public:
   OneDnnOpFusion() = default;
   ~OneDnnOpFusion() = default;
@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/opt/passes/AlgebraicSimplification.h"
+
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
+
+namespace fl {
+
+namespace {
+
+bool isFloatType(const dtype type) {
+  switch (type) {
+    case dtype::f16:
+    case dtype::bf16:
+    case dtype::f32:
+    case dtype::f64:
+      return true;
+    case dtype::b8:
+    case dtype::s16:
+    case dtype::s32:
+    case dtype::s64:
+    case dtype::u8:
+    case dtype::u16:
+    case dtype::u32:
+    case dtype::u64:
+      return false;
+  }
+  throw std::runtime_error("[isFloatType] Unknown dtype");
+}
+
+bool isScalarOf(const NodePtr& node, const double value) {
+  return node->isScalar() && !node->getResult().has_value() &&
+      node->impl<ScalarNode>().scalar<double>() == value;
+}
+
+class Simplifier {
+  // NodePtr keys keep nodes alive, so addresses aren't reused by new nodes
+  std::unordered_map<NodePtr, NodePtr> simplified_;
+  std::unordered_map<NodePtr, std::optional<dtype>> inferredTypes_;
+
+  // Conservatively infer output type of `node` w/o evaluating it, since type
+  // promotion rules are backend-specific.
+  std::optional<dtype> inferType(const NodePtr& node) {
+    const auto iter = inferredTypes_.find(node);
+    if (iter != inferredTypes_.end()) {
+      return iter->second;
+    }
+    const auto type = inferTypeImpl(node);
+    inferredTypes_.emplace(node, type);
+    return type;
+  }
+
+  std::optional<dtype> inferTypeImpl(const NodePtr& node) {
+    if (node->getResult().has_value()) {
+      return node->getResult()->type();
+    }
+    switch (node->type()) {
+      case NodeType::Scalar:
+        return node->impl<ScalarNode>().dataType();
+      case NodeType::Unary: {
+        const auto& unaryNode = node->impl<UnaryNode>();
+        const auto op = unaryNode.op();
+        if (op == UnaryOp::LogicalNot || op == UnaryOp::IsNan ||
+            op == UnaryOp::IsInf) {
+          return std::nullopt;
+        }
+        const auto inputType = inferType(unaryNode.input());
+        if (inputType.has_value() && isFloatType(inputType.value())) {
+          return inputType;
+        }
+        return std::nullopt;
+      }
+      case NodeType::Binary: {
+        const auto& binaryNode = node->impl<BinaryNode>();
+        switch (binaryNode.op()) {
+          case BinaryOp::Add:
+          case BinaryOp::Sub:
+          case BinaryOp::Mul:
+          case BinaryOp::Div:
+          case BinaryOp::Max:
+          case BinaryOp::Min:
+          case BinaryOp::Pow:
+            break;
+          default:
+            return std::nullopt;
+        }
+        const auto lhsType = inferType(binaryNode.lhs());
+        const auto rhsType = inferType(binaryNode.rhs());
+        if (!lhsType.has_value() || !rhsType.has_value()) {
+          return std::nullopt;
+        }
+        if (lhsType == rhsType) {
+          return lhsType;
+        }
+        // floating point wins over integral, regardless of size
+        const bool lhsFloat = isFloatType(lhsType.value());
+        const bool rhsFloat = isFloatType(rhsType.value());
+        if (lhsFloat != rhsFloat) {
+          return lhsFloat ? lhsType : rhsType;
+        }
+        return std::nullopt;
+      }
+      // views preserve type
+      case NodeType::View:
+        return inferType(node->impl<ViewNode>().input());
+      case NodeType::Custom:
+      case NodeType::Index:
+      case NodeType::IndexedUpdate:
+      case NodeType::Matmul:
+      case NodeType::Reduction:
+      case NodeType::Value:
+        return std::nullopt;
+    }
+    throw std::runtime_error("[Simplifier::inferType] Unknown node type");
+  }
+
+  // Whether `x op scalar` provably has the same shape & type as `x`.
+  bool preservesShapeAndType(
+      const NodePtr& result,
+      const NodePtr& x,
+      const NodePtr& scalar) {
+    if (result->shape() != x->shape()) {
+      return false;
+    }
+    const auto xType = inferType(x);
+    const auto scalarType = scalar->impl<ScalarNode>().dataType();
+    return xType.has_value() &&
+        (xType.value() == scalarType ||
+         (isFloatType(xType.value()) && !isFloatType(scalarType)));
+  }
+
+  NodePtr simplifyBinaryNode(const NodePtr& node) {
+    const auto& binaryNode = node->impl<BinaryNode>();
+    const auto lhs = binaryNode.lhs();
+    const auto rhs = binaryNode.rhs();
+    // `x op c`, whose result has the shape & type of `x`
+    auto rhsIsScalar = [&](double value) {
+      return isScalarOf(rhs, value) && preservesShapeAndType(node, lhs, rhs);
+    };
+    // `x op c` --> `x`, if `c` is the right identity of `op`
+    auto rightIdentity = [&](double identity) {
+      return rhsIsScalar(identity);
+    };
+    // `c op x` --> `x`, if `c` is the left identity of `op`
+    auto leftIdentity = [&](double identity) {
+      return isScalarOf(lhs, identity) &&
+          preservesShapeAndType(node, rhs, lhs);
+    };
+    switch (binaryNode.op()) {
+      // NOTE like `-fno-signed-zeros`, `-0 + 0` is taken as `-0`
+      case BinaryOp::Add:
+        if (rightIdentity(0)) {
+          return lhs;
+        } else if (leftIdentity(0)) {
+          return rhs;
+        }
+        return node;
+      case BinaryOp::Sub:
+        return rightIdentity(0) ? lhs : node;
+      case BinaryOp::Mul:
+        if (rightIdentity(1)) {
+          return lhs;
+        } else if (leftIdentity(1)) {
+          return rhs;
+        }
+        return node;
+      case BinaryOp::Div:
+        return rightIdentity(1) ? lhs : node;
+      case BinaryOp::Pow:
+        if (rightIdentity(1)) {
+          return lhs;
+        } else if (rhsIsScalar(2)) {
+          // `x ^ 2` --> `x * x`
+          return BinaryNode::create(lhs, lhs, BinaryOp::Mul);
+        }
+        return node;
+      default:
+        return node;
+    }
+  }
+
+  NodePtr simplifyUnaryNode(const NodePtr& node) {
+    const auto& unaryNode = node->impl<UnaryNode>();
+    const auto input = unaryNode.input();
+    // -(-x) --> x
+    if (unaryNode.op() == UnaryOp::Negative && input->isUnary() &&
+        !input->getResult().has_value() &&
+        input->impl<UnaryNode>().op() == UnaryOp::Negative) {
+      // unsigned negation wraps around, but booleans may be promoted
+      const auto x = input->impl<UnaryNode>().input();
+      const auto xType = inferType(x);
+      if (xType.has_value() && xType.value() != dtype::b8) {
+        return x;
+      }
+    }
+    return node;
+  }
+
+  NodePtr simplifyViewNode(const NodePtr& node) {
+    const auto& viewNode = node->impl<ViewNode>();
+    const auto input = viewNode.input();
+    // view that doesn't move any element --> x
+    // NOTE a transpose that only moves around size-1 axes doesn't either
+    if (node->shape() == input->shape() &&
+        viewNode.viewType() != ViewType::Transpose) {
+      return input;
+    }
+    if (viewNode.viewType() == ViewType::Transpose) {
+      const auto axes = viewNode.transposeAxes();
+      bool isIdentity = true;
+      for (unsigned i = 0; i < axes.size(); i++) {
+        isIdentity &= axes[i] == static_cast<int>(i);
+      }
+      if (isIdentity) {
+        return input;
+      }
+    }
+    // reshape(reshape(x)) --> reshape(x)
+    if (viewNode.viewType() == ViewType::Reshape && input->isView() &&
+        !input->getResult().has_value() &&
+        input->impl<ViewNode>().viewType() == ViewType::Reshape) {
+      return ViewNode::create(
+          input->impl<ViewNode>().input(), ViewType::Reshape, node->shape());
+    }
+    return node;
+  }
+
+ public:
+  NodePtr simplify(NodePtr node) {
+    const auto iter = simplified_.find(node);
+    if (iter != simplified_.end()) {
+      return iter->second;
+    }
+    if (isOptimizationLeaf(node)) {
+      simplified_.emplace(node, node);
+      return node;
+    }
+    // simplifying an input updates all its uses, including `node`
+    for (unsigned i = 0; i < node->inputs().size(); i++) {
+      simplify(node->inputs()[i]);
+    }
+    NodePtr newNode = node;
+    switch (node->type()) {
+      case NodeType::Binary:
+        newNode = simplifyBinaryNode(node);
+        break;
+      case NodeType::Unary:
+        newNode = simplifyUnaryNode(node);
+        break;
+      case NodeType::View:
+        newNode = simplifyViewNode(node);
+        break;
+      case NodeType::Custom:
+      case NodeType::Index:
+      case NodeType::IndexedUpdate:
+      case NodeType::Matmul:
+      case NodeType::Reduction:
+      case NodeType::Scalar:
+      case NodeType::Value:
+        break;
+    }
+    if (newNode != node) {
+      node->replaceAllUsesWith(newNode);
+    }
+    simplified_.emplace(node, newNode);
+    return newNode;
+  }
+};
+
+} // namespace
+
+NodePtr AlgebraicSimplification::apply(NodePtr node) {
+  return Simplifier().simplify(node);
+}
+
+} // namespace fl
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/tensor/backend/jit/opt/Pass.h"
+
+namespace fl {
+
+/**
+ * An optimization pass that recursively rewrites algebraic identities inside a
+ * JIT tree, e.g.,
+ *   x * 1, x / 1, x + 0, x - 0, x ^ 1, -(-x)  -->  x
+ *   x ^ 2                                     -->  x * x
+ *
+ * A rewrite only happens if it provably preserves the output shape and type
+ * (e.g., `x * 1` isn't rewritten if `1` broadcasts `x` or promotes its type).
+ * Rewritten nodes are left dead, see `DeadNodePruning`.
+ */
+class AlgebraicSimplification : public Pass {
+ public:
+  NodePtr apply(NodePtr node) override;
+};
+
+} // namespace fl
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/opt/passes/CommonSubexpressionElimination.h"
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
+#include "flashlight/fl/tensor/backend/jit/opt/ScalarKey.h"
+
+namespace fl {
+
+namespace {
+
+bool isCommutative(const BinaryOp op) {
+  switch (op) {
+    case BinaryOp::Add:
+    case BinaryOp::Mul:
+    case BinaryOp::Eq:
+    case BinaryOp::Neq:
+    case BinaryOp::Max:
+    case BinaryOp::Min:
+    case BinaryOp::And:
+    case BinaryOp::Or:
+    case BinaryOp::BitAnd:
+    case BinaryOp::BitOr:
+    case BinaryOp::BitXor:
+      return true;
+    case BinaryOp::Sub:
+    case BinaryOp::Div:
+    case BinaryOp::Gt:
+    case BinaryOp::Gte:
+    case BinaryOp::Lt:
+    case BinaryOp::Lte:
+    case BinaryOp::Pow:
+    case BinaryOp::Mod:
+    case BinaryOp::Shl:
+    case BinaryOp::Shr:
+      return false;
+  }
+  throw std::runtime_error("[isCommutative] Unknown binary operation type");
+}
+
+// Inputs are identified by address -- they've been merged already, so
+// identical inputs are the same node.
+void writeInputs(std::ostream& os, std::vector<const Node*> inputs) {
+  for (const auto* input : inputs) {
+    os << "," << input;
+  }
+}
+
+// Returns a key that's equal for 2 nodes iff they compute the same value, or
+// nullopt if `node` must not be merged.
+std::optional<std::string> getKey(const NodePtr& node) {
+  std::ostringstream oss;
+  oss << static_cast<int>(node->type()) << node->shape();
+  switch (node->type()) {
+    case NodeType::Binary: {
+      const auto& binaryNode = node->impl<BinaryNode>();
+      const auto op = binaryNode.op();
+      std::vector<const Node*> inputs{
+          binaryNode.lhs().get(), binaryNode.rhs().get()};
+      if (isCommutative(op)) {
+        std::sort(inputs.begin(), inputs.end());
+      }
+      oss << "b" << static_cast<int>(op);
+      writeInputs(oss, std::move(inputs));
+      return oss.str();
+    }
+    case NodeType::Unary: {
+      const auto& unaryNode = node->impl<UnaryNode>();
+      oss << "n" << static_cast<int>(unaryNode.op());
+      writeInputs(oss, {unaryNode.input().get()});
+      return oss.str();
+    }
+    case NodeType::Reduction: {
+      const auto& reductionNode = node->impl<ReductionNode>();
+      oss << "r" << static_cast<int>(reductionNode.op()) << "k"
+          << reductionNode.keepDims() << "a";
+      for (const auto axis : reductionNode.axes()) {
+        oss << axis << ",";
+      }
+      writeInputs(oss, {reductionNode.input().get()});
+      return oss.str();
+    }
+    case NodeType::Matmul: {
+      const auto& matmulNode = node->impl<MatmulNode>();
+      oss << "m" << static_cast<int>(matmulNode.lhsProp())
+          << static_cast<int>(matmulNode.rhsProp());
+      writeInputs(oss, {matmulNode.lhs().get(), matmulNode.rhs().get()});
+      return oss.str();
+    }
+    case NodeType::View: {
+      const auto& viewNode = node->impl<ViewNode>();
+      oss << "v" << static_cast<int>(viewNode.viewType()) << viewNode.params();
+      writeInputs(oss, {viewNode.input().get()});
+      return oss.str();
+    }
+    case NodeType::Scalar: {
+      const auto& scalarNode = node->impl<ScalarNode>();
+      oss << "s" << static_cast<int>(scalarNode.dataType()) << "=";
+      detail::writeScalar(oss, scalarNode);
+      return oss.str();
+    }
+    // CustomNode's evaluation logic is opaque, IndexNode may have tensor
+    // indices, and ValueNodes are distinct tensors.
+    case NodeType::Custom:
+    case NodeType::Index:
+    case NodeType::IndexedUpdate:
+    case NodeType::Value:
+      return std::nullopt;
+  }
+  throw std::runtime_error("[getKey] Unknown node type");
+}
+
+class Eliminator {
+  // node -> the node it's been merged into (possibly itself)
+  std::unordered_map<NodePtr, NodePtr> merged_;
+  std::unordered_map<std::string, NodePtr> keyToNode_;
+
+ public:
+  NodePtr eliminate(NodePtr node) {
+    const auto iter = merged_.find(node);
+    if (iter != merged_.end()) {
+      return iter->second;
+    }
+    if (!isOptimizationLeaf(node)) {
+      // merging an input updates all its uses, including `node`
+      for (unsigned i = 0; i < node->inputs().size(); i++) {
+        eliminate(node->inputs()[i]);
+      }
+      const auto key = getKey(node);
+      if (key.has_value()) {
+        const auto [keyIter, inserted] = keyToNode_.emplace(key.value(), node);
+        if (!inserted) {
+          const auto existing = keyIter->second;
+          node->replaceAllUsesWith(existing);
+          merged_.emplace(node, existing);
+          return existing;
+        }
+      }
+    }
+    merged_.emplace(node, node);
+    return node;
+  }
+};
+
+} // namespace
+
+NodePtr CommonSubexpressionElimination::apply(NodePtr node) {
+  return Eliminator().eliminate(node);
+}
+
+} // namespace fl
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/tensor/backend/jit/opt/Pass.h"
+
+namespace fl {
+
+/**
+ * An optimization pass that merges structurally identical nodes with identical
+ * inputs inside a JIT tree, e.g., the 2 `x * 2` below become 1 node.
+ *
+ *  x  2   x  2            x  2
+ *   \ /    \ /             \ /
+ *   mul    mul     -->     mul
+ *     \    /               / \
+ *       add                add
+ *
+ * Only nodes whose semantics are fully captured by their type, op, shape and
+ * inputs are merged, i.e., Binary, Unary, Reduction & Scalar nodes. Merged
+ * nodes are left dead, see `DeadNodePruning`.
+ */
+class CommonSubexpressionElimination : public Pass {
+ public:
+  NodePtr apply(NodePtr node) override;
+};
+
+} // namespace fl
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/opt/passes/DeadNodePruning.h"
+
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace fl {
+
+namespace {
+
+bool isPrunable(const Node& node, const Node& root) {
+  if (&node == &root || !node.uses().empty() ||
+      !node.externalUses().empty() || node.getResult().has_value()) {
+    return false;
+  }
+  switch (node.type()) {
+    case NodeType::Binary:
+    case NodeType::Custom:
+    case NodeType::Matmul:
+    case NodeType::Reduction:
+    case NodeType::Scalar:
+    case NodeType::Unary:
+    case NodeType::View:
+      return true;
+    // IndexNode may be referenced by JitTensor views w/o an ExternalUse, and
+    // ValueNodes always have results anyway.
+    case NodeType::Index:
+    case NodeType::IndexedUpdate:
+    case NodeType::Value:
+      return false;
+  }
+  throw std::runtime_error("[isPrunable] Unknown node type");
+}
+
+void prune(Node& node, const Node& root) {
+  // keep inputs alive while we look at them
+  const auto inputs = node.inputs();
+  node.unlinkInputs();
+  for (const auto& input : inputs) {
+    if (isPrunable(*input, root)) {
+      prune(*input, root);
+    }
+  }
+}
+
+// Returns true if a dead user of `node` was pruned. Pruning invalidates
+// `node->uses()`, and may destroy other dead users, so we prune one at a time.
+bool pruneDeadUser(const NodePtr& node, const Node& root) {
+  for (const auto& use : node->uses()) {
+    auto& user = use->user();
+    if (isPrunable(user, root)) {
+      prune(user, root);
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+NodePtr DeadNodePruning::apply(NodePtr root) {
+  std::vector<NodePtr> worklist{root};
+  std::unordered_set<NodePtr> visited;
+  while (!worklist.empty()) {
+    const auto node = worklist.back();
+    worklist.pop_back();
+    if (!visited.insert(node).second) {
+      continue;
+    }
+    while (pruneDeadUser(node, *root)) {
+    }
+    if (!isOptimizationLeaf(node)) {
+      for (const auto& input : node->inputs()) {
+        worklist.push_back(input);
+      }
+    }
+  }
+  return root;
+}
+
+} // namespace fl
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/tensor/backend/jit/opt/Pass.h"
+
+namespace fl {
+
+/**
+ * An optimization pass that prunes dead nodes hanging off a JIT tree, i.e.,
+ * unevaluated nodes with neither (external) uses nor a path to the root --
+ * typically what other passes left behind after a rewrite.
+ *
+ * e.g., after `exp(x * 1)` is simplified into `exp(x)`:
+ *
+ *     x  1              x
+ *    / \ /              |
+ *  exp  mul     -->    exp
+ *
+ * Pruned nodes unlink their inputs, so they stop counting as uses, which
+ * otherwise blocks fusion (see `ElementwiseFusion`) and keeps intermediate
+ * results alive during evaluation.
+ */
+class DeadNodePruning : public Pass {
+ public:
+  NodePtr apply(NodePtr node) override;
+};
+
+} // namespace fl
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/opt/passes/ElementwiseFusion.h"
+
+#include <utility>
+
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
+
+namespace fl {
+
+struct ElementwiseFusion::LoweringState {
+  std::vector<ElementwiseKernel::Instruction> instructions;
+  std::vector<NodePtr> inputs;
+  std::unordered_map<NodePtr, unsigned> inputToIdx;
+  std::vector<ScalarNodePtr> constants;
+  // number of Unary/Binary instructions
+  unsigned numOps{0};
+  // number of ViewNodes read through rather than materialized
+  unsigned numViews{0};
+};
+
+namespace {
+
+// Ops supported by ElementwiseKernel, i.e., the ones that map floating point
+// inputs to an output of the same type.
+bool isOpFusable(const BinaryOp op) {
+  switch (op) {
+    case BinaryOp::Add:
+    case BinaryOp::Sub:
+    case BinaryOp::Mul:
+    case BinaryOp::Div:
+    case BinaryOp::Min:
+    case BinaryOp::Max:
+    case BinaryOp::Pow:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isOpFusable(const UnaryOp op) {
+  switch (op) {
+    case UnaryOp::LogicalNot:
+    case UnaryOp::IsNan:
+    case UnaryOp::IsInf:
+      return false;
+    default:
+      return true;
+  }
+}
+
+bool isNodeFusable(const NodePtr node) {
+  // already evaluated nodes are just inputs
+  if (node->getResult().has_value()) {
+    return false;
+  }
+  return (node->isBinary() && isOpFusable(node->impl<BinaryNode>().op())) ||
+      (node->isUnary() && isOpFusable(node->impl<UnaryNode>().op()));
+}
+
+bool isFusionProfitable(const NodePtr node) {
+  return node->uses().size() + node->externalUses().size() <= 1;
+}
+
+// Returns the node that `node` is a (chain of) view of, and appends the views
+// to `views` in the order they are applied, as long as the kernel can read
+// through them. Views are cheap to read through, so they're absorbed even if
+// they have other uses.
+NodePtr collectLoadViews(
+    NodePtr node,
+    std::vector<ElementwiseKernel::LoadView>& views) {
+  if (!node->isView() || node->getResult().has_value()) {
+    return node;
+  }
+  const auto& viewNode = node->impl<ViewNode>();
+  const auto base = collectLoadViews(viewNode.input(), views);
+  views.push_back({viewNode.viewType(), viewNode.params()});
+  if (ElementwiseKernel::canLoadThrough(base->shape(), views)) {
+    return base;
+  }
+  views.clear();
+  return node;
+}
+
+} // namespace
+
+ElementwiseFusion::ElementwiseFusion(
+    TensorBackend& backend,
+    unsigned kernelCacheCapacity)
+    : backend_(backend), kernelCacheCapacity_(kernelCacheCapacity) {}
+
+NodePtr ElementwiseFusion::rewriteFrom(NodePtr node) {
+  const auto iter = rewritten_.find(node);
+  if (iter != rewritten_.end()) {
+    return iter->second;
+  }
+  const auto newNode = rewriteFromImpl(node);
+  rewritten_.emplace(node, newNode);
+  return newNode;
+}
+
+NodePtr ElementwiseFusion::rewriteFromImpl(NodePtr node) {
+  if (isOptimizationLeaf(node)) {
+    return node;
+  }
+  if (!isNodeFusable(node)) {
+    for (const auto& input : node->inputs()) {
+      rewriteFrom(input);
+    }
+    return node;
+  }
+
+  LoweringState state;
+  lower(node, state, /* isRoot = */ true);
+  // a single op gains nothing from fusion, unless it avoids materializing
+  // views of its inputs
+  if (state.numOps < 2 && (state.numOps == 0 || state.numViews == 0)) {
+    for (const auto& input : node->inputs()) {
+      rewriteFrom(input);
+    }
+    return node;
+  }
+
+  // NOTE rewriting an input may replace it, so use whatever is returned.
+  for (auto& input : state.inputs) {
+    input = rewriteFrom(input);
+  }
+  const auto kernel =
+      getOrCreateKernel(std::move(state.instructions), node->shape());
+  CustomNode::InPlaceEvalFunc evalFunc =
+      [kernel, constants = std::move(state.constants), &backend = backend_](
+          const std::vector<const Tensor*>& inputs,
+          const std::vector<unsigned>& donatedInputIdxs) {
+        return kernel->runInPlace(inputs, constants, backend, donatedInputIdxs);
+      };
+  const auto fusedNode = CustomNode::create(
+      "ElementwiseKernel",
+      std::move(state.inputs),
+      node->shape(),
+      std::move(evalFunc));
+  node->replaceAllUsesWith(fusedNode);
+  return fusedNode;
+}
+
+unsigned ElementwiseFusion::lower(
+    NodePtr node,
+    LoweringState& state,
+    bool isRoot) {
+  using OpCode = ElementwiseKernel::OpCode;
+  auto& insts = state.instructions;
+  if (node->isScalar()) {
+    state.constants.push_back(Node::cast<ScalarNodePtr>(node));
+    ElementwiseKernel::Instruction inst{
+        OpCode::Constant,
+        /* operandIdx = */ static_cast<unsigned>(state.constants.size() - 1),
+        /* lhs = */ 0,
+        /* rhs = */ 0,
+        UnaryOp::Exp,
+        BinaryOp::Add,
+        /* views = */ {},
+        node->shape()};
+    insts.push_back(std::move(inst));
+    return insts.size() - 1;
+  }
+
+  if (isNodeFusable(node) && (isRoot || isFusionProfitable(node))) {
+    ElementwiseKernel::Instruction inst{
+        OpCode::Unary,
+        /* operandIdx = */ 0,
+        /* lhs = */ 0,
+        /* rhs = */ 0,
+        UnaryOp::Exp,
+        BinaryOp::Add,
+        /* views = */ {},
+        node->shape()};
+    if (node->isBinary()) {
+      const auto& binaryNode = node->impl<BinaryNode>();
+      inst.opCode = OpCode::Binary;
+      inst.binop = binaryNode.op();
+      inst.lhs = lower(binaryNode.lhs(), state, /* isRoot = */ false);
+      inst.rhs = lower(binaryNode.rhs(), state, /* isRoot = */ false);
+    } else {
+      const auto& unaryNode = node->impl<UnaryNode>();
+      inst.unop = unaryNode.op();
+      inst.lhs = lower(unaryNode.input(), state, /* isRoot = */ false);
+    }
+    insts.push_back(std::move(inst));
+    state.numOps++;
+    return insts.size() - 1;
+  }
+
+  // everything else becomes a kernel input, possibly read through views
+  std::vector<ElementwiseKernel::LoadView> views;
+  const auto input = collectLoadViews(node, views);
+  auto iter = state.inputToIdx.find(input);
+  if (iter == state.inputToIdx.end()) {
+    state.inputs.push_back(input);
+    iter = state.inputToIdx.emplace(input, state.inputs.size() - 1).first;
+  }
+  state.numViews += views.size();
+  ElementwiseKernel::Instruction inst{
+      OpCode::Load,
+      /* operandIdx = */ iter->second,
+      /* lhs = */ 0,
+      /* rhs = */ 0,
+      UnaryOp::Exp,
+      BinaryOp::Add,
+      std::move(views),
+      node->shape()};
+  insts.push_back(std::move(inst));
+  return insts.size() - 1;
+}
+
+std::shared_ptr<const ElementwiseKernel> ElementwiseFusion::getOrCreateKernel(
+    std::vector<ElementwiseKernel::Instruction>&& instructions,
+    const Shape& shape) {
+  const auto signature = ElementwiseKernel::signatureOf(instructions, shape);
+  const auto iter = kernelCache_.find(signature);
+  if (iter != kernelCache_.end()) {
+    auto& lruPos = iter->second.second;
+    kernelLru_.splice(kernelLru_.begin(), kernelLru_, lruPos);
+    return iter->second.first;
+  }
+  auto kernel =
+      std::make_shared<const ElementwiseKernel>(std::move(instructions), shape);
+  if (kernelCacheCapacity_ == 0) {
+    return kernel;
+  }
+  if (kernelCache_.size() >= kernelCacheCapacity_) {
+    kernelCache_.erase(kernelLru_.back());
+    kernelLru_.pop_back();
+  }
+  kernelLru_.push_front(signature);
+  kernelCache_.emplace(signature, std::make_pair(kernel, kernelLru_.begin()));
+  return kernel;
+}
+
+NodePtr ElementwiseFusion::apply(NodePtr root) {
+  auto optimizedRoot = rewriteFrom(root);
+  rewritten_.clear();
+  return optimizedRoot;
+}
+
+unsigned ElementwiseFusion::numCachedKernels() const {
+  return kernelCache_.size();
+}
+
+} // namespace fl
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "flashlight/fl/tensor/TensorBackend.h"
+#include "flashlight/fl/tensor/backend/jit/eval/ElementwiseKernel.h"
+#include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+#include "flashlight/fl/tensor/backend/jit/opt/Pass.h"
+
+namespace fl {
+
+/**
+ * Fuse maximal trees of element-wise ops into a single ElementwiseKernel, so
+ * that the tree runs as one loop nest rather than one pass over memory per op.
+ *
+ * NOTE
+ * 1. like OneDnnOpFusion, we avoid recomputation -- intermediate nodes are
+ *    fused iff they are _only_ used within the tree. Scalars are the exception
+ *    since they are free to recompute.
+ * 2. kernels are cached by signature, so trees with the same structure &
+ *    shapes share a kernel, regardless of scalar values. The cache keeps the
+ *    most recently used kernels, so workloads with varying shapes don't grow
+ *    it without bound.
+ * 3. inputs that are views (e.g., tiled or transposed) are read through the
+ *    view by the kernel, so the view is never materialized.
+ *
+ *  x1  c1
+ *   \  /
+ *   mul  x2
+ *     \  /                  x1  x2
+ *     add                    \  /
+ *      |      -->  ------------------------- CustomNode with ElementwiseKernel
+ *     exp          | r0 = x1, r1 = c1      |
+ *                  | r0 = r0 * r1, r1 = x2 |
+ *                  | r0 = r0 + r1          |
+ *                  | r0 = exp(r0)          |
+ *                  -------------------------
+ */
+class ElementwiseFusion : public Pass {
+  struct LoweringState;
+
+  // backend used by kernels for allocation & fallback execution
+  TensorBackend& backend_;
+  const unsigned kernelCacheCapacity_;
+  // signatures of cached kernels, most recently used at front
+  std::list<std::string> kernelLru_{};
+  // signature -> kernel & its position in `kernelLru_`
+  std::unordered_map<
+      std::string,
+      std::pair<
+          std::shared_ptr<const ElementwiseKernel>,
+          std::list<std::string>::iterator>>
+      kernelCache_{};
+  // node -> its replacement, also avoids re-visit.
+  std::unordered_map<NodePtr, NodePtr> rewritten_{};
+
+  // Fuse the maximal tree rooted at `node` (if any), then recursively rewrite
+  // inputs of the tree.
+  NodePtr rewriteFrom(NodePtr node);
+  NodePtr rewriteFromImpl(NodePtr node);
+
+  // Append instructions that compute `node` to `state`, returns the index of
+  // the instruction that holds the result of `node`.
+  unsigned lower(NodePtr node, LoweringState& state, bool isRoot);
+
+  std::shared_ptr<const ElementwiseKernel> getOrCreateKernel(
+      std::vector<ElementwiseKernel::Instruction>&& instructions,
+      const Shape& shape);
+
+ public:
+  static constexpr unsigned kDefaultKernelCacheCapacity = 256;
+
+  explicit ElementwiseFusion(
+      TensorBackend& backend,
+      unsigned kernelCacheCapacity = kDefaultKernelCacheCapacity);
+  ~ElementwiseFusion() = default;
+
+  NodePtr apply(NodePtr root) override;
+
+  /**
+   * Returns the number of kernels currently cached.
+   */
+  unsigned numCachedKernels() const;
+};
+
+} // namespace fl
@@ -8,7 +8,10 @@
 #include "flashlight/fl/tensor/backend/jit/opt/passes/ScalarFolding.h"
 
 #include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
 
 #include <cmath>
 #include <optional>
@@ -87,6 +90,7 @@ std::optional<ScalarNodePtr> foldScalarNodes(
   const auto type = lhs.dataType();
   switch (type) {
     case dtype::f16:
+    case dtype::bf16:
       return std::nullopt;
     case dtype::f32:
       return foldScalarNodes<float>(lhs, rhs, op, type);
@@ -130,16 +134,189 @@ NodePtr foldScalarsInBinaryNode(BinaryNodePtr node) {
   return node;
 }
 
+template <typename T>
+std::optional<T> foldUnaryScalar(const T val, const UnaryOp op) {
+  switch (op) {
+    case UnaryOp::Exp:
+      return std::exp(val);
+    case UnaryOp::Log:
+      return std::log(val);
+    case UnaryOp::Negative:
+      return -val;
+    case UnaryOp::Log1p:
+      return std::log1p(val);
+    case UnaryOp::Sin:
+      return std::sin(val);
+    case UnaryOp::Cos:
+      return std::cos(val);
+    case UnaryOp::Sqrt:
+      return std::sqrt(val);
+    case UnaryOp::Tanh:
+      return std::tanh(val);
+    case UnaryOp::Floor:
+      return std::floor(val);
+    case UnaryOp::Ceil:
+      return std::ceil(val);
+    case UnaryOp::Rint:
+      return std::rint(val);
+    case UnaryOp::Absolute:
+      return std::abs(val);
+    case UnaryOp::Sigmoid:
+      return 1 / (1 + std::exp(-val));
+    case UnaryOp::Erf:
+      return std::erf(val);
+    case UnaryOp::Sign:
+      return (0 < val) - (val < 0);
+    // these produce boolean output, whose type is backend-specific
+    case UnaryOp::LogicalNot:
+    case UnaryOp::IsNan:
+    case UnaryOp::IsInf:
+      return std::nullopt;
+  }
+  throw std::runtime_error("[foldUnaryScalar] Unknown unary operation type");
+}
+
+template <typename T>
+std::optional<ScalarNodePtr> foldUnaryScalarNode(
+    const ScalarNode& input,
+    const UnaryOp op,
+    const dtype type) {
+  std::optional<T> resVal = foldUnaryScalar(input.scalar<T>(), op);
+  if (resVal.has_value()) {
+    return ScalarNode::create(Shape(input.shape()), type, resVal.value());
+  }
+  return std::nullopt;
+}
+
+std::optional<ScalarNodePtr> foldUnaryScalarNode(
+    const ScalarNode& input,
+    const UnaryOp op) {
+  // TODO integral types need op-specific type promotion rules (e.g., exp on
+  // s32), only fold floating point for now.
+  const auto type = input.dataType();
+  switch (type) {
+    case dtype::f32:
+      return foldUnaryScalarNode<float>(input, op, type);
+    case dtype::f64:
+      return foldUnaryScalarNode<double>(input, op, type);
+    default:
+      return std::nullopt;
+  }
+}
+
+NodePtr foldScalarsInUnaryNode(UnaryNodePtr node) {
+  const auto input = node->input();
+  if (input->isScalar()) {
+    const auto optFoldedScalarNode =
+        foldUnaryScalarNode(input->impl<ScalarNode>(), node->op());
+    if (optFoldedScalarNode.has_value()) {
+      const auto foldedScalarNode = optFoldedScalarNode.value();
+      node->replaceAllUsesWith(foldedScalarNode);
+      return foldedScalarNode;
+    }
+  }
+  return node;
+}
+
+template <typename T>
+ScalarNodePtr foldReductionScalarNode(
+    const ScalarNode& input,
+    const ReductionNode& node,
+    const dtype type) {
+  const T val = input.scalar<T>();
+  switch (node.op()) {
+    case ReductionOp::Min:
+    case ReductionOp::Max:
+    case ReductionOp::Mean:
+      return ScalarNode::create(Shape(node.shape()), type, val);
+    case ReductionOp::Sum: {
+      // every output element sums up the same # of input elements
+      const auto numReduced =
+          input.shape().elements() / std::max<Dim>(node.shape().elements(), 1);
+      return ScalarNode::create(Shape(node.shape()), type, val * numReduced);
+    }
+  }
+  throw std::runtime_error(
+      "[foldReductionScalarNode] Unknown reduction operation type");
+}
+
+NodePtr foldScalarsInReductionNode(ReductionNodePtr node) {
+  const auto input = node->input();
+  if (!input->isScalar()) {
+    return node;
+  }
+  // TODO integral reductions may promote output type in some backends (e.g.,
+  // mean of s32), only fold floating point for now.
+  const auto& scalarInput = input->impl<ScalarNode>();
+  const auto type = scalarInput.dataType();
+  ScalarNodePtr foldedScalarNode;
+  switch (type) {
+    case dtype::f32:
+      foldedScalarNode =
+          foldReductionScalarNode<float>(scalarInput, *node, type);
+      break;
+    case dtype::f64:
+      foldedScalarNode =
+          foldReductionScalarNode<double>(scalarInput, *node, type);
+      break;
+    default:
+      return node;
+  }
+  node->replaceAllUsesWith(foldedScalarNode);
+  return foldedScalarNode;
+}
+
+NodePtr foldScalarsInViewNode(ViewNodePtr node) {
+  const auto input = node->input();
+  if (!input->isScalar()) {
+    return node;
+  }
+  // every element of a view is still the same scalar
+  const auto& scalarInput = input->impl<ScalarNode>();
+  const auto type = scalarInput.dataType();
+  ScalarNodePtr foldedScalarNode;
+  switch (type) {
+    case dtype::f16:
+    case dtype::bf16:
+    case dtype::f32:
+    case dtype::f64:
+      foldedScalarNode = ScalarNode::create(
+          Shape(node->shape()), type, scalarInput.scalar<double>());
+      break;
+    case dtype::u64:
+      foldedScalarNode = ScalarNode::create(
+          Shape(node->shape()),
+          type,
+          scalarInput.scalar<unsigned long long>());
+      break;
+    default:
+      foldedScalarNode = ScalarNode::create(
+          Shape(node->shape()), type, scalarInput.scalar<long long>());
+  }
+  node->replaceAllUsesWith(foldedScalarNode);
+  return foldedScalarNode;
+}
+
 NodePtr foldScalars(NodePtr node) {
+  if (isOptimizationLeaf(node)) {
+    return node;
+  }
   for (const auto& input : node->inputs()) {
     foldScalars(input);
   }
   switch (node->type()) {
     case NodeType::Binary:
       return foldScalarsInBinaryNode(Node::cast<BinaryNodePtr>(node));
+    case NodeType::Unary:
+      return foldScalarsInUnaryNode(Node::cast<UnaryNodePtr>(node));
+    case NodeType::Reduction:
+      return foldScalarsInReductionNode(Node::cast<ReductionNodePtr>(node));
+    case NodeType::View:
+      return foldScalarsInViewNode(Node::cast<ViewNodePtr>(node));
     case NodeType::Custom:
     case NodeType::Index:
     case NodeType::IndexedUpdate:
+    case NodeType::Matmul:
     case NodeType::Scalar:
     case NodeType::Value:
       return node;
@@ -13,7 +13,7 @@ namespace fl {
 
 /**
  * An optimization pass that recursively merges scalars inside a JIT tree,
- * e.g., 1 + 2 becomes 3.
+ * e.g., 1 + 2 becomes 3, or exp(0) becomes 1.
  */
 class ScalarFolding : public Pass {
  public:
@@ -38,10 +38,6 @@ bool NodeNamer::contains(NodePtr node) const {
   return nodeToName_.find(node) != nodeToName_.end();
 }
 
-} // namespace detail
-
-namespace {
-
 const char* binopToStr(const BinaryOp op) {
   switch (op) {
     case BinaryOp::Add:
@@ -90,7 +86,85 @@ const char* binopToStr(const BinaryOp op) {
   throw std::runtime_error("Unsupported binary operation type");
 }
 
-} // namespace
+const char* unopToStr(const UnaryOp op) {
+  switch (op) {
+    case UnaryOp::Exp:
+      return "Exp";
+    case UnaryOp::Log:
+      return "Log";
+    case UnaryOp::Negative:
+      return "Negative";
+    case UnaryOp::LogicalNot:
+      return "LogicalNot";
+    case UnaryOp::Log1p:
+      return "Log1p";
+    case UnaryOp::Sin:
+      return "Sin";
+    case UnaryOp::Cos:
+      return "Cos";
+    case UnaryOp::Sqrt:
+      return "Sqrt";
+    case UnaryOp::Tanh:
+      return "Tanh";
+    case UnaryOp::Floor:
+      return "Floor";
+    case UnaryOp::Ceil:
+      return "Ceil";
+    case UnaryOp::Rint:
+      return "Rint";
+    case UnaryOp::Absolute:
+      return "Absolute";
+    case UnaryOp::Sigmoid:
+      return "Sigmoid";
+    case UnaryOp::Erf:
+      return "Erf";
+    case UnaryOp::IsNan:
+      return "IsNan";
+    case UnaryOp::IsInf:
+      return "IsInf";
+    case UnaryOp::Sign:
+      return "Sign";
+  }
+  throw std::runtime_error("Unsupported unary operation type");
+}
+
+const char* reductionOpToStr(const ReductionOp op) {
+  switch (op) {
+    case ReductionOp::Min:
+      return "Min";
+    case ReductionOp::Max:
+      return "Max";
+    case ReductionOp::Sum:
+      return "Sum";
+    case ReductionOp::Mean:
+      return "Mean";
+  }
+  throw std::runtime_error("Unsupported reduction operation type");
+}
+
+const char* matrixPropToStr(const MatrixProperty prop) {
+  switch (prop) {
+    case MatrixProperty::None:
+      return "None";
+    case MatrixProperty::Transpose:
+      return "Transpose";
+  }
+  throw std::runtime_error("Unsupported matrix property");
+}
+
+const char* viewTypeToStr(const ViewType type) {
+  switch (type) {
+    case ViewType::Reshape:
+      return "Reshape";
+    case ViewType::Transpose:
+      return "Transpose";
+    case ViewType::Tile:
+      return "Tile";
+  }
+  throw std::runtime_error("Unsupported view type");
+}
+
+} // namespace detail
 
 std::ostream& GraphvizPrinter::os() {
   return os_;
@@ -109,7 +183,7 @@ GraphvizPrinter& GraphvizPrinter::setNodeColor(Color newColor) {
 void GraphvizPrinter::printBinaryNodeLabels(const BinaryNode& node) {
   os() << "BinaryNode"
        << "\\n"
-       << "op = " << binopToStr(node.op()) << "\\n"
+       << "op = " << detail::binopToStr(node.op()) << "\\n"
        << "shape = " << node.shape() << "\\n";
 }
 
@@ -174,8 +248,9 @@ std::ostream& GraphvizPrinter::printIndices(const std::vector<Index>& indices) {
 std::ostream& GraphvizPrinter::printScalarValue(const ScalarNode& node) {
   switch (node.dataType()) {
     case dtype::f16:
+    case dtype::bf16:
       throw std::runtime_error(
-          "[GraphvizPrinter::printScalarNodeValue] f16 is unsupported");
+          "[GraphvizPrinter::printScalarNodeValue] f16/bf16 is unsupported");
     case dtype::f32:
       os() << node.scalar<float>();
       break;
@@ -227,6 +302,46 @@ void GraphvizPrinter::printValueNodeLabels(const ValueNode& node) {
        << "shape = " << node.shape() << "\\n";
 }
 
+void GraphvizPrinter::printUnaryNodeLabels(const UnaryNode& node) {
+  os() << "UnaryNode"
+       << "\\n"
+       << "op = " << detail::unopToStr(node.op()) << "\\n"
+       << "shape = " << node.shape() << "\\n";
+}
+
+void GraphvizPrinter::printReductionNodeLabels(const ReductionNode& node) {
+  os() << "ReductionNode"
+       << "\\n"
+       << "op = " << detail::reductionOpToStr(node.op()) << "\\n"
+       << "axes = [";
+  const auto& axes = node.axes();
+  for (unsigned i = 0; i < axes.size(); i++) {
+    os() << axes[i];
+    if (i != axes.size() - 1) {
+      os() << ", ";
+    }
+  }
+  os() << "]\\n"
+       << "keepDims = " << (node.keepDims() ? "true" : "false") << "\\n"
+       << "shape = " << node.shape() << "\\n";
+}
+
+void GraphvizPrinter::printMatmulNodeLabels(const MatmulNode& node) {
+  os() << "MatmulNode"
+       << "\\n"
+       << "lhsProp = " << detail::matrixPropToStr(node.lhsProp()) << "\\n"
+       << "rhsProp = " << detail::matrixPropToStr(node.rhsProp()) << "\\n"
+       << "shape = " << node.shape() << "\\n";
+}
+
+void GraphvizPrinter::printViewNodeLabels(const ViewNode& node) {
+  os() << "ViewNode"
+       << "\\n"
+       << "type = " << detail::viewTypeToStr(node.viewType()) << "\\n"
+       << "params = " << node.params() << "\\n"
+       << "shape = " << node.shape() << "\\n";
+}
+
 std::ostream& GraphvizPrinter::printNodes(NodePtr node) {
   if (!nodeNamer_.contains(node)) {
     // roots at bottom
@@ -272,6 +387,18 @@ std::ostream& GraphvizPrinter::printNodeLabels(NodePtr node) {
     case NodeType::Value:
       printValueNodeLabels(node->impl<ValueNode>());
       break;
+    case NodeType::Unary:
+      printUnaryNodeLabels(node->impl<UnaryNode>());
+      break;
+    case NodeType::Reduction:
+      printReductionNodeLabels(node->impl<ReductionNode>());
+      break;
+    case NodeType::Matmul:
+      printMatmulNodeLabels(node->impl<MatmulNode>());
+      break;
+    case NodeType::View:
+      printViewNodeLabels(node->impl<ViewNode>());
+      break;
     default:
       throw std::runtime_error(
           "[GraphvizPrinter::printNodeLabels] Unknown node type");
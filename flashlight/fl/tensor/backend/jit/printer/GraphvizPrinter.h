@@ -16,8 +16,12 @@
 #include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/IndexNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/IndexedUpdateNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
 
 namespace fl {
 
@@ -42,6 +46,13 @@ class NodeNamer {
   bool contains(NodePtr node) const;
 };
 
+// readable names of ops & properties of nodes
+const char* binopToStr(const BinaryOp op);
+const char* unopToStr(const UnaryOp op);
+const char* reductionOpToStr(const ReductionOp op);
+const char* matrixPropToStr(const MatrixProperty prop);
+const char* viewTypeToStr(const ViewType type);
+
 } // namespace detail
 
 /**
@@ -78,6 +89,10 @@ class GraphvizPrinter {
   void printScalarNodeLabels(const ScalarNode& node);
   std::ostream& printScalarValue(const ScalarNode& node);
   void printValueNodeLabels(const ValueNode& node);
+  void printUnaryNodeLabels(const UnaryNode& node);
+  void printReductionNodeLabels(const ReductionNode& node);
+  void printMatmulNodeLabels(const MatmulNode& node);
+  void printViewNodeLabels(const ViewNode& node);
   std::ostream& printNodes(NodePtr node);
   std::ostream& printNodeLabels(NodePtr node);
   std::ostream& printNodeColor(float tottime);
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/jit/printer/ScopedPostEvalTracePrinter.h"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/jit/JitBackend.h"
+#include "flashlight/fl/tensor/backend/jit/printer/GraphvizPrinter.h"
+
+namespace fl {
+
+namespace {
+
+std::string escapeJson(const std::string& str) {
+  std::ostringstream oss;
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        oss << "\\\"";
+        break;
+      case '\\':
+        oss << "\\\\";
+        break;
+      case '\n':
+        oss << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+              << static_cast<int>(c) << std::dec;
+        } else {
+          oss << c;
+        }
+    }
+  }
+  return oss.str();
+}
+
+std::string shapeToString(const Shape& shape) {
+  std::ostringstream oss;
+  oss << shape;
+  return oss.str();
+}
+
+std::string getOpLabel(const NodePtr& node) {
+  switch (node->type()) {
+    case NodeType::Binary:
+      return std::string("Binary:") +
+          detail::binopToStr(node->impl<BinaryNode>().op());
+    case NodeType::Custom:
+      return "Custom:" + node->impl<CustomNode>().name();
+    case NodeType::Matmul: {
+      const auto& matmulNode = node->impl<MatmulNode>();
+      return std::string("Matmul:") +
+          detail::matrixPropToStr(matmulNode.lhsProp()) + "," +
+          detail::matrixPropToStr(matmulNode.rhsProp());
+    }
+    case NodeType::Reduction:
+      return std::string("Reduction:") +
+          detail::reductionOpToStr(node->impl<ReductionNode>().op());
+    case NodeType::Unary:
+      return std::string("Unary:") +
+          detail::unopToStr(node->impl<UnaryNode>().op());
+    case NodeType::View:
+      return std::string("View:") +
+          detail::viewTypeToStr(node->impl<ViewNode>().viewType());
+    case NodeType::Index:
+    case NodeType::IndexedUpdate:
+    case NodeType::Scalar:
+    case NodeType::Value:
+      return nodeTypeToString(node->type());
+  }
+  throw std::runtime_error("[getOpLabel] Unknown node type");
+}
+
+// nodes evaluated in the last evaluation, in post-order from `root`
+void collectEvaluatedNodes(
+    const NodePtr& root,
+    const std::unordered_map<NodePtr, Evaluator::NodeTrace>& traces,
+    std::unordered_set<NodePtr>& visited,
+    std::vector<NodePtr>& nodes) {
+  if (traces.count(root) == 0 || !visited.insert(root).second) {
+    return;
+  }
+  for (const auto& input : root->inputs()) {
+    collectEvaluatedNodes(input, traces, visited, nodes);
+  }
+  nodes.push_back(root);
+}
+
+} // namespace
+
+ScopedPostEvalTracePrinter::ScopedPostEvalTracePrinter(
+    std::string filename,
+    unsigned maxNodeEvents)
+    : managedOfs_(std::make_unique<std::ofstream>(filename)),
+      os_(*managedOfs_),
+      maxNodeEvents_(maxNodeEvents) {
+  hookToEvaluator();
+}
+
+ScopedPostEvalTracePrinter::ScopedPostEvalTracePrinter(
+    std::ostream& os,
+    unsigned maxNodeEvents)
+    : os_(os), maxNodeEvents_(maxNodeEvents) {
+  hookToEvaluator();
+}
+
+void ScopedPostEvalTracePrinter::hookToEvaluator() {
+  auto& backend = defaultTensorBackend();
+  if (backend.backendType() != TensorBackendType::Jit) {
+    std::ostringstream oss;
+    oss << "[ScopedPostEvalTracePrinter::ScopedPostEvalTracePrinter] "
+        << "Expected default backend to be JitBackend, but got "
+        << backend.backendType();
+    throw std::runtime_error(oss.str());
+  }
+  auto& jitBackend = static_cast<JitBackend&>(backend);
+  monitoredEvaluator_ = &jitBackend.evaluator();
+  oldProfileState_ = monitoredEvaluator_->getProfilerState();
+  monitoredEvaluator_->setProfilerState(true);
+  callbackHandle_ = monitoredEvaluator_->addPostEvalCallback(
+      [this](NodePtr node, std::unordered_map<NodePtr, float> /* unused */) {
+        record(node);
+      });
+}
+
+ScopedPostEvalTracePrinter::~ScopedPostEvalTracePrinter() {
+  monitoredEvaluator_->removePostEvalCallback(callbackHandle_);
+  monitoredEvaluator_->setProfilerState(oldProfileState_);
+  write();
+}
+
+unsigned ScopedPostEvalTracePrinter::getTid(std::thread::id threadId) {
+  return threadToTid_.emplace(threadId, threadToTid_.size()).first->second;
+}
+
+void ScopedPostEvalTracePrinter::record(NodePtr root) {
+  const auto& traces = monitoredEvaluator_->getNodeTraces();
+  std::unordered_set<NodePtr> visited;
+  std::vector<NodePtr> nodes;
+  collectEvaluatedNodes(root, traces, visited, nodes);
+  if (nodes.empty()) {
+    return; // nothing was evaluated
+  }
+
+  // signature encodes ops, shapes & edges among the evaluated nodes
+  std::unordered_map<NodePtr, unsigned> nodeToIdx;
+  std::vector<std::string> labels;
+  std::ostringstream signatureOss;
+  for (const auto& node : nodes) {
+    nodeToIdx.emplace(node, nodeToIdx.size());
+    labels.push_back(getOpLabel(node));
+    signatureOss << labels.back() << shapeToString(node->shape()) << "(";
+    for (const auto& input : node->inputs()) {
+      const auto iter = nodeToIdx.find(input);
+      if (iter != nodeToIdx.end()) {
+        signatureOss << iter->second;
+      }
+      signatureOss << ",";
+    }
+    signatureOss << ");";
+  }
+  std::ostringstream hashOss;
+  hashOss << std::hex << std::hash<std::string>{}(signatureOss.str());
+  const auto signature = hashOss.str();
+
+  auto& stats = signatureToStats_[signature];
+  if (stats.nodes.empty()) {
+    for (unsigned i = 0; i < nodes.size(); i++) {
+      const auto& node = nodes[i];
+      stats.nodes.push_back(
+          {labels[i],
+           node->isCustom() ? node->impl<CustomNode>().name() : "",
+           0,
+           0});
+    }
+  }
+  stats.count++;
+
+  double graphStartUs = traces.at(nodes.front()).startUs;
+  double graphEndUs = graphStartUs;
+  for (unsigned i = 0; i < nodes.size(); i++) {
+    const auto& node = nodes[i];
+    const auto& trace = traces.at(node);
+    if (!hasOrigin_) {
+      originUs_ = trace.startUs;
+      hasOrigin_ = true;
+    }
+    graphStartUs = std::min(graphStartUs, trace.startUs);
+    graphEndUs = std::max(graphEndUs, trace.startUs + trace.durationUs);
+    auto& nodeStats = stats.nodes[i];
+    nodeStats.totalUs += trace.durationUs;
+    nodeStats.totalBytes += trace.inputBytes + trace.outputBytes;
+    stats.totalUs += trace.durationUs;
+
+    if (numNodeEvents_ >= maxNodeEvents_) {
+      numDroppedEvents_++;
+      continue;
+    }
+    numNodeEvents_++;
+    std::ostringstream args;
+    args << "{\"signature\":\"" << signature << "\",\"shape\":\""
+         << shapeToString(node->shape()) << "\",\"inputShapes\":[";
+    for (unsigned j = 0; j < node->inputs().size(); j++) {
+      args << (j == 0 ? "" : ",") << "\""
+           << shapeToString(node->inputs()[j]->shape()) << "\"";
+    }
+    args << "],\"inputBytes\":" << trace.inputBytes
+         << ",\"outputBytes\":" << trace.outputBytes << ",\"fusedGroup\":\""
+         << escapeJson(nodeStats.fusedGroup) << "\"}";
+    events_.push_back(
+        {labels[i],
+         node->isCustom() ? "fused" : "node",
+         trace.startUs,
+         trace.durationUs,
+         getTid(trace.threadId),
+         args.str()});
+  }
+  std::ostringstream args;
+  args << "{\"signature\":\"" << signature
+       << "\",\"numNodes\":" << nodes.size() << "}";
+  events_.push_back(
+      {"JitGraph",
+       "graph",
+       graphStartUs,
+       graphEndUs - graphStartUs,
+       getTid(std::this_thread::get_id()),
+       args.str()});
+}
+
+void ScopedPostEvalTracePrinter::write() {
+  os_ << std::fixed << std::setprecision(3);
+  os_ << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"numDroppedEvents\":"
+      << numDroppedEvents_ << "},\"traceEvents\":[";
+  for (unsigned i = 0; i < events_.size(); i++) {
+    const auto& event = events_[i];
+    os_ << (i == 0 ? "" : ",") << "\n{\"name\":\"" << escapeJson(event.name)
+        << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":"
+        << event.startUs - originUs_ << ",\"dur\":" << event.durationUs
+        << ",\"pid\":0,\"tid\":" << event.tid << ",\"args\":" << event.args
+        << "}";
+  }
+  os_ << "\n],\"jitGraphs\":[";
+  bool first = true;
+  for (const auto& [signature, stats] : signatureToStats_) {
+    os_ << (first ? "" : ",") << "\n{\"signature\":\"" << signature
+        << "\",\"count\":" << stats.count << ",\"totalUs\":" << stats.totalUs
+        << ",\"nodes\":[";
+    for (unsigned i = 0; i < stats.nodes.size(); i++) {
+      const auto& nodeStats = stats.nodes[i];
+      os_ << (i == 0 ? "" : ",") << "{\"label\":\""
+          << escapeJson(nodeStats.label) << "\",\"fusedGroup\":\""
+          << escapeJson(nodeStats.fusedGroup)
+          << "\",\"totalUs\":" << nodeStats.totalUs
+          << ",\"totalBytes\":" << nodeStats.totalBytes << "}";
+    }
+    os_ << "]}";
+    first = false;
+  }
+  os_ << "\n]}" << std::endl;
+}
+
+} // namespace fl
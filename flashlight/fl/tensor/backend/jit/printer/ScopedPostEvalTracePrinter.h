@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "flashlight/fl/tensor/backend/jit/eval/Evaluator.h"
+
+namespace fl {
+
+/**
+ * A class that uses RAII to record evaluated graphs in some scope, and writes
+ * them out in Chrome trace JSON format (loadable by chrome://tracing and
+ * Perfetto) when it goes out of scope.
+ *
+ * Each evaluated node becomes a complete ("X") event with its op, shapes,
+ * bytes moved and fused group (name of the fused CustomNode, if any); each
+ * evaluation becomes an event that spans its nodes.
+ *
+ * Graphs are also aggregated by signature (structure, ops and shapes of the
+ * evaluated graph), under the top-level "jitGraphs" key: # of evaluations,
+ * and total time & bytes moved of each node. Aggregation continues after
+ * `maxNodeEvents` is reached, so long runs can be summarized with bounded
+ * memory.
+ */
+class ScopedPostEvalTracePrinter {
+ public:
+  static constexpr unsigned kDefaultMaxNodeEvents = 1 << 20;
+
+ private:
+  struct Event {
+    std::string name;
+    std::string category;
+    double startUs;
+    double durationUs;
+    unsigned tid;
+    std::string args; // a JSON object
+  };
+
+  struct NodeStats {
+    std::string label;
+    std::string fusedGroup;
+    double totalUs{0};
+    size_t totalBytes{0};
+  };
+
+  struct GraphStats {
+    unsigned count{0};
+    double totalUs{0};
+    // in post-order of the evaluated graph
+    std::vector<NodeStats> nodes;
+  };
+
+  // created only if user provided a filename
+  std::unique_ptr<std::ofstream> managedOfs_;
+  std::ostream& os_;
+  const unsigned maxNodeEvents_;
+  unsigned numNodeEvents_{0};
+  unsigned numDroppedEvents_{0};
+  std::vector<Event> events_;
+  // ordered for deterministic output
+  std::map<std::string, GraphStats> signatureToStats_;
+  std::unordered_map<std::thread::id, unsigned> threadToTid_;
+  // timestamps are written relative to the first recorded node
+  double originUs_{0};
+  bool hasOrigin_{false};
+  Evaluator::PostEvalCallbackHandle callbackHandle_;
+  bool oldProfileState_;
+  Evaluator* monitoredEvaluator_;
+
+  void hookToEvaluator();
+  void record(NodePtr root);
+  unsigned getTid(std::thread::id threadId);
+  void write();
+
+ public:
+  explicit ScopedPostEvalTracePrinter(
+      std::string filename,
+      unsigned maxNodeEvents = kDefaultMaxNodeEvents);
+  explicit ScopedPostEvalTracePrinter(
+      std::ostream& os,
+      unsigned maxNodeEvents = kDefaultMaxNodeEvents);
+  ~ScopedPostEvalTracePrinter();
+};
+
+} // namespace fl
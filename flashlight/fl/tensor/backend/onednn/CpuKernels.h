@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+
+/**
+ * CPU kernels for ops that OneDNN has no primitive for. They operate on dense
+ * host buffers in Flashlight's column-major layout, are parallelized with
+ * OpenMP (when enabled) and keep innermost loops contiguous & branch-free so
+ * they vectorize.
+ */
+namespace fl::detail {
+
+// kernels on fewer elements run on the calling thread
+constexpr Dim kCpuKernelParallelThreshold = 1 << 15;
+// # of contiguous elements processed at once along the innermost dims, small
+// enough for a few rows to stay in L1
+constexpr Dim kCpuKernelBlockSize = 1024;
+
+/**
+ * A tensor viewed as [inner, axis, outer] around one of its axes, i.e., element
+ * (i, a, o) is at `i + (a + o * axisSize) * innerSize`.
+ */
+struct AxisView {
+  Dim innerSize{1};
+  Dim axisSize{1};
+  Dim outerSize{1};
+
+  AxisView(const Shape& shape, const unsigned axis) {
+    for (int i = 0; i < shape.ndim(); i++) {
+      if (i < static_cast<int>(axis)) {
+        innerSize *= shape[i];
+      } else if (i == static_cast<int>(axis)) {
+        axisSize = shape[i];
+      } else {
+        outerSize *= shape[i];
+      }
+    }
+  }
+
+  // # of 1D slices along the axis
+  Dim numLines() const {
+    return innerSize * outerSize;
+  }
+};
+
+template <typename T, typename R, typename Op>
+void unaryKernel(const T* in, R* out, const Dim count, Op op) {
+#pragma omp parallel for simd if (count >= kCpuKernelParallelThreshold)
+  for (Dim i = 0; i < count; i++) {
+    out[i] = op(in[i]);
+  }
+}
+
+template <typename L, typename R, typename T, typename Op>
+void binaryKernel(const L* lhs, const R* rhs, T* out, const Dim count, Op op) {
+#pragma omp parallel for simd if (count >= kCpuKernelParallelThreshold)
+  for (Dim i = 0; i < count; i++) {
+    out[i] = op(lhs[i], rhs[i]);
+  }
+}
+
+template <typename C, typename T>
+void whereKernel(const C* cond, const T* x, const T* y, T* out, Dim count) {
+#pragma omp parallel for simd if (count >= kCpuKernelParallelThreshold)
+  for (Dim i = 0; i < count; i++) {
+    out[i] = cond[i] ? x[i] : y[i];
+  }
+}
+
+/**
+ * Calls `func(outer, innerStart, innerEnd)` for blocks of the inner dims of
+ * `view`, in parallel. Rows along the axis are contiguous in the inner dims, so
+ * `func` can sweep along the axis one (cached) row block at a time.
+ */
+template <typename Func>
+void forEachInnerBlock(const AxisView& view, Func func) {
+  const Dim numBlocks =
+      (view.innerSize + kCpuKernelBlockSize - 1) / kCpuKernelBlockSize;
+  const Dim numTasks = view.outerSize * numBlocks;
+#pragma omp parallel for if ( \
+        view.numLines() * view.axisSize >= kCpuKernelParallelThreshold)
+  for (Dim task = 0; task < numTasks; task++) {
+    const Dim outer = task / numBlocks;
+    const Dim start = (task % numBlocks) * kCpuKernelBlockSize;
+    func(outer, start, std::min(start + kCpuKernelBlockSize, view.innerSize));
+  }
+}
+
+template <typename T, typename R>
+void cumsumKernel(const T* in, R* out, const AxisView& view) {
+  const Dim inner = view.innerSize;
+  forEachInnerBlock(view, [&](Dim outer, Dim start, Dim end) {
+    const Dim offset = outer * view.axisSize * inner;
+    const T* src = in + offset;
+    R* dst = out + offset;
+#pragma omp simd
+    for (Dim i = start; i < end; i++) {
+      dst[i] = src[i];
+    }
+    for (Dim a = 1; a < view.axisSize; a++) {
+      const R* prev = dst + (a - 1) * inner;
+      const T* row = src + a * inner;
+      R* curr = dst + a * inner;
+#pragma omp simd
+      for (Dim i = start; i < end; i++) {
+        curr[i] = prev[i] + row[i];
+      }
+    }
+  });
+}
+
+/**
+ * Finds the first element along the axis that no other element is `better`
+ * than, for every 1D slice along the axis. Outputs have shape [inner, outer];
+ * either may be null if not needed.
+ */
+template <typename T, typename Better>
+void argBestKernel(
+    const T* in,
+    T* values,
+    int* indices,
+    const AxisView& view,
+    Better better) {
+  const Dim inner = view.innerSize;
+  forEachInnerBlock(view, [&](Dim outer, Dim start, Dim end) {
+    const T* src = in + outer * view.axisSize * inner;
+    const Dim len = end - start;
+    // NOTE thread-local scratch, so outputs are only written once
+    std::vector<T> bestVals(src + start, src + end);
+    std::vector<int> bestIdxs(len, 0);
+    for (Dim a = 1; a < view.axisSize; a++) {
+      const T* row = src + a * inner + start;
+#pragma omp simd
+      for (Dim i = 0; i < len; i++) {
+        const bool isBetter = better(row[i], bestVals[i]);
+        bestVals[i] = isBetter ? row[i] : bestVals[i];
+        bestIdxs[i] = isBetter ? static_cast<int>(a) : bestIdxs[i];
+      }
+    }
+    const Dim dstOffset = outer * inner + start;
+    if (values) {
+      std::copy(bestVals.begin(), bestVals.end(), values + dstOffset);
+    }
+    if (indices) {
+      std::copy(bestIdxs.begin(), bestIdxs.end(), indices + dstOffset);
+    }
+  });
+}
+
+/**
+ * Sorts every 1D slice along the axis, keeping the first `k` elements. Outputs
+ * have shape [inner, k, outer]; either may be null if not needed. Sorting is
+ * stable when all elements are kept.
+ */
+template <typename T>
+void sortKernel(
+    const T* in,
+    T* values,
+    int* indices,
+    const AxisView& view,
+    const Dim k,
+    const bool descending) {
+  const Dim inner = view.innerSize;
+  const Dim axisSize = view.axisSize;
+  const Dim numLines = view.numLines();
+#pragma omp parallel if (numLines * axisSize >= kCpuKernelParallelThreshold)
+  {
+    std::vector<int> order(axisSize);
+    std::vector<T> line(axisSize);
+#pragma omp for
+    for (Dim lineIdx = 0; lineIdx < numLines; lineIdx++) {
+      const Dim outer = lineIdx / inner;
+      const Dim i = lineIdx % inner;
+      const T* src = in + outer * axisSize * inner + i;
+      // gather the strided line, so comparisons hit contiguous memory
+      for (Dim a = 0; a < axisSize; a++) {
+        line[a] = src[a * inner];
+      }
+      std::iota(order.begin(), order.end(), 0);
+      const auto sortLine = [&](auto cmp) {
+        if (k < axisSize) {
+          std::partial_sort(order.begin(), order.begin() + k, order.end(), cmp);
+        } else {
+          std::stable_sort(order.begin(), order.end(), cmp);
+        }
+      };
+      if (descending) {
+        sortLine([&](int l, int r) { return line[l] > line[r]; });
+      } else {
+        sortLine([&](int l, int r) { return line[l] < line[r]; });
+      }
+      const Dim dstOffset = outer * k * inner + i;
+      for (Dim a = 0; a < k; a++) {
+        if (values) {
+          values[dstOffset + a * inner] = line[order[a]];
+        }
+        if (indices) {
+          indices[dstOffset + a * inner] = order[a];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Median of every 1D slice along the axis, averaging the middle two elements of
+ * even-sized slices. Output has shape [inner, outer].
+ */
+template <typename T>
+void medianKernel(const T* in, T* out, const AxisView& view) {
+  const Dim inner = view.innerSize;
+  const Dim axisSize = view.axisSize;
+  const Dim numLines = view.numLines();
+  const Dim mid = axisSize / 2;
+#pragma omp parallel if (numLines * axisSize >= kCpuKernelParallelThreshold)
+  {
+    std::vector<T> line(axisSize);
+#pragma omp for
+    for (Dim lineIdx = 0; lineIdx < numLines; lineIdx++) {
+      const Dim outer = lineIdx / inner;
+      const Dim i = lineIdx % inner;
+      const T* src = in + outer * axisSize * inner + i;
+      for (Dim a = 0; a < axisSize; a++) {
+        line[a] = src[a * inner];
+      }
+      std::nth_element(line.begin(), line.begin() + mid, line.end());
+      T median = line[mid];
+      if (axisSize % 2 == 0) {
+        // the lower middle is the largest of the lower half
+        const T lower = *std::max_element(line.begin(), line.begin() + mid);
+        median = (lower + median) / 2;
+      }
+      out[lineIdx] = median;
+    }
+  }
+}
+
+/**
+ * Moves row `a` along the axis to row `rowMap(a)`, for every [inner] row.
+ */
+template <typename T, typename RowMap>
+void permuteRowsKernel(
+    const T* in,
+    T* out,
+    const AxisView& view,
+    RowMap rowMap) {
+  const Dim inner = view.innerSize;
+  const Dim numRows = view.outerSize * view.axisSize;
+#pragma omp parallel for if (numRows * inner >= kCpuKernelParallelThreshold)
+  for (Dim row = 0; row < numRows; row++) {
+    const Dim outer = row / view.axisSize;
+    const Dim a = row % view.axisSize;
+    std::copy_n(
+        in + row * inner,
+        inner,
+        out + (outer * view.axisSize + rowMap(a)) * inner);
+  }
+}
+
+template <typename T>
+void flipKernel(const T* in, T* out, const AxisView& view) {
+  const Dim last = view.axisSize - 1;
+  permuteRowsKernel(in, out, view, [last](Dim a) { return last - a; });
+}
+
+template <typename T>
+void rollKernel(const T* in, T* out, const AxisView& view, const Dim shift) {
+  const Dim axisSize = view.axisSize;
+  if (axisSize == 0) {
+    return; // nothing to move (and to take the modulo by)
+  }
+  // normalize into [0, axisSize)
+  const Dim offset = ((shift % axisSize) + axisSize) % axisSize;
+  permuteRowsKernel(in, out, view, [axisSize, offset](Dim a) {
+    return (a + offset) % axisSize;
+  });
+}
+
+/**
+ * Keeps the lower (i >= j) or upper (i <= j) triangle of every [rows, cols]
+ * matrix and zeros the rest.
+ */
+template <typename T>
+void triangularKernel(
+    const T* in,
+    T* out,
+    const Dim rows,
+    const Dim cols,
+    const Dim batch,
+    const bool lower) {
+  const Dim numCols = cols * batch;
+#pragma omp parallel for if (numCols * rows >= kCpuKernelParallelThreshold)
+  for (Dim col = 0; col < numCols; col++) {
+    const Dim j = col % cols;
+    const T* src = in + col * rows;
+    T* dst = out + col * rows;
+    // each column is a zero range and a copy range
+    if (lower) {
+      const Dim boundary = std::min(j, rows);
+      std::fill(dst, dst + boundary, T(0));
+      std::copy(src + boundary, src + rows, dst + boundary);
+    } else {
+      const Dim boundary = std::min(j + 1, rows);
+      std::copy(src, src + boundary, dst);
+      std::fill(dst + boundary, dst + rows, T(0));
+    }
+  }
+}
+
+/**
+ * Pads `in` of `inShape` by `padWidths` (before, after) per dim into `out`.
+ * `inShape` must have at least as many dims as `padWidths`.
+ */
+template <typename T>
+void padKernel(
+    const T* in,
+    T* out,
+    const Shape& inShape,
+    const std::vector<std::pair<int, int>>& padWidths,
+    const PadType type) {
+  const int ndim = inShape.ndim();
+  std::vector<Dim> outDims(ndim);
+  // maps output index to input index along each dim, -1 for constant padding
+  std::vector<std::vector<Dim>> srcIndices(ndim);
+  for (int d = 0; d < ndim; d++) {
+    const bool hasPad = d < static_cast<int>(padWidths.size());
+    const Dim before = hasPad ? padWidths[d].first : 0;
+    const Dim after = hasPad ? padWidths[d].second : 0;
+    const Dim inDim = inShape[d];
+    outDims[d] = before + inDim + after;
+    auto& indices = srcIndices[d];
+    indices.resize(outDims[d]);
+    for (Dim o = 0; o < outDims[d]; o++) {
+      const Dim i = o - before;
+      if (0 <= i && i < inDim) {
+        indices[o] = i;
+      } else if (type == PadType::Constant || inDim == 0) {
+        indices[o] = -1;
+      } else if (type == PadType::Edge) {
+        indices[o] = std::clamp<Dim>(i, 0, inDim - 1);
+      } else { // Symmetric, i.e., mirrored including the edge
+        const Dim period = 2 * inDim;
+        const Dim m = ((i % period) + period) % period;
+        indices[o] = m < inDim ? m : period - 1 - m;
+      }
+    }
+  }
+  if (ndim == 0) {
+    out[0] = in[0];
+    return;
+  }
+
+  const Dim outRowSize = outDims[0];
+  const Dim inRowSize = inShape[0];
+  const Dim before = padWidths.empty() ? 0 : padWidths[0].first;
+  Dim numRows = 1;
+  for (int d = 1; d < ndim; d++) {
+    numRows *= outDims[d];
+  }
+#pragma omp parallel for if (numRows * outRowSize >= kCpuKernelParallelThreshold)
+  for (Dim row = 0; row < numRows; row++) {
+    T* dst = out + row * outRowSize;
+    // locate the source row, if any
+    Dim srcRow = 0;
+    Dim srcStride = 1;
+    Dim rest = row;
+    bool isPadding = false;
+    for (int d = 1; d < ndim; d++) {
+      const Dim srcIdx = srcIndices[d][rest % outDims[d]];
+      rest /= outDims[d];
+      isPadding |= srcIdx < 0;
+      srcRow += srcIdx * srcStride;
+      srcStride *= inShape[d];
+    }
+    if (isPadding) {
+      std::fill(dst, dst + outRowSize, T(0));
+      continue;
+    }
+    const T* src = in + srcRow * inRowSize;
+    // copy the middle, then map the padding at both ends
+    std::copy(src, src + inRowSize, dst + before);
+    const auto& rowIndices = srcIndices[0];
+    const auto mapPadding = [&](Dim start, Dim end) {
+      for (Dim o = start; o < end; o++) {
+        dst[o] = rowIndices[o] < 0 ? T(0) : src[rowIndices[o]];
+      }
+    };
+    mapPadding(0, before);
+    mapPadding(before + inRowSize, outRowSize);
+  }
+}
+
+} // namespace fl::detail
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/onednn/CpuTaskQueue.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace fl::detail {
+
+CpuTaskQueue::CpuTaskQueue(unsigned numWorkers) {
+  if (numWorkers == 0) {
+    throw std::invalid_argument("CpuTaskQueue requires at least 1 worker");
+  }
+  for (unsigned i = 0; i < numWorkers; i++) {
+    threads_.emplace_back([this, i]() { workerLoop(i); });
+  }
+}
+
+CpuTaskQueue::~CpuTaskQueue() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCondition_.wait(lock, [this]() { return numUnfinished_ == 0; });
+    stop_ = true;
+  }
+  readyCondition_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void CpuTaskQueue::submit(
+    Task task,
+    const std::vector<const void*>& reads,
+    const std::vector<const void*>& writes) {
+  auto node = std::make_shared<Node>();
+  node->task = std::move(task);
+  for (const auto* buffer : writes) {
+    if (buffer &&
+        std::find(node->writes.begin(), node->writes.end(), buffer) ==
+            node->writes.end()) {
+      node->writes.push_back(buffer);
+    }
+  }
+  for (const auto* buffer : reads) {
+    if (buffer &&
+        std::find(node->writes.begin(), node->writes.end(), buffer) ==
+            node->writes.end() &&
+        std::find(node->reads.begin(), node->reads.end(), buffer) ==
+            node->reads.end()) {
+      node->reads.push_back(buffer);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<Node>> deps;
+    const auto addDep = [&deps](const std::shared_ptr<Node>& dep) {
+      if (dep && !dep->done &&
+          std::find(deps.begin(), deps.end(), dep) == deps.end()) {
+        deps.push_back(dep);
+      }
+    };
+    for (const auto* buffer : node->reads) {
+      auto& users = bufferToUsers_[buffer];
+      if (!users.lastWriter) { // otherwise the poison is overwritten first
+        const auto poisonIter = poisonedBuffers_.find(buffer);
+        if (poisonIter != poisonedBuffers_.end()) {
+          node->error = poisonIter->second;
+        }
+      }
+      addDep(users.lastWriter);
+      users.readers.push_back(node);
+    }
+    for (const auto* buffer : node->writes) {
+      auto& users = bufferToUsers_[buffer];
+      addDep(users.lastWriter);
+      for (const auto& reader : users.readers) {
+        addDep(reader);
+      }
+      users.lastWriter = node;
+      users.readers.clear();
+    }
+    for (const auto& dep : deps) {
+      dep->dependents.push_back(node);
+    }
+    node->numPendingDeps = deps.size();
+    numUnfinished_++;
+    if (node->numPendingDeps == 0) {
+      ready_.push_back(node);
+    }
+  }
+  readyCondition_.notify_one();
+}
+
+void CpuTaskQueue::waitAll() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  doneCondition_.wait(lock, [this]() { return numUnfinished_ == 0; });
+  if (error_) {
+    std::exception_ptr error = nullptr;
+    std::swap(error, error_);
+    std::rethrow_exception(error);
+  }
+}
+
+void CpuTaskQueue::waitFor(const void* buffer) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  waitForLocked(lock, buffer);
+  const auto poisonIter = poisonedBuffers_.find(buffer);
+  if (poisonIter != poisonedBuffers_.end()) {
+    std::rethrow_exception(poisonIter->second);
+  }
+}
+
+void CpuTaskQueue::release(const void* buffer) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  waitForLocked(lock, buffer);
+  poisonedBuffers_.erase(buffer);
+}
+
+void CpuTaskQueue::waitForLocked(
+    std::unique_lock<std::mutex>& lock,
+    const void* buffer) {
+  doneCondition_.wait(
+      lock, [this, buffer]() { return bufferToUsers_.count(buffer) == 0; });
+}
+
+unsigned CpuTaskQueue::numWorkers() const {
+  return threads_.size();
+}
+
+void CpuTaskQueue::workerLoop(unsigned workerId) {
+  while (true) {
+    std::shared_ptr<Node> node;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      readyCondition_.wait(lock, [this]() { return stop_ || !ready_.empty(); });
+      if (ready_.empty()) {
+        return; // stopping
+      }
+      node = std::move(ready_.front());
+      ready_.pop_front();
+    }
+
+    // `node->error` is only set before the task became ready, no need to lock
+    std::exception_ptr error = nullptr;
+    if (!node->error) {
+      try {
+        node->task(workerId);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    node->task = nullptr; // release captures outside the lock
+
+    size_t numReady = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error) {
+        node->error = error;
+        if (!error_) {
+          error_ = error;
+        }
+      }
+      const auto numReadyBefore = ready_.size();
+      finish(node);
+      numReady = ready_.size() - numReadyBefore;
+    }
+    // this worker takes one of the newly ready tasks itself
+    for (size_t i = 1; i < numReady; i++) {
+      readyCondition_.notify_one();
+    }
+    doneCondition_.notify_all();
+  }
+}
+
+void CpuTaskQueue::finish(const std::shared_ptr<Node>& node) {
+  node->done = true;
+  const auto releaseBuffer = [&](const void* buffer) {
+    const auto iter = bufferToUsers_.find(buffer);
+    if (iter == bufferToUsers_.end()) {
+      return;
+    }
+    auto& users = iter->second;
+    if (users.lastWriter == node) {
+      users.lastWriter.reset();
+    }
+    users.readers.erase(
+        std::remove(users.readers.begin(), users.readers.end(), node),
+        users.readers.end());
+    if (!users.lastWriter && users.readers.empty()) {
+      bufferToUsers_.erase(iter);
+    }
+  };
+  for (const auto* buffer : node->reads) {
+    releaseBuffer(buffer);
+  }
+  for (const auto* buffer : node->writes) {
+    releaseBuffer(buffer);
+    if (node->error) {
+      poisonedBuffers_[buffer] = node->error;
+    } else {
+      poisonedBuffers_.erase(buffer);
+    }
+  }
+  const auto usesOutputOf = [](const Node& user, const Node& producer) {
+    for (const auto* buffer : producer.writes) {
+      if (std::find(user.reads.begin(), user.reads.end(), buffer) !=
+              user.reads.end() ||
+          std::find(user.writes.begin(), user.writes.end(), buffer) !=
+              user.writes.end()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  for (const auto& dependent : node->dependents) {
+    // skip tasks using outputs of a failed one, but not those merely
+    // overwriting its inputs
+    if (node->error && !dependent->error && usesOutputOf(*dependent, *node)) {
+      dependent->error = node->error;
+    }
+    if (--dependent->numPendingDeps == 0) {
+      ready_.push_back(dependent);
+    }
+  }
+  node->dependents.clear(); // break reference cycles
+  numUnfinished_--;
+}
+
+} // namespace fl::detail
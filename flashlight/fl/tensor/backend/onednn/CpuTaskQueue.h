@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fl::detail {
+
+/**
+ * A fixed-size thread pool that runs tasks out of order, as soon as the tasks
+ * they depend on finished. Dependencies are derived from the buffers each task
+ * reads & writes, in submission order:
+ * - a reader waits for the last writer of the buffer (read after write).
+ * - a writer waits for the last writer and all readers since (write after
+ *   read/write).
+ *
+ * If a task throws, the buffers it writes are poisoned: tasks reading them are
+ * skipped (and poison their own outputs), and waiting for them rethrows the
+ * exception, until a later task writes them successfully or they're released.
+ *
+ * Submission and waiting must happen on threads outside the pool, and tasks
+ * must not own the buffers they use.
+ */
+class CpuTaskQueue {
+ public:
+  // takes the index of the worker running the task, in [0, numWorkers)
+  using Task = std::function<void(unsigned)>;
+
+  /**
+   * Launches `numWorkers` (must be positive) worker threads.
+   */
+  explicit CpuTaskQueue(unsigned numWorkers);
+  // joins all workers after finishing the submitted tasks
+  ~CpuTaskQueue();
+
+  // no copy/move
+  CpuTaskQueue(const CpuTaskQueue&) = delete;
+  CpuTaskQueue(CpuTaskQueue&&) = delete;
+  CpuTaskQueue& operator=(const CpuTaskQueue&) = delete;
+  CpuTaskQueue& operator=(CpuTaskQueue&&) = delete;
+
+  /**
+   * Submits a task that reads `reads` and writes `writes`. A buffer in both is
+   * treated as written; null buffers are ignored.
+   */
+  void submit(
+      Task task,
+      const std::vector<const void*>& reads,
+      const std::vector<const void*>& writes);
+
+  /**
+   * Blocks until all submitted tasks finished, and rethrows the first exception
+   * thrown by a task since the last call, if any.
+   */
+  void waitAll();
+
+  /**
+   * Blocks until submitted tasks that read or write `buffer` finished, and
+   * rethrows the exception that poisoned `buffer`, if any.
+   */
+  void waitFor(const void* buffer);
+
+  /**
+   * Like `waitFor`, but clears the poison instead of rethrowing it, e.g.,
+   * before `buffer` is freed and its address reused.
+   */
+  void release(const void* buffer);
+
+  unsigned numWorkers() const;
+
+ private:
+  struct Node {
+    Task task;
+    std::vector<const void*> reads;
+    std::vector<const void*> writes;
+    // # of unfinished tasks this one waits for
+    unsigned numPendingDeps{0};
+    std::vector<std::shared_ptr<Node>> dependents;
+    bool done{false};
+    // set if the task threw, or was skipped since it reads a poisoned buffer
+    std::exception_ptr error;
+  };
+
+  // unfinished tasks using a buffer
+  struct BufferUsers {
+    std::shared_ptr<Node> lastWriter;
+    // readers since `lastWriter` was submitted
+    std::vector<std::shared_ptr<Node>> readers;
+  };
+
+  void workerLoop(unsigned workerId);
+  // wait until no task uses `buffer`, must hold `mutex_` through `lock`
+  void waitForLocked(std::unique_lock<std::mutex>& lock, const void* buffer);
+  // mark `node` as done and release its dependents, must hold `mutex_`
+  void finish(const std::shared_ptr<Node>& node);
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  // signaled when tasks become ready or upon stopping
+  std::condition_variable readyCondition_;
+  // signaled when tasks finish
+  std::condition_variable doneCondition_;
+  std::deque<std::shared_ptr<Node>> ready_;
+  std::unordered_map<const void*, BufferUsers> bufferToUsers_;
+  // buffers whose last writer failed, with the exception
+  std::unordered_map<const void*, std::exception_ptr> poisonedBuffers_;
+  // # of submitted tasks that haven't finished
+  size_t numUnfinished_{0};
+  std::exception_ptr error_;
+  bool stop_{false};
+};
+
+} // namespace fl::detail
@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
 #include <functional>
 #include <initializer_list>
 #include <iostream>
@@ -17,16 +18,17 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
 #include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/onednn/CpuKernels.h"
 #include "flashlight/fl/tensor/backend/onednn/OneDnnTensor.h"
+#include "flashlight/fl/tensor/backend/onednn/PrimitiveCache.h"
 #include "flashlight/fl/tensor/backend/onednn/Utils.h"
-
-#define FL_ONEDNN_BACKEND_UNIMPLEMENTED \
-  throw std::invalid_argument(          \
-      "OneDnnBackend::" + std::string(__func__) + " - unimplemented.");
+#include "flashlight/fl/tensor/backend/onednn/mem/CachingHostMemoryManager.h"
 
 namespace fl {
 
@@ -124,7 +126,8 @@ Tensor iotaSingleAxisCpu(
   const Shape shape(dims);
   switch (type) {
     case dtype::f16:
-      return iotaWithTypeCpu<float>(shape, dtype::f32).astype(dtype::f16);
+    case dtype::bf16:
+      return iotaWithTypeCpu<float>(shape, dtype::f32).astype(type);
     case dtype::f32:
       return iotaWithTypeCpu<float>(shape, type);
     case dtype::f64:
@@ -215,6 +218,34 @@ BinaryOpOutputDesc getBinaryOpOutputDesc(
       /* dstShape = */ dstShape);
 }
 
+/**
+ * Returns the opaque layout (e.g., blocked, from a convolution) that the
+ * operands & output of a binary op can all use to avoid reorders, if any. That
+ * is, an operand in opaque layout has the output's dims & type, and the other
+ * operand either has the same layout, or is a (broadcast) scalar.
+ */
+std::optional<dnnl::memory::desc> getCommonOpaqueLayout(
+    OneDnnTensor& lhs,
+    OneDnnTensor& rhs,
+    const dnnl::memory::desc& dstMemDesc) {
+  for (auto* tensor : {&lhs, &rhs}) {
+    if (tensor->hasPlainLayout()) {
+      continue;
+    }
+    const auto desc = tensor->memoryDescAnyLayout();
+    if (desc.get_dims() != dstMemDesc.get_dims() ||
+        desc.get_data_type() != dstMemDesc.get_data_type()) {
+      continue;
+    }
+    auto& other = tensor == &lhs ? rhs : lhs;
+    if (other.memoryDescAnyLayout() == desc ||
+        (other.hasPlainLayout() && other.shape().elements() == 1)) {
+      return desc;
+    }
+  }
+  return std::nullopt;
+}
+
 template <typename L, typename R, typename T, typename OP>
 void applyBinopCpu(
     const void* lhs,
@@ -239,8 +270,9 @@ void applyBinopCpu(
     OP op) {
   switch (rhsType) {
     case fl::dtype::f16:
+    case fl::dtype::bf16:
       throw std::runtime_error(
-          "Fallback implementation currently doesn't support f16");
+          "Fallback implementation currently doesn't support f16/bf16");
     case fl::dtype::f32:
       applyBinopCpu<L, float>(lhs, rhs, dst, count, op);
       break;
@@ -285,8 +317,9 @@ void applyBinopCpu(
     OP op) {
   switch (lhsType) {
     case fl::dtype::f16:
+    case fl::dtype::bf16:
       throw std::runtime_error(
-          "Fallback implementation currently doesn't support f16");
+          "Fallback implementation currently doesn't support f16/bf16");
     case fl::dtype::f32:
       applyBinopCpu<float>(lhs, rhs, rhsType, dst, count, op);
       break;
@@ -332,8 +365,6 @@ Tensor sameShapeBinopCpu(const Tensor& lhs, const Tensor& rhs, OP op) {
     throw std::invalid_argument(
         "[OneDnnBackend] Generic Binop impl requires input tensors of the same shape");
   }
-  lhs.stream().sync();
-  rhs.stream().sync();
   void* lhsData;
   void* rhsData;
   // On CPU, device pointer is host pointer.
@@ -380,23 +411,6 @@ Tensor createScalarTensorForBinop(const Tensor& tensor, INPUT_TYPE val) {
       literalShape, type, &castedVal, tensor.location());
 }
 
-dnnl::memory::desc transposeInnerMatrix(const dnnl::memory::desc& memDesc) {
-  const auto ndims = memDesc.get_ndims();
-  if (ndims < 2) {
-    std::ostringstream oss;
-    oss << "[transposeInnerMatrix] expected ndims to be >= 2, got: " << ndims;
-    throw std::runtime_error(oss.str());
-  }
-  // recall that internal dims are reversed from the logical col-major dims
-  std::vector<int> transposeAxesPermutation;
-  for (int i = 0; i < ndims; i++) {
-    transposeAxesPermutation.push_back(i);
-  }
-  std::swap(
-      transposeAxesPermutation[ndims - 2], transposeAxesPermutation[ndims - 1]);
-  return memDesc.permute_axes(transposeAxesPermutation);
-}
-
 std::tuple<Shape, Shape> padShorterDimsWithOnesOnTheRight(
     const Shape& tensorShape,
     const Shape& tileDims) {
@@ -414,6 +428,247 @@ std::tuple<Shape, Shape> padShorterDimsWithOnesOnTheRight(
   return {Shape(paddedTensorDims), Shape(paddedTileDims)};
 }
 
+/**
+ * Calls `func` with a value of the C++ type that holds elements of `type` in a
+ * OneDnnTensor, for CPU kernels.
+ */
+template <typename Func>
+auto dispatchCpuType(const dtype type, const char* funcName, Func&& func) {
+  switch (type) {
+    case dtype::f32:
+      return func(float{});
+    case dtype::f64:
+      return func(double{});
+    case dtype::b8:
+      return func(char{});
+    case dtype::u8:
+      return func(static_cast<unsigned char>(0));
+    case dtype::s32:
+      return func(int{});
+    default:
+      throw std::invalid_argument(
+          "[OneDnnBackend::" + std::string(funcName) +
+          "] unsupported type: " + dtypeToString(type));
+  }
+}
+
+// f16 & bf16, which have no host type for CPU kernels to compute in
+bool isHalfFloatType(const dtype type) {
+  return type == dtype::f16 || type == dtype::bf16;
+}
+
+/**
+ * Same as `dispatchCpuType`, but also accepts f16 & bf16 as raw 16-bit values,
+ * for CPU kernels that only copy elements or fill zeros (all bits 0).
+ */
+template <typename Func>
+auto dispatchCpuStorageType(
+    const dtype type,
+    const char* funcName,
+    Func&& func) {
+  if (isHalfFloatType(type)) {
+    return func(static_cast<unsigned short>(0));
+  }
+  return dispatchCpuType(type, funcName, std::forward<Func>(func));
+}
+
+bool isFloatType(const dtype type) {
+  return isHalfFloatType(type) || type == dtype::f32 || type == dtype::f64;
+}
+
+// the tensor itself if floating point, otherwise cast to f32 into `holder`
+const Tensor& asFloatType(const Tensor& tensor, Tensor& holder) {
+  if (isFloatType(tensor.type())) {
+    return tensor;
+  }
+  holder = tensor.astype(dtype::f32);
+  return holder;
+}
+
+/**
+ * Dense host data of a tensor for CPU kernels to read; views are copied.
+ */
+template <typename T>
+class CpuInput {
+  Tensor dense_; // only used if the input wasn't dense
+  const T* data_;
+
+ public:
+  explicit CpuInput(const Tensor& tensor) {
+    if (!hasCpuEngine(tensor)) {
+      throw std::runtime_error(
+          "[OneDnnBackend] CPU kernels unimplemented for non-CPU engine");
+    }
+    const Tensor* src = &tensor;
+    if (!tensor.isContiguous() ||
+        toOneDnnTensor(tensor).memoryDesc().get_submemory_offset() != 0) {
+      dense_ = tensor.copy();
+      src = &dense_;
+    }
+    auto& srcMem = toOneDnnTensor(*src).memory();
+    OneDnnBackend::getInstance().cpuStream().syncData(srcMem.get_data_handle());
+    data_ = static_cast<const T*>(srcMem.get_data_handle());
+  }
+
+  const T* data() const {
+    return data_;
+  }
+};
+
+/**
+ * An uninitialized tensor & its data, for CPU kernels to write into. `type`
+ * only differs from `T`'s for raw 16-bit values (see `dispatchCpuStorageType`).
+ */
+template <typename T>
+std::pair<Tensor, T*> createCpuOutput(
+    const Shape& shape,
+    const dtype type = dtype_traits<T>::fl_type) {
+  auto& backend = OneDnnBackend::getInstance();
+  const auto memDesc = detail::oneDnnContiguousMemDescFromShape(
+      shape, detail::flToOneDnnType(type));
+  auto [mem, buffer] = backend.createMemory(memDesc, backend.cpuEngine());
+  T* data = static_cast<T*>(mem.get_data_handle());
+  return {toTensor<OneDnnTensor>(shape, std::move(mem), std::move(buffer)), data};
+}
+
+template <typename T, typename Op>
+Tensor applyUnaryCpu(const Tensor& tensor, Op op) {
+  CpuInput<T> input(tensor);
+  auto [output, outputData] = createCpuOutput<T>(tensor.shape());
+  detail::unaryKernel(input.data(), outputData, tensor.elements(), op);
+  return std::move(output);
+}
+
+// applies `op` on floating point elements, casting other types to f32 first
+template <typename Op>
+Tensor applyFpUnaryCpu(const Tensor& tensor, Op op) {
+  switch (tensor.type()) {
+    case dtype::f32:
+      return applyUnaryCpu<float>(tensor, op);
+    case dtype::f64:
+      return applyUnaryCpu<double>(tensor, op);
+    case dtype::f16:
+    case dtype::bf16:
+      return applyUnaryCpu<float>(tensor.astype(dtype::f32), op)
+          .astype(tensor.type());
+    default:
+      return applyUnaryCpu<float>(tensor.astype(dtype::f32), op);
+  }
+}
+
+Shape reduceAxis(const Shape& shape, const unsigned axis, const bool keepDims) {
+  std::vector<Dim> dims = shape.get();
+  if (keepDims) {
+    dims[axis] = 1;
+  } else {
+    dims.erase(dims.begin() + axis);
+  }
+  return Shape(dims);
+}
+
+void checkAxis(const char* funcName, const Tensor& tensor, const unsigned axis) {
+  if (axis >= static_cast<unsigned>(tensor.ndim())) {
+    std::ostringstream oss;
+    oss << "[OneDnnBackend::" << funcName << "] Axis too large: " << axis
+        << " for tensor of shape: " << tensor.shape();
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+void argBestCpu(
+    Tensor* values,
+    Tensor* indices,
+    const Tensor& input,
+    const unsigned axis,
+    const bool keepDims,
+    const bool isMax) {
+  if (isHalfFloatType(input.type())) {
+    const auto inputF32 = input.astype(dtype::f32);
+    argBestCpu(values, indices, inputF32, axis, keepDims, isMax);
+    if (values) {
+      *values = values->astype(input.type());
+    }
+    return;
+  }
+  const auto dstShape = reduceAxis(input.shape(), axis, keepDims);
+  const detail::AxisView view(input.shape(), axis);
+  dispatchCpuType(input.type(), isMax ? "max" : "min", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> in(input);
+    T* valuesData = nullptr;
+    int* indicesData = nullptr;
+    if (values) {
+      std::tie(*values, valuesData) = createCpuOutput<T>(dstShape);
+    }
+    if (indices) {
+      std::tie(*indices, indicesData) = createCpuOutput<int>(dstShape);
+    }
+    if (isMax) {
+      detail::argBestKernel(
+          in.data(), valuesData, indicesData, view, std::greater<>());
+    } else {
+      detail::argBestKernel(
+          in.data(), valuesData, indicesData, view, std::less<>());
+    }
+  });
+}
+
+void sortCpu(
+    Tensor* values,
+    Tensor* indices,
+    const Tensor& input,
+    const unsigned axis,
+    const Dim k,
+    const SortMode sortMode) {
+  if (isHalfFloatType(input.type())) {
+    sortCpu(values, indices, input.astype(dtype::f32), axis, k, sortMode);
+    if (values) {
+      *values = values->astype(input.type());
+    }
+    return;
+  }
+  std::vector<Dim> dstDims = input.shape().get();
+  dstDims[axis] = k;
+  const Shape dstShape(dstDims);
+  const detail::AxisView view(input.shape(), axis);
+  dispatchCpuType(input.type(), "sort", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> in(input);
+    T* valuesData = nullptr;
+    int* indicesData = nullptr;
+    if (values) {
+      std::tie(*values, valuesData) = createCpuOutput<T>(dstShape);
+    }
+    if (indices) {
+      std::tie(*indices, indicesData) = createCpuOutput<int>(dstShape);
+    }
+    detail::sortKernel(
+        in.data(),
+        valuesData,
+        indicesData,
+        view,
+        k,
+        sortMode == SortMode::Descending);
+  });
+}
+
+// tril/triu, on the first 2 dims of every matrix in the batch
+Tensor triangularCpu(const Tensor& tensor, const bool lower) {
+  const Dim rows = tensor.ndim() > 0 ? tensor.dim(0) : 1;
+  const Dim cols = tensor.ndim() > 1 ? tensor.dim(1) : 1;
+  const Dim batch = rows * cols == 0 ? 0 : tensor.elements() / (rows * cols);
+  const auto funcName = lower ? "tril" : "triu";
+  return dispatchCpuStorageType(tensor.type(), funcName, [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> input(tensor);
+    auto [output, outputData] =
+        createCpuOutput<T>(tensor.shape(), tensor.type());
+    detail::triangularKernel(
+        input.data(), outputData, rows, cols, batch, lower);
+    return std::move(output);
+  });
+}
+
 } // namespace
 
 OneDnnBackend::OneDnnBackend() {
@@ -424,6 +679,10 @@ OneDnnBackend::OneDnnBackend() {
 #endif // FL_USE_MKL_RNG
   engine_ = dnnl::engine(dnnl::engine::kind::cpu, 0);
   stream_ = OneDnnCPUStream::create(engine_);
+  if (const char* env = std::getenv("FL_ONEDNN_ASYNC_WORKERS")) {
+    stream_->setNumWorkers(std::stoul(env));
+  }
+  memoryManager_ = std::make_shared<CachingHostMemoryManager>();
 }
 
 OneDnnBackend& OneDnnBackend::getInstance() {
@@ -443,6 +702,10 @@ dnnl::stream& OneDnnBackend::nativeStream() const {
   return stream_->handle();
 }
 
+OneDnnCPUStream& OneDnnBackend::cpuStream() const {
+  return *stream_;
+}
+
 const dnnl::engine& OneDnnBackend::engine() const {
   return engine_;
 }
@@ -451,6 +714,42 @@ const dnnl::engine& OneDnnBackend::cpuEngine() const {
   return engine_;
 }
 
+detail::PrimitiveCache& OneDnnBackend::primitiveCache() {
+  return primitiveCache_;
+}
+
+HostMemoryManager& OneDnnBackend::memoryManager() const {
+  return *memoryManager_;
+}
+
+void OneDnnBackend::setMemoryManager(
+    std::shared_ptr<HostMemoryManager> manager) {
+  if (!manager) {
+    throw std::invalid_argument(
+        "[OneDnnBackend::setMemoryManager] manager must not be null");
+  }
+  memoryManager_ = std::move(manager);
+}
+
+std::pair<dnnl::memory, std::shared_ptr<void>> OneDnnBackend::createMemory(
+    const dnnl::memory::desc& desc,
+    const dnnl::engine& engine) const {
+  if (engine.get_kind() != dnnl::engine::kind::cpu) {
+    return {dnnl::memory(desc, engine), nullptr};
+  }
+  // NOTE size includes padding of blocked formats
+  void* data = memoryManager_->alloc(desc.get_size());
+  // primitives queued on an asynchronous stream may still use the buffer
+  std::shared_ptr<void> buffer(
+      data, [manager = memoryManager_, stream = stream_](void* ptr) {
+        if (stream->isAsync()) {
+          stream->releaseData(ptr);
+        }
+        manager->free(ptr);
+      });
+  return {dnnl::memory(desc, engine, data), std::move(buffer)};
+}
+
 /* -------------------------- Compute Functions -------------------------- */
 
 void OneDnnBackend::eval(const Tensor& /* tensor */) {
@@ -462,11 +761,10 @@ bool OneDnnBackend::supportsDataType(const fl::dtype& type) const {
 }
 
 void OneDnnBackend::getMemMgrInfo(
-    const char* /* msg */,
+    const char* msg,
     const int /* deviceId */,
-    std::ostream* /* ostream */) {
-  throw std::runtime_error(
-      "[OneDnnBackend] Currently no memory manager support");
+    std::ostream* ostream) {
+  memoryManager_->printInfo(msg, ostream);
 }
 
 void OneDnnBackend::setMemMgrLogStream(std::ostream* /* stream */) {
@@ -558,8 +856,8 @@ Tensor OneDnnBackend::rand(const Shape& shape, dtype type) {
       const Shape& shape, TYPE value, const dtype type) {                      \
     switch (type) {                                                            \
       case dtype::f16:                                                         \
-        return fullWithType<float>(shape, value, dtype::f32)                   \
-            .astype(dtype::f16);                                               \
+      case dtype::bf16:                                                        \
+        return fullWithType<float>(shape, value, dtype::f32).astype(type);     \
       case dtype::f32:                                                         \
         return fullWithType<float>(shape, value, type);                        \
       case dtype::f64:                                                         \
@@ -608,8 +906,23 @@ OneDnnBackend::fullWithType(const Shape& shape, V value, const dtype type) {
   }
 }
 
-Tensor OneDnnBackend::identity(const Dim /* dim */, const dtype /* type */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::identity(const Dim dim, const dtype type) {
+  if (engine_.get_kind() != dnnl::engine::kind::cpu) {
+    throw std::runtime_error(
+        "[OneDnnBackend::identity] unimplemented for non-CPU engine");
+  }
+  if (isHalfFloatType(type)) {
+    return identity(dim, dtype::f32).astype(type);
+  }
+  return dispatchCpuType(type, "identity", [&](auto tag) {
+    using T = decltype(tag);
+    auto [output, outputData] = createCpuOutput<T>({dim, dim});
+    std::fill(outputData, outputData + dim * dim, T(0));
+    for (Dim i = 0; i < dim; i++) {
+      outputData[i * (dim + 1)] = T(1);
+    }
+    return std::move(output);
+  });
 }
 
 Tensor
@@ -633,10 +946,12 @@ OneDnnBackend::arange(const Shape& shape, const Dim seqDim, const dtype type) {
 }
 
 Tensor OneDnnBackend::iota(
-    const Shape& /* dims */,
-    const Shape& /* tileDims */,
-    const dtype /* type */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Shape& dims,
+    const Shape& tileDims,
+    const dtype type) {
+  // column-major sequence over `dims`, then tiled
+  const auto sequence = arange({dims.elements()}, 0, type);
+  return tile(reshape(sequence, dims), tileDims);
 }
 
 /************************ Shaping and Indexing *************************/
@@ -655,7 +970,7 @@ Tensor OneDnnBackend::reshape(const Tensor& tensor, const Shape& shape) {
   const auto& memDesc = srcTensor.memoryDesc();
   const auto reshapedMemDesc =
       detail::oneDnnContiguousMemDescFromShape(shape, memDesc.get_data_type());
-  auto reshapedMem = dnnl::memory(reshapedMemDesc, engine_);
+  auto [reshapedMem, reshapedBuffer] = createMemory(reshapedMemDesc, engine_);
 
   // prepare primitive (use reorder to do a copy)
   const auto reorderPrimitiveDesc =
@@ -663,8 +978,10 @@ Tensor OneDnnBackend::reshape(const Tensor& tensor, const Shape& shape) {
   const auto reorderPrimitive = dnnl::reorder(reorderPrimitiveDesc);
 
   // execute primitive
-  reorderPrimitive.execute(stream_->handle(), mem, reshapedMem);
-  return toTensor<OneDnnTensor>(shape, std::move(reshapedMem));
+  stream_->execute(
+      reorderPrimitive, {{DNNL_ARG_FROM, mem}, {DNNL_ARG_TO, reshapedMem}});
+  return toTensor<OneDnnTensor>(
+      shape, std::move(reshapedMem), std::move(reshapedBuffer));
 }
 
 // 1. OneDNN doesn't have native support for tensor transpose.
@@ -725,7 +1042,7 @@ Tensor OneDnnBackend::transpose(
   const auto srcMemDims = srcMemDesc.get_dims();
   const auto dstMemDesc =
       detail::oneDnnContiguousMemDescFromShape(newShape, type);
-  auto dstMem = dnnl::memory(dstMemDesc, engine_);
+  auto [dstMem, dstBuffer] = createMemory(dstMemDesc, engine_);
 
   // prepare primitive
   const auto reorderDstStrides =
@@ -737,8 +1054,10 @@ Tensor OneDnnBackend::transpose(
   const auto reorderPrimitive = dnnl::reorder(reorderPrimitiveDesc);
 
   // execute primitive
-  reorderPrimitive.execute(stream_->handle(), srcMem, dstMem);
-  return toTensor<OneDnnTensor>(newShape, std::move(dstMem));
+  stream_->execute(
+      reorderPrimitive, {{DNNL_ARG_FROM, srcMem}, {DNNL_ARG_TO, dstMem}});
+  return toTensor<OneDnnTensor>(
+      newShape, std::move(dstMem), std::move(dstBuffer));
 }
 
 Tensor OneDnnBackend::tile(const Tensor& tensor, const Shape& tileDims) {
@@ -747,6 +1066,8 @@ Tensor OneDnnBackend::tile(const Tensor& tensor, const Shape& tileDims) {
 
   auto& srcTensor = toOneDnnTensor(tensor);
   auto currTiledMem = srcTensor.memory();
+  std::shared_ptr<void> currTiledBuffer;
+  bool isTiled = false; // false while `currTiledMem` is the memory of `tensor`
   auto currTiledMemDesc = srcTensor.memoryDesc().reshape(
       detail::shapeToOneDnnDims(paddedTensorShape));
   std::vector<Dim> finalDims;
@@ -764,7 +1085,8 @@ Tensor OneDnnBackend::tile(const Tensor& tensor, const Shape& tileDims) {
           engine_, dimsAxis, tileMemDescs);
       const dnnl::concat concatPrimitive(concatPrimitiveDesc);
       const auto newTileMemDesc = concatPrimitiveDesc.dst_desc();
-      auto newTiledMem = dnnl::memory(newTileMemDesc, engine_);
+      auto [newTiledMem, newTiledBuffer] =
+          createMemory(newTileMemDesc, engine_);
 
       // prepare arguments.
       std::unordered_map<int, dnnl::memory> args{{DNNL_ARG_DST, newTiledMem}};
@@ -773,29 +1095,159 @@ Tensor OneDnnBackend::tile(const Tensor& tensor, const Shape& tileDims) {
       }
 
       // execute primitive
-      concatPrimitive.execute(stream_->handle(), args);
+      stream_->execute(concatPrimitive, args);
       currTiledMemDesc = newTileMemDesc;
       currTiledMem = newTiledMem;
+      currTiledBuffer = newTiledBuffer;
+      isTiled = true;
     }
   }
-  return toTensor<OneDnnTensor>(Shape(finalDims), std::move(currTiledMem));
+  if (!isTiled) {
+    // nothing was tiled; copy, since the result must not alias `tensor`
+    return reshape(tensor, Shape(finalDims));
+  }
+  return toTensor<OneDnnTensor>(
+      Shape(finalDims), std::move(currTiledMem), std::move(currTiledBuffer));
 }
 
 Tensor OneDnnBackend::concatenate(
-    const std::vector<Tensor>& /* tensors */,
-    const unsigned /* axis */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const std::vector<Tensor>& tensors,
+    const unsigned axis) {
+  if (tensors.empty()) {
+    throw std::invalid_argument(
+        "[OneDnnBackend::concatenate] need at least one tensor");
+  }
+  if (tensors.size() == 1) {
+    return tensors.front().copy();
+  }
+  // all tensors are viewed with the same # of dims, enough to include `axis`
+  int ndim = static_cast<int>(axis) + 1;
+  for (const auto& tensor : tensors) {
+    ndim = std::max(ndim, tensor.ndim());
+  }
+  const auto type = tensors.front().type();
+  const auto paddedDims = [ndim](const Tensor& tensor) {
+    std::vector<Dim> dims = tensor.shape().get();
+    dims.resize(ndim, 1);
+    return dims;
+  };
+  std::vector<Dim> dstDims = paddedDims(tensors.front());
+  dstDims[axis] = 0;
+  std::vector<const Tensor*> inputs;
+  for (const auto& tensor : tensors) {
+    const auto dims = paddedDims(tensor);
+    for (int i = 0; i < ndim; i++) {
+      if (tensor.type() != type ||
+          (i != static_cast<int>(axis) && dims[i] != dstDims[i])) {
+        std::ostringstream oss;
+        oss << "[OneDnnBackend::concatenate] Incompatible tensor of shape "
+            << tensor.shape() << " and type " << tensor.type()
+            << " to concatenate along axis " << axis;
+        throw std::invalid_argument(oss.str());
+      }
+    }
+    dstDims[axis] += dims[axis];
+    // OneDNN doesn't accept zero-sized sources
+    if (tensor.elements() > 0) {
+      inputs.push_back(&tensor);
+    }
+  }
+  const Shape dstShape(dstDims);
+  const auto dstMemDesc = detail::oneDnnContiguousMemDescFromShape(
+      dstShape, detail::flToOneDnnType(type));
+  auto [dstMem, dstBuffer] = createMemory(dstMemDesc, engine_);
+  if (inputs.empty()) {
+    return toTensor<OneDnnTensor>(
+        dstShape, std::move(dstMem), std::move(dstBuffer));
+  }
+
+  // prepare source memories, viewed with the padded dims, which requires them
+  // to be dense
+  std::vector<Tensor> denseInputs;
+  denseInputs.reserve(inputs.size());
+  std::vector<dnnl::memory::desc> srcMemDescs;
+  std::unordered_map<int, dnnl::memory> args;
+  for (unsigned i = 0; i < inputs.size(); i++) {
+    if (!inputs[i]->isContiguous() ||
+        toOneDnnTensor(*inputs[i]).memoryDesc().get_submemory_offset() != 0) {
+      denseInputs.push_back(inputs[i]->copy());
+      inputs[i] = &denseInputs.back();
+    }
+    auto& srcTensor = toOneDnnTensor(*inputs[i]);
+    auto srcMem = srcTensor.memory();
+    const auto srcMemDesc = detail::oneDnnContiguousMemDescFromShape(
+        Shape(paddedDims(*inputs[i])), srcMem.get_desc().get_data_type());
+    srcMemDescs.push_back(srcMemDesc);
+    args.emplace(
+        DNNL_ARG_MULTIPLE_SRC + i,
+        dnnl::memory(srcMemDesc, srcMem.get_engine(), srcMem.get_data_handle()));
+  }
+  args.emplace(DNNL_ARG_DST, dstMem);
+
+  // OneDNN dims are in reverse order of Flashlight dims
+  const int concatAxis = ndim - 1 - static_cast<int>(axis);
+  detail::PrimitiveCacheKeyBuilder keyBuilder;
+  keyBuilder.add(engine_)
+      .add(dnnl::primitive::kind::concat)
+      .add(concatAxis)
+      .add(dstMemDesc);
+  for (const auto& srcMemDesc : srcMemDescs) {
+    keyBuilder.add(srcMemDesc);
+  }
+  const auto concatPrimitive =
+      primitiveCache_.getOrCreate(keyBuilder.build(), [&]() {
+        return dnnl::concat(dnnl::concat::primitive_desc(
+            engine_, dstMemDesc, concatAxis, srcMemDescs));
+      });
+  stream_->execute(concatPrimitive, args);
+  return toTensor<OneDnnTensor>(
+      dstShape, std::move(dstMem), std::move(dstBuffer));
 }
 
-Tensor OneDnnBackend::nonzero(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::nonzero(const Tensor& tensor) {
+  if (isHalfFloatType(tensor.type())) {
+    return nonzero(tensor.astype(dtype::f32)); // -0 isn't all bits 0
+  }
+  return dispatchCpuType(tensor.type(), "nonzero", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> input(tensor);
+    const T* data = input.data();
+    std::vector<int> indices;
+    for (Dim i = 0; i < tensor.elements(); i++) {
+      if (data[i] != T(0)) {
+        indices.push_back(i);
+      }
+    }
+    return toTensor<OneDnnTensor>(
+        Shape({static_cast<Dim>(indices.size())}),
+        dtype::s32,
+        indices.data(),
+        Location::Host);
+  });
 }
 
 Tensor OneDnnBackend::pad(
-    const Tensor& /* input */,
-    const std::vector<std::pair<int, int>>& /* padWidths */,
-    const PadType /* type */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const std::vector<std::pair<int, int>>& padWidths,
+    const PadType type) {
+  if (padWidths.size() > static_cast<size_t>(input.ndim())) {
+    std::ostringstream oss;
+    oss << "[OneDnnBackend::pad] too many pad widths (" << padWidths.size()
+        << ") for tensor of shape " << input.shape();
+    throw std::invalid_argument(oss.str());
+  }
+  std::vector<Dim> dstDims = input.shape().get();
+  for (unsigned i = 0; i < padWidths.size(); i++) {
+    dstDims[i] += padWidths[i].first + padWidths[i].second;
+  }
+  return dispatchCpuStorageType(input.type(), "pad", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> in(input);
+    auto [output, outputData] =
+        createCpuOutput<T>(Shape(dstDims), input.type());
+    detail::padKernel(in.data(), outputData, input.shape(), padWidths, type);
+    return std::move(output);
+  });
 }
 
 /************************** Unary Operators ***************************/
@@ -816,16 +1268,16 @@ Tensor OneDnnBackend::logicalNot(const Tensor& tensor) {
   return tensor == 0;
 }
 
-Tensor OneDnnBackend::log1p(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::log1p(const Tensor& tensor) {
+  return applyFpUnaryCpu(tensor, [](auto x) { return std::log1p(x); });
 }
 
-Tensor OneDnnBackend::sin(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::sin(const Tensor& tensor) {
+  return applyFpUnaryCpu(tensor, [](auto x) { return std::sin(x); });
 }
 
-Tensor OneDnnBackend::cos(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::cos(const Tensor& tensor) {
+  return applyFpUnaryCpu(tensor, [](auto x) { return std::cos(x); });
 }
 
 Tensor OneDnnBackend::sqrt(const Tensor& tensor) {
@@ -836,12 +1288,18 @@ Tensor OneDnnBackend::tanh(const Tensor& tensor) {
   return applyEltwiseOp(tensor, dnnl::algorithm::eltwise_tanh);
 }
 
-Tensor OneDnnBackend::floor(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::floor(const Tensor& tensor) {
+  if (!isFloatType(tensor.type())) {
+    return tensor.copy(); // integers are already whole
+  }
+  return applyFpUnaryCpu(tensor, [](auto x) { return std::floor(x); });
 }
 
-Tensor OneDnnBackend::ceil(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::ceil(const Tensor& tensor) {
+  if (!isFloatType(tensor.type())) {
+    return tensor.copy(); // integers are already whole
+  }
+  return applyFpUnaryCpu(tensor, [](auto x) { return std::ceil(x); });
 }
 
 Tensor OneDnnBackend::rint(const Tensor& tensor) {
@@ -852,8 +1310,8 @@ Tensor OneDnnBackend::absolute(const Tensor& tensor) {
   return applyEltwiseOp(tensor, dnnl::algorithm::eltwise_abs);
 }
 
-Tensor OneDnnBackend::sigmoid(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::sigmoid(const Tensor& tensor) {
+  return applyEltwiseOp(tensor, dnnl::algorithm::eltwise_logistic);
 }
 
 Tensor OneDnnBackend::erf(const Tensor& tensor) {
@@ -866,17 +1324,24 @@ Tensor OneDnnBackend::erf(const Tensor& tensor) {
   // TODO investigate performance using post-ops -- just launch 1 primitive here
 }
 
-Tensor OneDnnBackend::flip(
-    const Tensor& /* tensor */,
-    const unsigned /* dim */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::flip(const Tensor& tensor, const unsigned dim) {
+  checkAxis("flip", tensor, dim);
+  const detail::AxisView view(tensor.shape(), dim);
+  return dispatchCpuStorageType(tensor.type(), "flip", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> input(tensor);
+    auto [output, outputData] =
+        createCpuOutput<T>(tensor.shape(), tensor.type());
+    detail::flipKernel(input.data(), outputData, view);
+    return std::move(output);
+  });
 }
 
 Tensor OneDnnBackend::clip(
-    const Tensor& /* tensor */,
-    const Tensor& /* low */,
-    const Tensor& /* high */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& tensor,
+    const Tensor& low,
+    const Tensor& high) {
+  return maximum(minimum(tensor, high), low);
 }
 
 Tensor OneDnnBackend::clip(
@@ -887,14 +1352,24 @@ Tensor OneDnnBackend::clip(
 }
 
 Tensor OneDnnBackend::roll(
-    const Tensor& /* tensor */,
-    const int /* shift */,
-    const unsigned /* axis */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& tensor,
+    const int shift,
+    const unsigned axis) {
+  checkAxis("roll", tensor, axis);
+  const detail::AxisView view(tensor.shape(), axis);
+  return dispatchCpuStorageType(tensor.type(), "roll", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> input(tensor);
+    auto [output, outputData] =
+        createCpuOutput<T>(tensor.shape(), tensor.type());
+    detail::rollKernel(input.data(), outputData, view, shift);
+    return std::move(output);
+  });
 }
 
-Tensor OneDnnBackend::isnan(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::isnan(const Tensor& tensor) {
+  // NaN is the only value not equal to itself
+  return tensor != tensor;
 }
 
 Tensor OneDnnBackend::isinf(const Tensor& tensor) {
@@ -906,52 +1381,96 @@ Tensor OneDnnBackend::sign(const Tensor& tensor) {
   return (0 < tensor) - (tensor < 0);
 }
 
-Tensor OneDnnBackend::tril(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::tril(const Tensor& tensor) {
+  return triangularCpu(tensor, /* lower = */ true);
 }
 
-Tensor OneDnnBackend::triu(const Tensor& /* tensor */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::triu(const Tensor& tensor) {
+  return triangularCpu(tensor, /* lower = */ false);
 }
 
 Tensor OneDnnBackend::where(
-    const Tensor& /* condition */,
-    const Tensor& /* x */,
-    const Tensor& /* y */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& condition,
+    const Tensor& x,
+    const Tensor& y) {
+  if (condition.shape() != x.shape() || x.shape() != y.shape()) {
+    std::ostringstream oss;
+    oss << "[OneDnnBackend::where] shapes must match, got condition: "
+        << condition.shape() << ", x: " << x.shape() << ", y: " << y.shape();
+    throw std::invalid_argument(oss.str());
+  }
+  Tensor condHolder;
+  Tensor yHolder;
+  if (condition.type() != dtype::b8) {
+    condHolder = condition != 0;
+  }
+  if (y.type() != x.type()) {
+    yHolder = y.astype(x.type());
+  }
+  const auto& cond = condition.type() == dtype::b8 ? condition : condHolder;
+  const auto& yCast = y.type() == x.type() ? y : yHolder;
+  return dispatchCpuStorageType(x.type(), "where", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<char> condInput(cond);
+    CpuInput<T> xInput(x);
+    CpuInput<T> yInput(yCast);
+    auto [output, outputData] = createCpuOutput<T>(x.shape(), x.type());
+    detail::whereKernel(
+        condInput.data(),
+        xInput.data(),
+        yInput.data(),
+        outputData,
+        x.elements());
+    return std::move(output);
+  });
 }
 
 void OneDnnBackend::topk(
-    Tensor& /* values */,
-    Tensor& /* indices */,
-    const Tensor& /* input */,
-    const unsigned /* k */,
-    const Dim /* axis */,
-    const SortMode /* sortMode */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& input,
+    const unsigned k,
+    const Dim axis,
+    const SortMode sortMode) {
+  checkAxis("topk", input, axis);
+  const Dim axisSize = input.dim(axis);
+  if (k > axisSize) {
+    std::ostringstream oss;
+    oss << "[OneDnnBackend::topk] k (" << k << ") exceeds the size of axis "
+        << axis << " in tensor of shape " << input.shape();
+    throw std::invalid_argument(oss.str());
+  }
+  sortCpu(&values, &indices, input, axis, k, sortMode);
 }
 
 Tensor OneDnnBackend::sort(
-    const Tensor& /* input */,
-    const Dim /* axis */,
-    const SortMode /* sortMode */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const Dim axis,
+    const SortMode sortMode) {
+  checkAxis("sort", input, axis);
+  Tensor values;
+  sortCpu(&values, nullptr, input, axis, input.dim(axis), sortMode);
+  return values;
 }
 
 void OneDnnBackend::sort(
-    Tensor& /* values */,
-    Tensor& /* indices */,
-    const Tensor& /* input */,
-    const Dim /* axis */,
-    const SortMode /* sortMode */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& input,
+    const Dim axis,
+    const SortMode sortMode) {
+  checkAxis("sort", input, axis);
+  sortCpu(&values, &indices, input, axis, input.dim(axis), sortMode);
 }
 
 Tensor OneDnnBackend::argsort(
-    const Tensor& /* input */,
-    const Dim /* axis */,
-    const SortMode /* sortMode */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const Dim axis,
+    const SortMode sortMode) {
+  checkAxis("argsort", input, axis);
+  Tensor indices;
+  sortCpu(nullptr, &indices, input, axis, input.dim(axis), sortMode);
+  return indices;
 }
 
 Tensor OneDnnBackend::applyEltwiseOp(
@@ -961,22 +1480,38 @@ Tensor OneDnnBackend::applyEltwiseOp(
     float beta /* 0 */) {
   // prepare memories
   auto& srcTensor = toOneDnnTensor(tensor);
-  const auto mem = srcTensor.memory();
-  const auto& memDesc = srcTensor.memoryDesc();
-  const auto dstMemDesc = detail::oneDnnContiguousMemDescFromShape(
-      tensor.shape(), memDesc.get_data_type());
-  auto dstMem = dnnl::memory(dstMemDesc, engine_);
+  // keep opaque layouts (e.g., from a convolution) to avoid reorders
+  const bool keepLayout = !srcTensor.hasPlainLayout();
+  const auto mem =
+      keepLayout ? srcTensor.memoryAnyLayout() : srcTensor.memory();
+  const auto memDesc =
+      keepLayout ? srcTensor.memoryDescAnyLayout() : srcTensor.memoryDesc();
+  const auto dstMemDesc = keepLayout
+      ? memDesc
+      : detail::oneDnnContiguousMemDescFromShape(
+            tensor.shape(), memDesc.get_data_type());
+  auto [dstMem, dstBuffer] = createMemory(dstMemDesc, engine_);
 
   // prepare unary primitive
-  const auto unaryPrimitiveDesc = dnnl::eltwise_forward::primitive_desc(
-      engine_,
-      dnnl::prop_kind::forward_inference,
-      alg,
-      memDesc,
-      dstMemDesc,
-      alpha,
-      beta);
-  const auto unaryPrimitive = dnnl::eltwise_forward(unaryPrimitiveDesc);
+  const auto key = detail::PrimitiveCacheKeyBuilder()
+                       .add(engine_)
+                       .add(dnnl::primitive::kind::eltwise)
+                       .add(alg)
+                       .add(memDesc)
+                       .add(dstMemDesc)
+                       .add(alpha)
+                       .add(beta)
+                       .build();
+  const auto unaryPrimitive = primitiveCache_.getOrCreate(key, [&]() {
+    return dnnl::eltwise_forward(dnnl::eltwise_forward::primitive_desc(
+        engine_,
+        dnnl::prop_kind::forward_inference,
+        alg,
+        memDesc,
+        dstMemDesc,
+        alpha,
+        beta));
+  });
 
   // prepare arguments.
   const std::unordered_map<int, dnnl::memory> args = {
@@ -985,8 +1520,9 @@ Tensor OneDnnBackend::applyEltwiseOp(
   };
 
   // execute primitive
-  unaryPrimitive.execute(stream_->handle(), args);
-  return toTensor<OneDnnTensor>(tensor.shape(), std::move(dstMem));
+  stream_->execute(unaryPrimitive, args);
+  return toTensor<OneDnnTensor>(
+      tensor.shape(), std::move(dstMem), std::move(dstBuffer));
 }
 
 /************************** Binary Operators ***************************/
@@ -1129,18 +1665,38 @@ Tensor OneDnnBackend::applyBinop(
   // prepare memories
   auto& lhsTensor = toOneDnnTensor(lhs);
   auto& rhsTensor = toOneDnnTensor(rhs);
-  auto lhsMem = lhsTensor.memory();
-  auto rhsMem = rhsTensor.memory();
-  const auto& lhsMemDesc = lhsTensor.memoryDesc();
-  const auto& rhsMemDesc = rhsTensor.memoryDesc();
-  const auto outputDesc = getBinaryOpOutputDesc(
-      lhs.shape(), lhsMemDesc, rhs.shape(), rhsMemDesc, dstType);
-  auto dstMem = dnnl::memory(outputDesc.dstMemDesc, engine_);
+  auto outputDesc = getBinaryOpOutputDesc(
+      lhs.shape(),
+      lhsTensor.memoryDesc(),
+      rhs.shape(),
+      rhsTensor.memoryDesc(),
+      dstType);
+  const auto opaqueLayout =
+      getCommonOpaqueLayout(lhsTensor, rhsTensor, outputDesc.dstMemDesc);
+  if (opaqueLayout) {
+    outputDesc.dstMemDesc = opaqueLayout.value();
+  }
+  auto lhsMem = opaqueLayout ? lhsTensor.memoryAnyLayout() : lhsTensor.memory();
+  auto rhsMem = opaqueLayout ? rhsTensor.memoryAnyLayout() : rhsTensor.memory();
+  const auto lhsMemDesc = opaqueLayout ? lhsTensor.memoryDescAnyLayout()
+                                       : lhsTensor.memoryDesc();
+  const auto rhsMemDesc = opaqueLayout ? rhsTensor.memoryDescAnyLayout()
+                                       : rhsTensor.memoryDesc();
+  auto [dstMem, dstBuffer] = createMemory(outputDesc.dstMemDesc, engine_);
 
   // prepare primitive
-  const auto binaryPrimitiveDesc = dnnl::binary::primitive_desc(
-      engine_, alg, lhsMemDesc, rhsMemDesc, outputDesc.dstMemDesc);
-  const auto binaryPrimitive = dnnl::binary(binaryPrimitiveDesc);
+  const auto key = detail::PrimitiveCacheKeyBuilder()
+                       .add(engine_)
+                       .add(dnnl::primitive::kind::binary)
+                       .add(alg)
+                       .add(lhsMemDesc)
+                       .add(rhsMemDesc)
+                       .add(outputDesc.dstMemDesc)
+                       .build();
+  const auto binaryPrimitive = primitiveCache_.getOrCreate(key, [&]() {
+    return dnnl::binary(dnnl::binary::primitive_desc(
+        engine_, alg, lhsMemDesc, rhsMemDesc, outputDesc.dstMemDesc));
+  });
 
   // prepare arguments
   const std::unordered_map<int, dnnl::memory> args = {
@@ -1150,12 +1706,42 @@ Tensor OneDnnBackend::applyBinop(
   };
 
   // execute primitive
-  binaryPrimitive.execute(stream_->handle(), args);
-  return toTensor<OneDnnTensor>(outputDesc.dstShape, std::move(dstMem));
+  stream_->execute(binaryPrimitive, args);
+  return toTensor<OneDnnTensor>(
+      outputDesc.dstShape, std::move(dstMem), std::move(dstBuffer));
 }
 
-Tensor OneDnnBackend::power(const Tensor& /* lhs */, const Tensor& /* rhs */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::power(const Tensor& lhs, const Tensor& rhs) {
+  if (lhs.shape() != rhs.shape()) {
+    std::ostringstream oss;
+    oss << "[OneDnnBackend::power] shapes must match, got " << lhs.shape()
+        << " and " << rhs.shape();
+    throw std::invalid_argument(oss.str());
+  }
+  const auto powerCpu = [&](const Tensor& base, const Tensor& exponent) {
+    return dispatchCpuType(base.type(), "power", [&](auto tag) {
+      using T = decltype(tag);
+      CpuInput<T> baseInput(base);
+      CpuInput<T> exponentInput(exponent);
+      auto [output, outputData] = createCpuOutput<T>(base.shape());
+      detail::binaryKernel(
+          baseInput.data(),
+          exponentInput.data(),
+          outputData,
+          base.elements(),
+          [](T b, T e) { return static_cast<T>(std::pow(b, e)); });
+      return std::move(output);
+    });
+  };
+  const auto type = isFloatType(lhs.type()) ? lhs.type() : rhs.type();
+  if (type == dtype::f64) {
+    return powerCpu(lhs.astype(dtype::f64), rhs.astype(dtype::f64));
+  }
+  // compute in f32 if either operand isn't f32 already
+  if (lhs.type() == dtype::f32 && rhs.type() == dtype::f32) {
+    return powerCpu(lhs, rhs);
+  }
+  return powerCpu(lhs.astype(dtype::f32), rhs.astype(dtype::f32)).astype(type);
 }
 
 Tensor OneDnnBackend::power(const Tensor& lhs, const double& rhs) {
@@ -1183,33 +1769,47 @@ Tensor OneDnnBackend::matmul(
   if (isLhsScalarOrVector) { // pad to (1 x 1/K)
     lhsDims.insert(lhsDims.end(), 2 - lhsDims.size(), 1);
     std::reverse(lhsDims.begin(), lhsDims.end());
-    lhsMemDesc = lhsMemDesc.reshape(detail::flDimsToOneDnnDims(lhsDims));
-  } else if (lhsProp == MatrixProperty::Transpose) {
-    std::swap(lhsDims[0], lhsDims[1]);
-    lhsMemDesc = transposeInnerMatrix(lhsMemDesc);
   }
   if (isRhsScalarOrVector) { // pad to (1/K x 1)
     rhsDims.insert(rhsDims.end(), 2 - rhsDims.size(), 1);
+  }
+  // pad batch dims with 1s to the same # of dims, OneDNN matmul broadcasts
+  // batch dims of size 1. NOTE pad before transposing, since only the plain
+  // (possibly strided) layouts are guaranteed to be reshapable.
+  const auto ndim = std::max(lhsDims.size(), rhsDims.size());
+  lhsDims.resize(ndim, 1);
+  rhsDims.resize(ndim, 1);
+  if (lhsDims != lhs.shape().get()) {
+    lhsMemDesc = lhsMemDesc.reshape(detail::flDimsToOneDnnDims(lhsDims));
+  }
+  if (rhsDims != rhs.shape().get()) {
     rhsMemDesc = rhsMemDesc.reshape(detail::flDimsToOneDnnDims(rhsDims));
-  } else if (rhsProp == MatrixProperty::Transpose) {
+  }
+  // transposed operands are strided views of the same memory, no copy needed
+  if (!isLhsScalarOrVector && lhsProp == MatrixProperty::Transpose) {
+    std::swap(lhsDims[0], lhsDims[1]);
+    lhsMemDesc = detail::transposeInnerMatrix(lhsMemDesc);
+  }
+  if (!isRhsScalarOrVector && rhsProp == MatrixProperty::Transpose) {
     std::swap(rhsDims[0], rhsDims[1]);
-    rhsMemDesc = transposeInnerMatrix(rhsMemDesc);
+    rhsMemDesc = detail::transposeInnerMatrix(rhsMemDesc);
   }
 
-  // shape check (TODO support broadcasting)
-  if (!(lhsDims.at(1) == rhsDims.at(0) &&
-        std::equal(
-            lhsDims.begin() + 2,
-            lhsDims.end(),
-            rhsDims.begin() + 2,
-            rhsDims.end()))) {
+  // shape check, batch dims must match or be broadcastable
+  bool isValid = lhsDims[1] == rhsDims[0];
+  std::vector<Dim> dstDims = {lhsDims[0], rhsDims[1]};
+  for (size_t i = 2; i < ndim; i++) {
+    const auto lhsDim = lhsDims[i];
+    const auto rhsDim = rhsDims[i];
+    isValid &= lhsDim == rhsDim || lhsDim == 1 || rhsDim == 1;
+    dstDims.push_back(std::max(lhsDim, rhsDim));
+  }
+  if (!isValid) {
     std::ostringstream oss;
     oss << "Cannot perform matmul for tensors of shapes: " << lhs.shape()
         << " and " << rhs.shape();
     throw std::invalid_argument(oss.str());
   }
-  std::vector<Dim> dstDims = lhsDims;
-  dstDims[1] = rhsDims[1];
   Shape dstShape(dstDims);
 
   // prepare memories
@@ -1220,12 +1820,12 @@ Tensor OneDnnBackend::matmul(
   auto dstMemDesc = dstMemArgDesc;
   // For such cases, keep output as a vector instead of 2d matrix,
   // but the matmul primitive requries the 2d dims, thus dstMemArgDesc.
-  if (isLhsScalarOrVector || isRhsScalarOrVector) {
+  if ((isLhsScalarOrVector || isRhsScalarOrVector) && ndim == 2) {
     const auto elems = dstShape.elements();
     dstMemDesc = dstMemArgDesc.reshape({elems});
     dstShape = {elems};
   }
-  auto dstMem = dnnl::memory(dstMemDesc, engine_);
+  auto [dstMem, dstBuffer] = createMemory(dstMemDesc, engine_);
 
   // NOTE since our physical representation is a transpose of the logical
   // representation, we must switch lhs/rhs during matmul. i.e.,
@@ -1240,9 +1840,17 @@ Tensor OneDnnBackend::matmul(
   auto& weightsMem = lhsMem;
 
   // prepare primitive
-  const auto matmulPrimitiveDesc = dnnl::matmul::primitive_desc(
-      engine_, srcMemDesc, weightsMemDesc, dstMemArgDesc);
-  const auto matmulPrimitive = dnnl::matmul(matmulPrimitiveDesc);
+  const auto key = detail::PrimitiveCacheKeyBuilder()
+                       .add(engine_)
+                       .add(dnnl::primitive::kind::matmul)
+                       .add(srcMemDesc)
+                       .add(weightsMemDesc)
+                       .add(dstMemArgDesc)
+                       .build();
+  const auto matmulPrimitive = primitiveCache_.getOrCreate(key, [&]() {
+    return dnnl::matmul(dnnl::matmul::primitive_desc(
+        engine_, srcMemDesc, weightsMemDesc, dstMemArgDesc));
+  });
 
   // prepare arguments.
   const std::unordered_map<int, dnnl::memory> args = {
@@ -1252,8 +1860,9 @@ Tensor OneDnnBackend::matmul(
   };
 
   // execute primitive
-  matmulPrimitive.execute(stream_->handle(), args);
-  return toTensor<OneDnnTensor>(dstShape, std::move(dstMem));
+  stream_->execute(matmulPrimitive, args);
+  return toTensor<OneDnnTensor>(
+      dstShape, std::move(dstMem), std::move(dstBuffer));
 }
 
 /************************** Reductions ***************************/
@@ -1274,164 +1883,24 @@ Tensor OneDnnBackend::amax(
       input, dnnl::algorithm::reduction_max, axes, keepDims);
 }
 
-template <typename T, typename LessThan>
-void maxWithIndexCpu(
-    Tensor& values,
-    Tensor& indices,
-    const Shape& inputShape,
-    const std::vector<T>& inputData,
-    const unsigned axis,
-    const bool keepDims,
-    LessThan lt) {
-  const auto inputElemCount = inputShape.elements();
-  const auto axisSize = inputShape.dim(axis);
-  const unsigned axisStride = std::accumulate(
-      inputShape.get().begin(),
-      inputShape.get().begin() + axis,
-      1,
-      std::multiplies<>());
-  const auto resultElemCount = inputElemCount / axisSize;
-  std::vector<T> valuesData;
-  std::vector<int> indicesData;
-  valuesData.reserve(resultElemCount);
-  indicesData.reserve(resultElemCount);
-  // default to falses:
-  auto visited = std::make_unique<bool[]>(inputElemCount);
-  for (unsigned idx = 0; idx < inputElemCount; idx++) {
-    if (!visited[idx]) {
-      visited[idx] = true;
-      T maxVal = inputData[idx];
-      int maxAxisIdx = 0;
-      // search for max element & index along this unvisted axis
-      for (unsigned axisIdx = 1; axisIdx < axisSize; axisIdx++) {
-        int elemIdx = idx + axisIdx * axisStride;
-        assert(!visited[elemIdx]);
-        visited[elemIdx] = true;
-        T elemVal = inputData[elemIdx];
-        if (lt(maxVal, elemVal)) {
-          maxVal = elemVal;
-          maxAxisIdx = axisIdx;
-        }
-      }
-      valuesData.push_back(maxVal);
-      indicesData.push_back(maxAxisIdx);
-    }
-  }
-  // write data to output tensors
-  std::vector<Dim> outputDims = inputShape.get();
-  if (keepDims) {
-    outputDims[axis] = 1;
-  } else {
-    outputDims.erase(outputDims.begin() + axis);
-  }
-  auto valType = dtype_traits<T>::fl_type;
-  values = toTensor<OneDnnTensor>(
-      Shape(outputDims), valType, valuesData.data(), Location::Host);
-  indices = toTensor<OneDnnTensor>(
-      Shape(outputDims), dtype::s32, indicesData.data(), Location::Host);
-}
-
-template <typename LessThan>
-void maxWithIndexCpu(
-    Tensor& values,
-    Tensor& indices,
-    const Tensor& input,
-    const unsigned axis,
-    const bool keepDims,
-    LessThan lt) {
-  if (axis >= input.ndim()) {
-    std::ostringstream oss;
-    oss << "[OneDnnBackend::min] Axis too large: " << axis
-        << " for tensor of shape: " << input.shape();
-    throw std::invalid_argument(oss.str());
-  }
-  const Shape& inputShape = input.shape();
-  switch (input.type()) {
-    case dtype::f16:
-      throw std::runtime_error("[OneDnnTensor::min] doesn't support f16");
-    case dtype::f32: {
-      auto dataVec = input.toHostVector<float>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::f64: {
-      auto dataVec = input.toHostVector<double>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::b8: {
-      auto dataVec = input.toHostVector<char>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::s16: {
-      auto dataVec = input.toHostVector<short>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::s32: {
-      auto dataVec = input.toHostVector<int>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::s64: {
-      auto dataVec = input.toHostVector<long long>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::u8: {
-      auto dataVec = input.toHostVector<unsigned char>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::u16: {
-      auto dataVec = input.toHostVector<unsigned short>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::u32: {
-      auto dataVec = input.toHostVector<unsigned int>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-    case dtype::u64: {
-      auto dataVec = input.toHostVector<unsigned long long>();
-      maxWithIndexCpu(values, indices, inputShape, dataVec, axis, keepDims, lt);
-      return;
-    }
-  }
-}
-
-// TODO move this into a generic CPU backend
 void OneDnnBackend::min(
     Tensor& values,
     Tensor& indices,
     const Tensor& input,
     const unsigned axis,
     const bool keepDims) {
-  if (allHaveCpuEngines(values, indices, input)) {
-    return maxWithIndexCpu(
-        values, indices, input, axis, keepDims, std::greater<>());
-  } else {
-    throw std::runtime_error(
-        "[OneDnnBackend::min] unimplemented for non-CPU engine");
-  }
+  checkAxis("min", input, axis);
+  argBestCpu(&values, &indices, input, axis, keepDims, /* isMax = */ false);
 }
 
-// TODO move this into a generic CPU backend
 void OneDnnBackend::max(
     Tensor& values,
     Tensor& indices,
     const Tensor& input,
     const unsigned axis,
     const bool keepDims) {
-  if (allHaveCpuEngines(values, indices, input)) {
-    return maxWithIndexCpu(
-        values, indices, input, axis, keepDims, std::less<>());
-  } else {
-    throw std::runtime_error(
-        "[OneDnnBackend::min] unimplemented for non-CPU engine");
-  }
+  checkAxis("max", input, axis);
+  argBestCpu(&values, &indices, input, axis, keepDims, /* isMax = */ true);
 }
 
 Tensor OneDnnBackend::sum(
@@ -1442,24 +1911,41 @@ Tensor OneDnnBackend::sum(
       input, dnnl::algorithm::reduction_sum, axes, keepDims);
 }
 
-Tensor OneDnnBackend::cumsum(
-    const Tensor& /* input */,
-    const unsigned /* axis */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+Tensor OneDnnBackend::cumsum(const Tensor& input, const unsigned axis) {
+  checkAxis("cumsum", input, axis);
+  if (isHalfFloatType(input.type())) {
+    return cumsum(input.astype(dtype::f32), axis).astype(input.type());
+  }
+  const detail::AxisView view(input.shape(), axis);
+  return dispatchCpuType(input.type(), "cumsum", [&](auto tag) {
+    using T = decltype(tag);
+    // small integers accumulate in s32 to avoid overflow
+    using R = std::conditional_t<(sizeof(T) < sizeof(int)), int, T>;
+    CpuInput<T> in(input);
+    auto [output, outputData] = createCpuOutput<R>(input.shape());
+    detail::cumsumKernel(in.data(), outputData, view);
+    return std::move(output);
+  });
 }
 
 Tensor OneDnnBackend::argmax(
-    const Tensor& /* input */,
-    const unsigned /* axis */,
-    const bool /* keepDims */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const unsigned axis,
+    const bool keepDims) {
+  checkAxis("argmax", input, axis);
+  Tensor indices;
+  argBestCpu(nullptr, &indices, input, axis, keepDims, /* isMax = */ true);
+  return indices;
 }
 
 Tensor OneDnnBackend::argmin(
-    const Tensor& /* input */,
-    const unsigned /* axis */,
-    const bool /* keepDims */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const unsigned axis,
+    const bool keepDims) {
+  checkAxis("argmin", input, axis);
+  Tensor indices;
+  argBestCpu(nullptr, &indices, input, axis, keepDims, /* isMax = */ false);
+  return indices;
 }
 
 Tensor OneDnnBackend::mean(
@@ -1471,33 +1957,95 @@ Tensor OneDnnBackend::mean(
 }
 
 Tensor OneDnnBackend::median(
-    const Tensor& /* input */,
-    const std::vector<int>& /* axes */,
-    const bool /* keepDims */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const std::vector<int>& axes,
+    const bool keepDims) {
+  if (isHalfFloatType(input.type())) {
+    return median(input.astype(dtype::f32), axes, keepDims)
+        .astype(input.type());
+  }
+  const bool allAxes =
+      axes.empty() || static_cast<int>(axes.size()) == input.ndim();
+  if (!allAxes && axes.size() != 1) {
+    throw std::invalid_argument(
+        "[OneDnnBackend::median] only supports reducing a single axis or "
+        "all axes");
+  }
+  // reducing all axes is reducing the single axis of the flattened tensor
+  Tensor flatHolder;
+  if (allAxes) {
+    flatHolder = reshape(input, {input.elements()});
+  }
+  const auto& src = allAxes ? flatHolder : input;
+  const unsigned axis = allAxes ? 0 : axes.front();
+  checkAxis("median", src, axis);
+  if (src.dim(axis) == 0) {
+    throw std::invalid_argument(
+        "[OneDnnBackend::median] can't reduce an empty axis");
+  }
+  Tensor fpHolder;
+  const auto& srcFp = asFloatType(src, fpHolder);
+  Tensor result = dispatchCpuType(srcFp.type(), "median", [&](auto tag) {
+    using T = decltype(tag);
+    CpuInput<T> in(srcFp);
+    auto [output, outputData] =
+        createCpuOutput<T>(reduceAxis(srcFp.shape(), axis, keepDims));
+    detail::medianKernel(
+        in.data(), outputData, detail::AxisView(srcFp.shape(), axis));
+    return std::move(output);
+  });
+  if (allAxes) {
+    const std::vector<Dim> dstDims(keepDims ? input.ndim() : 0, 1);
+    return reshape(result, Shape(dstDims));
+  }
+  return result;
 }
 
 Tensor OneDnnBackend::var(
-    const Tensor& /* input */,
-    const std::vector<int>& /* axes */,
-    const bool /* bias */,
-    const bool /* keepDims */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const std::vector<int>& axes,
+    const bool bias,
+    const bool keepDims) {
+  Tensor fpHolder;
+  const auto& src = asFloatType(input, fpHolder);
+  Dim count = 1;
+  if (axes.empty()) {
+    count = src.elements();
+  } else {
+    for (const int axis : axes) {
+      checkAxis("var", src, axis);
+      count *= src.dim(axis);
+    }
+  }
+  const auto centered = src - mean(src, axes, /* keepDims = */ true);
+  const auto sumSquares = sum(centered * centered, axes, keepDims);
+  return sumSquares / static_cast<double>(bias ? count - 1 : count);
 }
 
 Tensor OneDnnBackend::std(
-    const Tensor& /* input */,
-    const std::vector<int>& /* axes */,
-    const bool /* keepDims */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const std::vector<int>& axes,
+    const bool keepDims) {
+  return sqrt(var(input, axes, /* bias = */ false, keepDims));
 }
 
 Tensor OneDnnBackend::norm(
-    const Tensor& /* input */,
-    const std::vector<int>& /* axes */,
-    double /* p */ /* = 2 */,
-    const bool /* keepDims */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const std::vector<int>& axes,
+    double p /* = 2 */,
+    const bool keepDims) {
+  Tensor fpHolder;
+  const auto& src = asFloatType(input, fpHolder);
+  if (p == std::numeric_limits<double>::infinity()) {
+    return amax(absolute(src), axes, keepDims);
+  }
+  if (p == 1) {
+    return sum(absolute(src), axes, keepDims);
+  }
+  if (p == 2) {
+    return sqrt(sum(src * src, axes, keepDims));
+  }
+  return power(sum(power(absolute(src), p), axes, keepDims), 1 / p);
 }
 
 Tensor OneDnnBackend::countNonzero(
@@ -1520,10 +2068,10 @@ Tensor OneDnnBackend::any(
 }
 
 Tensor OneDnnBackend::all(
-    const Tensor& /* input */,
-    const std::vector<int>& /* axes */,
-    const bool /* keepDims */) {
-  FL_ONEDNN_BACKEND_UNIMPLEMENTED;
+    const Tensor& input,
+    const std::vector<int>& axes,
+    const bool keepDims) {
+  return countNonzero(input == 0, axes, keepDims) == 0;
 }
 
 Tensor OneDnnBackend::applyReductionOp(
@@ -1562,9 +2110,17 @@ Tensor OneDnnBackend::applyReductionOp(
       dstShape, srcMemDesc.get_data_type());
 
   // prepare reduction primitive
-  const auto reductionPrimitiveDesc = dnnl::reduction::primitive_desc(
-      engine_, alg, srcMemDesc, dstArgMemDesc, 0, 0);
-  const auto reductionPrimitive = dnnl::reduction(reductionPrimitiveDesc);
+  const auto key = detail::PrimitiveCacheKeyBuilder()
+                       .add(engine_)
+                       .add(dnnl::primitive::kind::reduction)
+                       .add(alg)
+                       .add(srcMemDesc)
+                       .add(dstArgMemDesc)
+                       .build();
+  const auto reductionPrimitive = primitiveCache_.getOrCreate(key, [&]() {
+    return dnnl::reduction(dnnl::reduction::primitive_desc(
+        engine_, alg, srcMemDesc, dstArgMemDesc, 0, 0));
+  });
 
   // prepare dst memories
   auto dstMemDesc = dstArgMemDesc;
@@ -1573,7 +2129,7 @@ Tensor OneDnnBackend::applyReductionOp(
     dstMemDesc = detail::oneDnnContiguousMemDescFromShape(
         dstShape, srcMemDesc.get_data_type());
   }
-  auto dstMem = dnnl::memory(dstMemDesc, engine_);
+  auto [dstMem, dstBuffer] = createMemory(dstMemDesc, engine_);
 
   // prepare arguments.
   const std::unordered_map<int, dnnl::memory> args = {
@@ -1582,8 +2138,9 @@ Tensor OneDnnBackend::applyReductionOp(
   };
 
   // execute primitive
-  reductionPrimitive.execute(stream_->handle(), args);
-  return toTensor<OneDnnTensor>(dstShape, std::move(dstMem));
+  stream_->execute(reductionPrimitive, args);
+  return toTensor<OneDnnTensor>(
+      dstShape, std::move(dstMem), std::move(dstBuffer));
 }
 
 void OneDnnBackend::print(const Tensor& tensor) {
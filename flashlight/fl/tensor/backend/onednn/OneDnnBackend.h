@@ -11,8 +11,11 @@
 
 #include <memory>
 #include <optional>
+#include <utility>
 
 #include "flashlight/fl/tensor/backend/onednn/OneDnnCPUStream.h"
+#include "flashlight/fl/tensor/backend/onednn/PrimitiveCache.h"
+#include "flashlight/fl/tensor/backend/onednn/mem/HostMemoryManager.h"
 
 #if FL_USE_MKL_RNG
   #include <mkl_vsl.h>
@@ -28,6 +31,8 @@ namespace fl {
 class OneDnnBackend : public TensorBackend {
   dnnl::engine engine_;
   std::shared_ptr<OneDnnCPUStream> stream_;
+  std::shared_ptr<HostMemoryManager> memoryManager_;
+  detail::PrimitiveCache primitiveCache_;
 #if FL_USE_MKL_RNG
   VSLStreamStatePtr randStream_;
 #else
@@ -89,6 +94,14 @@ class OneDnnBackend : public TensorBackend {
    */
   dnnl::stream& nativeStream() const;
 
+  /**
+   * Gets the active OneDNN CPU stream, e.g., to execute primitives on it or
+   * configure asynchronous execution.
+   *
+   * @return the active OneDNN CPU stream.
+   */
+  OneDnnCPUStream& cpuStream() const;
+
   /**
    * Gets the active OneDNN engine.
    *
@@ -103,6 +116,42 @@ class OneDnnBackend : public TensorBackend {
    */
   const dnnl::engine& cpuEngine() const;
 
+  /**
+   * Gets the cache of primitives used by ops, e.g., to configure its capacity
+   * or inspect hit/miss counts.
+   *
+   * @return the primitive cache.
+   */
+  detail::PrimitiveCache& primitiveCache();
+
+  /**
+   * Gets the manager of host memory backing tensors on CPU engines.
+   *
+   * @return the host memory manager.
+   */
+  HostMemoryManager& memoryManager() const;
+
+  /**
+   * Sets the manager of host memory backing tensors created from now on.
+   * Existing tensors keep (and return their memory to) their own manager.
+   *
+   * @param[in] manager the new host memory manager.
+   */
+  void setMemoryManager(std::shared_ptr<HostMemoryManager> manager);
+
+  /**
+   * Creates memory for the given descriptor on the given engine. The buffer
+   * of memory on CPU engines comes from the host memory manager.
+   *
+   * @param[in] desc the descriptor of the memory.
+   * @param[in] engine the engine of the memory.
+   * @return the memory, and the owner of its buffer (null if allocated by
+   * OneDNN) which must outlive all uses of the memory.
+   */
+  std::pair<dnnl::memory, std::shared_ptr<void>> createMemory(
+      const dnnl::memory::desc& desc,
+      const dnnl::engine& engine) const;
+
   /* -------------------------- Compute Functions -------------------------- */
   void eval(const Tensor& tensor) override;
   bool supportsDataType(const fl::dtype& dtype) const override;
@@ -11,7 +11,40 @@
 
 namespace fl {
 
-OneDnnCPUStream::OneDnnCPUStream(const dnnl::engine& engine) {
+namespace detail {
+
+bool isReadOnlyArg(const int arg) {
+  // post-op args are DNNL_ARG_ATTR_MULTIPLE_POST_OP(idx) | <arg>, i.e.,
+  // multiples of the base (not just the base bit) for idx > 0
+  if (arg >= DNNL_ARG_ATTR_MULTIPLE_POST_OP_BASE &&
+      arg < DNNL_ARG_ATTR_MULTIPLE_POST_OP(DNNL_MAX_POST_OPS)) {
+    return true; // inputs of post-ops
+  }
+  if (arg >= DNNL_ARG_MULTIPLE_SRC && arg < DNNL_ARG_MULTIPLE_DST) {
+    return true;
+  }
+  switch (arg) {
+    case DNNL_ARG_SRC_0:
+    case DNNL_ARG_SRC_1:
+    case DNNL_ARG_SRC_2:
+    case DNNL_ARG_WEIGHTS_0:
+    case DNNL_ARG_WEIGHTS_1:
+    case DNNL_ARG_BIAS:
+    case DNNL_ARG_SCALE:
+    case DNNL_ARG_SHIFT:
+    case DNNL_ARG_DIFF_DST_0:
+    case DNNL_ARG_DIFF_DST_1:
+    case DNNL_ARG_DIFF_DST_2:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace detail
+
+OneDnnCPUStream::OneDnnCPUStream(const dnnl::engine& engine)
+    : engine_(engine) {
   stream_ = std::make_unique<dnnl::stream>(engine);
 }
 
@@ -27,9 +60,87 @@ std::shared_ptr<OneDnnCPUStream> OneDnnCPUStream::create(
 }
 
 void OneDnnCPUStream::sync() const {
+  if (taskQueue_) {
+    taskQueue_->waitAll();
+  }
   stream_->wait();
 }
 
+void OneDnnCPUStream::syncData(const void* buffer) const {
+  if (taskQueue_) {
+    taskQueue_->waitFor(buffer);
+  } else {
+    stream_->wait();
+  }
+}
+
+void OneDnnCPUStream::releaseData(const void* buffer) const {
+  if (taskQueue_) {
+    taskQueue_->release(buffer);
+  } else {
+    stream_->wait();
+  }
+}
+
+void OneDnnCPUStream::execute(
+    const dnnl::primitive& primitive,
+    const std::unordered_map<int, dnnl::memory>& args) {
+  if (!taskQueue_) {
+    primitive.execute(*stream_, args);
+    return;
+  }
+  std::vector<const void*> reads;
+  std::vector<const void*> writes;
+  for (const auto& [arg, memory] : args) {
+    auto& buffers = detail::isReadOnlyArg(arg) ? reads : writes;
+    buffers.push_back(memory.get_data_handle());
+  }
+  // NOTE the task only holds handles of the memories, buffers are kept alive
+  // by their owners until they're synced
+  taskQueue_->submit(
+      [this, primitive, args](unsigned workerId) {
+        auto& stream = workerStreams_[workerId];
+        primitive.execute(stream, args);
+        stream.wait();
+      },
+      reads,
+      writes);
+}
+
+void OneDnnCPUStream::setNumWorkers(unsigned numWorkers) {
+  if (!supportsConcurrentExecution()) {
+    numWorkers = 0;
+  }
+  if (numWorkers == this->numWorkers()) {
+    return;
+  }
+  sync();
+  taskQueue_.reset();
+  workerStreams_.clear();
+  if (numWorkers > 0) {
+    for (unsigned i = 0; i < numWorkers; i++) {
+      workerStreams_.emplace_back(engine_);
+    }
+    taskQueue_ = std::make_unique<detail::CpuTaskQueue>(numWorkers);
+  }
+}
+
+unsigned OneDnnCPUStream::numWorkers() const {
+  return taskQueue_ ? taskQueue_->numWorkers() : 0;
+}
+
+bool OneDnnCPUStream::isAsync() const {
+  return taskQueue_ != nullptr;
+}
+
+bool OneDnnCPUStream::supportsConcurrentExecution() {
+#if FL_ONEDNN_CONCURRENT_EXEC
+  return true;
+#else
+  return false;
+#endif // FL_ONEDNN_CONCURRENT_EXEC
+}
+
 dnnl::stream& OneDnnCPUStream::handle() {
   return *stream_;
 }
@@ -8,18 +8,50 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "flashlight/fl/runtime/SynchronousStream.h"
+#include "flashlight/fl/tensor/backend/onednn/CpuTaskQueue.h"
 
 #include <dnnl.hpp>
 
 namespace fl {
+namespace detail {
+
+/**
+ * Whether a primitive only reads the given argument, otherwise it's
+ * (conservatively) assumed to be written, e.g., destinations, workspaces and
+ * training stats.
+ *
+ * @param[in] arg the argument index, e.g., `DNNL_ARG_SRC`.
+ * @return whether the argument is read-only.
+ */
+bool isReadOnlyArg(int arg);
+
+} // namespace detail
 
 /**
  * An abstraction for OneDNN's CPU Stream with controlled creation methods.
+ *
+ * By default, primitives are executed in order on the calling thread. In
+ * asynchronous mode (see `setNumWorkers`), primitives are queued and executed
+ * out of order on a pool of workers as soon as the primitives producing their
+ * inputs (or still using their outputs) finished, so independent primitives
+ * overlap. Either way, `sync` blocks until all submitted work finished, and
+ * `syncData` until the work using a given buffer finished.
+ *
+ * Asynchronous mode requires oneDNN to be built with concurrent execution
+ * support (`ONEDNN_ENABLE_CONCURRENT_EXEC`, then configure Flashlight with
+ * `FL_ONEDNN_CONCURRENT_EXEC`): otherwise all executions of a primitive share
+ * one scratchpad, so primitives can't safely run on several workers at once.
  */
 class OneDnnCPUStream : public SynchronousStream {
   std::unique_ptr<dnnl::stream> stream_; // stored as a pointer to satisfy `sync() const`
+  dnnl::engine engine_;
+  // set iff in asynchronous mode, with one native stream per worker
+  std::unique_ptr<detail::CpuTaskQueue> taskQueue_;
+  std::vector<dnnl::stream> workerStreams_;
 
   // internal constructor used to create the native OneDNN stream.
   explicit OneDnnCPUStream(const dnnl::engine& engine);
@@ -38,7 +70,69 @@ class OneDnnCPUStream : public SynchronousStream {
   void sync() const override;
 
   /**
-   * Gets the underlying OneDNN stream.
+   * Blocks until submitted primitives that read or write the given buffer
+   * finished.
+   *
+   * @param[in] buffer the data handle of a memory.
+   * @throws the error of the primitive that failed to produce the buffer (or
+   * one of its inputs) in asynchronous mode, if any.
+   */
+  void syncData(const void* buffer) const;
+
+  /**
+   * Like `syncData`, but never throws and forgets about failures to produce
+   * the buffer, so it can be freed and its address reused.
+   *
+   * @param[in] buffer the data handle of a memory.
+   */
+  void releaseData(const void* buffer) const;
+
+  /**
+   * Executes (or, in asynchronous mode, submits) a primitive with the given
+   * arguments. In asynchronous mode, the buffers of the argument memories must
+   * stay alive until `syncData` on them returns.
+   *
+   * @param[in] primitive the primitive to execute.
+   * @param[in] args the arguments of the primitive.
+   */
+  void execute(
+      const dnnl::primitive& primitive,
+      const std::unordered_map<int, dnnl::memory>& args);
+
+  /**
+   * Switches to asynchronous mode with the given # of workers, or back to
+   * in-order execution on the calling thread if 0 or if
+   * `supportsConcurrentExecution()` is false. Submitted work is finished
+   * first. Must not be called concurrently with other uses of the stream.
+   *
+   * Each worker runs primitives with OneDNN's own threading, so the product of
+   * workers and OneDNN threads (e.g., `OMP_NUM_THREADS`) should not exceed the
+   * # of cores.
+   *
+   * @param[in] numWorkers the # of workers.
+   */
+  void setNumWorkers(unsigned numWorkers);
+
+  /**
+   * @return the # of workers, 0 if not in asynchronous mode.
+   */
+  unsigned numWorkers() const;
+
+  /**
+   * @return whether primitives are executed asynchronously.
+   */
+  bool isAsync() const;
+
+  /**
+   * @return whether primitives can run concurrently, i.e., whether
+   * asynchronous mode is available.
+   */
+  static bool supportsConcurrentExecution();
+
+  /**
+   * Gets the underlying OneDNN stream. Primitives executed on it directly
+   * bypass asynchronous execution, so their inputs and outputs must be synced
+   * first.
    *
    * @return the underlying OneDNN stream.
    */
@@ -14,6 +14,7 @@
 #include <numeric>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
 
 #include "flashlight/fl/tensor/Index.h"
 #include "flashlight/fl/tensor/Shape.h"
@@ -124,9 +125,32 @@ OneDnnTensor::OneDnnTensor(
     const dnnl::memory::desc& memDesc)
     : sharedData_(std::move(sharedData)), shape_(shape), memDesc_(memDesc) {}
 
+void OneDnnTensor::ensurePlainLayout() const {
+  if (sharedData_->hasPlainLayout) {
+    return;
+  }
+  // NOTE all shallow copies see the reordered memory, and the opaque memory is
+  // released once the reorder is done with it.
+  auto& srcMem = sharedData_->memory;
+  const auto engine = srcMem.get_engine();
+  auto [dstMem, dstBuffer] = backend().createMemory(memDesc_, engine);
+  const auto reorderPrimitiveDesc = dnnl::reorder::primitive_desc(
+      engine, srcMem.get_desc(), engine, memDesc_);
+  backend().cpuStream().execute(
+      dnnl::reorder(reorderPrimitiveDesc),
+      {{DNNL_ARG_FROM, srcMem}, {DNNL_ARG_TO, dstMem}});
+  sharedData_->memory = std::move(dstMem);
+  sharedData_->buffer = std::move(dstBuffer);
+  sharedData_->hasPlainLayout = true;
+}
+
 void* OneDnnTensor::getOrEvalDataHandle() {
-  if (!sharedData_->isDataReady) {
-    stream().sync();
+  ensurePlainLayout();
+  auto& cpuStream = backend().cpuStream();
+  // asynchronous streams don't flag data as not ready when queueing primitives
+  // that use it, so always check for them
+  if (!sharedData_->isDataReady || cpuStream.isAsync()) {
+    cpuStream.syncData(sharedData_->memory.get_data_handle());
     sharedData_->isDataReady = true;
   }
   return sharedData_->memory.get_data_handle();
@@ -142,10 +166,16 @@ unsigned OneDnnTensor::getSizeInBytes() const {
   return numElems * typeSize;
 }
 
-OneDnnTensor::OneDnnTensor(const Shape& shape, dnnl::memory&& memory) {
+OneDnnTensor::OneDnnTensor(
+    const Shape& shape,
+    dnnl::memory&& memory,
+    std::shared_ptr<void> buffer) {
   sharedData_ = std::make_shared<SharedData>();
   shape_ = shape;
-  memDesc_ = memory.get_desc();
+  memDesc_ = detail::oneDnnContiguousMemDescFromShape(
+      shape, memory.get_desc().get_data_type());
+  sharedData_->hasPlainLayout = memory.get_desc() == memDesc_;
+  sharedData_->buffer = std::move(buffer);
   sharedData_->memory = std::move(memory);
 }
 
@@ -166,7 +196,8 @@ OneDnnTensor::OneDnnTensor(
   memDesc_ = detail::oneDnnContiguousMemDescFromShape(
       shape, detail::flToOneDnnType(type));
   sharedData_ = std::make_shared<SharedData>();
-  sharedData_->memory = dnnl::memory(memDesc_, backend().engine());
+  std::tie(sharedData_->memory, sharedData_->buffer) =
+      backend().createMemory(memDesc_, backend().engine());
   const auto numDataBytes = shape.elements() * fl::getTypeSize(type);
   // NOTE, once we support CL, we can take ownership directly for device ptr.
   if (ptr != nullptr) {
@@ -187,13 +218,14 @@ OneDnnTensor::OneDnnTensor(
 
 std::unique_ptr<TensorAdapterBase> OneDnnTensor::clone() const {
   // TODO copy on write if this is not a view
+  ensurePlainLayout();
   auto& srcMem = sharedData_->memory;
   const auto& srcMemDesc = memoryDesc();
   const auto type = srcMemDesc.get_data_type();
   const auto dstMemDesc =
       detail::oneDnnContiguousMemDescFromShape(shape_, type);
   const auto engine = sharedData_->memory.get_engine();
-  auto dstMem = dnnl::memory(dstMemDesc, engine);
+  auto [dstMem, dstBuffer] = backend().createMemory(dstMemDesc, engine);
 
   // prepare primitive
   // (using reorder in a passthrough sense to generate a new buffer)
@@ -202,8 +234,10 @@ std::unique_ptr<TensorAdapterBase> OneDnnTensor::clone() const {
   const auto reorderPrimitive = dnnl::reorder(reorderPrimitiveDesc);
 
   // execute primitive
-  reorderPrimitive.execute(backend().nativeStream(), srcMem, dstMem);
-  return std::make_unique<OneDnnTensor>(shape_, std::move(dstMem));
+  backend().cpuStream().execute(
+      reorderPrimitive, {{DNNL_ARG_FROM, srcMem}, {DNNL_ARG_TO, dstMem}});
+  return std::make_unique<OneDnnTensor>(
+      shape_, std::move(dstMem), std::move(dstBuffer));
 }
 
 Tensor OneDnnTensor::copy() {
@@ -265,14 +299,15 @@ void OneDnnTensor::scalar(void* out) {
       srcMem.get_engine(), srcScalarMemDesc, cpuEngine, dstMemDesc);
   const auto reorderPrimitive = dnnl::reorder(reorderPrimitiveDesc);
 
-  // execute primitive
+  // execute primitive, once the data is ready since `out` isn't tracked
+  backend().cpuStream().syncData(srcMem.get_data_handle());
   auto& stream = backend().nativeStream();
   reorderPrimitive.execute(stream, srcMem, dstMem);
   stream.wait();
 }
 
 void OneDnnTensor::device(void** out) {
-  *out = sharedData_->memory.get_data_handle();
+  *out = getOrEvalDataHandle();
   sharedData_->isDevicePtrLocked = true;
 }
 
@@ -285,6 +320,7 @@ void OneDnnTensor::host(void* out) {
     // despite the "tranposed" internal representation, the physical data are
     // the same
     const auto& mem = memory();
+    backend().cpuStream().syncData(mem.get_data_handle());
     void* mappedData = mem.map_data();
     std::memcpy(out, mappedData, getSizeInBytes());
     mem.unmap_data(mappedData);
@@ -332,12 +368,12 @@ const Stream& OneDnnTensor::stream() const {
 
 Tensor OneDnnTensor::astype(const dtype type) {
   // prepare memories
-  auto& srcMem = sharedData_->memory;
+  auto& srcMem = memory();
   const auto engine = srcMem.get_engine();
   const auto& srcMemDesc = memoryDesc();
   const auto dstMemDesc = detail::oneDnnContiguousMemDescFromShape(
       shape(), detail::flToOneDnnType(type));
-  auto dstMem = dnnl::memory(dstMemDesc, engine);
+  auto [dstMem, dstBuffer] = backend().createMemory(dstMemDesc, engine);
 
   // prepare primitive
   const auto reorderPrimitiveDesc =
@@ -345,8 +381,10 @@ Tensor OneDnnTensor::astype(const dtype type) {
   const auto reorderPrimitive = dnnl::reorder(reorderPrimitiveDesc);
 
   // execute primitive
-  reorderPrimitive.execute(backend().nativeStream(), srcMem, dstMem);
-  return toTensor<OneDnnTensor>(shape(), std::move(dstMem));
+  backend().cpuStream().execute(
+      reorderPrimitive, {{DNNL_ARG_FROM, srcMem}, {DNNL_ARG_TO, dstMem}});
+  return toTensor<OneDnnTensor>(
+      shape(), std::move(dstMem), std::move(dstBuffer));
 }
 
 Tensor OneDnnTensor::index(const std::vector<Index>& indices) {
@@ -359,6 +397,8 @@ Tensor OneDnnTensor::index(const std::vector<Index>& indices) {
         << " for tensor of ndim = " << shape.ndim();
     throw std::invalid_argument(oss.str());
   }
+  // views share the memory, which must be in plain layout to be indexed
+  ensurePlainLayout();
   // by default, assume all indices are spans
   // recall that shape and dims are in reversed order
   dnnl::memory::dims dims(shape.get().rbegin(), shape.get().rend());
@@ -555,6 +595,11 @@ std::string dataToString(const void* data, const Shape& shape) {
 }
 
 std::string OneDnnTensor::toString() {
+  if (type() == fl::dtype::f16 || type() == fl::dtype::bf16) {
+    // no native host type to print with
+    const auto tensorF32 = astype(fl::dtype::f32);
+    return toOneDnnTensor(tensorF32).toString();
+  }
   // TODO lift this up into a util method: Tensor -> std::string
   std::vector<char> vec(getSizeInBytes());
   void* data = vec.data();
@@ -562,7 +607,8 @@ std::string OneDnnTensor::toString() {
   const auto& shape = this->shape();
   switch (type()) {
     case fl::dtype::f16:
-      throw std::runtime_error("OneDnnTensor::toString doesn't support f16");
+    case fl::dtype::bf16:
+      break; // handled above
     case fl::dtype::f32:
       return dataToString<float>(data, shape);
     case fl::dtype::f64:
@@ -584,6 +630,7 @@ std::string OneDnnTensor::toString() {
     case fl::dtype::u64:
       return dataToString<unsigned long long>(data, shape);
   }
+  throw std::runtime_error("OneDnnTensor::toString - unexpected type");
 }
 
 std::ostream& OneDnnTensor::operator<<(std::ostream& ostr) {
@@ -646,7 +693,8 @@ void OneDnnTensor::assign(const Tensor& tensor) {
   const auto reorderPrimitive = dnnl::reorder(reorderPrimitiveDesc);
 
   // execute primitive
-  reorderPrimitive.execute(backend().nativeStream(), otherMem, thisMem);
+  backend().cpuStream().execute(
+      reorderPrimitive, {{DNNL_ARG_FROM, otherMem}, {DNNL_ARG_TO, thisMem}});
   this->sharedData_->isDataReady = false;
 }
 
@@ -677,9 +725,23 @@ bool OneDnnTensor::equals(OneDnnTensor&& other) {
 }
 
 dnnl::memory& OneDnnTensor::memory() {
+  ensurePlainLayout();
+  return sharedData_->memory;
+}
+
+dnnl::memory& OneDnnTensor::memoryAnyLayout() {
   return sharedData_->memory;
 }
 
+dnnl::memory::desc OneDnnTensor::memoryDescAnyLayout() const {
+  return sharedData_->hasPlainLayout ? memDesc_
+                                     : sharedData_->memory.get_desc();
+}
+
+bool OneDnnTensor::hasPlainLayout() const {
+  return sharedData_->hasPlainLayout;
+}
+
 const dnnl::memory::desc& OneDnnTensor::memoryDesc() const {
   return memDesc_;
 }
@@ -49,7 +49,16 @@ class OneDnnTensor : public TensorAdapterBase {
      *       [[1, 2, 3],
      *        [4, 5, 6]]
      */
+    // Owns the buffer of `memory` if it came from the backend's host memory
+    // manager (null if allocated by OneDNN). Declared first so it outlives
+    // `memory`.
+    std::shared_ptr<void> buffer;
     dnnl::memory memory;
+    // Whether `memory` has the layout above. If not, it's in an opaque (e.g.,
+    // blocked) layout picked by a OneDNN primitive, which other primitives
+    // can consume as is; it's reordered to the layout above upon the first
+    // use that needs it.
+    bool hasPlainLayout{true};
     // Whether the data in `memory` is ready (its computation finished).
     bool isDataReady{false};
     bool isDevicePtrLocked{false};
@@ -60,10 +69,15 @@ class OneDnnTensor : public TensorAdapterBase {
   // shared among tensors that are shallow copied
   std::shared_ptr<SharedData> sharedData_;
   Shape shape_;
+  // always describes the plain layout, even if `sharedData_->memory` doesn't
+  // have it yet.
   dnnl::memory::desc memDesc_;
 
-  // Return the underlying data handle in `memory`.
-  // If `isDataReady` is false, sync and set it to true.
+  // Reorder the shared memory to plain layout if it isn't already.
+  void ensurePlainLayout() const;
+
+  // Return the underlying data handle in `memory`, once primitives using it
+  // finished. If `isDataReady` is false, sync and set it to true.
   void* getOrEvalDataHandle();
 
   // Trigger computation to convert to contiguous tensor if needed, block until
@@ -95,9 +109,15 @@ class OneDnnTensor : public TensorAdapterBase {
    * Construct an OneDNNTensor with given shape and memory.
    *
    * @param[in] shape the shape of the new tensor
-   * @param[in] memory the memory handle containing underlying tensor data
+   * @param[in] memory the memory handle containing underlying tensor data, in
+   * plain layout or any layout picked by a OneDNN primitive
+   * @param[in] buffer owner of the buffer of `memory`, if it isn't allocated
+   * by OneDNN (see `OneDnnBackend::createMemory`)
    */
-  OneDnnTensor(const Shape& shape, dnnl::memory&& memory);
+  OneDnnTensor(
+      const Shape& shape,
+      dnnl::memory&& memory,
+      std::shared_ptr<void> buffer = nullptr);
 
   /**
    * Construct an empty OneDNNTensor.
@@ -190,13 +210,33 @@ class OneDnnTensor : public TensorAdapterBase {
   bool equals(OneDnnTensor&& other);
 
   /**
-   * Get the underlying OneDNN memory handle.
+   * Get the underlying OneDNN memory handle, in plain layout.
    * NOTE not const-correct to conform with OneDNN primitive execution API.
    *
    * @return a reference to the underlying OneDNN memory handle.
    */
   dnnl::memory& memory();
 
+  /**
+   * Get the underlying OneDNN memory handle in whatever layout it has, i.e.,
+   * without reordering it to plain layout. For OneDNN primitives that accept
+   * any layout (as described by `memoryDescAnyLayout`).
+   *
+   * @return a reference to the underlying OneDNN memory handle.
+   */
+  dnnl::memory& memoryAnyLayout();
+
+  /**
+   * @return the memory descriptor for `memoryAnyLayout`.
+   */
+  dnnl::memory::desc memoryDescAnyLayout() const;
+
+  /**
+   * @return true if the underlying memory is in plain layout, i.e., using it
+   * requires no reorder.
+   */
+  bool hasPlainLayout() const;
+
   /**
    * Get the current OneDNN memory descriptor (which may be a view) for this
    * tensor. Guaranteed to have same data type as original memory desc.
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/onednn/PrimitiveCache.h"
+
+#include <cstdint>
+#include <ios>
+#include <stdexcept>
+
+namespace fl {
+namespace detail {
+
+namespace {
+
+template <typename T>
+void appendDims(std::ostringstream& oss, const T& dims) {
+  oss << '[';
+  for (const auto dim : dims) {
+    oss << dim << ',';
+  }
+  oss << ']';
+}
+
+} // namespace
+
+PrimitiveCacheKeyBuilder& PrimitiveCacheKeyBuilder::add(
+    const dnnl::engine& engine) {
+  oss_ << "engine:" << reinterpret_cast<std::uintptr_t>(engine.get()) << ';';
+  return *this;
+}
+
+PrimitiveCacheKeyBuilder& PrimitiveCacheKeyBuilder::add(
+    const dnnl::memory::desc& desc) {
+  oss_ << "md:" << static_cast<int>(desc.get_data_type());
+  appendDims(oss_, desc.get_dims());
+  appendDims(oss_, desc.get_padded_dims());
+  appendDims(oss_, desc.get_padded_offsets());
+  oss_ << desc.get_submemory_offset() << ':'
+       << static_cast<int>(desc.get_format_kind());
+  if (desc.get_format_kind() == dnnl::memory::format_kind::blocked) {
+    appendDims(oss_, desc.get_strides());
+    appendDims(oss_, desc.get_inner_blks());
+    appendDims(oss_, desc.get_inner_idxs());
+  }
+  oss_ << ';';
+  return *this;
+}
+
+PrimitiveCacheKeyBuilder& PrimitiveCacheKeyBuilder::add(
+    const dnnl::primitive_attr& attr) {
+  const auto postOps = attr.get_post_ops();
+  oss_ << "attr:" << static_cast<int>(attr.get_scratchpad_mode()) << ':'
+       << postOps.len();
+  for (int i = 0; i < postOps.len(); i++) {
+    const auto kind = postOps.kind(i);
+    oss_ << '|' << static_cast<int>(kind);
+    if (kind == dnnl::primitive::kind::eltwise) {
+      dnnl::algorithm alg;
+      float alpha;
+      float beta;
+      postOps.get_params_eltwise(i, alg, alpha, beta);
+      oss_ << ':' << static_cast<int>(alg) << ':' << std::hexfloat << alpha
+           << ':' << beta << std::defaultfloat;
+    } else if (kind == dnnl::primitive::kind::binary) {
+      dnnl::algorithm alg;
+      dnnl::memory::desc src1Desc;
+      postOps.get_params_binary(i, alg, src1Desc);
+      oss_ << ':' << static_cast<int>(alg) << ':';
+      add(src1Desc);
+    } else if (kind == dnnl::primitive::kind::sum) {
+      float scale;
+      postOps.get_params_sum(i, scale);
+      oss_ << ':' << std::hexfloat << scale << std::defaultfloat;
+    } else {
+      throw std::invalid_argument(
+          "[PrimitiveCacheKeyBuilder] unsupported post-op kind");
+    }
+  }
+  oss_ << ';';
+  return *this;
+}
+
+PrimitiveCacheKeyBuilder& PrimitiveCacheKeyBuilder::add(float value) {
+  // exact representation, so distinct values never share a key
+  oss_ << std::hexfloat << value << std::defaultfloat << ';';
+  return *this;
+}
+
+std::string PrimitiveCacheKeyBuilder::build() const {
+  return oss_.str();
+}
+
+PrimitiveCache::PrimitiveCache(size_t capacity) {
+  setCapacity(capacity);
+}
+
+dnnl::primitive PrimitiveCache::getOrCreate(
+    const std::string& key,
+    const std::function<dnnl::primitive()>& create) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_) {
+      if (auto* cached = cache_->get(key)) {
+        stats_.hits++;
+        return *cached;
+      }
+    }
+    stats_.misses++;
+  }
+  // create outside the lock, since it may take a while
+  auto primitive = create();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (cache_) {
+    cache_->put(key, std::make_unique<dnnl::primitive>(primitive));
+  }
+  return primitive;
+}
+
+void PrimitiveCache::setCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  // NOTE LRUCache requires a positive capacity
+  cache_ = capacity == 0
+      ? nullptr
+      : std::make_unique<LRUCache<std::string, dnnl::primitive>>(
+            static_cast<int>(capacity));
+}
+
+size_t PrimitiveCache::getCapacity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return capacity_;
+}
+
+PrimitiveCache::Stats PrimitiveCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void PrimitiveCache::resetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_ = Stats();
+}
+
+} // namespace detail
+} // namespace fl
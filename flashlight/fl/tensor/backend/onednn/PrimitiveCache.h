@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "flashlight/fl/distributed/LRUCache.h"
+
+#include <dnnl.hpp>
+
+namespace fl {
+namespace detail {
+
+/**
+ * Builds keys for `PrimitiveCache`, i.e., a serialization of everything a
+ * primitive descriptor depends on.
+ */
+class PrimitiveCacheKeyBuilder {
+  std::ostringstream oss_;
+
+ public:
+  PrimitiveCacheKeyBuilder& add(const dnnl::engine& engine);
+  PrimitiveCacheKeyBuilder& add(const dnnl::memory::desc& desc);
+  PrimitiveCacheKeyBuilder& add(const dnnl::primitive_attr& attr);
+  PrimitiveCacheKeyBuilder& add(float value);
+
+  // integers & enums (e.g., dnnl::algorithm)
+  template <typename T>
+  PrimitiveCacheKeyBuilder& add(T value) {
+    static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
+    oss_ << static_cast<long long>(value) << ';';
+    return *this;
+  }
+
+  std::string build() const;
+};
+
+/**
+ * A thread-safe LRU cache of OneDNN primitives. Creating a primitive descriptor
+ * and primitive is expensive relative to small ops (implementation dispatch,
+ * and JIT compilation of kernels not in OneDNN's own cache), so ops with the
+ * same key reuse the primitive.
+ */
+class PrimitiveCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  struct Stats {
+    size_t hits{0};
+    size_t misses{0};
+  };
+
+  explicit PrimitiveCache(size_t capacity = kDefaultCapacity);
+
+  /**
+   * Returns the primitive cached under `key`, or caches & returns the result of
+   * `create` if there's none.
+   *
+   * @param[in] key serialization of the primitive descriptor's arguments, see
+   * `PrimitiveCacheKeyBuilder`.
+   * @param[in] create creates the primitive on miss.
+   * @return the (possibly cached) primitive.
+   */
+  dnnl::primitive getOrCreate(
+      const std::string& key,
+      const std::function<dnnl::primitive()>& create);
+
+  /**
+   * Sets the max # of cached primitives, 0 disables caching. Drops all cached
+   * primitives.
+   */
+  void setCapacity(size_t capacity);
+  size_t getCapacity() const;
+
+  Stats getStats() const;
+  void resetStats();
+
+ private:
+  size_t capacity_;
+  std::unique_ptr<LRUCache<std::string, dnnl::primitive>> cache_;
+  Stats stats_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace detail
+} // namespace fl
@@ -9,6 +9,7 @@
 #include "flashlight/fl/tensor/backend/onednn/Utils.h"
 
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
 
 #include <dnnl_debug.h>
@@ -32,6 +33,7 @@ getFlashlightTypeToOnednnTypeMap() {
   static const std::unordered_map<fl::dtype, dnnl::memory::data_type>
       kFlashlightTypeToOneDnnType = {
           {fl::dtype::f16, dnnl::memory::data_type::f16},
+          {fl::dtype::bf16, dnnl::memory::data_type::bf16},
           {fl::dtype::f32, dnnl::memory::data_type::f32},
           {fl::dtype::f64, dnnl::memory::data_type::f64},
           {fl::dtype::b8, dnnl::memory::data_type::s8},
@@ -124,6 +126,12 @@ bool isIntType(dnnl::memory::data_type type) {
 dnnl::memory::data_type getTypeWithLargerRange(
     dnnl::memory::data_type t1,
     dnnl::memory::data_type t2) {
+  if (isFpType(t1) && isFpType(t2) && t1 != t2 &&
+      dnnl::memory::data_type_size(t1) == 2 &&
+      dnnl::memory::data_type_size(t2) == 2) {
+    // f16 & bf16 can't represent each other's range/precision
+    return dnnl::memory::data_type::f32;
+  }
   if ((isFpType(t1) && isFpType(t2)) || (isIntType(t1) && isIntType(t2))) {
     auto t1Size = dnnl::memory::data_type_size(t1);
     auto t2Size = dnnl::memory::data_type_size(t2);
@@ -142,4 +150,21 @@ dnnl::memory::desc oneDnnContiguousMemDescFromShape(
       /* allowEmpty */ true);
 }
 
+dnnl::memory::desc transposeInnerMatrix(const dnnl::memory::desc& memDesc) {
+  const auto ndims = memDesc.get_ndims();
+  if (ndims < 2) {
+    std::ostringstream oss;
+    oss << "[transposeInnerMatrix] expected ndims to be >= 2, got: " << ndims;
+    throw std::runtime_error(oss.str());
+  }
+  // recall that internal dims are reversed from the logical col-major dims
+  std::vector<int> transposeAxesPermutation;
+  for (int i = 0; i < ndims; i++) {
+    transposeAxesPermutation.push_back(i);
+  }
+  std::swap(
+      transposeAxesPermutation[ndims - 2], transposeAxesPermutation[ndims - 1]);
+  return memDesc.permute_axes(transposeAxesPermutation);
+}
+
 } // namespace fl
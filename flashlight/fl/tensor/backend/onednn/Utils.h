@@ -95,6 +95,15 @@ dnnl::memory::desc oneDnnContiguousMemDescFromShape(
     const Shape& shape,
     const dnnl::memory::data_type type);
 
+/**
+ * Swap the 2 innermost dims of the given memory descriptor, i.e., transpose
+ * the (logical) inner matrix without moving any data.
+ *
+ * @param[in] memDesc the memory descriptor with at least 2 dims.
+ * @return the transposed memory descriptor.
+ */
+dnnl::memory::desc transposeInnerMatrix(const dnnl::memory::desc& memDesc);
+
 /**
  * Return a copy of the given vector with items at given indices removed.
  *
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/onednn/mem/CachingHostMemoryManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace fl {
+
+namespace {
+
+constexpr size_t kMinBlockSize =
+    512; // all sizes are rounded to at least 512 bytes
+constexpr size_t kSmallSize = 1048576; // largest "small" allocation is 1 MiB
+constexpr size_t kSmallBuffer =
+    2097152; // "small" allocations are packed in 2 MiB blocks
+constexpr size_t kLargeBuffer =
+    20971520; // "large" allocations may be packed in 20 MiB blocks
+constexpr size_t kMinLargeAlloc =
+    10485760; // allocations between 1 and 10 MiB may use kLargeBuffer
+constexpr size_t kRoundLarge = 2097152; // round up large allocs to 2 MiB
+
+static_assert(
+    kMinBlockSize % HostMemoryManager::kAlignment == 0,
+    "splitting blocks must preserve alignment");
+
+// Environment variables names, specifying number of mega bytes as floats.
+constexpr const char* kMemRecyclingSize = "FL_ONEDNN_MEM_RECYCLING_SIZE_MB";
+constexpr const char* kMemSplitSize = "FL_ONEDNN_MEM_SPLIT_SIZE_MB";
+constexpr double kMB = static_cast<double>(1UL << 20);
+
+size_t roundSize(size_t size) {
+  if (size < kMinBlockSize) {
+    return kMinBlockSize;
+  } else {
+    return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
+  }
+}
+
+size_t getAllocationSize(size_t size) {
+  if (size <= kSmallSize) {
+    return kSmallBuffer;
+  } else if (size < kMinLargeAlloc) {
+    return kLargeBuffer;
+  } else {
+    return kRoundLarge * ((size + kRoundLarge - 1) / kRoundLarge);
+  }
+}
+
+bool BlockComparator(
+    const CachingHostMemoryManager::Block* a,
+    const CachingHostMemoryManager::Block* b) {
+  if (a->size_ != b->size_) {
+    return a->size_ < b->size_;
+  }
+  return (uintptr_t)a->ptr_ < (uintptr_t)b->ptr_;
+}
+
+std::string formatMemory(size_t bytes) {
+  const std::vector<std::string> units = {"B", "KiB", "MiB", "GiB", "TiB"};
+  size_t unitId =
+      bytes == 0 ? 0 : std::floor(std::log(bytes) / std::log(1024.0));
+  unitId = std::min(unitId, units.size() - 1);
+  std::string bytesStr = std::to_string(bytes / std::pow(1024.0, unitId));
+  bytesStr = bytesStr.substr(0, bytesStr.find('.') + 3);
+  return bytesStr + " " + units[unitId];
+}
+
+/**
+ * Returns number of bytes as represented by the named environment variable. The
+ * variable is interpreted as a float string specifying value in MBs. Returns
+ * defaultVal if the variable isn't set.
+ */
+size_t getEnvAsBytesFromFloatMb(const char* name, size_t defaultVal) {
+  const char* env = std::getenv(name);
+  if (env) {
+    try {
+      const double mb = std::stod(env);
+      return std::round(mb * kMB);
+    } catch (std::exception& ex) {
+      std::cerr << "getEnvAsBytesFromFloatMb: Invalid environment "
+                << "variable value: name=" << name << " value=" << env;
+      throw;
+    }
+  }
+  return defaultVal;
+}
+
+// e.g., "0-3" --> 4; falls back to 1 if unavailable
+int detectNumNumaNodes() {
+  std::ifstream possible("/sys/devices/system/node/possible");
+  std::string range;
+  if (!(possible >> range)) {
+    return 1;
+  }
+  const auto lastSep = range.find_last_of("-,");
+  try {
+    return std::stoi(
+               lastSep == std::string::npos ? range
+                                            : range.substr(lastSep + 1)) +
+        1;
+  } catch (const std::exception&) {
+    return 1;
+  }
+}
+
+unsigned getCurrentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return node;
+  }
+#endif
+  return 0;
+}
+
+void* nativeAlloc(size_t size) {
+  // NOTE `size` is a multiple of `kMinBlockSize`, as `aligned_alloc` requires
+  void* ptr = std::aligned_alloc(HostMemoryManager::kAlignment, size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+} // namespace
+
+CachingHostMemoryManager::NodeMemoryInfo::NodeMemoryInfo(int id)
+    : nodeId_(id),
+      largeBlocks_(BlockComparator),
+      smallBlocks_(BlockComparator) {}
+
+CachingHostMemoryManager::CachingHostMemoryManager(int numNodes) {
+  recyclingSizeLimit_ =
+      getEnvAsBytesFromFloatMb(kMemRecyclingSize, recyclingSizeLimit_);
+  splitSizeLimit_ = getEnvAsBytesFromFloatMb(kMemSplitSize, splitSizeLimit_);
+  if (numNodes < 0) {
+    numNodes = detectNumNumaNodes();
+  }
+  for (int i = 0; i < std::max(numNodes, 1); ++i) {
+    nodeMemInfos_.push_back(std::make_unique<NodeMemoryInfo>(i));
+  }
+}
+
+CachingHostMemoryManager::~CachingHostMemoryManager() {
+  signalMemoryCleanup();
+}
+
+void CachingHostMemoryManager::setRecyclingSizeLimit(size_t limit) {
+  recyclingSizeLimit_ = limit;
+}
+
+void CachingHostMemoryManager::setSplitSizeLimit(size_t limit) {
+  splitSizeLimit_ = limit;
+}
+
+CachingHostMemoryManager::NodeMemoryInfo&
+CachingHostMemoryManager::getCurrentNodeMemoryInfo() {
+  return *nodeMemInfos_[getCurrentNumaNode() % nodeMemInfos_.size()];
+}
+
+void* CachingHostMemoryManager::alloc(size_t bytes) {
+  if (bytes == 0) {
+    return nullptr;
+  }
+  auto& memInfo = getCurrentNodeMemoryInfo();
+  std::lock_guard<std::recursive_mutex> lock(memInfo.mutexAll_);
+  const size_t size = roundSize(bytes);
+  const bool isSmallAlloc = (size <= kSmallSize);
+  Block searchKey(size);
+  BlockSet& pool = isSmallAlloc ? memInfo.smallBlocks_ : memInfo.largeBlocks_;
+
+  Block* block = nullptr;
+  auto it = pool.lower_bound(&searchKey);
+  // Recycle blocks if any found, and if small alloc or the block size is not
+  // too large:
+  if (it != pool.end() &&
+      (isSmallAlloc || (*it)->size_ < recyclingSizeLimit_)) {
+    block = *it;
+    pool.erase(it);
+    memInfo.stats_.cachedBytes_ -= block->size_;
+  } else {
+    const size_t allocSize = getAllocationSize(size);
+    block = new Block(allocSize, mallocWithRetry(memInfo, allocSize));
+    memInfo.stats_.allocatedBytes_ += allocSize;
+  }
+
+  // Split off the remainder if it can serve another allocation from the same
+  // pool (we don't split small blocks out of large ones).
+  const size_t diff = block->size_ - size;
+  if ((diff >= (isSmallAlloc ? kMinBlockSize : kSmallSize)) &&
+      (block->size_ < splitSizeLimit_)) {
+    Block* remaining = block;
+    block = new Block(size, block->ptr_);
+    block->prev_ = remaining->prev_;
+    if (block->prev_) {
+      block->prev_->next_ = block;
+    }
+    block->next_ = remaining;
+
+    remaining->prev_ = block;
+    remaining->ptr_ = static_cast<char*>(remaining->ptr_) + size;
+    remaining->size_ -= size;
+    pool.insert(remaining);
+    memInfo.stats_.cachedBytes_ += remaining->size_;
+  }
+
+  block->inUse_ = true;
+  memInfo.allocatedBlocks_[block->ptr_] = block;
+  return block->ptr_;
+}
+
+void CachingHostMemoryManager::free(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  // usually released on the allocating node, so look there first
+  auto& currMemInfo = getCurrentNodeMemoryInfo();
+  if (tryFree(currMemInfo, ptr)) {
+    return;
+  }
+  for (auto& memInfo : nodeMemInfos_) {
+    if (memInfo.get() != &currMemInfo && tryFree(*memInfo, ptr)) {
+      return;
+    }
+  }
+  throw std::invalid_argument(
+      "[CachingHostMemoryManager::free] pointer not allocated by this manager");
+}
+
+bool CachingHostMemoryManager::tryFree(NodeMemoryInfo& memInfo, void* ptr) {
+  std::lock_guard<std::recursive_mutex> lock(memInfo.mutexAll_);
+  auto it = memInfo.allocatedBlocks_.find(ptr);
+  if (it == memInfo.allocatedBlocks_.end()) {
+    return false;
+  }
+  Block* block = it->second;
+  memInfo.allocatedBlocks_.erase(it);
+  block->inUse_ = false;
+  freeBlock(memInfo, block);
+  return true;
+}
+
+void CachingHostMemoryManager::freeBlock(
+    NodeMemoryInfo& memInfo,
+    Block* block) {
+  const bool isSmallAlloc = (block->size_ <= kSmallSize);
+  BlockSet& pool = isSmallAlloc ? memInfo.smallBlocks_ : memInfo.largeBlocks_;
+  tryMergeBlocks(memInfo, block, block->prev_, pool);
+  tryMergeBlocks(memInfo, block, block->next_, pool);
+
+  pool.insert(block);
+  memInfo.stats_.cachedBytes_ += block->size_;
+}
+
+/** combine previously split blocks */
+void CachingHostMemoryManager::tryMergeBlocks(
+    NodeMemoryInfo& memInfo,
+    Block* dst,
+    Block* src,
+    BlockSet& pool) {
+  if (!src || src->inUse_) {
+    return;
+  }
+  if (dst->prev_ == src) {
+    dst->ptr_ = src->ptr_;
+    dst->prev_ = src->prev_;
+    if (dst->prev_) {
+      dst->prev_->next_ = dst;
+    }
+  } else {
+    dst->next_ = src->next_;
+    if (dst->next_) {
+      dst->next_->prev_ = dst;
+    }
+  }
+  dst->size_ += src->size_;
+  pool.erase(src);
+  memInfo.stats_.cachedBytes_ -= src->size_;
+  delete src;
+}
+
+void* CachingHostMemoryManager::mallocWithRetry(
+    NodeMemoryInfo& memInfo,
+    size_t size) {
+  // If allocation fails, frees all non-split cached blocks and retries.
+  try {
+    ++memInfo.stats_.totalNativeMallocs_;
+    return nativeAlloc(size);
+  } catch (const std::bad_alloc&) {
+    try {
+      freeBlocks(memInfo, memInfo.largeBlocks_);
+      freeBlocks(memInfo, memInfo.smallBlocks_);
+      ++memInfo.stats_.totalNativeMallocs_;
+      return nativeAlloc(size);
+    } catch (const std::bad_alloc& ex) {
+      std::cerr << "Failed to allocate host memory of size "
+                << formatMemory(size) << " (NUMA node: " << memInfo.nodeId_
+                << ", Allocated: "
+                << formatMemory(memInfo.stats_.allocatedBytes_)
+                << ", Cached: " << formatMemory(memInfo.stats_.cachedBytes_)
+                << ") with error '" << ex.what() << "'" << std::endl;
+      throw;
+    }
+  }
+}
+
+void CachingHostMemoryManager::freeBlocks(
+    NodeMemoryInfo& memInfo,
+    BlockSet& blocks) {
+  // Frees all non-split blocks
+  auto it = blocks.begin();
+  while (it != blocks.end()) {
+    Block* block = *it;
+    if (!block->isSplit()) {
+      std::free(block->ptr_);
+      ++memInfo.stats_.totalNativeFrees_;
+      memInfo.stats_.allocatedBytes_ -= block->size_;
+      memInfo.stats_.cachedBytes_ -= block->size_;
+      it = blocks.erase(it);
+      delete block;
+    } else {
+      ++it;
+    }
+  }
+}
+
+void CachingHostMemoryManager::signalMemoryCleanup() {
+  for (auto& memInfo : nodeMemInfos_) {
+    std::lock_guard<std::recursive_mutex> lock(memInfo->mutexAll_);
+    freeBlocks(*memInfo, memInfo->largeBlocks_);
+    freeBlocks(*memInfo, memInfo->smallBlocks_);
+  }
+}
+
+CachingHostMemoryManager::MemoryAllocationStats
+CachingHostMemoryManager::getStats() {
+  MemoryAllocationStats total;
+  for (auto& memInfo : nodeMemInfos_) {
+    std::lock_guard<std::recursive_mutex> lock(memInfo->mutexAll_);
+    total.totalNativeMallocs_ += memInfo->stats_.totalNativeMallocs_;
+    total.totalNativeFrees_ += memInfo->stats_.totalNativeFrees_;
+    total.allocatedBytes_ += memInfo->stats_.allocatedBytes_;
+    total.cachedBytes_ += memInfo->stats_.cachedBytes_;
+  }
+  return total;
+}
+
+void CachingHostMemoryManager::printInfo(
+    const char* msg,
+    std::ostream* _ostream) {
+  std::ostream& ostream = *_ostream;
+  ostream << msg << "\nType: CachingHostMemoryManager" << std::endl;
+  for (auto& memInfo : nodeMemInfos_) {
+    std::lock_guard<std::recursive_mutex> lock(memInfo->mutexAll_);
+    ostream << "\nNUMA node: " << memInfo->nodeId_
+            << ", Allocated: " << formatMemory(memInfo->stats_.allocatedBytes_)
+            << ", Cached: " << formatMemory(memInfo->stats_.cachedBytes_)
+            << ", In use: " << memInfo->allocatedBlocks_.size() << " blocks"
+            << std::endl
+            << "Total native calls: " << memInfo->stats_.totalNativeMallocs_
+            << "(mallocs), " << memInfo->stats_.totalNativeFrees_ << "(frees)"
+            << std::endl;
+  }
+}
+
+} // namespace fl
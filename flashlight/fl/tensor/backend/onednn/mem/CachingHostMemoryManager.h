@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "flashlight/fl/tensor/backend/onednn/mem/HostMemoryManager.h"
+
+namespace fl {
+
+/**
+ * A caching host memory manager, following the block splitting & size class
+ * scheme of the ArrayFire backend's `CachingMemoryManager`:
+ * - requests are rounded to 512 bytes, and served from "small" (<= 1 MiB) or
+ *   "large" pools of cached blocks, using the smallest block that fits.
+ * - new blocks are allocated in 2 MiB (small) or >= 20 MiB (large) chunks,
+ *   and split; adjacent free blocks are merged upon release.
+ *
+ * Blocks are cached per NUMA node, keyed by the node of the allocating thread.
+ * Since fresh pages are placed on the node that first touches them, and the
+ * allocating thread is usually the one that dispatches the computation writing
+ * the buffer, this keeps recycled blocks local to their users.
+ *
+ * Runtime options are read from the environment (in MiB, as floats):
+ * - FL_ONEDNN_MEM_RECYCLING_SIZE_MB: large blocks above this aren't recycled.
+ * - FL_ONEDNN_MEM_SPLIT_SIZE_MB: blocks above this aren't split.
+ */
+class CachingHostMemoryManager : public HostMemoryManager {
+ public:
+  // Block denotes a single allocated unit of memory.
+  struct Block {
+    size_t size_; // size of block in bytes
+    void* ptr_; // memory address
+    bool inUse_{false}; // whether the memory is handed out by `alloc`
+    Block* prev_{nullptr}; // prev block if split from a larger allocation
+    Block* next_{nullptr}; // next block if split from a larger allocation
+
+    bool isSplit() const {
+      return (prev_ != nullptr) || (next_ != nullptr);
+    }
+
+    explicit Block(size_t size, void* ptr = nullptr) : size_(size), ptr_(ptr) {}
+  };
+
+  typedef bool (*Comparison)(const Block*, const Block*);
+  typedef std::set<Block*, Comparison> BlockSet;
+
+  struct MemoryAllocationStats {
+    size_t totalNativeMallocs_{0};
+    size_t totalNativeFrees_{0};
+    size_t allocatedBytes_{0}; // memory allocated by mem manager for the program
+    size_t cachedBytes_{0}; // memory held by mem manager & not used by program
+  };
+
+  // Pools, bookkeeping & lock of a single NUMA node
+  struct NodeMemoryInfo {
+    int nodeId_;
+    std::recursive_mutex mutexAll_;
+    // cached blocks larger than 1 MiB
+    BlockSet largeBlocks_;
+    // cached blocks 1 MiB or smaller
+    BlockSet smallBlocks_;
+    // allocated blocks by pointer
+    std::unordered_map<void*, Block*> allocatedBlocks_;
+    MemoryAllocationStats stats_;
+
+    explicit NodeMemoryInfo(int id);
+  };
+
+  /**
+   * @param[in] numNodes # of NUMA nodes to keep separate caches for; if
+   * negative, it's detected from the system.
+   */
+  explicit CachingHostMemoryManager(int numNodes = -1);
+  ~CachingHostMemoryManager() override;
+
+  CachingHostMemoryManager(const CachingHostMemoryManager&) = delete;
+  CachingHostMemoryManager(CachingHostMemoryManager&&) = delete;
+  CachingHostMemoryManager& operator=(const CachingHostMemoryManager&) = delete;
+  CachingHostMemoryManager& operator=(CachingHostMemoryManager&&) = delete;
+
+  void* alloc(size_t bytes) override;
+  void free(void* ptr) override;
+  void signalMemoryCleanup() override;
+  void printInfo(const char* msg, std::ostream* ostream = &std::cout) override;
+
+  // Set runtime options. Warning: not thread safe
+  void setRecyclingSizeLimit(size_t limit);
+  void setSplitSizeLimit(size_t limit);
+
+  // stats summed over all NUMA nodes
+  MemoryAllocationStats getStats();
+
+ private:
+  std::vector<std::unique_ptr<NodeMemoryInfo>> nodeMemInfos_;
+  size_t recyclingSizeLimit_{std::numeric_limits<size_t>::max()};
+  size_t splitSizeLimit_{std::numeric_limits<size_t>::max()};
+
+  // memory info of the NUMA node the calling thread runs on
+  NodeMemoryInfo& getCurrentNodeMemoryInfo();
+  // release `ptr` if it was allocated from `memInfo`, return whether it was
+  bool tryFree(NodeMemoryInfo& memInfo, void* ptr);
+  // ASSUME the memory info's lock is held by caller for the following
+  void freeBlocks(NodeMemoryInfo& memInfo, BlockSet& blocks);
+  void* mallocWithRetry(NodeMemoryInfo& memInfo, size_t size);
+  void tryMergeBlocks(
+      NodeMemoryInfo& memInfo,
+      Block* dst,
+      Block* src,
+      BlockSet& pool);
+  void freeBlock(NodeMemoryInfo& memInfo, Block* block);
+};
+
+} // namespace fl
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <ostream>
+
+namespace fl {
+
+/**
+ * An interface for managing the host memory backing CPU tensor buffers.
+ * Instances must be owned by a `std::shared_ptr`, so buffers returned by
+ * `allocShared` can keep their manager alive.
+ */
+class HostMemoryManager
+    : public std::enable_shared_from_this<HostMemoryManager> {
+ public:
+  // alignment of all buffers returned by managers, i.e., a cache line
+  static constexpr size_t kAlignment = 64;
+
+  virtual ~HostMemoryManager() = default;
+
+  /**
+   * Allocate a buffer of at least `bytes` bytes, aligned to `kAlignment`.
+   *
+   * @param[in] bytes the # of bytes requested.
+   * @return pointer to the buffer, or nullptr if `bytes` is 0.
+   */
+  virtual void* alloc(size_t bytes) = 0;
+
+  /**
+   * Release a buffer returned by `alloc` of this manager. No-op for nullptr.
+   *
+   * @param[in] ptr the pointer returned by `alloc`.
+   */
+  virtual void free(void* ptr) = 0;
+
+  /**
+   * Return all cached memory that isn't in use to the system.
+   */
+  virtual void signalMemoryCleanup() = 0;
+
+  /**
+   * Print the state of this manager.
+   *
+   * @param[in] msg a message to be printed before the state.
+   * @param[in] ostream the output stream to print to.
+   */
+  virtual void printInfo(const char* msg, std::ostream* ostream = &std::cout) = 0;
+
+  /**
+   * Same as `alloc`, but the buffer is released to this manager when the last
+   * copy of the returned pointer goes away.
+   *
+   * @param[in] bytes the # of bytes requested.
+   * @return an owning pointer to the buffer.
+   */
+  std::shared_ptr<void> allocShared(size_t bytes) {
+    auto self = shared_from_this();
+    return std::shared_ptr<void>(
+        alloc(bytes), [self = std::move(self)](void* ptr) { self->free(ptr); });
+  }
+};
+
+} // namespace fl
@@ -8,12 +8,16 @@
 #include <array>
 #include <cmath>
 #include <functional>
+#include <limits>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "flashlight/fl/autograd/Functions.h"
 #include "flashlight/fl/autograd/autograd.h"
+#include "flashlight/fl/autograd/tensor/AutogradOps.h"
 #include "flashlight/fl/common/common.h"
 #include "flashlight/fl/tensor/Index.h"
 #include "flashlight/fl/tensor/Init.h"
@@ -429,6 +433,242 @@ TEST(AutogradTest, GetAdvancedIndexF16) {
   }
 }
 
+TEST(AutogradTest, Checkpoint) {
+  auto x = Variable(fl::rand({5, 4}, fl::dtype::f64), true);
+  auto w = Variable(fl::rand({5, 5}, fl::dtype::f64), true);
+  auto fn = [&w](const std::vector<Variable>& in) -> std::vector<Variable> {
+    auto hidden = tanh(matmul(w, in[0]));
+    return {sum(hidden * hidden, {0}), sigmoid(hidden) * in[0]};
+  };
+
+  auto expected = fn({x});
+  (expected[0] + sum(expected[1], {0})).backward();
+  auto expectedXGrad = x.grad().tensor();
+  auto expectedWGrad = w.grad().tensor();
+  x.zeroGrad();
+  w.zeroGrad();
+
+  auto outputs = checkpoint(fn, {x});
+  ASSERT_EQ(outputs.size(), 2);
+  ASSERT_TRUE(allClose(outputs[0], expected[0]));
+  ASSERT_TRUE(allClose(outputs[1], expected[1]));
+  (outputs[0] + sum(outputs[1], {0})).backward();
+  ASSERT_TRUE(allClose(x.grad().tensor(), expectedXGrad, 1e-10));
+  ASSERT_TRUE(allClose(w.grad().tensor(), expectedWGrad, 1e-10));
+
+  // only parameters used by the checkpointed function need gradients
+  w.zeroGrad();
+  auto input = Variable(x.tensor(), false);
+  outputs = checkpoint(fn, {input});
+  (outputs[0] + sum(outputs[1], {0})).backward();
+  ASSERT_FALSE(input.isGradAvailable());
+  ASSERT_TRUE(allClose(w.grad().tensor(), expectedWGrad, 1e-10));
+
+  auto jacobianFn = [&w](Variable& in) {
+    return checkpoint([&w](const Variable& v) { return matmul(w, v); }, in);
+  };
+  ASSERT_TRUE(fl::detail::jacobianTestImpl(jacobianFn, x));
+}
+
+TEST(AutogradTest, CheckpointNoGradForward) {
+  auto x = Variable(fl::rand({5, 4}), true);
+  auto w = Variable(fl::rand({5, 5}), true);
+  Variable hidden;
+  auto output = checkpoint(
+      [&](const Variable& in) {
+        hidden = tanh(matmul(w, in));
+        return hidden * 2;
+      },
+      x);
+  // the forward pass doesn't record the graph of the checkpointed function
+  ASSERT_FALSE(hidden.isCalcGrad());
+  ASSERT_TRUE(output.isCalcGrad());
+  output.backward();
+  ASSERT_TRUE(hidden.isCalcGrad()); // recorded by the recomputation
+  ASSERT_TRUE(x.isGradAvailable());
+  ASSERT_TRUE(w.isGradAvailable());
+
+  NoGradGuard noGrad;
+  ASSERT_FALSE(checkpoint([](const Variable& in) { return in * 2; }, x)
+                   .isCalcGrad());
+}
+
+TEST(AutogradTest, CheckpointParameterSharedAcrossBoundary) {
+  auto x = Variable(fl::rand({5, 4}, fl::dtype::f64), true);
+  auto w = Variable(fl::rand({5, 5}, fl::dtype::f64), true);
+  auto fn = [&w](const Variable& in) { return tanh(matmul(w, in)); };
+  sum(matmul(w, fn(x)), {0, 1}).backward();
+  auto expectedWGrad = w.grad().tensor();
+  w.zeroGrad();
+
+  int numHookCalls = 0;
+  w.registerGradHook([&numHookCalls](Variable&) { ++numHookCalls; });
+  sum(matmul(w, checkpoint(fn, x)), {0, 1}).backward();
+  ASSERT_TRUE(allClose(w.grad().tensor(), expectedWGrad, 1e-10));
+  // once by the nested backward pass of the checkpoint, once by the outer one
+  ASSERT_EQ(numHookCalls, 2);
+}
+
+TEST(AutogradTest, CheckpointDropout) {
+  auto x = Variable(fl::rand({100, 10}), true);
+  auto output = checkpoint(
+      [](const Variable& in) { return dropout(in * 2, 0.5); }, x);
+  output.backward();
+  // the recomputation drops the same values as the forward pass
+  ASSERT_TRUE(fl::all((x.grad().tensor() == 0) == (output.tensor() == 0))
+                  .asScalar<bool>());
+}
+
+TEST(AutogradTest, DeepGraphBackward) {
+  // deep enough to overflow the call stack with a recursive traversal
+  const int depth = 200000;
+  auto x = Variable(fl::full({1}, 1.0), true);
+  auto y = x;
+  for (int i = 0; i < depth; ++i) {
+    y = y + 1.0;
+  }
+  y.backward();
+  ASSERT_FLOAT_EQ(x.grad().tensor().scalar<float>(), 1.0);
+}
+
+TEST(AutogradTest, ConcurrentBackward) {
+  // shared by the graphs of both threads, doesn't require gradients
+  const auto shared = Variable(fl::full({5}, 1.0), false);
+  std::vector<Variable> inputs;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    inputs.emplace_back(fl::full({5}, 1.0), true);
+  }
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&shared, &input = inputs[t]]() {
+      for (int i = 0; i < 20; ++i) {
+        input.zeroGrad();
+        auto y = input;
+        for (int j = 0; j < 100; ++j) {
+          y = y * 1.0 + shared * 0.0;
+        }
+        sum(y, {0}).backward();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& input : inputs) {
+    ASSERT_TRUE(allClose(input.grad().tensor(), fl::full({5}, 1.0)));
+  }
+}
+
+TEST(AutogradTest, BackwardCachedOrder) {
+  auto x = Variable(fl::rand({5}), true);
+  auto w = Variable(fl::rand({5}), true);
+  auto hidden = x * w;
+  auto y = sum(hidden * x + hidden, {0});
+  y.backward(/* retainGraph = */ true);
+  auto xGrad = x.grad().tensor();
+  auto wGrad = w.grad().tensor();
+
+  // retained graphs reuse their topological order
+  x.zeroGrad();
+  w.zeroGrad();
+  hidden.zeroGrad();
+  y.zeroGrad();
+  y.backward(/* retainGraph = */ true);
+  ASSERT_TRUE(allClose(x.grad().tensor(), xGrad));
+  ASSERT_TRUE(allClose(w.grad().tensor(), wGrad));
+
+  // the order is rebuilt when the graph changed
+  hidden.zeroGrad();
+  y.zeroGrad();
+  x.zeroGrad();
+  hidden.setCalcGrad(false);
+  y.backward(/* retainGraph = */ true);
+  ASSERT_TRUE(allClose(x.grad().tensor(), (x * w).tensor()));
+}
+
+TEST(AutogradTest, PersistentGrad) {
+  auto x = Variable(fl::rand({5}), true);
+  x.setPersistentGrad(true);
+  ASSERT_TRUE(x.isPersistentGrad());
+  ASSERT_FALSE(x.isGradAvailable());
+
+  for (int step = 0; step < 2; ++step) {
+    // both gradients of the sum share the same tensor, which accumulating in
+    // place mustn't modify
+    auto y = x + x;
+    auto grad = Variable(fl::rand({5}), false);
+    y.backward(grad, /* retainGraph = */ true);
+    ASSERT_TRUE(allClose(x.grad(), 2 * grad));
+    ASSERT_TRUE(allClose(y.grad(), grad));
+    // accumulate over several backward passes
+    y.zeroGrad();
+    y.backward(grad);
+    ASSERT_TRUE(allClose(x.grad(), 4 * grad));
+
+    x.zeroGrad();
+    ASSERT_FALSE(x.isGradAvailable());
+  }
+
+  x.setPersistentGrad(false);
+  auto y = 3 * x;
+  y.backward();
+  ASSERT_TRUE(allClose(x.grad().tensor(), fl::full({5}, 3.)));
+}
+
+TEST(AutogradTest, FusedMultiheadAttention) {
+  if (!fl::detail::isAttentionSupported(Tensor())) {
+    GTEST_SKIP() << "Attention isn't fused by the tensor backend";
+  }
+  // more positions than a block of the fused kernel
+  const int nHeads = 2, headDim = 4, T = 70, B = 2;
+  auto query = Variable(fl::randn({T, nHeads * headDim, B}), true);
+  auto key = Variable(fl::randn({T, nHeads * headDim, B}), true);
+  auto value = Variable(fl::randn({T, nHeads * headDim, B}), true);
+  auto mask = Variable(fl::randn({T, T}), false);
+  // the end of the second sequence is padding
+  std::vector<float> padMaskHost(T * B, 0);
+  for (int t = T - 10; t < T; ++t) {
+    padMaskHost[t + T] = -std::numeric_limits<float>::infinity();
+  }
+  auto padMask = Variable(Tensor::fromVector({T, B}, padMaskHost), false);
+  auto grad = Variable(fl::randn({T, nHeads * headDim, B}), false);
+
+  auto fused = multiheadAttention(
+      query, key, value, Variable(), mask, padMask, nHeads, 0.0);
+  fused.backward(grad);
+  std::vector<Variable> fusedGrads = {query.grad(), key.grad(), value.grad()};
+  query.zeroGrad();
+  key.zeroGrad();
+  value.zeroGrad();
+
+  // masks requiring gradients are computed with regular ops
+  auto composed = multiheadAttention(
+      query,
+      key,
+      value,
+      Variable(),
+      Variable(mask.tensor(), true),
+      padMask,
+      nHeads,
+      0.0);
+  composed.backward(grad);
+  ASSERT_TRUE(allClose(fused, composed, 1e-4));
+  ASSERT_TRUE(allClose(fusedGrads[0], query.grad(), 1e-4));
+  ASSERT_TRUE(allClose(fusedGrads[1], key.grad(), 1e-4));
+  ASSERT_TRUE(allClose(fusedGrads[2], value.grad(), 1e-4));
+
+  // the dropout mask follows the random seed
+  fl::setSeed(1);
+  auto dropped = multiheadAttention(
+      query, key, value, Variable(), mask, padMask, nHeads, 0.5);
+  fl::setSeed(1);
+  ASSERT_TRUE(allClose(
+      multiheadAttention(
+          query, key, value, Variable(), mask, padMask, nHeads, 0.5),
+      dropped));
+  ASSERT_FALSE(allClose(dropped, fused, 1e-4));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
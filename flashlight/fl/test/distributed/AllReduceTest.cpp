@@ -13,6 +13,7 @@
 
 #include <gtest/gtest.h>
 
+#include "flashlight/fl/autograd/autograd.h"
 #include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/distributed/distributed.h"
 #include "flashlight/fl/tensor/Init.h"
@@ -182,6 +183,51 @@ TEST(Distributed, CoalescingReducer) {
   }
 }
 
+TEST(Distributed, BucketedReducer) {
+  if (!isDistributedInit()) {
+    GTEST_SKIP() << "Distributed initialization failed or not enabled.";
+  }
+
+  auto rank = getWorldRank();
+  auto size = getWorldSize();
+
+  // buckets of two parameters
+  auto reducer = std::make_shared<fl::BucketedReducer>(
+      /* scale = */ 1.0 / size,
+      /*async=*/true && !FL_BACKEND_CPU,
+      /*contiguous=*/true && !FL_BACKEND_CPU,
+      /* bucketSizeBytes = */ 10 * sizeof(float));
+  std::vector<Variable> params;
+  for (size_t i = 0; i < 5; ++i) {
+    params.emplace_back(fl::full({4}, 1.0, dtype::f32), true);
+  }
+  reducer->registerParams(params);
+  auto unused = Variable(fl::full({4}, 1.0, dtype::f32), true);
+  reducer->registerParams({unused});
+  // registering parameters again doesn't synchronize them twice
+  reducer->registerParams(params);
+
+  for (int step = 0; step < 2; ++step) {
+    auto output = params[0] * (rank + 1);
+    for (size_t i = 1; i < params.size(); ++i) {
+      output = output + params[i] * (rank + 1);
+    }
+    output.backward();
+    reducer->finalize();
+
+    // The reducer averages gradients
+    float expected_val = (size + 1.0) / 2.0;
+    for (auto& param : params) {
+      auto diff = fl::abs(param.grad().tensor() - expected_val);
+      ASSERT_TRUE(fl::all(diff < 1e-5).scalar<char>());
+      param.zeroGrad();
+    }
+    // Unused parameters get a zero gradient
+    ASSERT_TRUE(fl::all(unused.grad().tensor() == 0).scalar<char>());
+    unused.zeroGrad();
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -6,6 +6,7 @@
  */
 
 #include <array>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 
@@ -823,6 +824,34 @@ TEST(ModuleTest, ContainerReplaceParam) {
   ASSERT_TRUE(allClose(seq.param(6), new_param));
 }
 
+TEST(ModuleTest, ContainerReplaceModule) {
+  auto seq = ContainerTestClass();
+  seq.addParam(Variable(fl::rand({5, 5}), true));
+  seq.add(Linear(10, 20));
+  seq.addParam(Variable(fl::rand({5, 5}), true));
+  seq.add(ReLU());
+  seq.add(Linear(20, 30));
+  const auto orphan = seq.param(3);
+  const auto lastParam = seq.param(5);
+
+  // params of the new module take the place of the old ones
+  auto replacement = std::make_shared<Linear>(10, 20, /* bias = */ false);
+  seq.replace(0, replacement);
+  ASSERT_EQ(seq.module(0), replacement);
+  ASSERT_EQ(seq.params().size(), 5);
+  ASSERT_TRUE(allClose(seq.param(1), replacement->param(0)));
+  ASSERT_TRUE(allClose(seq.param(2), orphan));
+  ASSERT_TRUE(allClose(seq.param(4), lastParam));
+
+  // the mapping of container params to module params is updated
+  auto newParam = Variable(fl::rand({30, 20}), true);
+  seq.setParams(newParam, 3);
+  ASSERT_TRUE(allClose(seq.module(2)->param(0), newParam));
+
+  ASSERT_THROW(seq.replace(3, replacement), std::out_of_range);
+  ASSERT_THROW(seq.replace(0, nullptr), std::invalid_argument);
+}
+
 TEST(ModuleTest, AdaptiveSoftMaxPredict) {
   // test predict gives the same as argmax along probs
   int N = 5;
@@ -979,6 +1008,57 @@ TEST(ModuleTest, ContainerCloneCopy) {
   ASSERT_TRUE(allClose(clonedModulePtr->params()[0], modulePtr->params()[0]));
 }
 
+TEST(ModuleTest, SequentialCheckpoint) {
+  Sequential model;
+  model.add(Linear(6, 8));
+  model.add(Tanh());
+  model.add(Linear(8, 8));
+  model.add(Tanh());
+  model.add(Linear(8, 3));
+  auto input = Variable(fl::rand({6, 4}), true);
+
+  auto expected = model(input);
+  expected.backward();
+  auto expectedInputGrad = input.grad().tensor();
+  std::vector<Tensor> expectedGrads;
+  for (auto& param : model.params()) {
+    expectedGrads.push_back(param.grad().tensor());
+  }
+  input.zeroGrad();
+  model.zeroGrad();
+
+  ASSERT_THROW(model.setCheckpointEvery(-1), std::invalid_argument);
+  model.setCheckpointEvery(2);
+  ASSERT_EQ(model.checkpointEvery(), 2);
+  ASSERT_EQ(Sequential(model).checkpointEvery(), 2);
+  auto output = model(input);
+  ASSERT_TRUE(allClose(output, expected));
+  output.backward();
+  ASSERT_TRUE(allClose(input.grad().tensor(), expectedInputGrad, 1e-5));
+  auto params = model.params();
+  for (size_t i = 0; i < params.size(); ++i) {
+    ASSERT_TRUE(allClose(params[i].grad().tensor(), expectedGrads[i], 1e-5));
+  }
+}
+
+TEST(ModuleTest, PersistentGrads) {
+  Linear linear(4, 3);
+  linear.setPersistentGrads(true);
+  auto input = Variable(fl::rand({4, 2}), false);
+  auto output = linear(input);
+  output.backward();
+  auto weightGrad = linear.param(0).grad().tensor().copy();
+  linear.zeroGrad();
+  ASSERT_FALSE(linear.param(0).isGradAvailable());
+
+  output = linear(input);
+  output.backward();
+  ASSERT_TRUE(allClose(linear.param(0).grad().tensor(), weightGrad));
+  for (const auto& param : linear.params()) {
+    ASSERT_TRUE(param.isPersistentGrad());
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/autograd/autograd.h"
+#include "flashlight/fl/common/common.h"
+#include "flashlight/fl/nn/nn.h"
+#include "flashlight/fl/tensor/Index.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/TensorBackend.h"
+
+using namespace fl;
+
+namespace {
+
+// int8 quantization error, relative to the max absolute value of the output
+const float kRelTolerance = 0.05;
+
+class QuantizationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!detail::TensorExtensionRegistrar::getInstance()
+             .isTensorExtensionRegistered(
+                 Tensor().backendType(), TensorExtensionType::Quantization)) {
+      GTEST_SKIP() << "Quantization isn't supported by the tensor backend";
+    }
+  }
+};
+
+float maxRelError(const Tensor& actual, const Tensor& expected) {
+  return fl::amax(fl::abs(actual - expected)).asScalar<float>() /
+      fl::amax(fl::abs(expected)).asScalar<float>();
+}
+
+} // namespace
+
+TEST_F(QuantizationTest, QuantizeWeights) {
+  auto weights = fl::randn({4, 3, 2, 5});
+  auto [quantized, scales] = quantizeWeights(weights, /* channelAxis = */ 3);
+  ASSERT_EQ(quantized.type(), fl::dtype::s32);
+  ASSERT_EQ(quantized.shape(), weights.shape());
+  ASSERT_EQ(scales.shape(), Shape({5}));
+  ASSERT_LE(fl::amax(fl::abs(quantized)).asScalar<int>(), 127);
+
+  // each channel uses the whole range, and dequantizes to within half a step
+  auto channelScales = fl::reshape(scales, {1, 1, 1, 5});
+  ASSERT_TRUE(allClose(
+      fl::amax(fl::abs(quantized), {0, 1, 2}).astype(fl::dtype::f32),
+      fl::full({5}, 127.)));
+  auto error =
+      fl::abs(quantized.astype(fl::dtype::f32) * channelScales - weights);
+  ASSERT_TRUE(fl::all(error <= channelScales * 0.5 + 1e-6).asScalar<bool>());
+
+  ASSERT_THROW(quantizeWeights(weights, 4), std::invalid_argument);
+  ASSERT_THROW(
+      quantizeWeights(weights.astype(fl::dtype::f64), 3),
+      std::invalid_argument);
+}
+
+TEST_F(QuantizationTest, QuantizedLinearFwd) {
+  auto linear = std::make_shared<Linear>(64, 32);
+  auto input = Variable(fl::randn({64, 10, 3}), false);
+  auto expected = linear->forward(input);
+
+  QuantizationCalibrator calibrator;
+  Sequential model;
+  model.add(linear);
+  calibrator.forward(model, input);
+  auto quantized = QuantizedLinear(*linear, calibrator.inputScale(*linear));
+  ASSERT_EQ(quantized.params().size(), 3);
+  for (const auto& param : quantized.params()) {
+    ASSERT_FALSE(param.isCalcGrad());
+  }
+
+  auto output = quantized(input);
+  ASSERT_EQ(output.shape(), expected.shape());
+  ASSERT_EQ(output.type(), fl::dtype::f32);
+  ASSERT_LT(maxRelError(output.tensor(), expected.tensor()), kRelTolerance);
+  // packed weights are reused
+  ASSERT_TRUE(allClose(quantized(input), output));
+}
+
+TEST_F(QuantizationTest, QuantizedConv2DFwd) {
+  auto input = Variable(fl::randn({20, 16, 8, 2}), false);
+  for (int groups : {1, 2}) {
+    auto conv =
+        std::make_shared<Conv2D>(8, 12, 3, 3, 2, 1, 1, 1, 1, 1, true, groups);
+    auto expected = conv->forward(input);
+
+    QuantizationCalibrator calibrator;
+    Sequential model;
+    model.add(conv);
+    calibrator.forward(model, input);
+    auto quantized = QuantizedConv2D(*conv, calibrator.inputScale(*conv));
+
+    auto output = quantized(input);
+    ASSERT_EQ(output.shape(), expected.shape());
+    ASSERT_LT(maxRelError(output.tensor(), expected.tensor()), kRelTolerance);
+  }
+}
+
+TEST_F(QuantizationTest, QuantizeSequential) {
+  Sequential nested;
+  nested.add(Linear(32, 16));
+  nested.add(ReLU());
+  Sequential model;
+  model.add(Conv2D(3, 8, 3, 3, 1, 1, PaddingMode::SAME, PaddingMode::SAME));
+  model.add(ReLU());
+  model.add(View(Shape({4 * 4 * 8, -1})));
+  model.add(Linear(8 * 4 * 4, 32));
+  model.add(std::move(nested));
+  model.add(Linear(16, 4, /* bias = */ false));
+  model.eval();
+
+  QuantizationCalibrator calibrator;
+  for (int i = 0; i < 4; ++i) {
+    calibrator.forward(model, Variable(fl::randn({4, 4, 3, 8}), false));
+  }
+  auto input = Variable(fl::randn({4, 4, 3, 8}), false);
+  auto expected = model(input);
+  const auto numParams = model.params().size();
+
+  ASSERT_EQ(quantize(model, calibrator), 4);
+  ASSERT_TRUE(dynamic_cast<QuantizedConv2D*>(model.module(0).get()));
+  ASSERT_TRUE(dynamic_cast<QuantizedLinear*>(model.module(3).get()));
+  auto quantizedNested = std::dynamic_pointer_cast<Sequential>(model.module(4));
+  ASSERT_TRUE(dynamic_cast<QuantizedLinear*>(quantizedNested->module(0).get()));
+  ASSERT_TRUE(dynamic_cast<QuantizedLinear*>(model.module(5).get()));
+  // + weight scales per quantized module
+  ASSERT_EQ(model.params().size(), numParams + 4);
+
+  auto output = model(input);
+  ASSERT_EQ(output.shape(), expected.shape());
+  ASSERT_LT(maxRelError(output.tensor(), expected.tensor()), 2 * kRelTolerance);
+
+  // quantized modules are (de)serialized, and rebuild backend data on load
+  std::stringstream ss;
+  {
+    cereal::BinaryOutputArchive ar(ss);
+    ar(model);
+  }
+  Sequential loaded;
+  {
+    cereal::BinaryInputArchive ar(ss);
+    ar(loaded);
+  }
+  ASSERT_TRUE(allClose(loaded(input), output));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  fl::init();
+  return RUN_ALL_TESTS();
+}
@@ -5,8 +5,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <atomic>
 #include <memory>
 #include <random>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include <af/device.h>
@@ -198,6 +201,186 @@ TEST_F(CachingMemoryManagerTest, RecLimit) {
   testFragmentation(deviceInterface_, adapter_, false); // should not OOM
 }
 
+TEST_F(CachingMemoryManagerTest, ConcurrentAllocs) {
+  // Allocates & frees from several threads at once, like dataset workers do.
+  // Memory held at the same time must never be handed out twice.
+  const int numThreads = 8;
+  std::vector<std::vector<void*>> held(numThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 gen(t);
+      for (int i = 0; i < 200; ++i) {
+        // mix of small and large allocations
+        dim_t size = gen() % 4 == 0 ? 1 + gen() % (4 << 20) : 1 + gen() % 4096;
+        void* ptr = adapter_->alloc(false, 1, &size, 1);
+        ASSERT_GE(adapter_->allocated(ptr), size);
+        if (gen() % 2) {
+          adapter_->unlock(ptr, false);
+        } else {
+          held[t].push_back(ptr);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::set<void*> ptrs;
+  size_t numHeld = 0;
+  for (const auto& ptrsOfThread : held) {
+    ptrs.insert(ptrsOfThread.begin(), ptrsOfThread.end());
+    numHeld += ptrsOfThread.size();
+  }
+  ASSERT_EQ(ptrs.size(), numHeld);
+  for (void* ptr : ptrs) {
+    adapter_->unlock(ptr, false);
+  }
+}
+
+namespace {
+
+struct FakeEvent {
+  std::atomic<bool> done{false};
+};
+
+// Fake streams & events, so that tests run on any backend
+struct FakeStreams {
+  int stream1;
+  int stream2;
+  void* activeStream{&stream1};
+  std::vector<FakeEvent*> events;
+  size_t numDestroyedEvents{0};
+
+  void install(fl::MemoryManagerDeviceInterface& itf) {
+    itf.getActiveStream = [this]() { return activeStream; };
+    itf.recordEvent = [this](void* /* stream */) {
+      events.push_back(new FakeEvent());
+      return static_cast<void*>(events.back());
+    };
+    itf.isEventDone = [](void* event) {
+      return static_cast<FakeEvent*>(event)->done.load();
+    };
+    itf.syncEvent = [](void* event) {
+      static_cast<FakeEvent*>(event)->done = true;
+    };
+    itf.destroyEvent = [this](void* event) {
+      delete static_cast<FakeEvent*>(event);
+      ++numDestroyedEvents;
+    };
+  }
+};
+
+} // namespace
+
+TEST_F(CachingMemoryManagerTest, StreamOrderedReuse) {
+  const auto itf = *deviceInterface_;
+  FakeStreams streams;
+  streams.install(*deviceInterface_);
+
+  dim_t size = 4096;
+  void* ptr1 = adapter_->alloc(false, 1, &size, 1);
+  adapter_->unlock(ptr1, false);
+  void* ptr = adapter_->alloc(false, 1, &size, 1);
+  ASSERT_EQ(ptr, ptr1); // reused on the same stream
+  adapter_->unlock(ptr, false);
+
+  // Each stream has its own free blocks
+  streams.activeStream = &streams.stream2;
+  void* ptr2 = adapter_->alloc(false, 1, &size, 1);
+  ASSERT_NE(ptr2, ptr1);
+  adapter_->unlock(ptr2, false);
+
+  // Memory used by another stream waits for that stream before reuse
+  streams.activeStream = &streams.stream1;
+  ptr1 = adapter_->alloc(false, 1, &size, 1);
+  adapter_->recordStream(ptr1, &streams.stream2);
+  adapter_->unlock(ptr1, false);
+  ASSERT_EQ(streams.events.size(), 1);
+  ptr = adapter_->alloc(false, 1, &size, 1);
+  ASSERT_NE(ptr, ptr1);
+  adapter_->unlock(ptr, false);
+  streams.events.back()->done = true;
+  ptr = adapter_->alloc(false, 1, &size, 1);
+  ASSERT_EQ(ptr, ptr1);
+  adapter_->unlock(ptr, false);
+
+  // Cleanup waits for pending events
+  ptr1 = adapter_->alloc(false, 1, &size, 1);
+  adapter_->recordStream(ptr1, &streams.stream2);
+  adapter_->unlock(ptr1, false);
+  ASSERT_EQ(streams.numDestroyedEvents, 1);
+  adapter_->signalMemoryCleanup();
+  ASSERT_EQ(streams.events.size(), 2);
+  ASSERT_EQ(streams.numDestroyedEvents, 2);
+
+  *deviceInterface_ = itf;
+}
+
+TEST_F(CachingMemoryManagerTest, MemorySnapshot) {
+  adapter_->setTimelineCapacity(3);
+  dim_t size = 4096;
+  void* ptr1 = adapter_->alloc(false, 1, &size, 1);
+  void* ptr2 = adapter_->alloc(false, 1, &size, 1);
+  adapter_->unlock(ptr1, false);
+  ptr1 = adapter_->alloc(false, 1, &size, 1); // cache hit
+
+  auto snapshot = adapter_->getMemorySnapshot();
+  ASSERT_EQ(snapshot.usedBlockSizes.numValues, 2);
+  ASSERT_EQ(snapshot.usedBlockSizes.max, size);
+  // the rest of the 2 MiB buffer of small allocations
+  ASSERT_EQ(snapshot.freeBlockSizes.numValues, 1);
+  ASSERT_EQ(snapshot.largestFreeBlock, (2 << 20) - 2 * size);
+  ASSERT_EQ(snapshot.splitCachedBytes, snapshot.largestFreeBlock);
+  ASSERT_EQ(snapshot.sizeClasses.size(), 1);
+  ASSERT_LE(snapshot.sizeClasses[0].minSize, size);
+  ASSERT_GT(snapshot.sizeClasses[0].maxSize, size);
+  ASSERT_EQ(snapshot.sizeClasses[0].cacheHits, 2);
+  ASSERT_EQ(snapshot.sizeClasses[0].cacheMisses, 1);
+  ASSERT_EQ(snapshot.timeline.size(), 3);
+  ASSERT_EQ(
+      snapshot.timeline.back().action,
+      fl::CachingMemoryManager::TimelineAction::Alloc);
+  ASSERT_FALSE(snapshot.prettyString().empty());
+
+  adapter_->unlock(ptr1, false);
+  adapter_->unlock(ptr2, false);
+  snapshot = adapter_->getMemorySnapshot();
+  ASSERT_EQ(snapshot.largestFreeBlock, 2 << 20);
+  ASSERT_EQ(snapshot.splitCachedBytes, 0);
+}
+
+TEST_F(CachingMemoryManagerTest, Compaction) {
+  const auto itf = *deviceInterface_;
+  FakeStreams streams;
+  streams.install(*deviceInterface_);
+
+  // Free memory of the first stream is reused by the second one after
+  // compacting
+  dim_t size = 4096;
+  void* ptr1 = adapter_->alloc(false, 1, &size, 1);
+  streams.activeStream = &streams.stream2;
+  ASSERT_EQ(adapter_->compact(), 0);
+  void* ptr2 = adapter_->alloc(false, 1, &size, 1);
+  ASSERT_EQ(ptr2, static_cast<char*>(ptr1) + size);
+
+  // Blocks of different streams aren't coalesced upon free, so the whole
+  // buffer stays cached after a cleanup, until compacted
+  adapter_->unlock(ptr2, false);
+  adapter_->unlock(ptr1, false);
+  adapter_->signalMemoryCleanup();
+  auto snapshot = adapter_->getMemorySnapshot();
+  ASSERT_EQ(snapshot.splitCachedBytes, 2 << 20);
+  ASSERT_EQ(adapter_->compact(), 2 << 20);
+  snapshot = adapter_->getMemorySnapshot();
+  ASSERT_EQ(snapshot.cachedBytes, 0);
+  ASSERT_EQ(snapshot.numCompactions, 2);
+  ASSERT_EQ(snapshot.compactedBytes, 2 << 20);
+
+  *deviceInterface_ = itf;
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
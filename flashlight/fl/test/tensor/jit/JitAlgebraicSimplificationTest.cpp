@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/Types.h"
+#include "flashlight/fl/tensor/backend/jit/Utils.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ExternalUse.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/AlgebraicSimplification.h"
+
+using namespace fl;
+
+class JitAlgebraicSimplificationTest : public ::testing::Test {
+ protected:
+  AlgebraicSimplification simplifier_;
+};
+
+TEST_F(JitAlgebraicSimplificationTest, identities) {
+  Shape shape(Shape({2, 3}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  auto simplify = [&](BinaryOp op, double scalar, bool scalarOnLeft) {
+    const auto c = ScalarNode::create(shape, dtype::f32, scalar);
+    return simplifier_.apply(
+        scalarOnLeft ? BinaryNode::create(c, v0, op)
+                     : BinaryNode::create(v0, c, op));
+  };
+  ASSERT_EQ(simplify(BinaryOp::Add, 0, false), v0);
+  ASSERT_EQ(simplify(BinaryOp::Add, 0, true), v0);
+  ASSERT_EQ(simplify(BinaryOp::Sub, 0, false), v0);
+  ASSERT_EQ(simplify(BinaryOp::Mul, 1, false), v0);
+  ASSERT_EQ(simplify(BinaryOp::Mul, 1, true), v0);
+  ASSERT_EQ(simplify(BinaryOp::Div, 1, false), v0);
+  ASSERT_EQ(simplify(BinaryOp::Pow, 1, false), v0);
+  // not identities
+  ASSERT_NE(simplify(BinaryOp::Sub, 0, true), v0);
+  ASSERT_NE(simplify(BinaryOp::Div, 1, true), v0);
+  ASSERT_NE(simplify(BinaryOp::Mul, 2, false), v0);
+}
+
+TEST_F(JitAlgebraicSimplificationTest, powerOfTwo) {
+  //   v0  c2
+  //    \  /
+  //    pow
+  //     |
+  //    exp
+  Shape shape(Shape({4}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f64));
+  const auto c2 = ScalarNode::create(shape, dtype::f64, 2);
+  const auto pow = BinaryNode::create(v0, c2, BinaryOp::Pow);
+  const auto exp = UnaryNode::create(pow, UnaryOp::Exp);
+  ExternalUse use(exp);
+  ASSERT_EQ(simplifier_.apply(exp), exp);
+  //   v0
+  //   ||
+  //   mul
+  //    |
+  //   exp
+  const auto mul = exp->inputs()[0];
+  ASSERT_TRUE(mul->isBinary());
+  ASSERT_EQ(mul->impl<BinaryNode>().op(), BinaryOp::Mul);
+  ASSERT_EQ(mul->inputs(), NodeList({v0, v0}));
+  ASSERT_EQ(use.usee(), exp);
+}
+
+TEST_F(JitAlgebraicSimplificationTest, doubleNegation) {
+  Shape shape(Shape({3}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto neg1 = UnaryNode::create(v0, UnaryOp::Negative);
+  const auto neg2 = UnaryNode::create(neg1, UnaryOp::Negative);
+  const auto sin = UnaryNode::create(neg2, UnaryOp::Sin);
+  ExternalUse use(neg2);
+  ASSERT_EQ(simplifier_.apply(sin), sin);
+  ASSERT_EQ(sin->inputs(), NodeList({v0}));
+  // external uses are redirected too
+  ASSERT_EQ(use.usee(), v0);
+}
+
+TEST_F(JitAlgebraicSimplificationTest, nestedIdentities) {
+  // (v0 * 1) + 0 --> v0
+  Shape shape(Shape({2, 2}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto c1 = ScalarNode::create(shape, dtype::f32, 1);
+  const auto c0 = ScalarNode::create(shape, dtype::f32, 0);
+  const auto mul = BinaryNode::create(v0, c1, BinaryOp::Mul);
+  const auto add = BinaryNode::create(mul, c0, BinaryOp::Add);
+  ASSERT_EQ(simplifier_.apply(add), v0);
+}
+
+TEST_F(JitAlgebraicSimplificationTest, typeOrShapeChangingNotSimplified) {
+  Shape shape(Shape({2, 2}));
+  const auto f32 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto s32 = ValueNode::create(fl::full(shape, 3, dtype::s32));
+  // f32 * 1.0 (f64) may promote to f64
+  const auto c1f64 = ScalarNode::create(shape, dtype::f64, 1);
+  const auto mul1 = BinaryNode::create(f32, c1f64, BinaryOp::Mul);
+  ASSERT_EQ(simplifier_.apply(mul1), mul1);
+  // s32 * 1.0 (f32) promotes to f32
+  const auto c1f32 = ScalarNode::create(shape, dtype::f32, 1);
+  const auto mul2 = BinaryNode::create(s32, c1f32, BinaryOp::Mul);
+  ASSERT_EQ(simplifier_.apply(mul2), mul2);
+  // f32 * 1 (s32) stays f32
+  const auto c1s32 = ScalarNode::create(shape, dtype::s32, 1);
+  const auto mul3 = BinaryNode::create(f32, c1s32, BinaryOp::Mul);
+  ASSERT_EQ(simplifier_.apply(mul3), f32);
+  // 1 broadcasts v0
+  const auto v0 = ValueNode::create(fl::rand({2, 1}, dtype::f32));
+  const auto c1Broadcast = ScalarNode::create({2, 3}, dtype::f32, 1);
+  const auto mul4 = BinaryNode::create(v0, c1Broadcast, BinaryOp::Mul);
+  ASSERT_EQ(simplifier_.apply(mul4), mul4);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
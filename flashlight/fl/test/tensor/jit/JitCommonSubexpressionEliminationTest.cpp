@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/Types.h"
+#include "flashlight/fl/tensor/backend/jit/Utils.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ExternalUse.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/CommonSubexpressionElimination.h"
+
+using namespace fl;
+
+class JitCommonSubexpressionEliminationTest : public ::testing::Test {
+ protected:
+  CommonSubexpressionElimination cse_;
+};
+
+TEST_F(JitCommonSubexpressionEliminationTest, identicalSubtrees) {
+  // v0  c1  v0  c2     v0  c1
+  //  \  /    \  /       \  /
+  //   mul1   mul2   -->  mul1
+  //     \    /           ||
+  //      add             add
+  Shape shape(Shape({2, 2}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto c1 = ScalarNode::create(shape, dtype::f32, 2);
+  const auto c2 = ScalarNode::create(shape, dtype::f32, 2);
+  const auto mul1 = BinaryNode::create(v0, c1, BinaryOp::Mul);
+  const auto mul2 = BinaryNode::create(v0, c2, BinaryOp::Mul);
+  const auto add = BinaryNode::create(mul1, mul2, BinaryOp::Add);
+  ASSERT_EQ(cse_.apply(add), add);
+  ASSERT_EQ(add->inputs(), NodeList({mul1, mul1}));
+  ASSERT_EQ(mul1->inputs(), NodeList({v0, c1}));
+  ASSERT_EQ(mul2->uses(), UseValList({}));
+}
+
+TEST_F(JitCommonSubexpressionEliminationTest, commutativeOps) {
+  Shape shape(Shape({3}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto v1 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto add1 = BinaryNode::create(v0, v1, BinaryOp::Add);
+  const auto add2 = BinaryNode::create(v1, v0, BinaryOp::Add);
+  const auto sub1 = BinaryNode::create(v0, v1, BinaryOp::Sub);
+  const auto sub2 = BinaryNode::create(v1, v0, BinaryOp::Sub);
+  const auto root = BinaryNode::create(
+      BinaryNode::create(add1, add2, BinaryOp::Mul),
+      BinaryNode::create(sub1, sub2, BinaryOp::Mul),
+      BinaryOp::Div);
+  cse_.apply(root);
+  ASSERT_EQ(root->inputs()[0]->inputs(), NodeList({add1, add1}));
+  ASSERT_EQ(root->inputs()[1]->inputs(), NodeList({sub1, sub2}));
+}
+
+TEST_F(JitCommonSubexpressionEliminationTest, differentParameters) {
+  Shape shape(Shape({2, 3}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  // reductions
+  const auto sum1 = ReductionNode::create(v0, ReductionOp::Sum, {0}, false);
+  const auto sum2 = ReductionNode::create(v0, ReductionOp::Sum, {0}, false);
+  const auto sum3 = ReductionNode::create(v0, ReductionOp::Sum, {1}, false);
+  const auto sum4 = ReductionNode::create(v0, ReductionOp::Sum, {0}, true);
+  const auto mean = ReductionNode::create(v0, ReductionOp::Mean, {0}, false);
+  const auto add1 = BinaryNode::create(sum1, sum2, BinaryOp::Add);
+  const auto add2 = BinaryNode::create(add1, mean, BinaryOp::Add);
+  cse_.apply(add2);
+  ASSERT_EQ(add1->inputs(), NodeList({sum1, sum1}));
+  ASSERT_EQ(add2->inputs(), NodeList({add1, mean}));
+  cse_.apply(BinaryNode::create(sum3, sum4, BinaryOp::Add));
+  ASSERT_EQ(sum3->uses().size(), 1);
+  ASSERT_EQ(sum4->uses().size(), 1);
+  // unary ops
+  const auto exp = UnaryNode::create(v0, UnaryOp::Exp);
+  const auto log = UnaryNode::create(v0, UnaryOp::Log);
+  const auto add3 = BinaryNode::create(exp, log, BinaryOp::Add);
+  cse_.apply(add3);
+  ASSERT_EQ(add3->inputs(), NodeList({exp, log}));
+  // scalars of different types or values
+  const auto c1 = ScalarNode::create(shape, dtype::f32, 1);
+  const auto c2 = ScalarNode::create(shape, dtype::f64, 1);
+  const auto c3 = ScalarNode::create(shape, dtype::f32, 3);
+  const auto add4 = BinaryNode::create(c1, c2, BinaryOp::Add);
+  const auto add5 = BinaryNode::create(add4, c3, BinaryOp::Add);
+  cse_.apply(add5);
+  ASSERT_EQ(add4->inputs(), NodeList({c1, c2}));
+  ASSERT_EQ(add5->inputs(), NodeList({add4, c3}));
+}
+
+TEST_F(JitCommonSubexpressionEliminationTest, externalUses) {
+  // external uses of merged nodes are redirected too
+  Shape shape(Shape({2}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto neg1 = UnaryNode::create(v0, UnaryOp::Negative);
+  const auto neg2 = UnaryNode::create(v0, UnaryOp::Negative);
+  const auto exp = UnaryNode::create(neg1, UnaryOp::Exp);
+  const auto add = BinaryNode::create(exp, neg2, BinaryOp::Add);
+  ExternalUse use(neg2);
+  cse_.apply(add);
+  ASSERT_EQ(add->inputs(), NodeList({exp, neg1}));
+  ASSERT_EQ(use.usee(), neg1);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/Types.h"
+#include "flashlight/fl/tensor/backend/jit/Utils.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ExternalUse.h"
+#include "flashlight/fl/tensor/backend/jit/ir/IndexNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/AlgebraicSimplification.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/DeadNodePruning.h"
+
+using namespace fl;
+
+class JitDeadNodePruningTest : public ::testing::Test {
+ protected:
+  AlgebraicSimplification simplifier_;
+  DeadNodePruning pruner_;
+};
+
+TEST_F(JitDeadNodePruningTest, afterSimplification) {
+  //     v0  c1             v0
+  //    / \  /              |
+  //  exp  mul     -->     exp
+  Shape shape(Shape({2, 2}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto c1 = ScalarNode::create(shape, dtype::f32, 1);
+  const auto mul = BinaryNode::create(v0, c1, BinaryOp::Mul);
+  const auto exp = UnaryNode::create(mul, UnaryOp::Exp);
+  ASSERT_EQ(simplifier_.apply(exp), exp);
+  ASSERT_EQ(exp->inputs(), NodeList({v0}));
+  ASSERT_EQ(v0->uses(), UseValList({{exp, 0}, {mul, 0}}));
+  ASSERT_EQ(pruner_.apply(exp), exp);
+  ASSERT_EQ(v0->uses(), UseValList({{exp, 0}}));
+  ASSERT_EQ(mul->inputs(), NodeList({}));
+  ASSERT_EQ(c1->uses(), UseValList({}));
+}
+
+TEST_F(JitDeadNodePruningTest, deadChain) {
+  // dead nodes' inputs that are only used by dead nodes are pruned too
+  //   v0 ----
+  //   |      |
+  //  sin    cos
+  //   | \    |
+  //   |  \  tanh
+  //   |   \  /
+  //  exp   add (dead)
+  Shape shape(Shape({3}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto sin = UnaryNode::create(v0, UnaryOp::Sin);
+  const auto cos = UnaryNode::create(v0, UnaryOp::Cos);
+  const auto tanh = UnaryNode::create(cos, UnaryOp::Tanh);
+  const auto add = BinaryNode::create(sin, tanh, BinaryOp::Add);
+  const auto exp = UnaryNode::create(sin, UnaryOp::Exp);
+  pruner_.apply(exp);
+  ASSERT_EQ(v0->uses(), UseValList({{sin, 0}}));
+  ASSERT_EQ(sin->uses(), UseValList({{exp, 0}}));
+  ASSERT_EQ(add->inputs(), NodeList({}));
+  ASSERT_EQ(tanh->inputs(), NodeList({}));
+  ASSERT_EQ(cos->inputs(), NodeList({}));
+  ASSERT_EQ(exp->inputs(), NodeList({sin}));
+}
+
+TEST_F(JitDeadNodePruningTest, liveNodesNotPruned) {
+  Shape shape(Shape({4}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  // used by a tensor
+  const auto sin = UnaryNode::create(v0, UnaryOp::Sin);
+  ExternalUse use(sin);
+  // may be viewed by a tensor
+  const auto index = IndexNode::create(v0, {fl::range(0, 2)});
+  // evaluated
+  const auto cos = UnaryNode::create(v0, UnaryOp::Cos);
+  cos->setResult(fl::cos(v0->getResult().value()));
+  const auto exp = UnaryNode::create(v0, UnaryOp::Exp);
+  pruner_.apply(exp);
+  ASSERT_EQ(sin->inputs(), NodeList({v0}));
+  ASSERT_EQ(index->inputs(), NodeList({v0}));
+  ASSERT_EQ(cos->inputs(), NodeList({v0}));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
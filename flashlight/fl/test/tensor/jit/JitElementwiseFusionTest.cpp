@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/Types.h"
+#include "flashlight/fl/tensor/backend/jit/Utils.h"
+#include "flashlight/fl/tensor/backend/jit/eval/Evaluator.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/ElementwiseFusion.h"
+
+using namespace fl;
+
+class JitElementwiseFusionTest : public ::testing::Test {
+ protected:
+  TensorBackend& defaultBackend_ = DefaultTensorBackend_t::getInstance();
+  ElementwiseFusion fuser_{defaultBackend_};
+  Evaluator evaluator_{defaultBackend_};
+
+  Tensor evalNode(NodePtr node) {
+    evaluator_.eval(node);
+    return node->getResult().value();
+  }
+};
+
+TEST_F(JitElementwiseFusionTest, singleBinaryNode) {
+  // v1  c2
+  //  \  /
+  //   add
+  Shape shape(Shape({2, 2}));
+  const auto v1 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto c2 = ScalarNode::create(shape, dtype::f32, 2);
+  const auto add = BinaryNode::create(v1, c2, BinaryOp::Add);
+  // nothing changes
+  ASSERT_EQ(add, fuser_.apply(add));
+  ASSERT_EQ(add->inputs(), NodeList({v1, c2}));
+  ASSERT_EQ(fuser_.numCachedKernels(), 0);
+}
+
+TEST_F(JitElementwiseFusionTest, elementwiseChain) {
+  // v1  c2
+  //  \  /
+  //   mul  v3
+  //     \  /
+  //     add
+  //      |
+  //     exp
+  Shape shape(Shape({3, 5}));
+  const auto t1 = fl::rand(shape, dtype::f32);
+  const auto t3 = fl::rand(shape, dtype::f32);
+  const auto v1 = ValueNode::create(t1.copy());
+  const auto c2 = ScalarNode::create(shape, dtype::f32, 2);
+  const auto v3 = ValueNode::create(t3.copy());
+  const auto mul = BinaryNode::create(v1, c2, BinaryOp::Mul);
+  const auto add = BinaryNode::create(mul, v3, BinaryOp::Add);
+  const auto exp = UnaryNode::create(add, UnaryOp::Exp);
+  const auto res = fuser_.apply(exp);
+  //  v1  v3
+  //   \  /
+  //  fused
+  ASSERT_TRUE(res->isCustom());
+  ASSERT_EQ(res->inputs(), NodeList({v1, v3}));
+  ASSERT_EQ(res->shape(), shape);
+  ASSERT_EQ(fuser_.numCachedKernels(), 1);
+  ASSERT_TRUE(allClose(evalNode(res), fl::exp(t1 * 2 + t3)));
+}
+
+TEST_F(JitElementwiseFusionTest, sharedIntermediateNode) {
+  //     v1
+  //     |
+  //    neg
+  //  +--+--+
+  //  |     |
+  // exp   sin
+  //  |     |
+  //  +-add-+
+  Shape shape(Shape({4}));
+  const auto t1 = fl::rand(shape, dtype::f64);
+  const auto v1 = ValueNode::create(t1.copy());
+  const auto neg = UnaryNode::create(v1, UnaryOp::Negative);
+  const auto exp = UnaryNode::create(neg, UnaryOp::Exp);
+  const auto sin = UnaryNode::create(neg, UnaryOp::Sin);
+  const auto add = BinaryNode::create(exp, sin, BinaryOp::Add);
+  const auto res = fuser_.apply(add);
+  // `neg` has 2 uses, so it's computed once and becomes a kernel input
+  ASSERT_TRUE(res->isCustom());
+  ASSERT_EQ(res->inputs(), NodeList({neg}));
+  ASSERT_EQ(fuser_.numCachedKernels(), 1);
+  ASSERT_TRUE(allClose(evalNode(res), fl::exp(-t1) + fl::sin(-t1)));
+}
+
+TEST_F(JitElementwiseFusionTest, broadcast) {
+  // v1  v2
+  //  \  /
+  //   sub  v3
+  //     \  /
+  //     mul
+  const auto t1 = fl::rand({3, 1}, dtype::f32);
+  const auto t2 = fl::rand({3, 1}, dtype::f32);
+  const auto t3 = fl::rand({3, 4, 2}, dtype::f32);
+  const auto v1 = ValueNode::create(t1.copy());
+  const auto v2 = ValueNode::create(t2.copy());
+  const auto v3 = ValueNode::create(t3.copy());
+  const auto sub = BinaryNode::create(v1, v2, BinaryOp::Sub);
+  const auto mul = BinaryNode::create(sub, v3, BinaryOp::Mul);
+  const auto res = fuser_.apply(mul);
+  ASSERT_TRUE(res->isCustom());
+  ASSERT_EQ(res->shape(), Shape({3, 4, 2}));
+  ASSERT_TRUE(allClose(evalNode(res), fl::tile(t1 - t2, {1, 4, 2}) * t3));
+}
+
+TEST_F(JitElementwiseFusionTest, readThroughViews) {
+  //  v1          v2
+  //   |           |
+  // tile(1,4) transpose
+  //     \       /
+  //        add
+  //         |
+  //        exp
+  const auto t1 = fl::rand({3, 1, 2}, dtype::f32);
+  const auto t2 = fl::rand({2, 4, 3}, dtype::f32);
+  const auto v1 = ValueNode::create(t1.copy());
+  const auto v2 = ValueNode::create(t2.copy());
+  const auto tile = ViewNode::create(v1, ViewType::Tile, Shape({1, 4}));
+  const auto transpose = ViewNode::create(v2, ViewType::Transpose, Shape());
+  const auto add = BinaryNode::create(tile, transpose, BinaryOp::Add);
+  const auto exp = UnaryNode::create(add, UnaryOp::Exp);
+  const auto res = fuser_.apply(exp);
+  // views are never materialized
+  ASSERT_TRUE(res->isCustom());
+  ASSERT_EQ(res->inputs(), NodeList({v1, v2}));
+  ASSERT_TRUE(allClose(
+      evalNode(res),
+      fl::exp(fl::tile(t1, {1, 4}) + fl::transpose(t2))));
+}
+
+TEST_F(JitElementwiseFusionTest, singleOpThroughView) {
+  // a single op is still fused if it avoids materializing a view
+  const auto t1 = fl::rand({4, 1}, dtype::f32);
+  const auto t2 = fl::rand({4, 5}, dtype::f32);
+  const auto v1 = ValueNode::create(t1.copy());
+  const auto v2 = ValueNode::create(t2.copy());
+  const auto tile = ViewNode::create(v1, ViewType::Tile, Shape({1, 5}));
+  const auto mul = BinaryNode::create(tile, v2, BinaryOp::Mul);
+  const auto res = fuser_.apply(mul);
+  ASSERT_TRUE(res->isCustom());
+  ASSERT_EQ(res->inputs(), NodeList({v1, v2}));
+  ASSERT_TRUE(allClose(evalNode(res), fl::tile(t1, {1, 5}) * t2));
+}
+
+TEST_F(JitElementwiseFusionTest, unsupportedViewsMaterialized) {
+  // reshaping a transposed layout isn't strided, so it's a kernel input
+  const auto t1 = fl::rand({2, 3}, dtype::f32);
+  const auto v1 = ValueNode::create(t1.copy());
+  const auto transpose = ViewNode::create(v1, ViewType::Transpose, Shape());
+  const auto reshape =
+      ViewNode::create(transpose, ViewType::Reshape, Shape({6}));
+  const auto neg = UnaryNode::create(reshape, UnaryOp::Negative);
+  const auto exp = UnaryNode::create(neg, UnaryOp::Exp);
+  const auto res = fuser_.apply(exp);
+  ASSERT_TRUE(res->isCustom());
+  ASSERT_EQ(res->inputs(), NodeList({reshape}));
+  ASSERT_TRUE(allClose(
+      evalNode(res), fl::exp(-fl::reshape(fl::transpose(t1), {6}))));
+}
+
+TEST_F(JitElementwiseFusionTest, kernelReuse) {
+  // same structure & shapes, different scalar values share a kernel
+  Shape shape(Shape({2, 3}));
+  const auto t1 = fl::rand(shape, dtype::f32);
+  auto makeGraph = [&](float scalar) {
+    const auto v1 = ValueNode::create(t1.copy());
+    const auto c2 = ScalarNode::create(shape, dtype::f32, scalar);
+    const auto mul = BinaryNode::create(v1, c2, BinaryOp::Mul);
+    return UnaryNode::create(mul, UnaryOp::Tanh);
+  };
+  const auto res1 = fuser_.apply(makeGraph(2));
+  const auto res2 = fuser_.apply(makeGraph(3));
+  ASSERT_EQ(fuser_.numCachedKernels(), 1);
+  ASSERT_TRUE(allClose(evalNode(res1), fl::tanh(t1 * 2)));
+  ASSERT_TRUE(allClose(evalNode(res2), fl::tanh(t1 * 3)));
+}
+
+TEST_F(JitElementwiseFusionTest, integralInputs) {
+  // not natively supported, falls back to the backend
+  Shape shape(Shape({2, 2}));
+  const auto t1 = fl::full(shape, 3, dtype::s32);
+  const auto v1 = ValueNode::create(t1.copy());
+  const auto c2 = ScalarNode::create(shape, dtype::s32, 2);
+  const auto c4 = ScalarNode::create(shape, dtype::s32, 4);
+  const auto mul = BinaryNode::create(v1, c2, BinaryOp::Mul);
+  const auto sub = BinaryNode::create(mul, c4, BinaryOp::Sub);
+  const auto res = fuser_.apply(sub);
+  ASSERT_TRUE(res->isCustom());
+  ASSERT_TRUE(allClose(evalNode(res), fl::full(shape, 2, dtype::s32)));
+}
+
+TEST_F(JitElementwiseFusionTest, unsupportedOpsNotFused) {
+  // v1  v2
+  //  \  /
+  //   eq
+  //   |
+  //   not
+  Shape shape(Shape({2, 2}));
+  const auto v1 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto v2 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto eq = BinaryNode::create(v1, v2, BinaryOp::Eq);
+  const auto logicalNot = UnaryNode::create(eq, UnaryOp::LogicalNot);
+  // nothing changes
+  ASSERT_EQ(logicalNot, fuser_.apply(logicalNot));
+  ASSERT_EQ(logicalNot->inputs(), NodeList({eq}));
+  ASSERT_EQ(eq->inputs(), NodeList({v1, v2}));
+  ASSERT_EQ(fuser_.numCachedKernels(), 0);
+}
+
+TEST_F(JitElementwiseFusionTest, kernelCacheBounded) {
+  ElementwiseFusion fuser(defaultBackend_, /* kernelCacheCapacity = */ 2);
+  // exp(v1 * c2) for shapes {1}, {2}, {3}, ...
+  auto fuseChain = [&](Dim size) {
+    Shape shape({size});
+    const auto t1 = fl::rand(shape, dtype::f32);
+    const auto v1 = ValueNode::create(t1.copy());
+    const auto c2 = ScalarNode::create(shape, dtype::f32, 2);
+    const auto mul = BinaryNode::create(v1, c2, BinaryOp::Mul);
+    const auto exp = UnaryNode::create(mul, UnaryOp::Exp);
+    const auto res = fuser.apply(exp);
+    ASSERT_TRUE(res->isCustom());
+    ASSERT_TRUE(allClose(evalNode(res), fl::exp(t1 * 2)));
+  };
+  for (Dim size = 1; size <= 5; size++) {
+    fuseChain(size);
+    ASSERT_LE(fuser.numCachedKernels(), 2);
+  }
+  // evicted kernels are recreated
+  fuseChain(1);
+  ASSERT_EQ(fuser.numCachedKernels(), 2);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
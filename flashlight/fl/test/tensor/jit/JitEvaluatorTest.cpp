@@ -56,6 +56,43 @@ TEST_F(JitEvaluatorTest, evalBinaryNode) {
   ASSERT_TRUE(allClose(add->getResult().value(), full(shape, 3, dtype)));
 }
 
+TEST_F(JitEvaluatorTest, evalUnaryNode) {
+  // c1
+  //  |
+  // neg
+  Shape shape(Shape({2, 2}));
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(shape, dtype, 3);
+  const auto neg = UnaryNode::create(c1, UnaryOp::Negative);
+  evaluator_.eval(neg);
+  ASSERT_TRUE(allClose(neg->getResult().value(), full(shape, -3, dtype)));
+}
+
+TEST_F(JitEvaluatorTest, evalReductionNode) {
+  // v1
+  //  |
+  // sum
+  const auto value = fl::rand(Shape({2, 3, 4}), dtype::f32);
+  const auto v1 = ValueNode::create(value.copy());
+  const auto sum = ReductionNode::create(v1, ReductionOp::Sum, {1}, true);
+  evaluator_.eval(sum);
+  const auto& result = sum->getResult().value();
+  ASSERT_EQ(result.shape(), sum->shape());
+  ASSERT_TRUE(allClose(result, fl::sum(value, {1}, true)));
+}
+
+TEST_F(JitEvaluatorTest, evalMatmulNode) {
+  const auto lhs = fl::rand({3, 4}, dtype::f32);
+  const auto rhs = fl::rand({4, 5}, dtype::f32);
+  const auto lhsNode = ValueNode::create(lhs.copy());
+  const auto rhsNode = ValueNode::create(rhs.copy());
+  const auto matmulNode = MatmulNode::create(
+      lhsNode, rhsNode, MatrixProperty::None, MatrixProperty::None);
+  evaluator_.eval(matmulNode);
+  ASSERT_TRUE(
+      allClose(matmulNode->getResult().value(), fl::matmul(lhs, rhs)));
+}
+
 TEST_F(JitEvaluatorTest, evalCustomNode) {
   // c1  c2  c3
   //  \  |  /
@@ -188,6 +225,108 @@ TEST_F(JitEvaluatorTest, evalRetainResults) {
   ASSERT_TRUE(allClose(add->getResult().value(), full(shape, 3, dtype)));
 }
 
+TEST_F(JitEvaluatorTest, evalMemoryStats) {
+  // c1  c2
+  //  \  /
+  //   add
+  Shape shape(Shape({2, 2}));
+  auto dtype = dtype::s32;
+  const auto c1 = ScalarNode::create(shape, dtype, 1);
+  const auto c2 = ScalarNode::create(shape, dtype, 2);
+  const auto add = BinaryNode::create(c1, c2, BinaryOp::Add);
+  evaluator_.eval(add);
+  // all 3 results are alive right after `add` is evaluated
+  const auto bytes = shape.elements() * getTypeSize(dtype);
+  ASSERT_EQ(evaluator_.getMemoryStats().peakIntermediateBytes, 3 * bytes);
+  ASSERT_EQ(evaluator_.getMemoryStats().numInPlaceEvals, 0);
+}
+
+TEST_F(JitEvaluatorTest, evalIndexedUpdateNodeInPlace) {
+  // c1 is only read by the update, so its buffer is updated in place
+  Shape shape(Shape({2, 3}));
+  auto dtype = dtype::s32;
+  const std::vector<Index> indices{range(0, 1)};
+  const auto updateValue = full({1, 3}, 7, dtype);
+  const auto c1 = ScalarNode::create(shape, dtype, 1);
+  const auto updateValueNode = ValueNode::create(updateValue.copy());
+  const auto indexedUpdateNode =
+      IndexedUpdateNode::create(c1, {indices}, updateValueNode);
+  evaluator_.eval(indexedUpdateNode);
+  auto resultValue = full(shape, 1, dtype);
+  resultValue(indices) = updateValue;
+  ASSERT_TRUE(allClose(indexedUpdateNode->getResult().value(), resultValue));
+  ASSERT_EQ(evaluator_.getMemoryStats().numInPlaceEvals, 1);
+}
+
+TEST_F(JitEvaluatorTest, evalIndexedUpdateNodeNotInPlace) {
+  // c1's result is retained, so it must not be overwritten
+  Shape shape(Shape({2, 3}));
+  auto dtype = dtype::s32;
+  const std::vector<Index> indices{range(0, 1)};
+  const auto updateValue = full({1, 3}, 7, dtype);
+  const auto c1 = ScalarNode::create(shape, dtype, 1);
+  const auto updateValueNode = ValueNode::create(updateValue.copy());
+  const auto indexedUpdateNode =
+      IndexedUpdateNode::create(c1, {indices}, updateValueNode);
+  ExternalUse u1(c1);
+  evaluator_.eval(indexedUpdateNode);
+  auto resultValue = full(shape, 1, dtype);
+  resultValue(indices) = updateValue;
+  ASSERT_TRUE(allClose(indexedUpdateNode->getResult().value(), resultValue));
+  ASSERT_TRUE(allClose(c1->getResult().value(), full(shape, 1, dtype)));
+  ASSERT_EQ(evaluator_.getMemoryStats().numInPlaceEvals, 0);
+}
+
+TEST_F(JitEvaluatorTest, evalParallel) {
+  // independent branches, some sharing inputs
+  //      v0         v1
+  //    /  |  \      |
+  //  sin cos  exp  tanh
+  //    \  |    \   /
+  //     mul     add
+  //       \    /
+  //        sub
+  Shape shape(Shape({3, 4}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto v1 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto buildTree = [&]() -> NodePtr {
+    const auto sin = UnaryNode::create(v0, UnaryOp::Sin);
+    const auto cos = UnaryNode::create(v0, UnaryOp::Cos);
+    const auto exp = UnaryNode::create(v0, UnaryOp::Exp);
+    const auto tanh = UnaryNode::create(v1, UnaryOp::Tanh);
+    const auto mul = BinaryNode::create(sin, cos, BinaryOp::Mul);
+    const auto add = BinaryNode::create(exp, tanh, BinaryOp::Add);
+    return BinaryNode::create(mul, add, BinaryOp::Sub);
+  };
+  const auto serialRoot = buildTree();
+  evaluator_.eval(serialRoot);
+  evaluator_.setMaxParallelism(4);
+  ASSERT_EQ(evaluator_.getMaxParallelism(), 4);
+  for (int i = 0; i < 10; i++) {
+    const auto parallelRoot = buildTree();
+    evaluator_.eval(parallelRoot);
+    ASSERT_TRUE(allClose(
+        parallelRoot->getResult().value(), serialRoot->getResult().value()));
+  }
+  ASSERT_THROW(evaluator_.setMaxParallelism(0), std::invalid_argument);
+}
+
+TEST_F(JitEvaluatorTest, evalParallelThrows) {
+  Shape shape(Shape({2, 2}));
+  const auto c1 = ScalarNode::create(shape, dtype::s32, 1);
+  const auto fail = CustomNode::create(
+      "fail",
+      {c1},
+      shape,
+      [](const std::vector<const Tensor*>& /* inputs */) -> Tensor {
+        throw std::runtime_error("fail");
+      });
+  const auto add = BinaryNode::create(fail, c1, BinaryOp::Add);
+  evaluator_.setMaxParallelism(2);
+  ASSERT_THROW(evaluator_.eval(add), std::runtime_error);
+  ASSERT_FALSE(add->getResult().has_value());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   init();
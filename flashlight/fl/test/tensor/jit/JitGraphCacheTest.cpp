@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/Types.h"
+#include "flashlight/fl/tensor/backend/jit/Utils.h"
+#include "flashlight/fl/tensor/backend/jit/eval/Evaluator.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ExternalUse.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/opt/GraphCache.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/ElementwiseFusion.h"
+#include "flashlight/fl/tensor/backend/jit/opt/passes/ScalarFolding.h"
+
+using namespace fl;
+
+class JitGraphCacheTest : public ::testing::Test {
+ protected:
+  TensorBackend& defaultBackend_ = DefaultTensorBackend_t::getInstance();
+  ScalarFolding scalarFolder_;
+  ElementwiseFusion fuser_{defaultBackend_};
+  Evaluator evaluator_{defaultBackend_};
+  GraphCache cache_;
+  unsigned numOptimizations_{0};
+
+  NodePtr optimize(NodePtr root, std::vector<NodePtr>& schedule) {
+    return cache_.optimize(
+        root,
+        [this](NodePtr node) {
+          numOptimizations_++;
+          return fuser_.apply(scalarFolder_.apply(node));
+        },
+        schedule);
+  }
+
+  //    c1  c2
+  //     \  /
+  // v0  add
+  //  \  /
+  //   mul
+  //    |
+  //   exp
+  NodePtr buildTree(const Tensor& value, int scalar) {
+    const auto shape = value.shape();
+    const auto v0 = ValueNode::create(value.copy());
+    const auto c1 = ScalarNode::create(shape, value.type(), scalar);
+    const auto c2 = ScalarNode::create(shape, value.type(), 1);
+    const auto add = BinaryNode::create(c1, c2, BinaryOp::Add);
+    const auto mul = BinaryNode::create(v0, add, BinaryOp::Mul);
+    return UnaryNode::create(mul, UnaryOp::Exp);
+  }
+};
+
+TEST_F(JitGraphCacheTest, hitOnSameStructure) {
+  const auto t0 = fl::rand({3, 4}, dtype::f32);
+  const auto t1 = fl::rand({3, 4}, dtype::f32);
+  std::vector<NodePtr> schedule;
+
+  // external uses (e.g., from tensors) are part of the key
+  const auto tree0 = buildTree(t0, 2);
+  ExternalUse use0(tree0);
+  const auto res0 = optimize(tree0, schedule);
+  ASSERT_EQ(cache_.getStats().hits, 0);
+  ASSERT_EQ(cache_.getStats().misses, 1);
+  ASSERT_EQ(numOptimizations_, 1);
+  ASSERT_EQ(schedule.back(), res0);
+
+  // different leaf value, same structure
+  const auto tree1 = buildTree(t1, 2);
+  ExternalUse use1(tree1);
+  const auto res1 = optimize(tree1, schedule);
+  ASSERT_EQ(cache_.getStats().hits, 1);
+  ASSERT_EQ(cache_.getStats().misses, 1);
+  ASSERT_EQ(numOptimizations_, 1);
+  ASSERT_EQ(schedule.back(), res1);
+  ASSERT_EQ(use0.usee(), res0);
+  ASSERT_EQ(use1.usee(), res1);
+
+  // the replayed tree has the same structure as an optimized one
+  ASSERT_EQ(res0->type(), res1->type());
+  ASSERT_EQ(res0->inputs().size(), res1->inputs().size());
+  ASSERT_TRUE(res1->isCustom());
+  ASSERT_EQ(res1->uses(), UseValList({}));
+
+  evaluator_.eval(res1, schedule);
+  ASSERT_TRUE(allClose(res1->getResult().value(), fl::exp(t1 * 3)));
+}
+
+TEST_F(JitGraphCacheTest, missOnDifferentScalar) {
+  const auto t0 = fl::rand({3, 4}, dtype::f32);
+  std::vector<NodePtr> schedule;
+  optimize(buildTree(t0, 2), schedule);
+  const auto res = optimize(buildTree(t0, 3), schedule);
+  ASSERT_EQ(cache_.getStats().hits, 0);
+  ASSERT_EQ(cache_.getStats().misses, 2);
+  evaluator_.eval(res, schedule);
+  ASSERT_TRUE(allClose(res->getResult().value(), fl::exp(t0 * 4)));
+}
+
+TEST_F(JitGraphCacheTest, missOnDifferentShape) {
+  std::vector<NodePtr> schedule;
+  optimize(buildTree(fl::rand({3, 4}, dtype::f32), 2), schedule);
+  optimize(buildTree(fl::rand({4, 3}, dtype::f32), 2), schedule);
+  optimize(buildTree(fl::rand({3, 4}, dtype::f64), 2), schedule);
+  ASSERT_EQ(cache_.getStats().hits, 0);
+  ASSERT_EQ(cache_.getStats().misses, 3);
+}
+
+TEST_F(JitGraphCacheTest, evaluatedNodesAreLeaves) {
+  // the history behind an evaluated node isn't part of the key
+  const auto t0 = fl::rand({2, 2}, dtype::f32);
+  std::vector<NodePtr> schedule;
+  auto makeEvaluatedNode = [&](unsigned depth) {
+    NodePtr node = ValueNode::create(t0.copy());
+    for (unsigned i = 0; i < depth; i++) {
+      node = UnaryNode::create(node, UnaryOp::Negative);
+    }
+    evaluator_.eval(node);
+    return node;
+  };
+  const auto leaf0 = makeEvaluatedNode(1);
+  const auto leaf1 = makeEvaluatedNode(2);
+  const auto sin0 = UnaryNode::create(leaf0, UnaryOp::Sin);
+  const auto sin1 = UnaryNode::create(leaf1, UnaryOp::Sin);
+  optimize(UnaryNode::create(sin0, UnaryOp::Cos), schedule);
+  const auto res = optimize(UnaryNode::create(sin1, UnaryOp::Cos), schedule);
+  ASSERT_EQ(cache_.getStats().hits, 1);
+  ASSERT_EQ(res->inputs(), NodeList({leaf1}));
+  evaluator_.eval(res, schedule);
+  ASSERT_TRUE(allClose(res->getResult().value(), fl::cos(fl::sin(t0))));
+}
+
+TEST_F(JitGraphCacheTest, customNodeNotCached) {
+  const auto t0 = fl::rand({2, 2}, dtype::f32);
+  std::vector<NodePtr> schedule;
+  for (unsigned i = 0; i < 2; i++) {
+    const auto v0 = ValueNode::create(t0.copy());
+    const auto custom = CustomNode::create(
+        "identity",
+        {v0},
+        v0->shape(),
+        [](const std::vector<const Tensor*>& inputs) { return *inputs[0]; });
+    optimize(custom, schedule);
+    ASSERT_TRUE(schedule.empty());
+  }
+  ASSERT_EQ(cache_.getStats().hits, 0);
+  ASSERT_EQ(cache_.getStats().misses, 2);
+  ASSERT_EQ(numOptimizations_, 2);
+}
+
+TEST_F(JitGraphCacheTest, evictsLeastRecentlyUsed) {
+  const auto t0 = fl::rand({2, 2}, dtype::f32);
+  std::vector<NodePtr> schedule;
+  GraphCache cache(/* capacity = */ 2);
+  const auto optimizeWith = [&](int scalar) {
+    cache.optimize(
+        buildTree(t0, scalar),
+        [this](NodePtr node) { return fuser_.apply(node); },
+        schedule);
+  };
+  optimizeWith(1);
+  optimizeWith(2);
+  optimizeWith(1); // refreshes the plan for 1
+  optimizeWith(3); // evicts the plan for 2
+  ASSERT_EQ(cache.getStats().hits, 1);
+  optimizeWith(1);
+  ASSERT_EQ(cache.getStats().hits, 2);
+  optimizeWith(2);
+  ASSERT_EQ(cache.getStats().misses, 4);
+}
+
+TEST_F(JitGraphCacheTest, clearStats) {
+  const auto t0 = fl::rand({2, 2}, dtype::f32);
+  std::vector<NodePtr> schedule;
+  optimize(buildTree(t0, 2), schedule);
+  optimize(buildTree(t0, 2), schedule);
+  cache_.clearStats();
+  ASSERT_EQ(cache_.getStats().hits, 0);
+  ASSERT_EQ(cache_.getStats().misses, 0);
+  // plans survive
+  optimize(buildTree(t0, 2), schedule);
+  ASSERT_EQ(cache_.getStats().hits, 1);
+  cache_.clear();
+  optimize(buildTree(t0, 2), schedule);
+  ASSERT_EQ(cache_.getStats().misses, 1);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/Types.h"
+#include "flashlight/fl/tensor/backend/jit/JitBackend.h"
+#include "flashlight/fl/tensor/backend/jit/JitTensor.h"
+#include "flashlight/fl/tensor/backend/jit/JitTensorBase.h"
+#include "flashlight/fl/tensor/backend/jit/MaterializationPolicy.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+
+using namespace fl;
+
+TEST(JitMaterializationPolicyTest, estimateTreeCost) {
+  //  v0   c1
+  //   \   /
+  //  matmul
+  //     |
+  //    sum
+  //     |
+  //    exp
+  const auto v0 = ValueNode::create(fl::rand({3, 4}, dtype::f32));
+  const auto c1 = ScalarNode::create(Shape({4, 5}), dtype::f32, 1);
+  const auto matmul = MatmulNode::create(
+      v0, c1, MatrixProperty::None, MatrixProperty::None);
+  const auto sum = ReductionNode::create(matmul, ReductionOp::Sum, {1}, false);
+  const auto exp = UnaryNode::create(sum, UnaryOp::Exp);
+  const auto cost = estimateTreeCost(exp);
+  ASSERT_EQ(cost.numNodes, 4); // v0 is evaluated
+  ASSERT_EQ(cost.flops, 2 * 3 * 5 * 4 + 3 * 5 + 3);
+  ASSERT_EQ(cost.intermediateElements, 4 * 5 + 3 * 5 + 3 + 3);
+  // costs are cached for incremental estimation
+  ASSERT_EQ(matmul->getTreeCost().value().numNodes, 2);
+  ASSERT_FALSE(UnaryNode::create(exp, UnaryOp::Exp)->getTreeCost().has_value());
+  ASSERT_EQ(estimateTreeCost(UnaryNode::create(exp, UnaryOp::Exp)).numNodes, 5);
+  // evaluated nodes cut off their inputs
+  sum->setResult(fl::full({3}, 20, dtype::f32));
+  ASSERT_EQ(estimateTreeCost(exp).numNodes, 1);
+}
+
+TEST(JitMaterializationPolicyTest, thresholds) {
+  Shape shape({10, 10});
+  const auto c0 = ScalarNode::create(shape, dtype::f32, 0);
+  NodePtr node = c0;
+  for (int i = 0; i < 4; i++) {
+    node = UnaryNode::create(node, UnaryOp::Exp);
+  }
+  // 5 nodes, 400 flops, 500 elements
+  ThresholdMaterializationPolicy::Thresholds thresholds;
+  ThresholdMaterializationPolicy defaultPolicy;
+  ASSERT_EQ(defaultPolicy.shouldMaterialize(node), std::nullopt);
+
+  thresholds.maxNodes = 4;
+  ASSERT_EQ(
+      ThresholdMaterializationPolicy(thresholds).shouldMaterialize(node),
+      MaterializationReason::NodeCount);
+  thresholds.maxNodes = 5;
+  thresholds.maxFlops = 399;
+  ASSERT_EQ(
+      ThresholdMaterializationPolicy(thresholds).shouldMaterialize(node),
+      MaterializationReason::Flops);
+  thresholds.maxFlops = 400;
+  thresholds.maxIntermediateElements = 499;
+  ASSERT_EQ(
+      ThresholdMaterializationPolicy(thresholds).shouldMaterialize(node),
+      MaterializationReason::IntermediateMemory);
+  thresholds.maxIntermediateElements = 500;
+  ASSERT_EQ(
+      ThresholdMaterializationPolicy(thresholds).shouldMaterialize(node),
+      std::nullopt);
+}
+
+TEST(JitMaterializationPolicyTest, jitBackendMaterializes) {
+  fl::setDefaultTensorType<JitTensor<DefaultTensorType_t>>();
+  auto x = fl::full({2, 2}, 0, dtype::s32);
+  auto& backend = toJitTensorBase(x).backend();
+  ASSERT_EQ(backend.materializationPolicy(), nullptr); // opt-in
+  ThresholdMaterializationPolicy::Thresholds thresholds;
+  thresholds.maxNodes = 8;
+  backend.setMaterializationPolicy(
+      std::make_unique<ThresholdMaterializationPolicy>(thresholds));
+  backend.clearMaterializationCounts();
+  for (int i = 0; i < 20; i++) {
+    x = x + 1;
+    // the tree never grows beyond the threshold
+    ASSERT_LE(estimateTreeCost(toJitTensorBase(x).node()).numNodes, 8);
+  }
+  const auto& counts = backend.getMaterializationCounts();
+  ASSERT_GT(counts.at(MaterializationReason::NodeCount), 0);
+  ASSERT_EQ(counts.count(MaterializationReason::Flops), 0);
+  ASSERT_TRUE(allClose(x, fl::full({2, 2}, 20, dtype::s32)));
+
+  // consumers decide when to evaluate
+  backend.setMaterializationPolicy(nullptr);
+  backend.clearMaterializationCounts();
+  for (int i = 0; i < 20; i++) {
+    x = x + 1;
+  }
+  ASSERT_GT(estimateTreeCost(toJitTensorBase(x).node()).numNodes, 20);
+  ASSERT_TRUE(backend.getMaterializationCounts().empty());
+}
+
+TEST(JitMaterializationPolicyTest, matmulWaitsForConsumer) {
+  fl::setDefaultTensorType<JitTensor<DefaultTensorType_t>>();
+  const auto lhs = fl::rand({3, 4}, dtype::f32);
+  const auto rhs = fl::rand({4, 5}, dtype::f32);
+  auto& backend = toJitTensorBase(lhs).backend();
+  ThresholdMaterializationPolicy::Thresholds thresholds;
+  thresholds.maxFlops = 1;
+  backend.setMaterializationPolicy(
+      std::make_unique<ThresholdMaterializationPolicy>(thresholds));
+  backend.clearMaterializationCounts();
+  // a matmul alone is never evaluated, its consumer may be fused into it
+  const auto product = fl::matmul(lhs, rhs);
+  ASSERT_FALSE(toJitTensorBase(product).node()->getResult().has_value());
+  ASSERT_TRUE(backend.getMaterializationCounts().empty());
+  const auto sum = product + 1;
+  ASSERT_TRUE(toJitTensorBase(sum).node()->getResult().has_value());
+  const auto& counts = backend.getMaterializationCounts();
+  ASSERT_EQ(counts.at(MaterializationReason::Flops), 1);
+  backend.setMaterializationPolicy(nullptr);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
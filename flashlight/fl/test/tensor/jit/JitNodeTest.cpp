@@ -22,9 +22,13 @@
 #include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/IndexNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/IndexedUpdateNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/Node.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
 
 using namespace fl;
 
@@ -71,6 +75,104 @@ TEST(JitNodeTest, BinaryNodeMetaData) {
   ASSERT_EQ(node->shape(), outShape);
 }
 
+TEST(JitNodeTest, UnaryNodeMetaData) {
+  Shape shape({3, 4});
+  const auto c1 = ScalarNode::create(shape, dtype::f32, 42);
+  const auto op = UnaryOp::Tanh;
+  const auto node = UnaryNode::create(c1, op);
+  ASSERT_EQ(node->inputs(), NodeList({c1}));
+  ASSERT_EQ(node->uses(), UseValList({}));
+  ASSERT_EQ(c1->uses(), UseValList({{node, 0}}));
+  ASSERT_EQ(node->isUnary(), true);
+  ASSERT_EQ(node->getResult(), std::nullopt);
+  ASSERT_EQ(node->input(), c1);
+  ASSERT_EQ(node->op(), op);
+  ASSERT_EQ(node->shape(), shape);
+}
+
+TEST(JitNodeTest, ReductionNodeMetaData) {
+  const auto c1 = ScalarNode::create(Shape({3, 4, 5}), dtype::f32, 42);
+  const auto op = ReductionOp::Sum;
+  const std::vector<int> axes{0, 2};
+  const auto node = ReductionNode::create(c1, op, axes, /* keepDims = */ false);
+  ASSERT_EQ(node->inputs(), NodeList({c1}));
+  ASSERT_EQ(node->uses(), UseValList({}));
+  ASSERT_EQ(c1->uses(), UseValList({{node, 0}}));
+  ASSERT_EQ(node->isReduction(), true);
+  ASSERT_EQ(node->getResult(), std::nullopt);
+  ASSERT_EQ(node->input(), c1);
+  ASSERT_EQ(node->op(), op);
+  ASSERT_EQ(node->axes(), axes);
+  ASSERT_EQ(node->keepDims(), false);
+  ASSERT_EQ(node->shape(), Shape({4}));
+  // keepDims & empty axes (reduce all)
+  const auto node2 = ReductionNode::create(c1, ReductionOp::Max, {}, true);
+  ASSERT_EQ(node2->shape(), Shape({1, 1, 1}));
+  ASSERT_THROW(
+      ReductionNode::create(c1, ReductionOp::Mean, {3}, false),
+      std::invalid_argument);
+}
+
+TEST(JitNodeTest, MatmulNodeMetaData) {
+  const auto c1 = ScalarNode::create(Shape({4, 3}), dtype::f32, 42);
+  const auto c2 = ScalarNode::create(Shape({4, 5}), dtype::f32, 23);
+  const auto lhsProp = MatrixProperty::Transpose;
+  const auto rhsProp = MatrixProperty::None;
+  const auto node = MatmulNode::create(c1, c2, lhsProp, rhsProp);
+  ASSERT_EQ(node->inputs(), NodeList({c1, c2}));
+  ASSERT_EQ(node->uses(), UseValList({}));
+  ASSERT_EQ(c1->uses(), UseValList({{node, 0}}));
+  ASSERT_EQ(c2->uses(), UseValList({{node, 1}}));
+  ASSERT_EQ(node->isMatmul(), true);
+  ASSERT_EQ(node->getResult(), std::nullopt);
+  ASSERT_EQ(node->lhs(), c1);
+  ASSERT_EQ(node->rhs(), c2);
+  ASSERT_EQ(node->lhsProp(), lhsProp);
+  ASSERT_EQ(node->rhsProp(), rhsProp);
+  ASSERT_EQ(node->shape(), Shape({3, 5}));
+  ASSERT_THROW(
+      MatmulNode::create(c1, c2, rhsProp, rhsProp), std::invalid_argument);
+}
+
+TEST(JitNodeTest, MatmulNodeBroadcastsBatchDims) {
+  const auto none = MatrixProperty::None;
+  const auto create = [none](const Shape& lhsShape, const Shape& rhsShape) {
+    return MatmulNode::create(
+        ScalarNode::create(lhsShape, dtype::f32, 1),
+        ScalarNode::create(rhsShape, dtype::f32, 2),
+        none,
+        none);
+  };
+  // batch dims of size 1 are broadcast
+  ASSERT_EQ(create({2, 2, 3, 1}, {2, 2, 1, 4})->shape(), Shape({2, 2, 3, 4}));
+  // missing batch dims are padded with 1s
+  ASSERT_EQ(create({2, 2, 3}, {2, 2, 1, 4})->shape(), Shape({2, 2, 3, 4}));
+  ASSERT_EQ(create({2, 2}, {2, 2, 3})->shape(), Shape({2, 2, 3}));
+  ASSERT_THROW(create({2, 2, 3}, {2, 2, 2}), std::invalid_argument);
+}
+
+TEST(JitNodeTest, ViewNodeMetaData) {
+  const auto c1 = ScalarNode::create(Shape({2, 3, 4}), dtype::f32, 42);
+  const auto tile = ViewNode::create(c1, ViewType::Tile, Shape({1, 2}));
+  ASSERT_EQ(tile->inputs(), NodeList({c1}));
+  ASSERT_EQ(c1->uses(), UseValList({{tile, 0}}));
+  ASSERT_EQ(tile->isView(), true);
+  ASSERT_EQ(tile->getResult(), std::nullopt);
+  ASSERT_EQ(tile->input(), c1);
+  ASSERT_EQ(tile->viewType(), ViewType::Tile);
+  ASSERT_EQ(tile->params(), Shape({1, 2}));
+  ASSERT_EQ(tile->shape(), Shape({2, 6, 4}));
+  const auto transpose = ViewNode::create(c1, ViewType::Transpose, Shape());
+  ASSERT_EQ(transpose->shape(), Shape({4, 3, 2}));
+  ASSERT_EQ(transpose->transposeAxes(), std::vector<int>({2, 1, 0}));
+  const auto reshape =
+      ViewNode::create(c1, ViewType::Reshape, Shape({6, 4}));
+  ASSERT_EQ(reshape->shape(), Shape({6, 4}));
+  ASSERT_THROW(
+      ViewNode::create(c1, ViewType::Reshape, Shape({5, 5})),
+      std::invalid_argument);
+}
+
 TEST(JitNodeTest, CustomNodeMetaData) {
   Shape shape({2, 2});
   auto type = dtype::f32;
@@ -6,17 +6,22 @@
  */
 
 #include <functional>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "flashlight/fl/tensor/Init.h"
 #include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/TensorBase.h"
 #include "flashlight/fl/tensor/Types.h"
 #include "flashlight/fl/tensor/backend/jit/Utils.h"
 #include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/MatmulNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/opt/backends/onednn/OneDnnOpFusion.h"
+#include "flashlight/fl/tensor/backend/onednn/OneDnnBackend.h"
 
 using namespace fl;
 
@@ -186,6 +191,196 @@ TEST_F(JitOneDnnOpFusionTest, nestedFusableChains) {
   ASSERT_TRUE(fusedCustomRoot->isCustom());
 }
 
+TEST_F(JitOneDnnOpFusionTest, binaryChainWithUnaryOps) {
+  // c1  c2
+  //  \  /
+  //   mul  c3
+  //    \  /
+  //     add
+  //      |
+  //     tanh
+  Shape shape(Shape({2, 2}));
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(shape, dtype, 1);
+  const auto c2 = ScalarNode::create(shape, dtype, 2);
+  const auto c3 = ScalarNode::create(shape, dtype, 3);
+  const auto mul = BinaryNode::create(c1, c2, BinaryOp::Mul);
+  const auto add = BinaryNode::create(mul, c3, BinaryOp::Add);
+  const auto tanh = UnaryNode::create(add, UnaryOp::Tanh);
+  // c1  c2
+  //  \  /
+  //   mul  c3            c1 c2  c3
+  //    \  /               \  |  /
+  //     add      ---->  fusedCustomNode
+  //      |
+  //     tanh
+  const auto fusedNode = oneDnnFuser_.apply(tanh);
+  ASSERT_TRUE(fusedNode->isCustom());
+  ASSERT_EQ(fusedNode->inputs(), NodeList({c1, c2, c3}));
+  ASSERT_EQ(fusedNode->uses(), UseValList({}));
+  ASSERT_EQ(fusedNode->shape(), shape);
+  ASSERT_EQ(tanh->uses(), UseValList({})); // replaced by fused node
+}
+
+TEST_F(JitOneDnnOpFusionTest, leadingUnaryOpNotFused) {
+  // c1
+  //  |
+  // exp  c2
+  //  \  /
+  //   add  c3
+  //    \  /
+  //     sub
+  Shape shape(Shape({2, 2}));
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(shape, dtype, 1);
+  const auto c2 = ScalarNode::create(shape, dtype, 2);
+  const auto c3 = ScalarNode::create(shape, dtype, 3);
+  const auto exp = UnaryNode::create(c1, UnaryOp::Exp);
+  const auto add = BinaryNode::create(exp, c2, BinaryOp::Add);
+  const auto sub = BinaryNode::create(add, c3, BinaryOp::Sub);
+  // c1
+  //  |
+  // exp  c2                c1
+  //  \  /                  |
+  //   add  c3     ---->    exp c2  c3
+  //    \  /                 \  |  /
+  //     sub              fusedCustomNode
+  const auto fusedNode = oneDnnFuser_.apply(sub);
+  ASSERT_TRUE(fusedNode->isCustom());
+  ASSERT_EQ(fusedNode->inputs(), NodeList({exp, c2, c3}));
+  ASSERT_EQ(exp->inputs(), NodeList({c1}));
+  ASSERT_EQ(exp->uses(), UseValList({{add, 0}, {fusedNode, 0}}));
+}
+
+TEST_F(JitOneDnnOpFusionTest, matmulEpilogue) {
+  // c1  c2
+  //  \  /
+  // matmul  c3
+  //     \  /
+  //      add
+  //       |
+  //      tanh
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(Shape({3, 4}), dtype, 1);
+  const auto c2 = ScalarNode::create(Shape({4, 5}), dtype, 2);
+  const auto c3 = ScalarNode::create(Shape({3, 5}), dtype, 3);
+  const auto matmul = MatmulNode::create(
+      c1, c2, MatrixProperty::None, MatrixProperty::None);
+  const auto add = BinaryNode::create(matmul, c3, BinaryOp::Add);
+  const auto tanh = UnaryNode::create(add, UnaryOp::Tanh);
+  // c1  c2
+  //  \  /
+  // matmul  c3           c1 c2  c3
+  //     \  /             \  |  /
+  //      add    ---->  fusedCustomNode
+  //       |
+  //      tanh
+  const auto fusedNode = oneDnnFuser_.apply(tanh);
+  ASSERT_TRUE(fusedNode->isCustom());
+  ASSERT_EQ(fusedNode->inputs(), NodeList({c1, c2, c3}));
+  ASSERT_EQ(fusedNode->shape(), Shape({3, 5}));
+  ASSERT_EQ(tanh->uses(), UseValList({})); // replaced by fused node
+}
+
+TEST_F(JitOneDnnOpFusionTest, fusedEvalUsesBackendCacheAndMemory) {
+  // c1  c2
+  //  \  /
+  //   add  c3
+  //     \  /
+  //      mul
+  Shape shape({2, 2});
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(shape, dtype, 1);
+  const auto c2 = ScalarNode::create(shape, dtype, 2);
+  const auto c3 = ScalarNode::create(shape, dtype, 3);
+  const auto add = BinaryNode::create(c1, c2, BinaryOp::Add);
+  const auto mul = BinaryNode::create(add, c3, BinaryOp::Mul);
+  const auto fusedNode = oneDnnFuser_.apply(mul);
+  ASSERT_TRUE(fusedNode->isCustom());
+
+  auto& backend = OneDnnBackend::getInstance();
+  const auto t1 = backend.full(shape, 1, dtype);
+  const auto t2 = backend.full(shape, 2, dtype);
+  const auto t3 = backend.full(shape, 3, dtype);
+  const auto& evalFunc = fusedNode->impl<CustomNode>().evalFunc();
+  auto& cache = backend.primitiveCache();
+  cache.resetStats();
+  // the 2nd evaluation reuses the primitive built by the 1st one
+  const auto res1 = evalFunc({&t1, &t2, &t3});
+  const auto res2 = evalFunc({&t1, &t2, &t3});
+  ASSERT_EQ(cache.getStats().misses, 1);
+  ASSERT_EQ(cache.getStats().hits, 1);
+  ASSERT_TRUE(allClose(res1, backend.full(shape, 9, dtype)));
+  ASSERT_TRUE(allClose(res2, res1));
+}
+
+TEST_F(JitOneDnnOpFusionTest, matmulEpilogueTooManyPostOps) {
+  // c1  c2
+  //  \  /
+  // matmul  c3
+  //     \  /
+  //     add1  c3
+  //        \  /
+  //         ...
+  //          \  c3
+  //           \ /
+  //          add33
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(Shape({3, 4}), dtype, 1);
+  const auto c2 = ScalarNode::create(Shape({4, 5}), dtype, 2);
+  const auto c3 = ScalarNode::create(Shape({3, 5}), dtype, 3);
+  const auto matmul = MatmulNode::create(
+      c1, c2, MatrixProperty::None, MatrixProperty::None);
+  const unsigned numAdds = 33;
+  std::vector<NodePtr> adds;
+  NodePtr root = matmul;
+  for (unsigned i = 0; i < numAdds; i++) {
+    root = BinaryNode::create(root, c3, BinaryOp::Add);
+    adds.push_back(root);
+  }
+  // OneDNN allows at most 32 post-ops, so `add33` stays on top of the fused
+  // matmul epilogue
+  //
+  // c1  c2
+  //  \  /
+  // matmul  c3           c1 c2  c3 ... c3
+  //     \  /             \  |  /      /
+  //     add1   ---->    fusedCustomNode  c3
+  //      ...                       \   /
+  //     add33                      add33
+  const auto fusedNode = oneDnnFuser_.apply(root);
+  ASSERT_EQ(fusedNode, root);
+  const auto epilogue = root->inputs().front();
+  ASSERT_TRUE(epilogue->isCustom());
+  NodeList expectedInputs{c1, c2};
+  expectedInputs.insert(expectedInputs.end(), numAdds - 1, c3);
+  ASSERT_EQ(epilogue->inputs(), expectedInputs);
+  ASSERT_EQ(epilogue->shape(), Shape({3, 5}));
+  ASSERT_EQ(root->inputs(), NodeList({epilogue, c3}));
+  ASSERT_EQ(adds[numAdds - 2]->uses(), UseValList({})); // replaced
+}
+
+TEST_F(JitOneDnnOpFusionTest, sharedMatmulNotFused) {
+  // c1  c2
+  //  \  /
+  // matmul
+  //  |   |
+  //  |  exp
+  //   \  /
+  //    add
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(Shape({3, 4}), dtype, 1);
+  const auto c2 = ScalarNode::create(Shape({4, 5}), dtype, 2);
+  const auto matmul = MatmulNode::create(
+      c1, c2, MatrixProperty::None, MatrixProperty::None);
+  const auto exp = UnaryNode::create(matmul, UnaryOp::Exp);
+  const auto add = BinaryNode::create(matmul, exp, BinaryOp::Add);
+  // nothing changes, matmul's result is needed by 2 nodes
+  ASSERT_EQ(oneDnnFuser_.apply(add), add);
+  ASSERT_EQ(add->inputs(), NodeList({matmul, exp}));
+  ASSERT_EQ(exp->inputs(), NodeList({matmul}));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   init();
@@ -16,8 +16,11 @@
 #include "flashlight/fl/tensor/backend/jit/Utils.h"
 #include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/CustomNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
 #include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ViewNode.h"
 #include "flashlight/fl/tensor/backend/jit/opt/passes/ScalarFolding.h"
 
 using namespace fl;
@@ -141,6 +144,74 @@ TEST_F(JitScalarFoldingTest, multipleUsers) {
   ASSERT_EQ(res->impl<ScalarNode>().scalar<int>(), 20);
 }
 
+TEST_F(JitScalarFoldingTest, unaryNode) {
+  // c1  c2
+  //  \  /
+  //   sub
+  //    |
+  //   exp
+  Shape shape(Shape({2, 2}));
+  auto dtype = dtype::f32;
+  const auto c1 = ScalarNode::create(shape, dtype, 3);
+  const auto c2 = ScalarNode::create(shape, dtype, 3);
+  const auto sub = BinaryNode::create(c1, c2, BinaryOp::Sub);
+  const auto exp = UnaryNode::create(sub, UnaryOp::Exp);
+  const auto res = scalarFolder_.apply(exp);
+  ASSERT_EQ(exp->uses(), UseValList({}));
+  ASSERT_EQ(res->inputs(), NodeList({}));
+  ASSERT_EQ(res->uses(), UseValList({}));
+  ASSERT_EQ(res->impl<ScalarNode>().shape(), shape);
+  ASSERT_EQ(res->impl<ScalarNode>().dataType(), dtype);
+  ASSERT_EQ(res->impl<ScalarNode>().scalar<float>(), 1);
+}
+
+TEST_F(JitScalarFoldingTest, unaryNodeNonFloatingPoint) {
+  // c1
+  //  |
+  // neg
+  Shape shape(Shape({2, 2}));
+  auto dtype = dtype::s32;
+  const auto c1 = ScalarNode::create(shape, dtype, 3);
+  const auto neg = UnaryNode::create(c1, UnaryOp::Negative);
+  // nothing changed
+  ASSERT_EQ(neg, scalarFolder_.apply(neg));
+  ASSERT_EQ(neg->inputs(), NodeList({c1}));
+  ASSERT_EQ(c1->uses(), UseValList({{neg, 0}}));
+}
+
+TEST_F(JitScalarFoldingTest, reductionNode) {
+  // c1       c1
+  //  |        |
+  // sum     mean
+  auto dtype = dtype::f64;
+  const auto c1 = ScalarNode::create(Shape({2, 3, 4}), dtype, 2);
+  const auto sum = ReductionNode::create(c1, ReductionOp::Sum, {0, 2}, false);
+  const auto sumRes = scalarFolder_.apply(sum);
+  ASSERT_EQ(sumRes->inputs(), NodeList({}));
+  ASSERT_EQ(sumRes->impl<ScalarNode>().shape(), Shape({3}));
+  ASSERT_EQ(sumRes->impl<ScalarNode>().dataType(), dtype);
+  ASSERT_EQ(sumRes->impl<ScalarNode>().scalar<double>(), 16);
+  const auto mean = ReductionNode::create(c1, ReductionOp::Mean, {}, true);
+  const auto meanRes = scalarFolder_.apply(mean);
+  ASSERT_EQ(meanRes->impl<ScalarNode>().shape(), Shape({1, 1, 1}));
+  ASSERT_EQ(meanRes->impl<ScalarNode>().dataType(), dtype);
+  ASSERT_EQ(meanRes->impl<ScalarNode>().scalar<double>(), 2);
+}
+
+TEST_F(JitScalarFoldingTest, viewNode) {
+  //   c1
+  //    |
+  //  tile
+  auto dtype = dtype::u64;
+  const auto c1 = ScalarNode::create(Shape({2, 1}), dtype, 7);
+  const auto tile = ViewNode::create(c1, ViewType::Tile, Shape({1, 3}));
+  const auto res = scalarFolder_.apply(tile);
+  ASSERT_EQ(res->inputs(), NodeList({}));
+  ASSERT_EQ(res->impl<ScalarNode>().shape(), Shape({2, 3}));
+  ASSERT_EQ(res->impl<ScalarNode>().dataType(), dtype);
+  ASSERT_EQ(res->impl<ScalarNode>().scalar<unsigned long long>(), 7);
+}
+
 TEST_F(JitScalarFoldingTest, nonFoldableRoot) {
   // c6  c3
   //  \  /
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/Types.h"
+#include "flashlight/fl/tensor/backend/jit/Utils.h"
+#include "flashlight/fl/tensor/backend/jit/eval/Scheduler.h"
+#include "flashlight/fl/tensor/backend/jit/ir/BinaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ReductionNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ScalarNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/UnaryNode.h"
+#include "flashlight/fl/tensor/backend/jit/ir/ValueNode.h"
+
+using namespace fl;
+
+TEST(JitSchedulerTest, largerPeakFirst) {
+  // the subtree that needs more memory to evaluate goes first, so that the
+  // small result of `exp` isn't alive while evaluating it.
+  //        cs   cb1  cb2
+  //        |     \   /
+  //        |      add
+  //        |       |
+  //       exp     sum
+  //         \     /
+  //          root
+  const auto dtype = dtype::f32;
+  const auto cs = ScalarNode::create(Shape({4}), dtype, 1);
+  const auto cb1 = ScalarNode::create(Shape({4, 100}), dtype, 1);
+  const auto cb2 = ScalarNode::create(Shape({4, 100}), dtype, 2);
+  const auto exp = UnaryNode::create(cs, UnaryOp::Exp);
+  const auto add = BinaryNode::create(cb1, cb2, BinaryOp::Add);
+  const auto sum = ReductionNode::create(add, ReductionOp::Sum, {1}, false);
+  const auto root = BinaryNode::create(exp, sum, BinaryOp::Add);
+  ASSERT_EQ(
+      getEvaluationSchedule(root),
+      NodeList({cb1, cb2, add, sum, cs, exp, root}));
+}
+
+TEST(JitSchedulerTest, sharedInputScheduledOnce) {
+  //    c1
+  //   /  |
+  // sin  cos
+  //   \  |
+  //    add
+  Shape shape(Shape({2, 2}));
+  const auto c1 = ScalarNode::create(shape, dtype::f32, 1);
+  const auto sin = UnaryNode::create(c1, UnaryOp::Sin);
+  const auto cos = UnaryNode::create(c1, UnaryOp::Cos);
+  const auto add = BinaryNode::create(sin, cos, BinaryOp::Add);
+  ASSERT_EQ(getEvaluationSchedule(add), NodeList({c1, sin, cos, add}));
+}
+
+TEST(JitSchedulerTest, evaluatedNodesFirst) {
+  // nodes with results are scheduled first, and their inputs are skipped
+  Shape shape(Shape({3}));
+  const auto v0 = ValueNode::create(fl::rand(shape, dtype::f32));
+  const auto exp = UnaryNode::create(v0, UnaryOp::Exp);
+  exp->setResult(fl::exp(v0->getResult().value()));
+  const auto c1 = ScalarNode::create(shape, dtype::f32, 1);
+  const auto neg = UnaryNode::create(c1, UnaryOp::Negative);
+  const auto add = BinaryNode::create(neg, exp, BinaryOp::Add);
+  ASSERT_EQ(getEvaluationSchedule(add), NodeList({exp, c1, neg, add}));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/Compute.h"
+#include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/jit/JitTensor.h"
+#include "flashlight/fl/tensor/backend/jit/printer/ScopedPostEvalTracePrinter.h"
+
+using namespace fl;
+
+namespace {
+
+unsigned countOccurrences(const std::string& str, const std::string& pattern) {
+  unsigned count = 0;
+  for (auto pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + pattern.size())) {
+    count++;
+  }
+  return count;
+}
+
+} // namespace
+
+class JitTracePrinterTest : public ::testing::Test {
+  void SetUp() override {
+    fl::setDefaultTensorType<JitTensor<DefaultTensorType_t>>();
+  }
+};
+
+TEST_F(JitTracePrinterTest, recordsEvaluations) {
+  std::ostringstream oss;
+  {
+    ScopedPostEvalTracePrinter printer(oss);
+    for (int i = 0; i < 2; i++) {
+      auto x = fl::full({2, 3}, i, dtype::f32);
+      auto y = fl::matmul(x, fl::transpose(x)) + 1;
+      fl::eval(y);
+    }
+    // printer only writes when it goes out of scope
+    ASSERT_TRUE(oss.str().empty());
+  }
+  const auto trace = oss.str();
+  ASSERT_NE(trace.find("\"traceEvents\":["), std::string::npos);
+  ASSERT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+  ASSERT_NE(trace.find("Matmul"), std::string::npos);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"JitGraph\""), 2);
+  // both evaluations have the same signature
+  ASSERT_EQ(countOccurrences(trace, "\"count\":2"), 1);
+  ASSERT_EQ(countOccurrences(trace, "\"count\":"), 1);
+}
+
+TEST_F(JitTracePrinterTest, maxNodeEvents) {
+  std::ostringstream oss;
+  {
+    ScopedPostEvalTracePrinter printer(oss, /* maxNodeEvents */ 0);
+    auto x = fl::full({2, 2}, 1, dtype::f32);
+    auto y = fl::exp(x) + x;
+    fl::eval(y);
+  }
+  const auto trace = oss.str();
+  // only graph events are kept, nodes are still aggregated
+  ASSERT_EQ(countOccurrences(trace, "\"cat\":\"node\""), 0);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"JitGraph\""), 1);
+  ASSERT_EQ(trace.find("\"numDroppedEvents\":0"), std::string::npos);
+  ASSERT_NE(trace.find("\"totalBytes\":"), std::string::npos);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  init();
+  return RUN_ALL_TESTS();
+}
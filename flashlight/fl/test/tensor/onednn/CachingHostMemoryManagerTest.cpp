@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/Compute.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/fl/tensor/backend/onednn/OneDnnBackend.h"
+#include "flashlight/fl/tensor/backend/onednn/OneDnnTensor.h"
+#include "flashlight/fl/tensor/backend/onednn/mem/CachingHostMemoryManager.h"
+
+using fl::CachingHostMemoryManager;
+
+namespace {
+
+bool isAligned(const void* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % fl::HostMemoryManager::kAlignment ==
+      0;
+}
+
+} // namespace
+
+TEST(CachingHostMemoryManagerTest, splitAndRecycle) {
+  auto manager = std::make_shared<CachingHostMemoryManager>(1);
+  // small allocations are carved out of the same native allocation
+  void* ptr1 = manager->alloc(100);
+  void* ptr2 = manager->alloc(1000);
+  ASSERT_TRUE(isAligned(ptr1));
+  ASSERT_TRUE(isAligned(ptr2));
+  ASSERT_EQ(static_cast<char*>(ptr2) - static_cast<char*>(ptr1), 512);
+  ASSERT_EQ(manager->getStats().totalNativeMallocs_, 1);
+
+  // released blocks are recycled
+  manager->free(ptr1);
+  ASSERT_EQ(manager->alloc(300), ptr1);
+  manager->free(ptr1);
+  manager->free(ptr2);
+  auto stats = manager->getStats();
+  ASSERT_EQ(stats.totalNativeMallocs_, 1);
+  ASSERT_EQ(stats.cachedBytes_, stats.allocatedBytes_);
+
+  // merged back into a single block, which can be returned to the system
+  manager->signalMemoryCleanup();
+  stats = manager->getStats();
+  ASSERT_EQ(stats.allocatedBytes_, 0);
+  ASSERT_EQ(stats.totalNativeFrees_, 1);
+}
+
+TEST(CachingHostMemoryManagerTest, largeAllocations) {
+  auto manager = std::make_shared<CachingHostMemoryManager>(1);
+  const size_t bytes = 30 << 20;
+  void* ptr = manager->alloc(bytes);
+  ASSERT_TRUE(isAligned(ptr));
+  manager->free(ptr);
+  ASSERT_EQ(manager->alloc(bytes), ptr);
+  manager->free(ptr);
+
+  // recycling disabled for blocks of this size
+  manager->setRecyclingSizeLimit(bytes);
+  void* newPtr = manager->alloc(bytes);
+  ASSERT_EQ(manager->getStats().totalNativeMallocs_, 2);
+  manager->free(newPtr);
+}
+
+TEST(CachingHostMemoryManagerTest, allocShared) {
+  auto manager = std::make_shared<CachingHostMemoryManager>(1);
+  ASSERT_EQ(manager->alloc(0), nullptr);
+  {
+    auto buffer = manager->allocShared(4096);
+    ASSERT_TRUE(isAligned(buffer.get()));
+    ASSERT_EQ(manager->getStats().cachedBytes_, (2 << 20) - 4096);
+  }
+  const auto stats = manager->getStats();
+  ASSERT_EQ(stats.cachedBytes_, stats.allocatedBytes_);
+
+  int notManaged = 0;
+  ASSERT_THROW(manager->free(&notManaged), std::invalid_argument);
+}
+
+TEST(CachingHostMemoryManagerTest, backsOneDnnTensors) {
+  auto& backend = fl::OneDnnBackend::getInstance();
+  auto manager = std::make_shared<CachingHostMemoryManager>(1);
+  backend.setMemoryManager(manager);
+  {
+    auto a = fl::full({64, 64}, 1.0);
+    auto b = a + a;
+    ASSERT_TRUE(isAligned(b.device<void>()));
+    b.unlock();
+    ASSERT_GT(manager->getStats().allocatedBytes_, 0);
+    ASSERT_LT(
+        manager->getStats().cachedBytes_, manager->getStats().allocatedBytes_);
+  }
+  // all tensor buffers are back in the cache
+  const auto stats = manager->getStats();
+  ASSERT_EQ(stats.cachedBytes_, stats.allocatedBytes_);
+
+  std::ostringstream oss;
+  ASSERT_NO_THROW(fl::detail::getMemMgrInfo("info", 0, &oss));
+  ASSERT_NE(oss.str().find("CachingHostMemoryManager"), std::string::npos);
+
+  backend.setMemoryManager(std::make_shared<CachingHostMemoryManager>());
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  fl::init();
+  fl::setDefaultTensorType<fl::OneDnnTensor>();
+  return RUN_ALL_TESTS();
+}
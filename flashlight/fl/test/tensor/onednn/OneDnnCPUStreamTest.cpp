@@ -5,10 +5,14 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <stdexcept>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "flashlight/fl/runtime/DeviceManager.h"
 #include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/backend/onednn/CpuTaskQueue.h"
 #include "flashlight/fl/tensor/backend/onednn/OneDnnCPUStream.h"
 
 #include <dnnl.hpp>
@@ -52,6 +56,119 @@ TEST(OneDnnCPUStreamTest, sync) {
   ASSERT_NO_THROW(os1->sync());
 }
 
+TEST(OneDnnCPUStreamTest, asyncExecute) {
+  const dnnl::engine engine(dnnl::engine::kind::cpu, 0);
+  const auto stream = OneDnnCPUStream::create(engine);
+  ASSERT_FALSE(stream->isAsync());
+  stream->setNumWorkers(4);
+  // falls back to in-order execution if primitives can't run concurrently
+  const bool isAsync = OneDnnCPUStream::supportsConcurrentExecution();
+  ASSERT_EQ(stream->isAsync(), isAsync);
+  ASSERT_EQ(stream->numWorkers(), isAsync ? 4 : 0);
+
+  const dnnl::memory::desc desc(
+      {1024}, dnnl::memory::data_type::f32, dnnl::memory::format_tag::a);
+  std::vector<float> a(1024, 1), b(1024), c(1024), d(1024, 2), e(1024);
+  const auto memory = [&](std::vector<float>& data) {
+    return dnnl::memory(desc, engine, data.data());
+  };
+  const auto add = [&](dnnl::memory lhs, dnnl::memory rhs, dnnl::memory dst) {
+    const dnnl::binary primitive(dnnl::binary::primitive_desc(
+        engine, dnnl::algorithm::binary_add, desc, desc, desc));
+    stream->execute(
+        primitive,
+        {{DNNL_ARG_SRC_0, lhs}, {DNNL_ARG_SRC_1, rhs}, {DNNL_ARG_DST, dst}});
+  };
+  // b = a + a, c = b + b; independently, e = d + d; then a = e + e, which must
+  // wait for the read of a
+  add(memory(a), memory(a), memory(b));
+  add(memory(b), memory(b), memory(c));
+  add(memory(d), memory(d), memory(e));
+  add(memory(e), memory(e), memory(a));
+
+  stream->syncData(c.data());
+  ASSERT_EQ(c, std::vector<float>(1024, 4));
+  stream->sync();
+  ASSERT_EQ(a, std::vector<float>(1024, 8));
+
+  stream->setNumWorkers(0);
+  ASSERT_FALSE(stream->isAsync());
+  add(memory(a), memory(a), memory(b));
+  ASSERT_EQ(b, std::vector<float>(1024, 16));
+}
+
+TEST(OneDnnCPUStreamTest, postOpArgsAreReadOnly) {
+  for (int idx = 0; idx < 3; idx++) {
+    ASSERT_TRUE(fl::detail::isReadOnlyArg(
+        DNNL_ARG_ATTR_MULTIPLE_POST_OP(idx) | DNNL_ARG_SRC_1));
+  }
+  ASSERT_FALSE(fl::detail::isReadOnlyArg(DNNL_ARG_DST));
+  ASSERT_FALSE(fl::detail::isReadOnlyArg(DNNL_ARG_WORKSPACE));
+
+  // e = (a + b) + c + d, where c and d are inputs of post-ops #0 and #1, so
+  // they must stay readable (and overwritable) by other primitives
+  const dnnl::engine engine(dnnl::engine::kind::cpu, 0);
+  const auto stream = OneDnnCPUStream::create(engine);
+  stream->setNumWorkers(4);
+  const dnnl::memory::desc desc(
+      {1024}, dnnl::memory::data_type::f32, dnnl::memory::format_tag::a);
+  std::vector<float> a(1024, 1), b(1024, 2), c(1024, 3), d(1024, 4), e(1024);
+  const auto memory = [&](std::vector<float>& data) {
+    return dnnl::memory(desc, engine, data.data());
+  };
+  dnnl::post_ops postOps;
+  postOps.append_binary(dnnl::algorithm::binary_add, desc);
+  postOps.append_binary(dnnl::algorithm::binary_add, desc);
+  dnnl::primitive_attr attr;
+  attr.set_post_ops(postOps);
+  const dnnl::binary fused(dnnl::binary::primitive_desc(
+      engine, dnnl::algorithm::binary_add, desc, desc, desc, attr));
+  stream->execute(
+      fused,
+      {{DNNL_ARG_SRC_0, memory(a)},
+       {DNNL_ARG_SRC_1, memory(b)},
+       {DNNL_ARG_ATTR_MULTIPLE_POST_OP(0) | DNNL_ARG_SRC_1, memory(c)},
+       {DNNL_ARG_ATTR_MULTIPLE_POST_OP(1) | DNNL_ARG_SRC_1, memory(d)},
+       {DNNL_ARG_DST, memory(e)}});
+  // then d = a + a must wait for the read of d
+  const dnnl::binary add(dnnl::binary::primitive_desc(
+      engine, dnnl::algorithm::binary_add, desc, desc, desc));
+  stream->execute(
+      add,
+      {{DNNL_ARG_SRC_0, memory(a)},
+       {DNNL_ARG_SRC_1, memory(a)},
+       {DNNL_ARG_DST, memory(d)}});
+  stream->sync();
+  ASSERT_EQ(e, std::vector<float>(1024, 10));
+  ASSERT_EQ(d, std::vector<float>(1024, 2));
+}
+
+TEST(OneDnnCPUStreamTest, taskQueueErrors) {
+  fl::detail::CpuTaskQueue queue(2);
+  int a = 0, b = 0, c = 0, d = 0;
+  const auto fail = [](unsigned) { throw std::runtime_error("failed"); };
+  // b = f(a) fails, so c = g(b) is skipped, while d = h(a) runs
+  queue.submit(fail, {&a}, {&b});
+  queue.submit([&c](unsigned) { c = 1; }, {&b}, {&c});
+  queue.submit([&d](unsigned) { d = 1; }, {&a}, {&d});
+  ASSERT_THROW(queue.waitFor(&b), std::runtime_error);
+  ASSERT_THROW(queue.waitFor(&c), std::runtime_error);
+  ASSERT_NO_THROW(queue.waitFor(&d));
+  ASSERT_EQ(c, 0);
+  ASSERT_EQ(d, 1);
+  // readers submitted after the failure are skipped too
+  queue.submit([&d](unsigned) { d = 2; }, {&b}, {&d});
+  ASSERT_THROW(queue.waitFor(&d), std::runtime_error);
+  ASSERT_EQ(d, 1);
+  ASSERT_THROW(queue.waitAll(), std::runtime_error);
+  // overwriting or releasing a buffer clears its poison
+  queue.submit([&b](unsigned) { b = 1; }, {}, {&b});
+  ASSERT_NO_THROW(queue.waitFor(&b));
+  queue.release(&c);
+  ASSERT_NO_THROW(queue.waitFor(&c));
+  ASSERT_NO_THROW(queue.waitAll()); // rethrown only once
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
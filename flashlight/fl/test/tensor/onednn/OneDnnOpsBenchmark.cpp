@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "flashlight/fl/common/Timer.h"
+#include "flashlight/fl/tensor/Compute.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/TensorAdapter.h"
+#include "flashlight/fl/tensor/backend/onednn/OneDnnTensor.h"
+
+#if FL_USE_ARRAYFIRE
+#include "flashlight/fl/tensor/backend/af/ArrayFireTensor.h"
+#endif
+
+using namespace fl;
+
+// Times ops that OneDnnBackend implements with CPU kernels. Run it once per
+// backend and compare, e.g., against ArrayFire's CPU backend.
+
+namespace {
+
+double timeit(std::function<Tensor()> fn) {
+  // warmup
+  for (int i = 0; i < 10; ++i) {
+    fn();
+  }
+  fl::sync();
+
+  int num_iters = 100;
+  fl::sync();
+  auto start = fl::Timer::start();
+  for (int i = 0; i < num_iters; i++) {
+    // force evaluation, so lazy backends can't skip the computation
+    auto result = fn();
+    fl::eval(result);
+  }
+  fl::sync();
+  return fl::Timer::stop(start) / num_iters;
+}
+
+void runBenchmarks(const std::string& backendName) {
+  const Shape shape({1024, 1024});
+  const auto x = fl::rand(shape);
+  const auto y = fl::rand(shape);
+  const auto cond = x > y;
+  const std::vector<std::pair<std::string, std::function<Tensor()>>> ops = {
+      {"sin", [&]() { return fl::sin(x); }},
+      {"floor", [&]() { return fl::floor(x * 10); }},
+      {"power", [&]() { return fl::power(x, y); }},
+      {"where", [&]() { return fl::where(cond, x, y); }},
+      {"cumsum(0)", [&]() { return fl::cumsum(x, 0); }},
+      {"cumsum(1)", [&]() { return fl::cumsum(x, 1); }},
+      {"argmax(0)", [&]() { return fl::argmax(x, 0); }},
+      {"argmax(1)", [&]() { return fl::argmax(x, 1); }},
+      {"sort(0)", [&]() { return fl::sort(x, 0); }},
+      {"median(1)", [&]() { return fl::median(x, {1}); }},
+      {"var(1)", [&]() { return fl::var(x, {1}); }},
+      {"norm", [&]() { return fl::norm(x); }},
+      {"flip(1)", [&]() { return fl::flip(x, 1); }},
+      {"roll(0)", [&]() { return fl::roll(x, 3, 0); }},
+      {"tril", [&]() { return fl::tril(x); }},
+      {"pad", [&]() { return fl::pad(x, {{2, 2}, {2, 2}}); }},
+      {"concatenate(1)", [&]() { return fl::concatenate({x, y}, 1); }},
+  };
+  std::cout << "Backend: " << backendName << std::endl;
+  for (const auto& [name, fn] : ops) {
+    std::cout << "Timing " << name << " ...  " << std::flush;
+    std::cout << std::setprecision(5) << timeit(fn) * 1000.0 << " msec"
+              << std::endl;
+  }
+}
+
+} // namespace
+
+int main() {
+  fl::init();
+
+  fl::setDefaultTensorType<OneDnnTensor>();
+  runBenchmarks("OneDNN");
+
+#if FL_USE_ARRAYFIRE
+  fl::setDefaultTensorType<ArrayFireTensor>();
+  runBenchmarks("ArrayFire");
+#endif
+  return 0;
+}
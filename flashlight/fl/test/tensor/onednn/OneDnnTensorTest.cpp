@@ -12,8 +12,12 @@
 
 #include <gtest/gtest.h>
 
+#include "flashlight/fl/autograd/Functions.h"
+#include "flashlight/fl/autograd/Variable.h"
 #include "flashlight/fl/tensor/Index.h"
 #include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/TensorAdapter.h"
 #include "flashlight/fl/tensor/backend/onednn/OneDnnBackend.h"
 #include "flashlight/fl/tensor/backend/onednn/OneDnnTensor.h"
 
@@ -523,6 +527,17 @@ TEST(OneDnnTensorTest, matmul) {
       res2,
       fl::Tensor::fromVector<float>(
           {3, 3}, {22, 29, 36, 27, 36, 45, 32, 43, 54}));
+
+  // batch dims of size 1 (or missing) are broadcast
+  auto batch = fl::Tensor::fromVector<float>(
+      {3, 2, 2}, {2, 3, 4, 5, 6, 7, 4, 6, 8, 10, 12, 14});
+  auto res3 = backend.matmul(t1, batch, MP::None, MP::None);
+  auto expected3 = fl::Tensor::fromVector<float>(
+      {2, 2, 2}, {20, 47, 38, 92, 40, 94, 76, 184});
+  assertOneDnnTensorEq(res3, expected3.copy());
+  auto res4 = backend.matmul(
+      batch, fl::reshape(t1, {2, 3, 1}), MP::Transpose, MP::Transpose);
+  assertOneDnnTensorEq(res4, fl::transpose(expected3, {1, 0, 2}));
 }
 
 TEST(OneDnnTensorTest, matmulShapes) {
@@ -553,9 +568,12 @@ TEST(OneDnnTensorTest, matmulShapes) {
       // batch matrix
       {{2, 3, 42}, {2, 3, 42}, MP::None, MP::Transpose, {{2, 2, 42}}},
       {{2, 3, 41}, {2, 3, 42}, MP::None, MP::Transpose, std::nullopt},
-      // TODO support broadcast
-      {{2, 3, 1}, {2, 3, 42}, MP::None, MP::Transpose, std::nullopt},
-      {{2, 3}, {2, 3, 42}, MP::None, MP::Transpose, std::nullopt},
+      // broadcast batch matrix
+      {{2, 3, 1}, {2, 3, 42}, MP::None, MP::Transpose, {{2, 2, 42}}},
+      {{2, 3}, {2, 3, 42}, MP::None, MP::Transpose, {{2, 2, 42}}},
+      {{3, 2, 42}, {3, 4}, MP::Transpose, MP::None, {{2, 4, 42}}},
+      {{2, 3, 1, 4}, {3, 5, 6, 1}, MP::None, MP::None, {{2, 5, 6, 4}}},
+      {{2, 3, 2, 4}, {3, 5, 3, 4}, MP::None, MP::None, std::nullopt},
   };
   for (auto& input : inputs) {
     const auto lhs = backend.rand(input.lhsShape, fl::dtype::f32);
@@ -678,6 +696,256 @@ TEST(OneDnnTensorTest, arange) {
       fl::Tensor::fromVector<float>({2, 2}, {0, 0, 1, 1}));
 }
 
+TEST(OneDnnTensorTest, primitiveCache) {
+  auto& cache = fl::OneDnnBackend::getInstance().primitiveCache();
+  auto a = fl::full({3, 4}, 1.0f);
+  auto b = fl::full({3, 4}, 2.0f);
+  assertOneDnnTensorEq(a + b, fl::full({3, 4}, 3.0f));
+
+  // same op on same memory layouts reuses the primitive
+  cache.resetStats();
+  assertOneDnnTensorEq(b + a, fl::full({3, 4}, 3.0f));
+  ASSERT_EQ(cache.getStats().hits, 1);
+  ASSERT_EQ(cache.getStats().misses, 0);
+
+  // different shape or op needs a new one
+  auto c = fl::full({4, 3}, 1.0f);
+  assertOneDnnTensorEq(c + c, fl::full({4, 3}, 2.0f));
+  assertOneDnnTensorEq(a * b, fl::full({3, 4}, 2.0f));
+  ASSERT_EQ(cache.getStats().misses, 2);
+
+  // caching disabled
+  const auto capacity = cache.getCapacity();
+  cache.setCapacity(0);
+  cache.resetStats();
+  assertOneDnnTensorEq(a + b, fl::full({3, 4}, 3.0f));
+  assertOneDnnTensorEq(a + b, fl::full({3, 4}, 3.0f));
+  ASSERT_EQ(cache.getStats().hits, 0);
+  ASSERT_EQ(cache.getStats().misses, 2);
+  cache.setCapacity(capacity);
+}
+
+TEST(OneDnnTensorTest, blockedLayout) {
+  auto& backend = fl::OneDnnBackend::getInstance();
+  const auto& engine = backend.cpuEngine();
+  const fl::Shape shape({3, 3, 32, 2}); // WHCN
+  auto plain = fl::rand(shape) - 0.5;
+  auto& plainMem = plain.getAdapter<OneDnnTensor>().memory();
+  // reorder into a blocked layout, as picked by e.g. a convolution
+  const auto blockedDesc = dnnl::memory::desc(
+      {2, 32, 3, 3},
+      dnnl::memory::data_type::f32,
+      dnnl::memory::format_tag::nChw16c);
+  auto [blockedMem, buffer] = backend.createMemory(blockedDesc, engine);
+  dnnl::reorder(plainMem, blockedMem)
+      .execute(backend.nativeStream(), plainMem, blockedMem);
+  auto blocked = fl::toTensor<OneDnnTensor>(
+      shape, dnnl::memory(blockedMem), std::move(buffer));
+  ASSERT_FALSE(blocked.getAdapter<OneDnnTensor>().hasPlainLayout());
+
+  // element-wise ops keep the layout, with or without broadcast scalars
+  auto relu = fl::maximum(blocked, 0.0);
+  auto sum = relu + blocked;
+  ASSERT_FALSE(relu.getAdapter<OneDnnTensor>().hasPlainLayout());
+  ASSERT_FALSE(sum.getAdapter<OneDnnTensor>().hasPlainLayout());
+  ASSERT_EQ(
+      sum.getAdapter<OneDnnTensor>().memoryDescAnyLayout(), blockedDesc);
+
+  // reordered to plain layout when needed
+  assertOneDnnTensorEq(blocked, plain.copy());
+  ASSERT_TRUE(blocked.getAdapter<OneDnnTensor>().hasPlainLayout());
+  assertOneDnnTensorEq(sum, fl::maximum(plain, 0.0) + plain);
+  assertOneDnnTensorEq(
+      relu(fl::span, fl::span, 0),
+      fl::maximum(plain, 0.0)(fl::span, fl::span, 0));
+}
+
+TEST(OneDnnTensorTest, shapeOps) {
+  using fl::Tensor;
+  auto a = Tensor::fromVector<float>({2, 2}, {1, 2, 3, 4});
+  auto b = Tensor::fromVector<float>({2, 1}, {5, 6});
+  assertOneDnnTensorEq(
+      fl::concatenate({a, b}, 1),
+      Tensor::fromVector<float>({2, 3}, {1, 2, 3, 4, 5, 6}));
+  assertOneDnnTensorEq(
+      fl::concatenate({a(fl::span, 1), a(fl::span, 0)}, 0),
+      Tensor::fromVector<float>({4}, {3, 4, 1, 2}));
+  ASSERT_THROW(fl::concatenate({a, b}, 0), std::invalid_argument);
+
+  assertOneDnnTensorEq(
+      fl::pad(b, {{1, 2}}),
+      Tensor::fromVector<float>({5, 1}, {0, 5, 6, 0, 0}));
+  assertOneDnnTensorEq(
+      fl::pad(b, {{1, 2}}, fl::PadType::Edge),
+      Tensor::fromVector<float>({5, 1}, {5, 5, 6, 6, 6}));
+  assertOneDnnTensorEq(
+      fl::pad(b, {{1, 2}}, fl::PadType::Symmetric),
+      Tensor::fromVector<float>({5, 1}, {5, 5, 6, 6, 5}));
+
+  assertOneDnnTensorEq(
+      fl::flip(a, 1), Tensor::fromVector<float>({2, 2}, {3, 4, 1, 2}));
+  assertOneDnnTensorEq(
+      fl::roll(a, 1, 0), Tensor::fromVector<float>({2, 2}, {2, 1, 4, 3}));
+  ASSERT_EQ(fl::roll(fl::rand({0, 3}), 1, 0).shape(), fl::Shape({0, 3}));
+  ASSERT_EQ(fl::flip(fl::rand({0, 3}), 0).shape(), fl::Shape({0, 3}));
+  ASSERT_THROW(fl::roll(a, 1, 2), std::invalid_argument);
+  ASSERT_THROW(fl::flip(a, 2), std::invalid_argument);
+  assertOneDnnTensorEq(
+      fl::tril(a), Tensor::fromVector<float>({2, 2}, {1, 2, 0, 4}));
+  assertOneDnnTensorEq(
+      fl::triu(a), Tensor::fromVector<float>({2, 2}, {1, 0, 3, 4}));
+  assertOneDnnTensorEq(
+      fl::identity(2), Tensor::fromVector<float>({2, 2}, {1, 0, 0, 1}));
+  assertOneDnnTensorEq(
+      fl::iota({2}, {2}), Tensor::fromVector<float>({4}, {0, 1, 0, 1}));
+  assertOneDnnTensorEq(
+      fl::nonzero(Tensor::fromVector<float>({4}, {0, 3, 0, 1})),
+      Tensor::fromVector<int>({2}, {1, 3}));
+
+  auto cond = Tensor::fromVector<float>({2, 2}, {1, 0, 0, 1});
+  assertOneDnnTensorEq(
+      fl::where(cond, a, fl::full({2, 2}, 0.0f)),
+      Tensor::fromVector<float>({2, 2}, {1, 0, 0, 4}));
+}
+
+TEST(OneDnnTensorTest, sortOps) {
+  using fl::Tensor;
+  // 3 1 2
+  // 0 5 4
+  auto a = Tensor::fromVector<float>({2, 3}, {3, 0, 1, 5, 2, 4});
+  assertOneDnnTensorEq(
+      fl::sort(a, 1), Tensor::fromVector<float>({2, 3}, {1, 0, 2, 4, 3, 5}));
+  assertOneDnnTensorEq(
+      fl::argsort(a, 1, fl::SortMode::Descending),
+      Tensor::fromVector<int>({2, 3}, {0, 1, 2, 2, 1, 0}));
+
+  Tensor values, indices;
+  fl::topk(values, indices, a, 1, 1);
+  assertOneDnnTensorEq(values, Tensor::fromVector<float>({2, 1}, {3, 5}));
+  assertOneDnnTensorEq(indices, Tensor::fromVector<int>({2, 1}, {0, 1}));
+  assertOneDnnTensorEq(
+      fl::argmax(a, 1), Tensor::fromVector<int>({2}, {0, 1}));
+  assertOneDnnTensorEq(
+      fl::argmin(a, 0), Tensor::fromVector<int>({3}, {1, 0, 0}));
+}
+
+TEST(OneDnnTensorTest, cpuReductions) {
+  using fl::Tensor;
+  auto a = Tensor::fromVector<float>({2, 3}, {3, 0, 1, 5, 2, 4});
+  assertOneDnnTensorEq(
+      fl::cumsum(a, 1), Tensor::fromVector<float>({2, 3}, {3, 0, 4, 5, 6, 9}));
+  assertOneDnnTensorEq(
+      fl::median(a, {1}), Tensor::fromVector<float>({2}, {2, 4}));
+  assertOneDnnTensorEq(fl::median(a), Tensor::fromVector<float>({}, {2.5}));
+  assertOneDnnTensorEq(
+      fl::var(a, {0}), Tensor::fromVector<float>({3}, {2.25, 4, 1}));
+  assertOneDnnTensorEq(
+      fl::var(a, {0}, /* bias = */ true),
+      Tensor::fromVector<float>({3}, {4.5, 8, 2}));
+  assertOneDnnTensorEq(
+      fl::std(a, {0}), Tensor::fromVector<float>({3}, {1.5, 2, 1}));
+  assertOneDnnTensorEq(
+      fl::norm(a, {0}, 1), Tensor::fromVector<float>({3}, {3, 6, 6}));
+  assertOneDnnTensorEq(
+      fl::norm(a, {0}), Tensor::fromVector<float>({3}, {3, 5.0990195, 4.472136}));
+  ASSERT_FALSE(fl::all(a).scalar<char>());
+  ASSERT_TRUE(fl::all(a(fl::span, 1)).scalar<char>());
+}
+
+TEST(OneDnnTensorTest, cpuEltwise) {
+  using fl::Tensor;
+  auto a = Tensor::fromVector<float>({3}, {-1.5, 0, 2.5});
+  assertOneDnnTensorEq(fl::floor(a), Tensor::fromVector<float>({3}, {-2, 0, 2}));
+  assertOneDnnTensorEq(fl::ceil(a), Tensor::fromVector<float>({3}, {-1, 0, 3}));
+  assertOneDnnTensorEq(
+      fl::sin(a),
+      Tensor::fromVector<float>({3}, {std::sin(-1.5f), 0, std::sin(2.5f)}));
+  assertOneDnnTensorEq(
+      fl::sigmoid(a(1)), Tensor::fromVector<float>({}, {0.5}));
+  assertOneDnnTensorEq(
+      fl::power(a, fl::full({3}, 2.0f)),
+      Tensor::fromVector<float>({3}, {2.25, 0, 6.25}));
+  assertOneDnnTensorEq(
+      fl::isnan(fl::log(a)),
+      Tensor::fromVector<char>({3}, {1, 0, 0}));
+}
+
+TEST(OneDnnTensorTest, asyncStream) {
+  const auto a = fl::rand({64, 64});
+  const auto compute = [&]() {
+    auto x = a.copy();
+    // independent branches, joined at the end
+    auto b = fl::matmul(x, x) + 1;
+    auto c = fl::exp(x) * 2;
+    // overwrite an input still read by queued primitives
+    x(fl::span, 0) = fl::full({64}, 0.0);
+    return fl::sum(b + c, {0}) + fl::sum(x, {0});
+  };
+  const auto expected = compute();
+
+  auto& stream = fl::OneDnnBackend::getInstance().cpuStream();
+  stream.setNumWorkers(4);
+  auto result = compute();
+  ASSERT_TRUE(fl::allClose(result, expected));
+  stream.setNumWorkers(0);
+}
+
+TEST(OneDnnTensorTest, asyncConvNetwork) {
+  const fl::Variable input(fl::rand({10, 9, 3, 2}), false);
+  const fl::Variable weights1(fl::rand({3, 3, 3, 8}), false);
+  const fl::Variable weights2(fl::rand({3, 3, 8, 4}), false);
+  const auto compute = [&]() {
+    // convolutions keep their outputs in OneDNN's layout, which the second one
+    // reads as is while relu reorders it, all possibly still queued
+    const auto hidden = fl::conv2d(input, weights1, 1, 1, 1, 1);
+    const auto output = fl::conv2d(fl::relu(hidden), weights2, 1, 1, 1, 1) +
+        fl::conv2d(hidden, weights2, 1, 1, 1, 1);
+    return output.tensor();
+  };
+  const auto expected = compute();
+
+  auto& stream = fl::OneDnnBackend::getInstance().cpuStream();
+  stream.setNumWorkers(4);
+  auto result = compute();
+  ASSERT_TRUE(fl::allClose(result, expected));
+  stream.setNumWorkers(0);
+}
+
+TEST(OneDnnTensorTest, bf16) {
+  using fl::Tensor;
+  ASSERT_EQ(fl::stringToDtype("bf16"), fl::dtype::bf16);
+  ASSERT_EQ(fl::getTypeSize(fl::dtype::bf16), 2);
+  // small integers are exact in bf16
+  auto a = Tensor::fromVector<float>({2, 3}, {3, 0, 1, 5, 2, 4});
+  auto aBf16 = a.astype(fl::dtype::bf16);
+  ASSERT_EQ(aBf16.type(), fl::dtype::bf16);
+  ASSERT_EQ(aBf16.bytes(), a.bytes() / 2);
+  assertOneDnnTensorEq(aBf16.astype(fl::dtype::f32), a.copy());
+  ASSERT_EQ((aBf16 + 1).type(), fl::dtype::bf16);
+  ASSERT_EQ((aBf16 + a).type(), fl::dtype::f32);
+  assertOneDnnTensorEq(
+      fl::matmul(aBf16, fl::transpose(aBf16)).astype(fl::dtype::f32),
+      fl::matmul(a, fl::transpose(a)));
+
+  // CPU kernels
+  Tensor values, indices;
+  fl::max(values, indices, aBf16, 1);
+  ASSERT_EQ(values.type(), fl::dtype::bf16);
+  assertOneDnnTensorEq(
+      values.astype(fl::dtype::f32), Tensor::fromVector<float>({2}, {3, 5}));
+  assertOneDnnTensorEq(indices, Tensor::fromVector<int>({2}, {0, 1}));
+  assertOneDnnTensorEq(
+      fl::sort(aBf16, 1).astype(fl::dtype::f32), fl::sort(a, 1));
+  assertOneDnnTensorEq(
+      fl::flip(aBf16, 1).astype(fl::dtype::f32), fl::flip(a, 1));
+  assertOneDnnTensorEq(
+      fl::tril(aBf16).astype(fl::dtype::f32), fl::tril(a));
+  assertOneDnnTensorEq(
+      fl::full({2}, 1.5, fl::dtype::bf16).astype(fl::dtype::f32),
+      fl::full({2}, 1.5));
+  ASSERT_NO_THROW(aBf16.toString());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -19,22 +19,36 @@ DynamicScaler::DynamicScaler(
       maxScaleFactor_(maxFactor),
       updateInterval_(updateInterval) {}
 
+bool DynamicScaler::isScalingNeeded() const {
+  // bf16 has the range of f32, so small gradients don't underflow
+  return fl::OptimMode::get().getReducedPrecisionType() != fl::dtype::bf16;
+}
+
 fl::Variable DynamicScaler::scale(const fl::Variable& loss) {
   // Force casting to fp32 to avoid overflow in scaling.
   auto scaledLoss = loss.astype(fl::dtype::f32);
+  if (!isScalingNeeded()) {
+    return scaledLoss;
+  }
   scaledLoss = scaledLoss * scaleFactor_;
   return scaledLoss;
 }
 
 bool DynamicScaler::unscale(std::vector<fl::Variable>& params) {
+  const bool scalingNeeded = isScalingNeeded();
   for (auto& p : params) {
     if (!p.isGradAvailable()) {
       // Add a dummy grad for params not used in the backwards pass
       p.addGrad(Variable(fl::full(p.shape(), 0., p.type()), false));
     }
-    p.grad() = p.grad() / scaleFactor_;
+    if (scalingNeeded) {
+      p.grad() = p.grad() / scaleFactor_;
+    }
     if (fl::isInvalidArray(p.grad().tensor())) {
-      if (scaleFactor_ >= fl::kAmpMinimumScaleFactorValue) {
+      if (!scalingNeeded) {
+        FL_LOG(LogLevel::WARNING)
+            << "AMP: NAN or INF in bf16 gradients, skipping the update";
+      } else if (scaleFactor_ >= fl::kAmpMinimumScaleFactorValue) {
         scaleFactor_ = scaleFactor_ / 2.0f;
         FL_LOG(LogLevel::INFO)
             << "AMP: Scale factor decreased. New value:\t" << scaleFactor_;
@@ -56,7 +70,7 @@ bool DynamicScaler::unscale(std::vector<fl::Variable>& params) {
 }
 
 void DynamicScaler::update() {
-  if (scaleFactor_ >= maxScaleFactor_) {
+  if (!isScalingNeeded() || scaleFactor_ >= maxScaleFactor_) {
     return;
   }
 
@@ -35,6 +35,10 @@ namespace runtime {
  *   }
  *   opt.step();
  * }
+ *
+ * If the reduced precision type is bf16 (see
+ * `fl::OptimMode::setReducedPrecisionType`), losses and gradients aren't
+ * scaled, and only steps with NAN or INF gradients are skipped.
  */
 class DynamicScaler {
  public:
@@ -74,6 +78,9 @@ class DynamicScaler {
   // Double up the scaleFactor_ when successCounter_ equals updateInterval_.
   unsigned int updateInterval_;
 
+  // false if the reduced precision type doesn't underflow like f16
+  bool isScalingNeeded() const;
+
   FL_SAVE_LOAD(scaleFactor_, maxScaleFactor_, updateInterval_, successCounter_)
   DynamicScaler() = default;
 };